@@ -16,7 +16,6 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include "asio/detail/config.hpp"
-#include <climits>
 #include <cstddef>
 #include "asio/detail/noncopyable.hpp"
 
@@ -32,6 +31,22 @@
 namespace asio {
 namespace detail {
 
+// Handler memory is recycled in size classes. Class i holds blocks of
+// ASIO_HANDLER_CACHE_MIN_SIZE << i bytes, and each thread keeps up to
+// ASIO_HANDLER_CACHE_DEPTH blocks of every class. Larger blocks, and
+// blocks freed when a class is full, go to the global heap.
+#if !defined(ASIO_HANDLER_CACHE_MIN_SIZE)
+# define ASIO_HANDLER_CACHE_MIN_SIZE 64
+#endif // !defined(ASIO_HANDLER_CACHE_MIN_SIZE)
+
+#if !defined(ASIO_HANDLER_CACHE_SIZE_CLASSES)
+# define ASIO_HANDLER_CACHE_SIZE_CLASSES 8
+#endif // !defined(ASIO_HANDLER_CACHE_SIZE_CLASSES)
+
+#if !defined(ASIO_HANDLER_CACHE_DEPTH)
+# define ASIO_HANDLER_CACHE_DEPTH 4
+#endif // !defined(ASIO_HANDLER_CACHE_DEPTH)
+
 class thread_info_base
   : private noncopyable
 {
@@ -51,6 +66,25 @@ public:
     enum { mem_index = 2 };
   };
 
+  // Counters for the handler memory of one thread.
+  struct cache_statistics
+  {
+    // Calls to allocate.
+    std::size_t allocations;
+
+    // Allocations satisfied from the cache.
+    std::size_t hits;
+
+    // Allocations which went to the global heap.
+    std::size_t misses;
+
+    // Calls to deallocate.
+    std::size_t deallocations;
+
+    // Deallocations which went to the global heap.
+    std::size_t releases;
+  };
+
   thread_info_base()
 #if defined(ASIO_HAS_STD_EXCEPTION_PTR) \
   && !defined(ASIO_NO_EXCEPTIONS)
@@ -58,20 +92,25 @@ public:
 #endif // defined(ASIO_HAS_STD_EXCEPTION_PTR)
        // && !defined(ASIO_NO_EXCEPTIONS)
   {
-    for (int i = 0; i < max_mem_index; ++i)
-      reusable_memory_[i] = 0;
+    for (int i = 0; i < size_classes; ++i)
+      cached_[i] = 0;
+    stats_.allocations = 0;
+    stats_.hits = 0;
+    stats_.misses = 0;
+    stats_.deallocations = 0;
+    stats_.releases = 0;
   }
 
   ~thread_info_base()
   {
-    for (int i = 0; i < max_mem_index; ++i)
-    {
-      // The following test for non-null pointers is technically redundant, but
-      // it is significantly faster when using a tight io_context::poll() loop
-      // in latency sensitive applications.
-      if (reusable_memory_[i])
-        ::operator delete(reusable_memory_[i]);
-    }
+    for (int i = 0; i < size_classes; ++i)
+      while (cached_[i] > 0)
+        ::operator delete(reusable_memory_[i][--cached_[i]]);
+  }
+
+  const cache_statistics& statistics() const
+  {
+    return stats_;
   }
 
   static void* allocate(thread_info_base* this_thread, std::size_t size)
@@ -85,46 +124,43 @@ public:
     deallocate(default_tag(), this_thread, pointer, size);
   }
 
+  // All purposes share the size classes. The tag is kept so that the
+  // interface matches the one used throughout the library.
   template <typename Purpose>
   static void* allocate(Purpose, thread_info_base* this_thread,
       std::size_t size)
   {
-    std::size_t chunks = (size + chunk_size - 1) / chunk_size;
-
-    if (this_thread && this_thread->reusable_memory_[Purpose::mem_index])
+    const int c = size_class(size);
+    if (this_thread)
     {
-      void* const pointer = this_thread->reusable_memory_[Purpose::mem_index];
-      this_thread->reusable_memory_[Purpose::mem_index] = 0;
-
-      unsigned char* const mem = static_cast<unsigned char*>(pointer);
-      if (static_cast<std::size_t>(mem[0]) >= chunks)
+      ++this_thread->stats_.allocations;
+      if (c < size_classes && this_thread->cached_[c] > 0)
       {
-        mem[size] = mem[0];
-        return pointer;
+        ++this_thread->stats_.hits;
+        return this_thread->reusable_memory_[c][--this_thread->cached_[c]];
       }
-
-      ::operator delete(pointer);
+      ++this_thread->stats_.misses;
     }
 
-    void* const pointer = ::operator new(chunks * chunk_size + 1);
-    unsigned char* const mem = static_cast<unsigned char*>(pointer);
-    mem[size] = (chunks <= UCHAR_MAX) ? static_cast<unsigned char>(chunks) : 0;
-    return pointer;
+    // Blocks of a class are always allocated at the full class size, so
+    // that any thread can recycle them.
+    return ::operator new(c < size_classes ? class_size(c) : size);
   }
 
   template <typename Purpose>
   static void deallocate(Purpose, thread_info_base* this_thread,
       void* pointer, std::size_t size)
   {
-    if (size <= chunk_size * UCHAR_MAX)
+    const int c = size_class(size);
+    if (this_thread)
     {
-      if (this_thread && this_thread->reusable_memory_[Purpose::mem_index] == 0)
+      ++this_thread->stats_.deallocations;
+      if (c < size_classes && this_thread->cached_[c] < cache_depth)
       {
-        unsigned char* const mem = static_cast<unsigned char*>(pointer);
-        mem[0] = mem[size];
-        this_thread->reusable_memory_[Purpose::mem_index] = pointer;
+        this_thread->reusable_memory_[c][this_thread->cached_[c]++] = pointer;
         return;
       }
+      ++this_thread->stats_.releases;
     }
 
     ::operator delete(pointer);
@@ -170,9 +206,31 @@ public:
   }
 
 private:
-  enum { chunk_size = 4 };
-  enum { max_mem_index = 3 };
-  void* reusable_memory_[max_mem_index];
+  enum { min_size = ASIO_HANDLER_CACHE_MIN_SIZE };
+  enum { size_classes = ASIO_HANDLER_CACHE_SIZE_CLASSES };
+  enum { cache_depth = ASIO_HANDLER_CACHE_DEPTH };
+
+  static std::size_t class_size(int c)
+  {
+    return static_cast<std::size_t>(min_size) << c;
+  }
+
+  // Returns size_classes if the size is too large to be cached.
+  static int size_class(std::size_t size)
+  {
+    int c = 0;
+    std::size_t n = min_size;
+    while (n < size && c < size_classes)
+    {
+      n <<= 1;
+      ++c;
+    }
+    return c;
+  }
+
+  void* reusable_memory_[size_classes][cache_depth];
+  int cached_[size_classes];
+  cache_statistics stats_;
 
 #if defined(ASIO_HAS_STD_EXCEPTION_PTR) \
   && !defined(ASIO_NO_EXCEPTIONS)
@@ -19,10 +19,12 @@
 #include <boost/beast/core/buffered_read_stream.hpp>
 #include <boost/beast/core/buffers_adaptor.hpp>
 #include <boost/beast/core/buffers_cat.hpp>
+#include <boost/beast/core/buffers_flatten.hpp>
 #include <boost/beast/core/buffers_prefix.hpp>
 #include <boost/beast/core/buffers_range.hpp>
 #include <boost/beast/core/buffers_suffix.hpp>
 #include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/circular_buffer.hpp>
 #include <boost/beast/core/detect_ssl.hpp>
 #include <boost/beast/core/error.hpp>
 #include <boost/beast/core/file.hpp>
@@ -33,18 +35,25 @@
 #include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/core/flat_static_buffer.hpp>
 #include <boost/beast/core/flat_stream.hpp>
+#include <boost/beast/core/hdr_histogram.hpp>
+#include <boost/beast/core/io_context_pool.hpp>
 #include <boost/beast/core/make_printable.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
 #include <boost/beast/core/ostream.hpp>
 #include <boost/beast/core/rate_policy.hpp>
 #include <boost/beast/core/read_size.hpp>
+#include <boost/beast/core/recycling_allocator.hpp>
 #include <boost/beast/core/role.hpp>
 #include <boost/beast/core/saved_handler.hpp>
+#include <boost/beast/core/segment_pool.hpp>
+#include <boost/beast/core/sharded_statistics.hpp>
 #include <boost/beast/core/span.hpp>
 #include <boost/beast/core/static_buffer.hpp>
 #include <boost/beast/core/static_string.hpp>
+#include <boost/beast/core/stream_statistics.hpp>
 #include <boost/beast/core/stream_traits.hpp>
 #include <boost/beast/core/string.hpp>
 #include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/core/trace.hpp>
 
 #endif
@@ -17,6 +17,7 @@
 #include <asio/associated_allocator.hpp>
 #include <asio/associated_executor.hpp>
 #include <asio/bind_executor.hpp>
+#include <asio/detail/recycling_allocator.hpp>
 #include <asio/handler_alloc_hook.hpp>
 #include <asio/handler_continuation_hook.hpp>
 #include <asio/handler_invoke_hook.hpp>
@@ -11,10 +11,13 @@
 #define BOOST_BEAST_CORE_BASIC_STREAM_HPP
 
 #include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/detail/io_uring_service.hpp>
+#include <boost/beast/core/detail/shared_impl.hpp>
 #include <boost/beast/core/detail/stream_base.hpp>
 #include <boost/beast/core/error.hpp>
 #include <boost/beast/core/rate_policy.hpp>
 #include <boost/beast/core/role.hpp>
+#include <boost/beast/core/stream_statistics.hpp>
 #include <boost/beast/core/stream_traits.hpp>
 #include <asio/async_result.hpp>
 #include <asio/basic_stream_socket.hpp>
@@ -40,6 +43,36 @@ template<typename> class stream;
 namespace boost {
 namespace beast {
 
+/** Determine if an executor runs all submitted work on a single thread.
+
+    When this trait is `true` for the executor of a @ref basic_stream,
+    the stream keeps the reference counts of its shared state in plain
+    integers instead of atomics, which removes an atomic read-modify-write
+    from every asynchronous operation.
+
+    The default is `false`. Specialize it to `std::true_type` only for
+    executors which guarantee that every function object submitted to
+    them, including the completion handlers of the stream and the
+    destruction of the stream itself, runs on the same thread. For
+    example, the executor of an `net::io_context` that is only ever run
+    from one thread.
+
+    @par Example
+    @code
+    struct single_thread_executor : net::io_context::executor_type { ... };
+
+    template<>
+    struct beast::is_single_threaded_executor<single_thread_executor>
+        : std::true_type
+    {
+    };
+    @endcode
+*/
+template<class Executor>
+struct is_single_threaded_executor : std::false_type
+{
+};
+
 /** A stream socket wrapper with timeouts, an executor, and a rate limit policy.
 
     This stream wraps a `net::basic_stream_socket` to provide
@@ -56,6 +89,10 @@ namespace beast {
     @li A <em>RatePolicy</em> may be associated with the stream, to implement
     rate limiting through the policy's interface.
 
+    @li Statistics about the stream's I/O may be collected by using a
+    @ref statistics_policy as the rate policy, and read with
+    @ref statistics.
+
     Although the stream supports multiple concurrent outstanding asynchronous
     operations, the stream object is not thread-safe. The caller is responsible
     for ensuring that the stream is accessed from only one thread at a time.
@@ -235,9 +272,19 @@ private:
         net::is_executor<Executor>::value || net::execution::is_executor<Executor>::value,
         "Executor type requirements not met");
 
+    struct impl_type;
+
+    static bool constexpr is_atomic =
+        ! is_single_threaded_executor<Executor>::value;
+
+    using impl_ptr =
+        detail::shared_impl_ptr<impl_type, is_atomic>;
+
+    using weak_impl_ptr =
+        detail::weak_impl_ptr<impl_type, is_atomic>;
+
     struct impl_type
-        : std::enable_shared_from_this<impl_type>
-        , boost::empty_value<RatePolicy>
+        : boost::empty_value<RatePolicy>
     {
         // must come first
         net::basic_stream_socket<
@@ -255,6 +302,10 @@ private:
         net::steady_timer timer;
 #endif
         int waiting = 0;
+#if BOOST_BEAST_HAS_IO_URING
+        // null when the executor is not an io_context's
+        detail::io_uring_service* uring = nullptr;
+#endif
 
         impl_type(impl_type&&) = default;
 
@@ -288,7 +339,9 @@ private:
         }
 
         template<class Executor2>
-        void on_timer(Executor2 const& ex2);
+        void on_timer(
+            impl_ptr const& self,
+            Executor2 const& ex2);
 
         void reset();           // set timeouts to never
         void close() noexcept;  // cancel everything
@@ -298,7 +351,7 @@ private:
     // outlive the destruction of the stream_socket object,
     // in the case where there is no outstanding read or write
     // but the implementation is still waiting on a timer.
-    std::shared_ptr<impl_type> impl_;
+    impl_ptr impl_;
 
     template<class Executor2>
     struct timeout_handler;
@@ -345,7 +398,9 @@ public:
 #else
     template<class Arg0, class... Args,
         class = typename std::enable_if<
-        ! std::is_constructible<RatePolicy, Arg0>::value>::type>
+        ! std::is_constructible<RatePolicy, Arg0>::value &&
+        ! std::is_same<typename std::decay<Arg0>::type,
+            std::allocator_arg_t>::value>::type>
     explicit
     basic_stream(Arg0&& argo, Args&&... args);
 #endif
@@ -376,8 +431,69 @@ public:
         RatePolicy_&& policy, Arg0&& arg, Args&&... args);
 #endif
 
+    /** Constructor
+
+        This constructor creates the stream by forwarding all remaining
+        arguments to the underlying socket, and allocates the shared
+        state of the stream (which holds the socket, the timers, and
+        the rate policy) using the specified allocator.
+
+        @param alloc The allocator to use. A copy of this object is
+        kept until the shared state is freed, which may be after the
+        stream is destroyed. Use @ref recycling_allocator to reuse the
+        memory of recently closed streams on the same thread.
+
+        @param args A list of parameters forwarded to the constructor of
+        the underlying socket.
+    */
+#if BOOST_BEAST_DOXYGEN
+    template<class Allocator, class... Args>
+    basic_stream(std::allocator_arg_t,
+        Allocator const& alloc, Args&&... args);
+#else
+    template<class Allocator, class Arg0, class... Args,
+        class = typename std::enable_if<
+        ! std::is_constructible<RatePolicy, Arg0>::value>::type>
+    basic_stream(std::allocator_arg_t,
+        Allocator const& alloc, Arg0&& arg0, Args&&... args);
+#endif
+
+    /** Constructor
+
+        This constructor creates the stream with the specified rate
+        policy, forwards all remaining arguments to the underlying
+        socket, and allocates the shared state of the stream using
+        the specified allocator.
+
+        @param alloc The allocator to use. A copy of this object is
+        kept until the shared state is freed, which may be after the
+        stream is destroyed.
+
+        @param policy The rate policy object to use. The stream will
+        take ownership of this object by decay-copy.
+
+        @param args A list of parameters forwarded to the constructor of
+        the underlying socket.
+    */
+#if BOOST_BEAST_DOXYGEN
+    template<class Allocator, class RatePolicy_, class... Args>
+    basic_stream(std::allocator_arg_t, Allocator const& alloc,
+        RatePolicy_&& policy, Args&&... args);
+#else
+    template<class Allocator,
+        class RatePolicy_, class Arg0, class... Args,
+        class = typename std::enable_if<
+            std::is_constructible<
+                RatePolicy, RatePolicy_>::value>::type>
+    basic_stream(std::allocator_arg_t, Allocator const& alloc,
+        RatePolicy_&& policy, Arg0&& arg0, Args&&... args);
+#endif
+
     /** Move constructor
 
+        The shared state of this stream is allocated with the
+        allocator used for the shared state of `other`.
+
         @param other The other object from which the move will occur.
 
         @note Following the move, the moved-from object is in the
@@ -428,6 +544,23 @@ public:
         return impl_->policy();
     }
 
+    /** Returns the statistics collected by the rate policy.
+
+        This function is only available when the rate policy
+        collects statistics, as @ref statistics_policy does.
+
+        @see stream_statistics
+    */
+    decltype(auto)
+    statistics() const noexcept
+        requires requires (RatePolicy const& policy)
+        {
+            policy.statistics();
+        }
+    {
+        return impl_->policy().statistics();
+    }
+
     /** Set the timeout for the next logical operation.
 
         This sets either the read timer, the write timer, or
@@ -1198,6 +1331,78 @@ public:
         IteratorConnectHandler&& handler =
             net::default_completion_token_t<executor_type>{});
 
+    /** Establishes a connection by racing the endpoints in a sequence asynchronously.
+
+        This function attempts to connect the stream to one of a sequence of
+        endpoints, using the connection racing of Happy Eyeballs (RFC 8305).
+        Instead of waiting for each attempt to fail before trying the next
+        endpoint, another attempt is started after `attempt_delay`, or as
+        soon as the latest attempt fails, while the earlier attempts are
+        still outstanding. The first attempt to succeed completes the
+        operation, and the others are canceled.
+
+        The endpoints are tried with their address families interleaved,
+        starting with the family of the first endpoint. With a resolver
+        which lists IPv6 addresses first, an unreachable IPv6 network then
+        delays the connection by `attempt_delay`, instead of by the time
+        it takes each IPv6 attempt to fail.
+
+        Each attempt uses its own socket. When the operation succeeds, the
+        socket of the winning attempt replaces the underlying socket of the
+        stream, closing it if it was open.
+
+        If the timeout timer expires while the operation is outstanding,
+        all the attempts will be canceled and the completion handler will
+        be invoked with the error @ref error::timeout.
+
+        @param endpoints A sequence of endpoints. This this object must meet
+        the requirements of <em>EndpointSequence</em>.
+
+        @param attempt_delay The time to wait for an attempt to complete
+        before starting the next one. RFC 8305 recommends 250 milliseconds.
+
+        @param handler The completion handler to invoke when the operation
+        completes. The implementation takes ownership of the handler by
+        performing a decay-copy. The equivalent function signature of
+        the handler must be:
+        @code
+        void handler(
+            // Result of operation. if the sequence is empty, set to
+            // net::error::not_found. Otherwise, contains the
+            // error from the last connection attempt to fail.
+            error_code const& error,
+
+            // On success, the successfully connected endpoint.
+            // Otherwise, a default-constructed endpoint.
+            typename Protocol::endpoint const& endpoint
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+    */
+    template<
+        class EndpointSequence,
+        ASIO_COMPLETION_TOKEN_FOR(
+            void(error_code, typename Protocol::endpoint))
+            RangeConnectHandler =
+                net::default_completion_token_t<executor_type>
+    #if ! BOOST_BEAST_DOXYGEN
+        ,class = typename std::enable_if<
+            net::is_endpoint_sequence<
+                EndpointSequence>::value>::type
+    #endif
+    >
+    ASIO_INITFN_RESULT_TYPE(
+        RangeConnectHandler,
+        void(error_code, typename Protocol::endpoint))
+    async_race_connect(
+        EndpointSequence const& endpoints,
+        std::chrono::steady_clock::duration attempt_delay,
+        RangeConnectHandler&& handler =
+            net::default_completion_token_t<executor_type>{});
+
     //--------------------------------------------------------------------------
 
     /** Read some data.
@@ -18,6 +18,10 @@
 namespace boost {
 namespace beast {
 
+namespace detail {
+struct buffers_flattener;
+} // detail
+
 /** A buffer sequence representing a concatenation of buffer sequences.
     @see buffers_cat
 */
@@ -26,6 +30,8 @@ class buffers_cat_view
 {
     detail::tuple<Buffers...> bn_;
 
+    friend struct detail::buffers_flattener;
+
 public:
     /** The type of buffer returned when dereferencing an iterator.
         If every buffer sequence in the view is a <em>MutableBufferSequence</em>,
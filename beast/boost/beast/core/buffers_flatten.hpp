@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_BUFFERS_FLATTEN_HPP
+#define BOOST_BEAST_BUFFERS_FLATTEN_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/detail/buffers_flatten.hpp>
+#include <asio/buffer.hpp>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+namespace boost {
+namespace beast {
+
+/** A buffer sequence held in a fixed-capacity array.
+
+    Objects of this type are produced by @ref buffers_flatten, and
+    hold up to `N` buffers, none of which are empty. Iterating the
+    sequence visits the elements of the array.
+
+    @tparam Buffer The type of buffer, either `net::const_buffer`
+    or `net::mutable_buffer`.
+
+    @tparam N The largest number of buffers held.
+*/
+template<class Buffer, std::size_t N>
+class buffers_array
+{
+    static_assert(N > 0, "N must be positive");
+
+    // left uninitialized, since only n_ elements are used
+    alignas(Buffer) unsigned char v_[N * sizeof(Buffer)];
+    std::size_t n_ = 0;
+
+    static_assert(std::is_trivially_copyable<Buffer>::value,
+        "Buffer requirements not met");
+
+    friend struct detail::buffers_flattener;
+
+public:
+    /// The type of each buffer in the sequence
+    using value_type = Buffer;
+
+    /// The iterator used to visit the buffers
+    using const_iterator = Buffer const*;
+
+    /// The largest number of buffers held
+    static std::size_t constexpr max_count = N;
+
+    /// Constructor
+    buffers_array() = default;
+
+    /// Copy Constructor
+    buffers_array(buffers_array const& other) noexcept
+        : n_(other.n_)
+    {
+        std::memcpy(v_, other.v_, n_ * sizeof(Buffer));
+    }
+
+    /// Copy Assignment
+    buffers_array&
+    operator=(buffers_array const& other) noexcept
+    {
+        n_ = other.n_;
+        std::memmove(v_, other.v_, n_ * sizeof(Buffer));
+        return *this;
+    }
+
+    /// Returns the number of buffers in the sequence
+    std::size_t
+    count() const noexcept
+    {
+        return n_;
+    }
+
+    /// Returns an iterator to the first buffer in the sequence
+    const_iterator
+    begin() const noexcept
+    {
+        return std::launder(
+            reinterpret_cast<Buffer const*>(v_));
+    }
+
+    /// Returns an iterator to one past the last buffer in the sequence
+    const_iterator
+    end() const noexcept
+    {
+        return begin() + n_;
+    }
+};
+
+/** Copy the buffers of a buffer sequence into a fixed-capacity array.
+
+    This function returns a @ref buffers_array holding the first
+    `N` non-empty buffers of `buffers`. If the sequence has more
+    non-empty buffers than that, the result represents a prefix of
+    the sequence, which suits operations such as `writev` that
+    transfer a limited number of buffers in each call.
+
+    Sequences built by @ref buffers_cat, @ref buffers_prefix and
+    @ref buffers_suffix, such as those produced by
+    @ref http::serializer, are copied by walking the sequences
+    they adapt directly, which avoids the cost of their own
+    iterators. Algorithms which visit a sequence more than once
+    can do so more cheaply by flattening it first.
+
+    @par Example
+    @code
+    template<class SyncWriteStream, class ConstBufferSequence>
+    std::size_t
+    write_some_flat(SyncWriteStream& stream, ConstBufferSequence const& buffers)
+    {
+        return stream.write_some(buffers_flatten<16>(buffers));
+    }
+    @endcode
+
+    @tparam N The largest number of buffers to copy.
+
+    @param buffers The buffer sequence to copy. The memory
+    which the buffers refer to is not copied.
+
+    @return The array of buffers.
+*/
+template<std::size_t N, class BufferSequence>
+buffers_array<buffers_type<BufferSequence>, N>
+buffers_flatten(BufferSequence const& buffers)
+{
+    static_assert(
+        is_const_buffer_sequence<BufferSequence>::value,
+        "BufferSequence type requirements not met");
+    buffers_array<buffers_type<BufferSequence>, N> result;
+    detail::buffers_flattener::fill(result, buffers);
+    return result;
+}
+
+} // beast
+} // boost
+
+#endif
@@ -23,6 +23,10 @@
 namespace boost {
 namespace beast {
 
+namespace detail {
+struct buffers_flattener;
+} // detail
+
 /** A buffer sequence adaptor that shortens the sequence size.
 
     The class adapts a buffer sequence to efficiently represent
@@ -42,6 +46,8 @@ class buffers_prefix_view
     std::size_t remain_ = 0;
     iter_type end_{};
 
+    friend struct detail::buffers_flattener;
+
     void
     setup(std::size_t size);
 
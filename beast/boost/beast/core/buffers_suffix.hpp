@@ -19,6 +19,10 @@
 namespace boost {
 namespace beast {
 
+namespace detail {
+struct buffers_flattener;
+} // detail
+
 /** Adaptor to progressively trim the front of a <em>BufferSequence</em>.
 
     This adaptor wraps a buffer sequence to create a new sequence
@@ -58,6 +62,8 @@ class buffers_suffix
     iter_type begin_{};
     std::size_t skip_ = 0;
 
+    friend struct detail::buffers_flattener;
+
     template<class Deduced>
     buffers_suffix(Deduced&& other, std::size_t dist)
         : bs_(std::forward<Deduced>(other).bs_)
@@ -0,0 +1,364 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CIRCULAR_BUFFER_HPP
+#define BOOST_BEAST_CIRCULAR_BUFFER_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/detail/buffers_pair.hpp>
+#include <asio/buffer.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace boost {
+namespace beast {
+
+/** A dynamic buffer providing a growable circular buffer.
+
+    A dynamic buffer encapsulates memory storage that may be
+    automatically resized as required, where the memory is
+    divided into two regions: readable bytes followed by
+    writable bytes. These memory regions are internal to
+    the dynamic buffer, but direct access to the elements
+    is provided to permit them to be efficiently used with
+    I/O operations.
+
+    Unlike @ref flat_buffer, consuming bytes never moves the
+    remaining readable bytes, and unlike @ref multi_buffer,
+    the storage is a single allocation which is reused once
+    it has grown. Bytes are only copied when the capacity,
+    which is always a power of two, must grow.
+
+    On Linux, storage of at least one page is mapped twice into
+    adjacent virtual memory, so that the readable and writable
+    bytes are each always a single contiguous buffer even when
+    they wrap around the end of the storage. Algorithms which
+    would otherwise flatten a sequence of two buffers, such as
+    @ref http::basic_parser, then work on the buffer in place.
+    If the mapping cannot be created, or `BOOST_BEAST_NO_MIRRORED_BUFFER`
+    is defined, ordinary memory is used instead; see @ref mirrored.
+
+    Objects of this type meet the requirements of <em>DynamicBuffer</em>
+    and have the following additional properties:
+
+    @li A mutable buffer sequence representing the readable
+    bytes is returned by @ref data when `this` is non-const.
+
+    @li Buffer sequences representing the readable and writable
+    bytes, returned by @ref data and @ref prepare, may have
+    length up to two, or exactly one when @ref mirrored
+    returns `true`.
+
+    @li A call to @ref prepare which does not exceed the
+    capacity, and all calls to @ref commit and @ref consume,
+    execute in constant time.
+
+    @see flat_buffer, multi_buffer, static_buffer
+*/
+class circular_buffer
+{
+    char* begin_ = nullptr;
+    std::size_t capacity_ = 0;  // zero or a power of two
+    std::size_t in_off_ = 0;
+    std::size_t in_size_ = 0;
+    std::size_t out_size_ = 0;
+    std::size_t max_;
+    bool mirrored_ = false;
+
+    BOOST_BEAST_DECL
+    static
+    char*
+    allocate(std::size_t n, bool& mirrored);
+
+    BOOST_BEAST_DECL
+    static
+    void
+    deallocate(char* p, std::size_t n, bool mirrored) noexcept;
+
+    BOOST_BEAST_DECL
+    void
+    realloc(std::size_t n);
+
+public:
+    /// The smallest capacity which is allocated
+    static std::size_t constexpr min_capacity = 512;
+
+#if BOOST_BEAST_DOXYGEN
+    /// The ConstBufferSequence used to represent the readable bytes.
+    using const_buffers_type = __implementation_defined__;
+
+    /// The MutableBufferSequence used to represent the writable bytes.
+    using mutable_buffers_type = __implementation_defined__;
+#else
+    using const_buffers_type   = detail::buffers_pair<false>;
+    using mutable_buffers_type = detail::buffers_pair<true>;
+#endif
+
+    /// Destructor
+    BOOST_BEAST_DECL
+    ~circular_buffer();
+
+    /** Constructor
+
+        After construction, @ref capacity will return zero, and
+        @ref max_size will return the largest value of
+        `std::ptrdiff_t`.
+    */
+    circular_buffer() noexcept
+        : max_(static_cast<std::size_t>(
+            (std::numeric_limits<std::ptrdiff_t>::max)()))
+    {
+    }
+
+    /** Constructor
+
+        After construction, @ref capacity will return zero, and
+        @ref max_size will return `limit`.
+
+        @param limit The desired maximum size.
+    */
+    explicit
+    circular_buffer(std::size_t limit) noexcept
+        : max_(limit)
+    {
+    }
+
+    /** Move Constructor
+
+        The storage of `other` is moved to the new object.
+        After the move, the moved-from object will have zero
+        capacity, zero readable bytes, and zero writable bytes.
+
+        @esafe
+        No-throw guarantee.
+    */
+    BOOST_BEAST_DECL
+    circular_buffer(circular_buffer&& other) noexcept;
+
+    /** Copy Constructor
+
+        The readable bytes of `other` are copied. The new object
+        has the same maximum size, and the smallest capacity
+        which holds the readable bytes.
+    */
+    BOOST_BEAST_DECL
+    circular_buffer(circular_buffer const& other);
+
+    /// Move Assignment
+    BOOST_BEAST_DECL
+    circular_buffer&
+    operator=(circular_buffer&& other) noexcept;
+
+    /// Copy Assignment
+    BOOST_BEAST_DECL
+    circular_buffer&
+    operator=(circular_buffer const& other);
+
+    /** Set the maximum allowed capacity
+
+        This function changes the currently configured upper limit
+        on capacity to the specified value.
+
+        @param n The maximum number of bytes ever allowed for capacity.
+
+        @esafe
+        No-throw guarantee.
+    */
+    void
+    max_size(std::size_t n) noexcept
+    {
+        max_ = n;
+    }
+
+    /** Guarantee a minimum capacity
+
+        This function adjusts the internal storage, if necessary,
+        to have at least the smallest power of two capacity which
+        holds `n` bytes. The readable bytes are preserved.
+
+        Buffer sequences previously obtained using @ref data or
+        @ref prepare become invalid.
+
+        @param n The minimum number of bytes for the new capacity.
+
+        @throws std::length_error if `n` exceeds @ref max_size.
+
+        @esafe
+        Strong guarantee.
+    */
+    BOOST_BEAST_DECL
+    void
+    reserve(std::size_t n);
+
+    /** Reallocate the buffer to the smallest capacity holding the readable bytes.
+
+        Buffer sequences previously obtained using @ref data or
+        @ref prepare become invalid.
+
+        @esafe
+        Strong guarantee.
+    */
+    BOOST_BEAST_DECL
+    void
+    shrink_to_fit();
+
+    /** Set the size of the readable and writable bytes to zero.
+
+        This clears the buffer without changing capacity.
+        Buffer sequences previously obtained using @ref data or
+        @ref prepare become invalid.
+
+        @esafe
+        No-throw guarantee.
+    */
+    void
+    clear() noexcept
+    {
+        in_off_ = 0;
+        in_size_ = 0;
+        out_size_ = 0;
+    }
+
+    /** Returns `true` if the storage is mapped twice.
+
+        When this returns `true`, the buffer sequences returned
+        by @ref data and @ref prepare are each one buffer.
+    */
+    bool
+    mirrored() const noexcept
+    {
+        return mirrored_;
+    }
+
+    //--------------------------------------------------------------------------
+
+    /// Returns the number of readable bytes.
+    std::size_t
+    size() const noexcept
+    {
+        return in_size_;
+    }
+
+    /// Return the maximum number of bytes, both readable and writable, that can ever be held.
+    std::size_t
+    max_size() const noexcept
+    {
+        return max_;
+    }
+
+    /// Return the maximum number of bytes, both readable and writable, that can be held without requiring an allocation.
+    std::size_t
+    capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    /// Returns a constant buffer sequence representing the readable bytes
+    BOOST_BEAST_DECL
+    const_buffers_type
+    data() const noexcept;
+
+    /// Returns a constant buffer sequence representing the readable bytes
+    const_buffers_type
+    cdata() const noexcept
+    {
+        return data();
+    }
+
+    /// Returns a mutable buffer sequence representing the readable bytes
+    BOOST_BEAST_DECL
+    mutable_buffers_type
+    data() noexcept;
+
+    /** Returns a mutable buffer sequence representing writable bytes.
+
+        Returns a mutable buffer sequence representing the writable
+        bytes containing exactly `n` bytes of storage. Memory may be
+        reallocated as needed.
+
+        All buffers sequences previously obtained using
+        @ref data or @ref prepare are invalidated.
+
+        @param n The desired number of bytes in the returned buffer
+        sequence.
+
+        @throws std::length_error if `size() + n` exceeds `max_size()`.
+
+        @esafe
+        Strong guarantee.
+    */
+    BOOST_BEAST_DECL
+    mutable_buffers_type
+    prepare(std::size_t n);
+
+    /** Append writable bytes to the readable bytes.
+
+        Appends n bytes from the start of the writable bytes to the
+        end of the readable bytes. The remainder of the writable bytes
+        are discarded. If n is greater than the number of writable
+        bytes, all writable bytes are appended to the readable bytes.
+
+        All buffers sequences previously obtained using
+        @ref data or @ref prepare are invalidated.
+
+        @param n The number of bytes to append. If this number
+        is greater than the number of writable bytes, all
+        writable bytes are appended.
+
+        @esafe
+        No-throw guarantee.
+    */
+    void
+    commit(std::size_t n) noexcept
+    {
+        in_size_ += (std::min)(n, out_size_);
+        out_size_ = 0;
+    }
+
+    /** Remove bytes from beginning of the readable bytes.
+
+        Removes n bytes from the beginning of the readable bytes.
+
+        All buffers sequences previously obtained using
+        @ref data or @ref prepare are invalidated.
+
+        @param n The number of bytes to remove. If this number
+        is greater than the number of readable bytes, all
+        readable bytes are removed.
+
+        @esafe
+        No-throw guarantee.
+    */
+    void
+    consume(std::size_t n) noexcept
+    {
+        if(n < in_size_)
+        {
+            in_off_ = (in_off_ + n) & (capacity_ - 1);
+            in_size_ -= n;
+        }
+        else
+        {
+            // rewind the offset, so the next call to prepare
+            // has the longest possible contiguous segment
+            in_off_ = 0;
+            in_size_ = 0;
+        }
+    }
+};
+
+} // beast
+} // boost
+
+#if BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/impl/circular_buffer.ipp>
+#endif
+
+#endif
@@ -0,0 +1,209 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_BUFFERS_FLATTEN_HPP
+#define BOOST_BEAST_CORE_DETAIL_BUFFERS_FLATTEN_HPP
+
+#include <boost/beast/core/buffers_cat.hpp>
+#include <boost/beast/core/buffers_prefix.hpp>
+#include <boost/beast/core/buffers_suffix.hpp>
+#include <boost/beast/core/detail/buffers_ref.hpp>
+#include <boost/beast/core/detail/tuple.hpp>
+#include <asio/buffer.hpp>
+#include <cstddef>
+#include <new>
+#include <variant>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+// Copies the buffers of a sequence into an array. Concatenations,
+// prefixes, suffixes and references are walked with the iterators
+// of the sequences they adapt, so that each step is a plain
+// iterator increment rather than a visit of a variant.
+struct buffers_flattener
+{
+    template<class Buffer>
+    struct sink
+    {
+        using buffer_type = Buffer;
+
+        void* v;
+        std::size_t size;
+        std::size_t capacity;
+        std::size_t remain;     // bytes which may still be added
+
+        bool
+        full() const noexcept
+        {
+            return size == capacity || remain == 0;
+        }
+
+        // Returns false when nothing more can be added
+        bool
+        push(Buffer b) noexcept
+        {
+            if(full())
+                return false;
+            if(b.size() == 0)
+                return true;
+            if(b.size() > remain)
+                b = Buffer(b.data(), remain);
+            ::new(static_cast<Buffer*>(v) + size++) Buffer(b);
+            remain -= b.size();
+            return ! full();
+        }
+    };
+
+    template<class Sink, class Iterator, class End>
+    static
+    bool
+    range(Sink& s, Iterator it, End const& end,
+        std::size_t skip = 0)
+    {
+        for(; it != end; ++it)
+        {
+            if(! s.push(typename Sink::buffer_type(*it) + skip))
+                return false;
+            skip = 0;
+        }
+        return true;
+    }
+
+    template<class Sink, class BufferSequence>
+    static
+    bool
+    append(Sink& s, BufferSequence const& bs)
+    {
+        return range(s,
+            net::buffer_sequence_begin(bs),
+            net::buffer_sequence_end(bs));
+    }
+
+    template<class Sink, class BufferSequence>
+    static
+    bool
+    append(Sink& s, buffers_ref<BufferSequence> const& bs)
+    {
+        return append(s, *bs.buffers_);
+    }
+
+    template<class Sink, class B1, class B2, class... Bn>
+    static
+    bool
+    append(Sink& s, buffers_cat_view<B1, B2, Bn...> const& bs)
+    {
+        return cat<0>(s, bs.bn_);
+    }
+
+    template<class Sink, class BufferSequence>
+    static
+    bool
+    append(Sink& s, buffers_prefix_view<BufferSequence> const& bs)
+    {
+        // the prefix ends after size_ bytes of the sequence
+        auto const remain = s.remain;
+        if(bs.size_ < remain)
+            s.remain = bs.size_;
+        auto const limit = s.remain;
+        append(s, bs.bs_);
+        s.remain = remain - (limit - s.remain);
+        return ! s.full();
+    }
+
+    template<class Sink, class BufferSequence>
+    static
+    bool
+    append(Sink& s, buffers_suffix<BufferSequence> const& bs)
+    {
+        return from(s, bs.bs_, bs.begin_, bs.skip_);
+    }
+
+    // Append every sequence in a concatenation from the I-th
+    template<std::size_t I, class Sink, class... Bn>
+    static
+    bool
+    cat(Sink& s, detail::tuple<Bn...> const& bn)
+    {
+        if constexpr(I == sizeof...(Bn))
+            return true;
+        else
+        {
+            if(! append(s, bn.template get<I>()))
+                return false;
+            return cat<I + 1>(s, bn);
+        }
+    }
+
+    // Append the buffers of a sequence from an iterator,
+    // skipping bytes at the front of the first buffer
+    template<class Sink, class BufferSequence, class Iterator>
+    static
+    bool
+    from(Sink& s, BufferSequence const& bs,
+        Iterator const& it, std::size_t skip)
+    {
+        return range(s, it,
+            net::buffer_sequence_end(bs), skip);
+    }
+
+    template<class Sink, class B1, class B2, class... Bn>
+    static
+    bool
+    from(Sink& s, buffers_cat_view<B1, B2, Bn...> const& bs,
+        typename buffers_cat_view<
+            B1, B2, Bn...>::const_iterator const& it,
+        std::size_t skip)
+    {
+        // one look at the variant, then plain iterators
+        return cat_from<0>(s, bs.bn_, it.it_, skip);
+    }
+
+    template<std::size_t I, class Sink, class Variant, class... Bn>
+    static
+    bool
+    cat_from(Sink& s, detail::tuple<Bn...> const& bn,
+        Variant const& v, std::size_t skip)
+    {
+        if constexpr(I == sizeof...(Bn))
+        {
+            // one past the end
+            return true;
+        }
+        else
+        {
+            if(v.index() != I)
+                return cat_from<I + 1>(s, bn, v, skip);
+            if(! range(s, std::get<I>(v),
+                    net::buffer_sequence_end(
+                        bn.template get<I>()), skip))
+                return false;
+            return cat<I + 1>(s, bn);
+        }
+    }
+
+    template<class Array, class BufferSequence>
+    static
+    void
+    fill(Array& a, BufferSequence const& bs)
+    {
+        sink<typename Array::value_type> s{
+            a.v_, 0, Array::max_count,
+            static_cast<std::size_t>(-1)};
+        append(s, bs);
+        a.n_ = s.size;
+    }
+};
+
+} // detail
+} // beast
+} // boost
+
+#endif
@@ -18,12 +18,16 @@ namespace boost {
 namespace beast {
 namespace detail {
 
+struct buffers_flattener;
+
 // A very lightweight reference to a buffer sequence
 template<class BufferSequence>
 class buffers_ref
 {
     BufferSequence const* buffers_;
 
+    friend struct buffers_flattener;
+
 public:
     using const_iterator =
         buffers_iterator_type<BufferSequence>;
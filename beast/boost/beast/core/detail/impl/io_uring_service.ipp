@@ -0,0 +1,289 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_IMPL_IO_URING_SERVICE_IPP
+#define BOOST_BEAST_CORE_DETAIL_IMPL_IO_URING_SERVICE_IPP
+
+#include <boost/beast/core/detail/io_uring_service.hpp>
+#include <asio/post.hpp>
+#include <boost/assert.hpp>
+#include <thread>
+
+#ifndef BOOST_BEAST_IO_URING_ENTRIES
+#define BOOST_BEAST_IO_URING_ENTRIES 1024
+#endif
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+io_uring_service::
+io_uring_service(net::execution_context& ctx)
+    : service_base<io_uring_service>(ctx)
+{
+    error_code ec;
+    ring_.open(BOOST_BEAST_IO_URING_ENTRIES, ec);
+    if(ec)
+        return;
+
+    // The reactor takes ownership of the descriptor it is given,
+    // so it gets a duplicate and the ring keeps its own.
+    int const fd = ::dup(ring_.native_handle());
+    if(fd == -1)
+    {
+        ring_.close();
+        return;
+    }
+    desc_.emplace(get_io_context(), fd);
+}
+
+io_uring_service::
+~io_uring_service()
+{
+    BOOST_ASSERT(head_ == nullptr);
+    BOOST_ASSERT(done_ == nullptr);
+}
+
+auto
+io_uring_service::
+stats() ->
+    statistics
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return stats_;
+}
+
+io_uring_sqe*
+io_uring_service::
+get_sqe_locked()
+{
+    for(;;)
+    {
+        if(auto const sqe = ring_.get_sqe())
+            return sqe;
+        // full, make room
+        submit_locked();
+    }
+}
+
+void
+io_uring_service::
+submit_locked()
+{
+    while(ring_.pending() > 0)
+    {
+        auto const rv = ring_.submit();
+        ++stats_.enters;
+        if(rv >= 0)
+            continue;
+        if(rv != -EAGAIN && rv != -EBUSY)
+        {
+            // not expected for well-formed entries
+            BOOST_ASSERT(false);
+            return;
+        }
+        // the completion queue is backed up,
+        // drain it and let the io_context deliver.
+        reap_locked();
+        post_flush_locked();
+        std::this_thread::yield();
+    }
+}
+
+void
+io_uring_service::
+reap_locked()
+{
+    stats_.completed += ring_.reap(
+        [this](io_uring_cqe const& cqe)
+        {
+            auto const o = reinterpret_cast<op*>(cqe.user_data);
+            if(! o)
+                return; // a cancellation request
+            if(o->prev)
+                o->prev->next = o->next;
+            else
+                head_ = o->next;
+            if(o->next)
+                o->next->prev = o->prev;
+            --in_flight_;
+            o->res = cqe.res;
+            o->next = nullptr;
+            if(done_tail_)
+                done_tail_->next = o;
+            else
+                done_ = o;
+            done_tail_ = o;
+        });
+}
+
+void
+io_uring_service::
+arm_locked()
+{
+    if(shutdown_)
+        return;
+    if(in_flight_ == 0)
+    {
+        // let the io_context run out of work
+        if(waiting_)
+        {
+            error_code ec;
+            desc_->cancel(ec);
+        }
+        return;
+    }
+    if(waiting_)
+        return;
+    waiting_ = true;
+    desc_->async_wait(
+        net::posix::stream_descriptor::wait_read,
+        [this](error_code)
+        {
+            on_wait();
+        });
+
+    // The reactor only reports a change in readiness, so
+    // completions which arrived before the wait are seen here.
+    if(ring_.ready())
+        post_flush_locked();
+}
+
+void
+io_uring_service::
+post_flush_locked()
+{
+    if(flush_pending_ || shutdown_)
+        return;
+    flush_pending_ = true;
+    net::post(get_io_context(),
+        [this]
+        {
+            flush();
+        });
+}
+
+void
+io_uring_service::
+flush()
+{
+    op* list;
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        flush_pending_ = false;
+        submit_locked();
+        reap_locked();
+        arm_locked();
+        list = std::exchange(done_, nullptr);
+        done_tail_ = nullptr;
+    }
+    complete(list, true);
+}
+
+void
+io_uring_service::
+on_wait()
+{
+    op* list;
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        waiting_ = false;
+        if(shutdown_)
+            return;
+        reap_locked();
+        arm_locked();
+        list = std::exchange(done_, nullptr);
+        done_tail_ = nullptr;
+    }
+    complete(list, true);
+}
+
+void
+io_uring_service::
+complete(op* list, bool invoke)
+{
+    while(list)
+    {
+        auto const o = list;
+        list = list->next;
+        o->func(o, invoke);
+    }
+}
+
+void
+io_uring_service::
+cancel(int fd) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_);
+    if(! ring_.is_open())
+        return;
+    bool any = false;
+    for(auto o = head_; o; o = o->next)
+    {
+        if(o->fd != fd || o->canceled)
+            continue;
+        o->canceled = true;
+        auto const sqe = get_sqe_locked();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = reinterpret_cast<std::uint64_t>(o);
+        sqe->user_data = 0;
+        any = true;
+    }
+    if(any)
+        submit_locked();
+}
+
+void
+io_uring_service::
+shutdown()
+{
+    op* list;
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        shutdown_ = true;
+        if(desc_)
+        {
+            error_code ec;
+            desc_->close(ec);
+        }
+        if(! ring_.is_open())
+            return;
+
+        // The kernel writes into the buffers of the operations
+        // until they complete, so wait for all of them.
+        for(auto o = head_; o; o = o->next)
+        {
+            auto const sqe = get_sqe_locked();
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = reinterpret_cast<std::uint64_t>(o);
+            sqe->user_data = 0;
+        }
+        submit_locked();
+        reap_locked();
+        while(in_flight_ > 0)
+        {
+            ring_.submit(1);
+            reap_locked();
+        }
+        list = std::exchange(done_, nullptr);
+        done_tail_ = nullptr;
+    }
+
+    // destroying a handler can destroy a stream,
+    // which calls cancel, so the lock is not held.
+    complete(list, false);
+}
+
+} // detail
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,272 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_IO_URING_HPP
+#define BOOST_BEAST_CORE_DETAIL_IO_URING_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+
+// io_uring is opt-in: define BOOST_BEAST_USE_IO_URING to route the
+// socket reads and writes of basic_stream through a submission ring.
+// It is silently disabled where the kernel headers are unavailable.
+#if ! defined(BOOST_BEAST_HAS_IO_URING)
+# if defined(BOOST_BEAST_USE_IO_URING) && defined(__linux__)
+#  if __has_include(<linux/io_uring.h>)
+#   define BOOST_BEAST_HAS_IO_URING 1
+#  endif
+# endif
+#endif
+#if ! defined(BOOST_BEAST_HAS_IO_URING)
+# define BOOST_BEAST_HAS_IO_URING 0
+#endif
+
+#if BOOST_BEAST_HAS_IO_URING
+
+#include <boost/beast/core/error.hpp>
+#include <asio/error.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+/*  A minimal io_uring, driven with raw system calls.
+
+    Only the pieces needed by io_uring_service are provided. The
+    object is not thread-safe; the owner serializes access.
+*/
+class io_uring
+{
+    int fd_ = -1;
+
+    void* sq_ptr_ = MAP_FAILED;
+    std::size_t sq_len_ = 0;
+    void* cq_ptr_ = MAP_FAILED;
+    std::size_t cq_len_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    std::size_t sqes_len_ = 0;
+
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned sqe_tail_ = 0; // not yet visible to the kernel
+
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    template<class T>
+    static
+    T*
+    at(void* base, unsigned offset) noexcept
+    {
+        return reinterpret_cast<T*>(
+            static_cast<char*>(base) + offset);
+    }
+
+    static
+    unsigned
+    load_acquire(unsigned* p) noexcept
+    {
+        return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+    }
+
+    static
+    void
+    store_release(unsigned* p, unsigned v) noexcept
+    {
+        __atomic_store_n(p, v, __ATOMIC_RELEASE);
+    }
+
+public:
+    io_uring() = default;
+    io_uring(io_uring const&) = delete;
+    io_uring& operator=(io_uring const&) = delete;
+
+    ~io_uring()
+    {
+        close();
+    }
+
+    bool
+    is_open() const noexcept
+    {
+        return fd_ != -1;
+    }
+
+    int
+    native_handle() const noexcept
+    {
+        return fd_;
+    }
+
+    void
+    open(unsigned entries, error_code& ec)
+    {
+        io_uring_params p;
+        std::memset(&p, 0, sizeof(p));
+        int const fd = static_cast<int>(::syscall(
+            __NR_io_uring_setup, entries, &p));
+        if(fd < 0)
+        {
+            ec = error_code(errno, net::error::get_system_category());
+            return;
+        }
+        fd_ = fd;
+
+        sq_len_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_len_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        bool const single = p.features & IORING_FEAT_SINGLE_MMAP;
+        if(single)
+            sq_len_ = cq_len_ = (std::max)(sq_len_, cq_len_);
+        sq_ptr_ = ::mmap(nullptr, sq_len_, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        if(sq_ptr_ == MAP_FAILED)
+            goto fail;
+        if(single)
+        {
+            cq_ptr_ = sq_ptr_;
+        }
+        else
+        {
+            cq_ptr_ = ::mmap(nullptr, cq_len_, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+            if(cq_ptr_ == MAP_FAILED)
+                goto fail;
+        }
+        sqes_len_ = p.sq_entries * sizeof(io_uring_sqe);
+        {
+            void* sqes = ::mmap(nullptr, sqes_len_,
+                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    fd_, IORING_OFF_SQES);
+            if(sqes == MAP_FAILED)
+                goto fail;
+            sqes_ = static_cast<io_uring_sqe*>(sqes);
+        }
+
+        sq_head_ = at<unsigned>(sq_ptr_, p.sq_off.head);
+        sq_tail_ = at<unsigned>(sq_ptr_, p.sq_off.tail);
+        sq_mask_ = *at<unsigned>(sq_ptr_, p.sq_off.ring_mask);
+        sq_entries_ = *at<unsigned>(sq_ptr_, p.sq_off.ring_entries);
+        sqe_tail_ = *sq_tail_;
+        {
+            // slot i of the ring always names sqe i
+            auto const array = at<unsigned>(sq_ptr_, p.sq_off.array);
+            for(unsigned i = 0; i < sq_entries_; ++i)
+                array[i] = i;
+        }
+        cq_head_ = at<unsigned>(cq_ptr_, p.cq_off.head);
+        cq_tail_ = at<unsigned>(cq_ptr_, p.cq_off.tail);
+        cq_mask_ = *at<unsigned>(cq_ptr_, p.cq_off.ring_mask);
+        cqes_ = at<io_uring_cqe>(cq_ptr_, p.cq_off.cqes);
+        ec = {};
+        return;
+
+    fail:
+        ec = error_code(errno, net::error::get_system_category());
+        close();
+    }
+
+    void
+    close() noexcept
+    {
+        if(sqes_)
+            ::munmap(sqes_, sqes_len_);
+        if(cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_)
+            ::munmap(cq_ptr_, cq_len_);
+        if(sq_ptr_ != MAP_FAILED)
+            ::munmap(sq_ptr_, sq_len_);
+        if(fd_ != -1)
+            ::close(fd_);
+        sqes_ = nullptr;
+        cq_ptr_ = sq_ptr_ = MAP_FAILED;
+        fd_ = -1;
+    }
+
+    // Returns a zeroed entry, or nullptr if the ring is full
+    io_uring_sqe*
+    get_sqe() noexcept
+    {
+        if(sqe_tail_ - load_acquire(sq_head_) >= sq_entries_)
+            return nullptr;
+        auto const sqe = &sqes_[sqe_tail_ & sq_mask_];
+        ++sqe_tail_;
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    // Returns the number of entries not yet consumed by the kernel
+    unsigned
+    pending() const noexcept
+    {
+        return sqe_tail_ - load_acquire(sq_head_);
+    }
+
+    /*  Hand all new entries to the kernel.
+
+        Returns the number of entries submitted, or a negative
+        error number.
+    */
+    int
+    submit(unsigned wait_nr = 0) noexcept
+    {
+        store_release(sq_tail_, sqe_tail_);
+        auto const n = pending();
+        if(n == 0 && wait_nr == 0)
+            return 0;
+        for(;;)
+        {
+            auto const rv = ::syscall(__NR_io_uring_enter,
+                fd_, n, wait_nr,
+                wait_nr ? IORING_ENTER_GETEVENTS : 0,
+                nullptr, 0);
+            if(rv >= 0)
+                return static_cast<int>(rv);
+            if(errno != EINTR)
+                return -errno;
+        }
+    }
+
+    // Returns true if there is at least one completion
+    bool
+    ready() const noexcept
+    {
+        return *cq_head_ != load_acquire(cq_tail_);
+    }
+
+    // Invoke f(cqe) for every available completion
+    template<class F>
+    unsigned
+    reap(F&& f)
+    {
+        unsigned head = *cq_head_;
+        unsigned const tail = load_acquire(cq_tail_);
+        unsigned n = 0;
+        for(; head != tail; ++head, ++n)
+            f(cqes_[head & cq_mask_]);
+        store_release(cq_head_, head);
+        return n;
+    }
+};
+
+} // detail
+} // beast
+} // boost
+
+#endif
+
+#endif
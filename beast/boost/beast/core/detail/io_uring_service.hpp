@@ -0,0 +1,392 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_IO_URING_SERVICE_HPP
+#define BOOST_BEAST_CORE_DETAIL_IO_URING_SERVICE_HPP
+
+#include <boost/beast/core/detail/io_uring.hpp>
+
+#if BOOST_BEAST_HAS_IO_URING
+
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/recycling_allocator.hpp>
+#include <boost/beast/core/detail/get_io_context.hpp>
+#include <boost/beast/core/detail/service_base.hpp>
+#include <asio/associated_allocator.hpp>
+#include <asio/dispatch.hpp>
+#include <asio/io_context.hpp>
+#include <asio/posix/stream_descriptor.hpp>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+/*  Performs socket reads and writes through an io_uring.
+
+    There is one service, and one ring, per io_context. Operations
+    started while the context runs are batched: the first one posts
+    a flush, which hands every queued entry to the kernel with a
+    single io_uring_enter, so a pass of the event loop costs one
+    system call however many streams it touches.
+
+    Completions are noticed through the reactor of the io_context:
+    the ring's descriptor becomes readable when the completion queue
+    is not empty. The wait is only outstanding while operations are,
+    so an idle service does not keep the context running.
+
+    If the ring cannot be created (for example the kernel is too old,
+    or io_uring is disabled by policy), available() returns false and
+    callers use the regular socket functions instead.
+*/
+class io_uring_service
+    : public service_base<io_uring_service>
+{
+public:
+    struct op
+    {
+        using func_type = void(*)(op*, bool invoke);
+
+        op* next = nullptr;
+        op* prev = nullptr;
+        func_type func;
+        int fd;
+        int res = 0;
+        bool canceled = false;
+
+        op(func_type f, int fd_) noexcept
+            : func(f)
+            , fd(fd_)
+        {
+        }
+    };
+
+    struct statistics
+    {
+        // io_uring_enter calls
+        std::uint64_t enters = 0;
+
+        // operations submitted
+        std::uint64_t submitted = 0;
+
+        // completions reaped, including those of cancellations
+        std::uint64_t completed = 0;
+    };
+
+private:
+    std::mutex m_;
+    io_uring ring_;
+    std::optional<net::posix::stream_descriptor> desc_;
+    op* head_ = nullptr;        // in flight
+    op* done_ = nullptr;        // reaped, not yet invoked
+    op* done_tail_ = nullptr;
+    std::size_t in_flight_ = 0;
+    statistics stats_;
+    bool flush_pending_ = false;
+    bool waiting_ = false;
+    bool shutdown_ = false;
+
+    net::io_context&
+    get_io_context() noexcept
+    {
+        return static_cast<net::io_context&>(context());
+    }
+
+    BOOST_BEAST_DECL
+    io_uring_sqe*
+    get_sqe_locked();
+
+    BOOST_BEAST_DECL
+    void
+    submit_locked();
+
+    BOOST_BEAST_DECL
+    void
+    reap_locked();
+
+    BOOST_BEAST_DECL
+    void
+    arm_locked();
+
+    BOOST_BEAST_DECL
+    void
+    post_flush_locked();
+
+    BOOST_BEAST_DECL
+    void
+    flush();
+
+    BOOST_BEAST_DECL
+    void
+    on_wait();
+
+    BOOST_BEAST_DECL
+    static
+    void
+    complete(op* list, bool invoke);
+
+public:
+    BOOST_BEAST_DECL
+    explicit
+    io_uring_service(net::execution_context& ctx);
+
+    BOOST_BEAST_DECL
+    ~io_uring_service();
+
+    // Returns true if the ring was created
+    bool
+    available() const noexcept
+    {
+        return ring_.is_open();
+    }
+
+    BOOST_BEAST_DECL
+    statistics
+    stats();
+
+    /*  Queue an operation.
+
+        `prepare` fills in the submission entry. The operation is
+        handed to the kernel by the next flush, and its `func` is
+        called exactly once: with invoke == true from the io_context
+        when it completes, or with invoke == false on shutdown.
+    */
+    template<class Prepare>
+    void
+    start(op* o, Prepare&& prepare)
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        auto const sqe = get_sqe_locked();
+        prepare(*sqe);
+        sqe->user_data = reinterpret_cast<std::uint64_t>(o);
+        o->prev = nullptr;
+        o->next = head_;
+        if(head_)
+            head_->prev = o;
+        head_ = o;
+        ++in_flight_;
+        ++stats_.submitted;
+        post_flush_locked();
+    }
+
+    /*  Cancel all operations on a descriptor.
+
+        The cancellations are submitted before this returns, so the
+        descriptor may be closed immediately afterwards. Canceled
+        operations complete with net::error::operation_aborted.
+    */
+    BOOST_BEAST_DECL
+    void
+    cancel(int fd) noexcept;
+
+    BOOST_BEAST_DECL
+    void
+    shutdown() override;
+
+    // Returns the usable service for an I/O object, or nullptr
+    template<class T>
+    static
+    io_uring_service*
+    find(T& t)
+    {
+        auto const ioc = detail::get_io_context(t);
+        if(! ioc)
+            return nullptr;
+        auto& svc = net::use_service<io_uring_service>(*ioc);
+        if(! svc.available())
+            return nullptr;
+        return &svc;
+    }
+};
+
+//------------------------------------------------------------------------------
+
+template<bool isRead, class Handler>
+class io_uring_transfer_op
+    : public io_uring_service::op
+{
+    // the same limit as the reactor
+    static std::size_t constexpr max_iov = 64;
+
+    using handler_allocator =
+        net::associated_allocator_t<Handler>;
+
+    // handlers without an allocator of their own use the
+    // thread-local cache instead of the global heap
+    using allocator_type = typename std::allocator_traits<
+        typename std::conditional<std::is_same<
+            handler_allocator, std::allocator<void>>::value,
+                recycling_allocator<void>,
+                handler_allocator>::type>::template
+                    rebind_alloc<io_uring_transfer_op>;
+
+    static
+    allocator_type
+    get_allocator(Handler const& h) noexcept
+    {
+        if constexpr(std::is_same<
+                handler_allocator, std::allocator<void>>::value)
+            return allocator_type();
+        else
+            return allocator_type(net::get_associated_allocator(h));
+    }
+
+    Handler h_;
+    ::msghdr msg_;
+    ::iovec iov_[max_iov];
+    std::size_t size_ = 0;
+
+    static
+    void
+    do_complete(io_uring_service::op* base, bool invoke)
+    {
+        auto const self =
+            static_cast<io_uring_transfer_op*>(base);
+        Handler h(std::move(self->h_));
+        auto const res = self->res;
+        auto const size = self->size_;
+        auto a = get_allocator(h);
+        std::allocator_traits<allocator_type>::destroy(a, self);
+        std::allocator_traits<allocator_type>::deallocate(a, self, 1);
+        if(! invoke)
+            return;
+
+        // the category matches what the reactor reports
+        error_code ec(0, net::error::get_system_category());
+        std::size_t n = 0;
+        if(res == -ECANCELED)
+            ec = net::error::operation_aborted;
+        else if(res < 0)
+            ec = error_code(-res, net::error::get_system_category());
+        else
+        {
+            n = static_cast<std::size_t>(res);
+            if(isRead && n == 0 && size > 0)
+                ec = net::error::eof;
+        }
+        net::dispatch(beast::bind_handler(std::move(h), ec, n));
+    }
+
+public:
+    template<class Handler_, class Buffers>
+    io_uring_transfer_op(
+        int fd, Handler_&& h, Buffers const& buffers)
+        : io_uring_service::op(&do_complete, fd)
+        , h_(std::forward<Handler_>(h))
+    {
+        std::size_t i = 0;
+        for(auto it = net::buffer_sequence_begin(buffers),
+            end = net::buffer_sequence_end(buffers);
+            it != end && i < max_iov; ++it)
+        {
+            auto const b = *it;
+            if(b.size() == 0)
+                continue;
+            iov_[i].iov_base = const_cast<void*>(
+                static_cast<void const*>(b.data()));
+            iov_[i].iov_len = b.size();
+            size_ += b.size();
+            ++i;
+        }
+        std::memset(&msg_, 0, sizeof(msg_));
+        msg_.msg_iov = iov_;
+        msg_.msg_iovlen = i;
+    }
+
+    template<class Buffers>
+    static
+    void
+    launch(
+        io_uring_service& svc,
+        int fd,
+        Handler&& h,
+        Buffers const& buffers)
+    {
+        auto a = get_allocator(h);
+        auto const p = std::allocator_traits<
+            allocator_type>::allocate(a, 1);
+        io_uring_transfer_op* self;
+        try
+        {
+            self = ::new(static_cast<void*>(p)) io_uring_transfer_op(
+                fd, std::move(h), buffers);
+        }
+        catch(...)
+        {
+            std::allocator_traits<allocator_type>::deallocate(a, p, 1);
+            throw;
+        }
+        svc.start(self,
+            [self](io_uring_sqe& sqe)
+            {
+                sqe.opcode = isRead ?
+                    IORING_OP_RECVMSG : IORING_OP_SENDMSG;
+                sqe.fd = self->fd;
+                sqe.addr = reinterpret_cast<std::uint64_t>(&self->msg_);
+                sqe.len = 1;
+                sqe.msg_flags = isRead ? 0 : MSG_NOSIGNAL;
+            });
+    }
+};
+
+/*  Start a read or write of some bytes on a socket descriptor.
+
+    The handler is invoked as if by net::dispatch with
+    (error_code, std::size_t), matching async_read_some and
+    async_write_some. Only the first 64 buffers are used.
+*/
+template<bool isRead, class Buffers, class Handler>
+void
+async_io_uring_transfer(
+    io_uring_service& svc,
+    int fd,
+    Buffers const& buffers,
+    Handler&& handler)
+{
+    using op_type = io_uring_transfer_op<
+        isRead, typename std::decay<Handler>::type>;
+    typename std::decay<Handler>::type h(
+        std::forward<Handler>(handler));
+    op_type::launch(svc, fd, std::move(h), buffers);
+}
+
+// Cancel the io_uring operations on a socket, if there are any
+template<class Socket>
+void
+io_uring_cancel(Socket& s) noexcept
+{
+    if(! s.is_open())
+        return;
+    auto const ioc = detail::get_io_context(s);
+    if(! ioc || ! net::has_service<io_uring_service>(*ioc))
+        return;
+    net::use_service<io_uring_service>(*ioc).cancel(
+        s.native_handle());
+}
+
+} // detail
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/detail/impl/io_uring_service.ipp>
+#endif
+
+#endif
+
+#endif
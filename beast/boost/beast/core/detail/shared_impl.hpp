@@ -0,0 +1,419 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_SHARED_IMPL_HPP
+#define BOOST_BEAST_CORE_DETAIL_SHARED_IMPL_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/assert.hpp>
+#include <boost/core/empty_value.hpp>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+/*  A reference counted implementation object, similar to what
+    `std::allocate_shared` produces, with two differences:
+
+    @li The counts may be plain integers instead of atomics, for
+        objects which are only ever touched from one thread.
+
+    @li The control block and the object share one allocation
+        obtained from a caller supplied allocator, and the handles
+        are as cheap to copy as the counts allow.
+*/
+
+template<bool Atomic>
+class shared_impl_control
+{
+    using count_type = typename std::conditional<Atomic,
+        std::atomic<std::size_t>, std::size_t>::type;
+
+    count_type strong_{1};
+    count_type weak_{1}; // +1 while strong_ > 0
+
+    static
+    std::size_t
+    inc(count_type& c) noexcept
+    {
+        if constexpr(Atomic)
+            return c.fetch_add(1, std::memory_order_relaxed) + 1;
+        else
+            return ++c;
+    }
+
+    static
+    std::size_t
+    dec(count_type& c) noexcept
+    {
+        if constexpr(Atomic)
+            return c.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        else
+            return --c;
+    }
+
+protected:
+    virtual ~shared_impl_control() = default;
+
+    // destroy the object, keeping the storage
+    virtual void destroy() noexcept = 0;
+
+    // free the storage, including *this
+    virtual void deallocate() noexcept = 0;
+
+public:
+    void
+    add_ref() noexcept
+    {
+        inc(strong_);
+    }
+
+    // add a strong reference only if the object is alive
+    bool
+    add_ref_lock() noexcept
+    {
+        if constexpr(Atomic)
+        {
+            auto n = strong_.load(std::memory_order_relaxed);
+            while(n != 0)
+                if(strong_.compare_exchange_weak(n, n + 1,
+                        std::memory_order_relaxed))
+                    return true;
+            return false;
+        }
+        else
+        {
+            if(strong_ == 0)
+                return false;
+            ++strong_;
+            return true;
+        }
+    }
+
+    void
+    release() noexcept
+    {
+        if(dec(strong_) == 0)
+        {
+            destroy();
+            release_weak();
+        }
+    }
+
+    void
+    add_weak() noexcept
+    {
+        inc(weak_);
+    }
+
+    void
+    release_weak() noexcept
+    {
+        if(dec(weak_) == 0)
+            deallocate();
+    }
+
+    std::size_t
+    use_count() const noexcept
+    {
+        if constexpr(Atomic)
+            return strong_.load(std::memory_order_relaxed);
+        else
+            return strong_;
+    }
+};
+
+// The control block seen by the handles, which knows the
+// type of the object but not the allocator of the block
+template<class T, bool Atomic>
+class shared_impl_object
+    : public shared_impl_control<Atomic>
+{
+public:
+    virtual T* object() noexcept = 0;
+
+    // Create another block with the allocator of this
+    // one, holding an object moved from this object.
+    virtual shared_impl_object* make_moved() = 0;
+};
+
+template<class T, class Allocator, bool Atomic>
+class shared_impl_block final
+    : public shared_impl_object<T, Atomic>
+    , private boost::empty_value<Allocator>
+{
+    alignas(T) unsigned char buf_[sizeof(T)];
+
+    using alloc_type = typename
+        std::allocator_traits<Allocator>::template
+            rebind_alloc<shared_impl_block>;
+    using alloc_traits = std::allocator_traits<alloc_type>;
+
+    void
+    destroy() noexcept override
+    {
+        get()->~T();
+    }
+
+    void
+    deallocate() noexcept override
+    {
+        alloc_type alloc(this->boost::empty_value<Allocator>::get());
+        alloc_traits::destroy(alloc, this);
+        alloc_traits::deallocate(alloc, this, 1);
+    }
+
+    T*
+    object() noexcept override
+    {
+        return get();
+    }
+
+    shared_impl_object<T, Atomic>*
+    make_moved() override
+    {
+        return create(
+            this->boost::empty_value<Allocator>::get(),
+            std::move(*get()));
+    }
+
+public:
+    template<class... Args>
+    explicit
+    shared_impl_block(Allocator const& alloc, Args&&... args)
+        : boost::empty_value<Allocator>(
+            boost::empty_init_t{}, alloc)
+    {
+        ::new(static_cast<void*>(buf_)) T(
+            std::forward<Args>(args)...);
+    }
+
+    T*
+    get() noexcept
+    {
+        return std::launder(reinterpret_cast<T*>(buf_));
+    }
+
+    template<class... Args>
+    static
+    shared_impl_block*
+    create(Allocator const& a, Args&&... args)
+    {
+        alloc_type alloc(a);
+        auto p = alloc_traits::allocate(alloc, 1);
+        try
+        {
+            alloc_traits::construct(alloc, p,
+                a, std::forward<Args>(args)...);
+        }
+        catch(...)
+        {
+            alloc_traits::deallocate(alloc, p, 1);
+            throw;
+        }
+        return p;
+    }
+};
+
+template<class T, bool Atomic>
+class weak_impl_ptr;
+
+/// A strong reference to a shared implementation object
+template<class T, bool Atomic>
+class shared_impl_ptr
+{
+    template<class, bool>
+    friend class weak_impl_ptr;
+
+    template<class U, bool A, class Allocator, class... Args>
+    friend
+    shared_impl_ptr<U, A>
+    allocate_shared_impl(Allocator const&, Args&&...);
+
+    using control_type = shared_impl_object<T, Atomic>;
+
+    T* p_ = nullptr;
+    control_type* c_ = nullptr;
+
+    shared_impl_ptr(T* p, control_type* c) noexcept
+        : p_(p)
+        , c_(c)
+    {
+    }
+
+public:
+    shared_impl_ptr() = default;
+
+    ~shared_impl_ptr()
+    {
+        if(c_)
+            c_->release();
+    }
+
+    shared_impl_ptr(shared_impl_ptr&& other) noexcept
+        : p_(std::exchange(other.p_, nullptr))
+        , c_(std::exchange(other.c_, nullptr))
+    {
+    }
+
+    shared_impl_ptr(shared_impl_ptr const& other) noexcept
+        : p_(other.p_)
+        , c_(other.c_)
+    {
+        if(c_)
+            c_->add_ref();
+    }
+
+    shared_impl_ptr&
+    operator=(shared_impl_ptr other) noexcept
+    {
+        std::swap(p_, other.p_);
+        std::swap(c_, other.c_);
+        return *this;
+    }
+
+    void
+    reset() noexcept
+    {
+        shared_impl_ptr().swap(*this);
+    }
+
+    void
+    swap(shared_impl_ptr& other) noexcept
+    {
+        std::swap(p_, other.p_);
+        std::swap(c_, other.c_);
+    }
+
+    T*
+    get() const noexcept
+    {
+        return p_;
+    }
+
+    T&
+    operator*() const noexcept
+    {
+        return *p_;
+    }
+
+    T*
+    operator->() const noexcept
+    {
+        return p_;
+    }
+
+    explicit
+    operator bool() const noexcept
+    {
+        return p_ != nullptr;
+    }
+
+    std::size_t
+    use_count() const noexcept
+    {
+        return c_ ? c_->use_count() : 0;
+    }
+
+    /** Return a new object move-constructed from this one.
+
+        The new object is allocated with the allocator
+        which was used for this one.
+    */
+    shared_impl_ptr
+    make_moved() const
+    {
+        BOOST_ASSERT(c_);
+        auto const c = c_->make_moved();
+        return {c->object(), c};
+    }
+};
+
+/// A weak reference to a shared implementation object
+template<class T, bool Atomic>
+class weak_impl_ptr
+{
+    using control_type = shared_impl_object<T, Atomic>;
+
+    T* p_ = nullptr;
+    control_type* c_ = nullptr;
+
+public:
+    weak_impl_ptr() = default;
+
+    ~weak_impl_ptr()
+    {
+        if(c_)
+            c_->release_weak();
+    }
+
+    weak_impl_ptr(
+        shared_impl_ptr<T, Atomic> const& sp) noexcept
+        : p_(sp.p_)
+        , c_(sp.c_)
+    {
+        if(c_)
+            c_->add_weak();
+    }
+
+    weak_impl_ptr(weak_impl_ptr&& other) noexcept
+        : p_(std::exchange(other.p_, nullptr))
+        , c_(std::exchange(other.c_, nullptr))
+    {
+    }
+
+    weak_impl_ptr(weak_impl_ptr const& other) noexcept
+        : p_(other.p_)
+        , c_(other.c_)
+    {
+        if(c_)
+            c_->add_weak();
+    }
+
+    weak_impl_ptr&
+    operator=(weak_impl_ptr other) noexcept
+    {
+        std::swap(p_, other.p_);
+        std::swap(c_, other.c_);
+        return *this;
+    }
+
+    shared_impl_ptr<T, Atomic>
+    lock() const noexcept
+    {
+        if(c_ && c_->add_ref_lock())
+            return {p_, c_};
+        return {};
+    }
+};
+
+/// Create a shared implementation object using an allocator
+template<class T, bool Atomic, class Allocator, class... Args>
+shared_impl_ptr<T, Atomic>
+allocate_shared_impl(Allocator const& alloc, Args&&... args)
+{
+    using char_alloc = typename std::allocator_traits<
+        Allocator>::template rebind_alloc<char>;
+    using block_type = shared_impl_block<T, char_alloc, Atomic>;
+    auto const b = block_type::create(
+        char_alloc(alloc), std::forward<Args>(args)...);
+    return {b->get(), b};
+}
+
+} // detail
+} // beast
+} // boost
+
+#endif
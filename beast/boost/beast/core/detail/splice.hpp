@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_SPLICE_HPP
+#define BOOST_BEAST_CORE_DETAIL_SPLICE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+
+// splice(2) is used on Linux to move bytes between two sockets
+// without copying them through user space. Define
+// BOOST_BEAST_NO_SPLICE to always copy instead.
+#if ! defined(BOOST_BEAST_HAS_SPLICE)
+# if defined(__linux__) && ! defined(BOOST_BEAST_NO_SPLICE)
+#  define BOOST_BEAST_HAS_SPLICE 1
+# endif
+#endif
+#if ! defined(BOOST_BEAST_HAS_SPLICE)
+# define BOOST_BEAST_HAS_SPLICE 0
+#endif
+
+#if BOOST_BEAST_HAS_SPLICE
+
+#include <boost/beast/core/error.hpp>
+#include <asio/error.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+/*  A kernel pipe through which socket data is spliced.
+
+    Bytes are moved from the source socket into the pipe with
+    `fill`, and from the pipe to the destination socket with
+    `drain`. When a socket is not ready the error is
+    `net::error::would_block`, and the call may be repeated
+    once the socket is ready.
+*/
+class splice_pipe
+{
+    int fd_[2] = {-1, -1};
+    std::size_t size_ = 0; // bytes in the pipe
+
+    static
+    error_code
+    last_error() noexcept
+    {
+        return error_code(errno, net::error::get_system_category());
+    }
+
+public:
+    // Largest amount moved by one call to fill
+    static std::size_t constexpr max_fill = 65536;
+
+    splice_pipe() = default;
+    splice_pipe(splice_pipe const&) = delete;
+    splice_pipe& operator=(splice_pipe const&) = delete;
+
+    ~splice_pipe()
+    {
+        close();
+    }
+
+    bool
+    is_open() const noexcept
+    {
+        return fd_[0] != -1;
+    }
+
+    // Returns the number of bytes in the pipe
+    std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    void
+    open(error_code& ec)
+    {
+        if(::pipe2(fd_, O_NONBLOCK | O_CLOEXEC) != 0)
+        {
+            fd_[0] = fd_[1] = -1;
+            ec = last_error();
+            return;
+        }
+        size_ = 0;
+        ec = {};
+    }
+
+    void
+    close() noexcept
+    {
+        if(fd_[0] != -1)
+            ::close(fd_[0]);
+        if(fd_[1] != -1)
+            ::close(fd_[1]);
+        fd_[0] = fd_[1] = -1;
+        size_ = 0;
+    }
+
+    // Move up to `n` bytes from the socket `from` into the pipe
+    std::size_t
+    fill(int from, std::size_t n, error_code& ec)
+    {
+        if(n > max_fill)
+            n = max_fill;
+        for(;;)
+        {
+            auto const result = ::splice(from, nullptr,
+                fd_[1], nullptr, n, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if(result > 0)
+            {
+                size_ += static_cast<std::size_t>(result);
+                ec = {};
+                return static_cast<std::size_t>(result);
+            }
+            if(result == 0)
+            {
+                ec = net::error::eof;
+                return 0;
+            }
+            if(errno != EINTR)
+            {
+                ec = last_error();
+                return 0;
+            }
+        }
+    }
+
+    // Move bytes from the pipe to the socket `to`
+    std::size_t
+    drain(int to, error_code& ec)
+    {
+        for(;;)
+        {
+            auto const result = ::splice(fd_[0], nullptr,
+                to, nullptr, size_, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if(result >= 0)
+            {
+                size_ -= static_cast<std::size_t>(result);
+                ec = {};
+                return static_cast<std::size_t>(result);
+            }
+            if(errno != EINTR)
+            {
+                ec = last_error();
+                return 0;
+            }
+        }
+    }
+};
+
+} // detail
+} // beast
+} // boost
+
+#endif
+
+#endif
@@ -0,0 +1,228 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_TOKEN_BUCKET_HPP
+#define BOOST_BEAST_CORE_DETAIL_TOKEN_BUCKET_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+/*  A lock-free token bucket.
+
+    The bucket is stored as a single "theoretical arrival time" (the
+    generic cell rate algorithm): the instant at which the bucket would
+    be full again if nothing else were taken from it. Taking `n` tokens
+    pushes that instant forward by `n / rate` seconds, and at most
+    `burst` tokens worth of time may be outstanding. Refill is therefore
+    continuous with nanosecond granularity and needs no timer.
+
+    All members may be called concurrently from any thread.
+*/
+class token_bucket
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    static std::size_t constexpr all =
+        (std::numeric_limits<std::size_t>::max)();
+
+private:
+    std::atomic<std::int64_t> tat_{0};      // in ns
+    std::atomic<std::size_t> rate_{all};    // bytes per second
+    std::atomic<std::size_t> burst_{all};   // bytes
+    std::atomic<std::size_t> quantum_{all}; // bytes per grant
+
+    static
+    std::int64_t
+    to_ns(clock_type::time_point t) noexcept
+    {
+        return std::chrono::duration_cast<
+            std::chrono::nanoseconds>(
+                t.time_since_epoch()).count();
+    }
+
+    static
+    std::int64_t
+    cost(std::size_t n, std::size_t rate) noexcept
+    {
+        return static_cast<std::int64_t>(
+            static_cast<double>(n) * 1e9 /
+                static_cast<double>(rate));
+    }
+
+    static
+    std::size_t
+    bytes(std::int64_t ns, std::size_t rate) noexcept
+    {
+        if(ns <= 0)
+            return 0;
+        auto const n = static_cast<double>(ns) *
+            static_cast<double>(rate) / 1e9;
+        if(n >= static_cast<double>(all))
+            return all;
+        return static_cast<std::size_t>(n);
+    }
+
+public:
+    /// Returns `true` if the bucket does not limit anything
+    bool
+    unlimited() const noexcept
+    {
+        return rate_.load(std::memory_order_relaxed) == all;
+    }
+
+    /// Set the refill rate, and the burst and quantum sizes
+    void
+    limit(
+        std::size_t rate,
+        std::size_t burst,
+        std::size_t quantum) noexcept
+    {
+        rate = (std::max<std::size_t>)(rate, 1);
+        burst = (std::max<std::size_t>)(burst, 1);
+        quantum = (std::max<std::size_t>)(quantum, 1);
+        rate_.store(rate, std::memory_order_relaxed);
+        burst_.store(burst, std::memory_order_relaxed);
+        quantum_.store(quantum, std::memory_order_relaxed);
+    }
+
+    std::size_t
+    rate() const noexcept
+    {
+        return rate_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t
+    burst() const noexcept
+    {
+        return burst_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t
+    quantum() const noexcept
+    {
+        return quantum_.load(std::memory_order_relaxed);
+    }
+
+    /** Take up to `max_n` tokens, and return the number taken.
+
+        No more than one quantum is handed out per call, so that
+        callers racing for a nearly empty bucket share it instead
+        of the first one draining it.
+    */
+    std::size_t
+    acquire(
+        std::size_t max_n,
+        clock_type::time_point now) noexcept
+    {
+        auto const rate = rate_.load(std::memory_order_relaxed);
+        if(rate == all)
+            return max_n;
+        auto const t = to_ns(now);
+        auto const window = cost(
+            burst_.load(std::memory_order_relaxed), rate);
+        max_n = (std::min)(max_n,
+            quantum_.load(std::memory_order_relaxed));
+        auto tat = tat_.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            auto const base = (std::max)(tat, t);
+            auto const n = (std::min)(max_n,
+                bytes(t + window - base, rate));
+            if(n == 0)
+                return 0;
+            if(tat_.compare_exchange_weak(
+                tat, base + cost(n, rate),
+                std::memory_order_relaxed))
+                return n;
+        }
+    }
+
+    /// Return `n` tokens previously taken with @ref acquire
+    void
+    release(std::size_t n) noexcept
+    {
+        auto const rate = rate_.load(std::memory_order_relaxed);
+        if(rate == all || n == 0)
+            return;
+        tat_.fetch_sub(cost(n, rate),
+            std::memory_order_relaxed);
+    }
+
+    /// Take `n` tokens unconditionally, going into debt if needed
+    void
+    consume(
+        std::size_t n,
+        clock_type::time_point now) noexcept
+    {
+        auto const rate = rate_.load(std::memory_order_relaxed);
+        if(rate == all || n == 0)
+            return;
+        auto const t = to_ns(now);
+        auto tat = tat_.load(std::memory_order_relaxed);
+        while(! tat_.compare_exchange_weak(
+            tat, (std::max)(tat, t) + cost(n, rate),
+            std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /// Returns the number of tokens which may be taken right now
+    std::size_t
+    available(clock_type::time_point now) const noexcept
+    {
+        auto const rate = rate_.load(std::memory_order_relaxed);
+        if(rate == all)
+            return all;
+        auto const t = to_ns(now);
+        auto const tat = tat_.load(std::memory_order_relaxed);
+        return bytes(t + cost(burst_.load(
+            std::memory_order_relaxed), rate) -
+                (std::max)(tat, t), rate);
+    }
+
+    /** Returns how long until one quantum of tokens is available.
+
+        The result is never less than `resolution`, which bounds
+        how often a starved caller polls the bucket.
+    */
+    clock_type::duration
+    delay(
+        clock_type::time_point now,
+        clock_type::duration resolution) const noexcept
+    {
+        auto const rate = rate_.load(std::memory_order_relaxed);
+        if(rate == all)
+            return resolution;
+        auto const t = to_ns(now);
+        auto const burst = burst_.load(std::memory_order_relaxed);
+        auto const want = (std::min)(burst,
+            quantum_.load(std::memory_order_relaxed));
+        auto const tat = tat_.load(std::memory_order_relaxed);
+        auto const ns = (std::max)(tat, t) + cost(want, rate) -
+            cost(burst, rate) - t;
+        return (std::max)(resolution,
+            std::chrono::duration_cast<clock_type::duration>(
+                std::chrono::nanoseconds(ns)));
+    }
+};
+
+} // detail
+} // beast
+} // boost
+
+#endif
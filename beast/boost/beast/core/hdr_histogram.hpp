@@ -0,0 +1,201 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_HDR_HISTOGRAM_HPP
+#define BOOST_BEAST_CORE_HDR_HISTOGRAM_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace boost {
+namespace beast {
+
+/** A high dynamic range histogram of unsigned integers.
+
+    Values are counted in log-linear buckets: every power of two
+    is divided into 64 buckets of equal width, so that any value
+    from zero to the largest `std::uint64_t` is recorded with a
+    relative error of less than 1.6%, in a fixed amount of memory.
+    This suits latencies measured in nanoseconds, which span many
+    orders of magnitude.
+
+    Recording a value is a handful of arithmetic instructions and
+    relaxed atomic stores, without locks. A histogram has a single
+    writer: @ref record must not be called concurrently with itself,
+    which is usually arranged by giving each thread its own
+    histogram. Any thread may read a histogram at any time, or
+    merge it into another, while it is written. Percentiles of
+    all the threads are obtained by merging their histograms.
+
+    @par Example
+    @code
+    hdr_histogram h;
+    for(auto v : latencies)
+        h.record(v);
+    std::cout << h.value_at_percentile(99);
+    @endcode
+*/
+class hdr_histogram
+{
+public:
+    /// The number of buckets in each power of two
+    static std::size_t constexpr sub_buckets = 64;
+
+private:
+    static unsigned constexpr sub_bits = 6;
+
+    static_assert(std::size_t(1) << sub_bits == sub_buckets, "");
+
+    static std::size_t constexpr bucket_count =
+        (66 - (sub_bits + 1)) * sub_buckets;
+
+    std::atomic<std::uint64_t> counts_[bucket_count];
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> min_{
+        (std::numeric_limits<std::uint64_t>::max)()};
+    std::atomic<std::uint64_t> max_{0};
+
+    static
+    std::size_t
+    index(std::uint64_t v) noexcept
+    {
+        // values below 2^(sub_bits+1) are counted exactly
+        if(v < 2 * sub_buckets)
+            return static_cast<std::size_t>(v);
+        unsigned const shift =
+            std::bit_width(v) - (sub_bits + 1);
+        return shift * sub_buckets +
+            static_cast<std::size_t>(v >> shift);
+    }
+
+    BOOST_BEAST_DECL
+    static
+    std::uint64_t
+    highest_equivalent(std::size_t i) noexcept;
+
+    static
+    void
+    add(std::atomic<std::uint64_t>& a, std::uint64_t n) noexcept
+    {
+        // single writer, so no read-modify-write is needed
+        a.store(a.load(std::memory_order_relaxed) + n,
+            std::memory_order_relaxed);
+    }
+
+public:
+    /// Constructor
+    BOOST_BEAST_DECL
+    hdr_histogram() noexcept;
+
+    /// Constructor
+    BOOST_BEAST_DECL
+    hdr_histogram(hdr_histogram const& other) noexcept;
+
+    /// Assignment
+    BOOST_BEAST_DECL
+    hdr_histogram&
+    operator=(hdr_histogram const& other) noexcept;
+
+    /** Record a value.
+
+        @param v The value to record.
+
+        @param n The number of times to record the value.
+    */
+    void
+    record(std::uint64_t v, std::uint64_t n = 1) noexcept
+    {
+        auto constexpr relaxed = std::memory_order_relaxed;
+        add(counts_[index(v)], n);
+        add(count_, n);
+        add(sum_, v * n);
+        if(v < min_.load(relaxed))
+            min_.store(v, relaxed);
+        if(v > max_.load(relaxed))
+            max_.store(v, relaxed);
+    }
+
+    /** Add the values recorded by another histogram to this one.
+
+        The other histogram may be written concurrently, in which
+        case only part of its recent values may be added. This
+        must not be called concurrently with @ref record on this
+        histogram.
+    */
+    BOOST_BEAST_DECL
+    void
+    merge(hdr_histogram const& other) noexcept;
+
+    /** Remove all values.
+
+        This must not be called concurrently with @ref record.
+    */
+    BOOST_BEAST_DECL
+    void
+    reset() noexcept;
+
+    /// Returns the number of values recorded
+    std::uint64_t
+    count() const noexcept
+    {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    /// Returns the smallest value recorded, or zero if there are none
+    std::uint64_t
+    min() const noexcept
+    {
+        return count() ? min_.load(std::memory_order_relaxed) : 0;
+    }
+
+    /// Returns the largest value recorded, or zero if there are none
+    std::uint64_t
+    max() const noexcept
+    {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    /// Returns the mean of the values recorded, or zero if there are none
+    double
+    mean() const noexcept
+    {
+        auto const n = count();
+        return n ? static_cast<double>(
+            sum_.load(std::memory_order_relaxed)) / n : 0;
+    }
+
+    /** Returns the value at a percentile.
+
+        The result is the largest value equivalent to the one
+        below which `p` percent of the recorded values lie,
+        that is, an upper bound accurate to the precision of
+        the histogram, and never more than @ref max.
+
+        @param p The percentile, from 0 to 100.
+
+        @return The value, or zero if the histogram is empty.
+    */
+    BOOST_BEAST_DECL
+    std::uint64_t
+    value_at_percentile(double p) const noexcept;
+};
+
+} // beast
+} // boost
+
+#if BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/impl/hdr_histogram.ipp>
+#endif
+
+#endif
@@ -116,8 +116,14 @@ allocate_stable(
         Handler, Executor1, Allocator>& base,
     Args&&... args)
 {
-    using allocator_type = typename stable_async_base<
-        Handler, Executor1, Allocator>::allocator_type;
+    // Without an allocator of its own, the state is recycled
+    // through the per-thread cache, like the memory for the
+    // operations of the implementation.
+    using recycling = net::detail::get_recycling_allocator<
+        typename stable_async_base<
+            Handler, Executor1, Allocator>::allocator_type,
+        net::detail::thread_info_base::default_tag>;
+    using allocator_type = typename recycling::type;
     using state = detail::allocate_stable_state<
         State, allocator_type>;
     using A = typename std::allocator_traits<
@@ -138,8 +144,10 @@ allocate_stable(
         }
     };
 
-    A a(base.get_allocator());
-    deleter d{base.get_allocator(), a.allocate(1)};
+    allocator_type const alloc =
+        recycling::get(base.get_allocator());
+    A a(alloc);
+    deleter d{alloc, a.allocate(1)};
     ::new(static_cast<void*>(d.ptr))
         state(d.alloc, std::forward<Args>(args)...);
     d.ptr->next_ = base.list_;
@@ -13,12 +13,19 @@
 #include <boost/beast/core/async_base.hpp>
 #include <boost/beast/core/buffer_traits.hpp>
 #include <boost/beast/core/buffers_prefix.hpp>
+#include <boost/beast/core/trace.hpp>
 #include <boost/beast/websocket/teardown.hpp>
+#include <asio/bind_executor.hpp>
 #include <asio/coroutine.hpp>
+#include <asio/post.hpp>
+#include <asio/strand.hpp>
 #include <boost/assert.hpp>
 #include <cstdlib>
+#include <memory>
+#include <optional>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace boost {
 namespace beast {
@@ -36,6 +43,9 @@ impl_type(std::false_type, Args&&... args)
     , timer(ex())
 {
     reset();
+#if BOOST_BEAST_HAS_IO_URING
+    uring = detail::io_uring_service::find(socket);
+#endif
 }
 
 template<class Protocol, class Executor, class RatePolicy>
@@ -53,6 +63,9 @@ impl_type(std::true_type,
     , timer(ex())
 {
     reset();
+#if BOOST_BEAST_HAS_IO_URING
+    uring = detail::io_uring_service::find(socket);
+#endif
 }
 
 template<class Protocol, class Executor, class RatePolicy>
@@ -60,7 +73,9 @@ template<class Executor2>
 void
 basic_stream<Protocol, Executor, RatePolicy>::
 impl_type::
-on_timer(Executor2 const& ex2)
+on_timer(
+    impl_ptr const& self,
+    Executor2 const& ex2)
 {
     BOOST_ASSERT(waiting > 0);
 
@@ -68,6 +83,14 @@ on_timer(Executor2 const& ex2)
     if(--waiting > 0)
         return;
 
+    // policies which refill on demand have no slices
+    if constexpr(rate_policy_access::
+        has_refill_delay<RatePolicy>)
+    {
+        rate_policy_access::on_timer(policy());
+        return;
+    }
+
     // update the expiration time
     BOOST_VERIFY(timer.expires_after(
         std::chrono::seconds(1)) == 0);
@@ -76,7 +99,7 @@ on_timer(Executor2 const& ex2)
 
     struct handler : boost::empty_value<Executor2>
     {
-        std::weak_ptr<impl_type> wp;
+        weak_impl_ptr wp;
 
         using executor_type = Executor2;
 
@@ -88,7 +111,7 @@ on_timer(Executor2 const& ex2)
 
         handler(
             Executor2 const& ex2,
-            std::shared_ptr<impl_type> const& sp)
+            impl_ptr const& sp)
             : boost::empty_value<Executor2>(
                 boost::empty_init_t{}, ex2)
             , wp(sp)
@@ -106,13 +129,13 @@ on_timer(Executor2 const& ex2)
             BOOST_ASSERT(! ec);
             if(ec)
                 return;
-            sp->on_timer(this->get());
+            sp->on_timer(sp, this->get());
         }
     };
 
     // wait on the timer again
     ++waiting;
-    timer.async_wait(handler(ex2, this->shared_from_this()));
+    timer.async_wait(handler(ex2, self));
 }
 
 template<class Protocol, class Executor, class RatePolicy>
@@ -144,6 +167,9 @@ impl_type::
 close() noexcept
 {
     {
+#if BOOST_BEAST_HAS_IO_URING
+        detail::io_uring_cancel(socket);
+#endif
         error_code ec;
         socket.close(ec);
     }
@@ -166,7 +192,7 @@ struct basic_stream<Protocol, Executor, RatePolicy>::
     using executor_type = Executor2;
 
     op_state& state;
-    std::weak_ptr<impl_type> wp;
+    weak_impl_ptr wp;
     tick_type tick;
     executor_type ex;
 
@@ -212,7 +238,7 @@ class transfer_op
     : public async_base<Handler, Executor>
     , public ::asio::coroutine
 {
-    std::shared_ptr<impl_type> impl_;
+    impl_ptr impl_;
     pending_guard pg_;
     Buffers b_;
 
@@ -253,6 +279,13 @@ class transfer_op
     async_perform(
         std::size_t amount, std::true_type)
     {
+#if BOOST_BEAST_HAS_IO_URING
+        if(impl_->uring && amount > 0)
+            return detail::async_io_uring_transfer<true>(
+                *impl_->uring, impl_->socket.native_handle(),
+                beast::buffers_prefix(amount, b_),
+                    std::move(*this));
+#endif
         impl_->socket.async_read_some(
             beast::buffers_prefix(amount, b_),
                 std::move(*this));
@@ -262,6 +295,13 @@ class transfer_op
     async_perform(
         std::size_t amount, std::false_type)
     {
+#if BOOST_BEAST_HAS_IO_URING
+        if(impl_->uring && amount > 0)
+            return detail::async_io_uring_transfer<false>(
+                *impl_->uring, impl_->socket.native_handle(),
+                beast::buffers_prefix(amount, b_),
+                    std::move(*this));
+#endif
         impl_->socket.async_write_some(
             beast::buffers_prefix(amount, b_),
                 std::move(*this));
@@ -350,7 +390,18 @@ public:
             amount = available_bytes();
             if(amount == 0)
             {
+                if constexpr(rate_policy_access::
+                    has_refill_delay<RatePolicy>)
+                {
+                    // the first waiter decides when to poll again
+                    if(impl_->waiting == 0)
+                        impl_->timer.expires_after(
+                            rate_policy_access::refill_delay(
+                                impl_->policy(), isRead));
+                }
                 ++impl_->waiting;
+                rate_policy_access::on_wait_begin(
+                    impl_->policy(), isRead);
                 ASIO_CORO_YIELD
                 {
                     ASIO_HANDLER_LOCATION((
@@ -360,6 +411,8 @@ public:
 
                     impl_->timer.async_wait(std::move(*this));
                 }
+                rate_policy_access::on_wait_end(
+                    impl_->policy(), isRead);
                 if(ec)
                 {
                     // socket was closed, or a timeout
@@ -374,7 +427,7 @@ public:
                     }
                     goto upcall;
                 }
-                impl_->on_timer(this->get_executor());
+                impl_->on_timer(impl_, this->get_executor());
 
                 // Allow at least one byte, otherwise
                 // bytes_transferred could be 0.
@@ -418,6 +471,9 @@ public:
 
         upcall:
             pg_.reset();
+            if(ec == beast::error::timeout)
+                rate_policy_access::on_timeout(
+                    impl_->policy(), isRead);
             transfer_bytes(bytes_transferred);
             this->complete_now(ec, bytes_transferred);
         }
@@ -428,9 +484,10 @@ template<class Handler>
 class connect_op
     : public async_base<Handler, Executor>
 {
-    std::shared_ptr<impl_type> impl_;
+    impl_ptr impl_;
     pending_guard pg0_;
     pending_guard pg1_;
+    trace_span span_;
 
     op_state&
     state() noexcept
@@ -575,12 +632,234 @@ public:
             }
         }
 
+        if(ec == beast::error::timeout)
+            rate_policy_access::on_timeout(
+                impl_->policy(), false);
+        span_.finish(trace_phase::connect, ec);
         pg0_.reset();
         pg1_.reset();
         this->complete_now(ec, std::forward<Args>(args)...);
     }
 };
 
+// Races connection attempts to the endpoints, as in RFC 8305.
+// The attempts, the delay timer and the timeout complete
+// independently, so the operation is shared between them, and
+// their handlers are serialized by a strand of the stream's
+// executor so that a multi-threaded io_context may run them.
+template<class Handler>
+class race_connect_op
+    : public async_base<Handler, Executor>
+    , public std::enable_shared_from_this<race_connect_op<Handler>>
+{
+    impl_ptr impl_;
+    pending_guard pg0_;
+    pending_guard pg1_;
+    trace_span span_;
+    net::strand<Executor> strand_;
+    std::vector<endpoint_type> eps_;
+
+    // Sized once to the number of endpoints, so that the
+    // sockets of outstanding attempts never move
+    std::vector<std::optional<socket_type>> socks_;
+
+    net::steady_timer delay_timer_;
+    std::chrono::steady_clock::duration delay_;
+    std::size_t started_ = 0;
+    std::size_t pending_ = 0;
+    bool done_ = false;
+    error_code ec_;
+
+    op_state&
+    state() noexcept
+    {
+        return impl_->write;
+    }
+
+    template<class F>
+    auto
+    bind(F&& f)
+    {
+        return net::bind_executor(
+            strand_, std::forward<F>(f));
+    }
+
+    // Start the next attempt, or complete
+    // if every attempt has failed
+    void
+    try_next()
+    {
+        while(started_ < eps_.size())
+        {
+            auto const i = started_++;
+            auto& sock = socks_[i].emplace(impl_->ex());
+            error_code ec;
+            sock.open(eps_[i].protocol(), ec);
+            if(ec)
+            {
+                ec_ = ec;
+                continue;
+            }
+
+            ASIO_HANDLER_LOCATION((
+                __FILE__, __LINE__,
+                "basic_stream::async_race_connect"));
+
+            ++pending_;
+            sock.async_connect(eps_[i], bind(
+                [self = this->shared_from_this(), i](error_code ec)
+                {
+                    self->on_connect(i, ec);
+                }));
+            if(started_ < eps_.size())
+            {
+                delay_timer_.expires_after(delay_);
+                delay_timer_.async_wait(bind(
+                    [self = this->shared_from_this(), n = started_](error_code ec)
+                    {
+                        // skip a delay which has been overtaken by a failure
+                        if(! ec && ! self->done_ && self->started_ == n)
+                            self->try_next();
+                    }));
+            }
+            return;
+        }
+        if(pending_ == 0)
+            finish(ec_, eps_.size());
+    }
+
+    void
+    on_connect(std::size_t i, error_code ec)
+    {
+        --pending_;
+        if(done_)
+            return;
+        if(! ec)
+            return finish(ec, i);
+
+        // don't wait for the delay to try the next one
+        ec_ = ec;
+        delay_timer_.cancel();
+        try_next();
+    }
+
+    void
+    on_timeout()
+    {
+        if(done_)
+            return;
+        rate_policy_access::on_timeout(
+            impl_->policy(), false);
+        finish(beast::error::timeout, eps_.size());
+    }
+
+    void
+    finish(error_code ec, std::size_t winner)
+    {
+        done_ = true;
+        delay_timer_.cancel();
+        if(state().timer.expiry() != stream_base::never())
+            impl_->write.timer.cancel();
+        for(std::size_t i = 0; i < started_; ++i)
+        {
+            if(i == winner)
+                continue;
+            error_code ignored;
+            socks_[i]->close(ignored);
+        }
+        endpoint_type ep;
+        if(! ec)
+        {
+            impl_->socket = std::move(*socks_[winner]);
+            ep = eps_[winner];
+        }
+        span_.finish(trace_phase::connect, ec);
+        pg0_.reset();
+        pg1_.reset();
+
+        // we are on the strand, not necessarily
+        // on the executor of the handler
+        this->complete(false, ec, ep);
+    }
+
+    void
+    run()
+    {
+        if(eps_.empty())
+            return finish(net::error::not_found, 0);
+
+        if(state().timer.expiry() != stream_base::never())
+        {
+            ASIO_HANDLER_LOCATION((
+                __FILE__, __LINE__,
+                "basic_stream::async_race_connect"));
+
+            impl_->write.timer.async_wait(bind(
+                [self = this->shared_from_this()](error_code ec)
+                {
+                    if(ec != net::error::operation_aborted)
+                        self->on_timeout();
+                }));
+        }
+        try_next();
+    }
+
+public:
+    template<class Endpoints, class Handler_>
+    race_connect_op(
+        Handler_&& h,
+        basic_stream& s,
+        Endpoints const& eps,
+        std::chrono::steady_clock::duration delay)
+        : async_base<Handler, Executor>(
+            std::forward<Handler_>(h), s.get_executor())
+        , impl_(s.impl_)
+        , pg0_(impl_->read.pending)
+        , pg1_(impl_->write.pending)
+        , strand_(impl_->ex())
+        , delay_timer_(impl_->ex())
+        , delay_(delay)
+    {
+        // Interleave the address families, starting
+        // with the family of the first endpoint
+        std::vector<endpoint_type> first;
+        std::vector<endpoint_type> second;
+        for(auto const& e : eps)
+        {
+            endpoint_type const ep = e;
+            if( first.empty() ||
+                ep.protocol().family() ==
+                    first.front().protocol().family())
+                first.push_back(ep);
+            else
+                second.push_back(ep);
+        }
+        eps_.reserve(first.size() + second.size());
+        for(std::size_t i = 0;
+            i < first.size() || i < second.size(); ++i)
+        {
+            if(i < first.size())
+                eps_.push_back(first[i]);
+            if(i < second.size())
+                eps_.push_back(second[i]);
+        }
+        socks_.resize(eps_.size());
+    }
+
+    void
+    start()
+    {
+        // Everything, including the first attempt, happens
+        // on the strand, so that no handler can run before
+        // the initiation has finished with the shared state.
+        net::post(strand_,
+            [self = this->shared_from_this()]
+            {
+                self->run();
+            });
+    }
+};
+
 struct run_read_op
 {
     template<class ReadHandler, class Buffers>
@@ -710,6 +989,38 @@ struct run_connect_iter_op
     }
 };
 
+struct run_race_connect_op
+{
+    template<
+        class RangeConnectHandler,
+        class EndpointSequence>
+    void
+    operator()(
+        RangeConnectHandler&& h,
+        basic_stream* s,
+        EndpointSequence const& eps,
+        std::chrono::steady_clock::duration delay)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            detail::is_invocable<RangeConnectHandler,
+                void(error_code, typename Protocol::endpoint)>::value,
+            "RangeConnectHandler type requirements not met");
+
+        // The operation is allocated with the
+        // allocator associated with the handler
+        using op_type = race_connect_op<
+            typename std::decay<RangeConnectHandler>::type>;
+        auto const alloc = net::get_associated_allocator(h);
+        std::allocate_shared<op_type>(alloc,
+            std::forward<RangeConnectHandler>(h),
+            *s, eps, delay)->start();
+    }
+};
+
 };
 
 //------------------------------------------------------------------------------
@@ -728,7 +1039,8 @@ template<class Protocol, class Executor, class RatePolicy>
 template<class Arg0, class... Args, class>
 basic_stream<Protocol, Executor, RatePolicy>::
 basic_stream(Arg0&& arg0, Args&&... args)
-    : impl_(std::make_shared<impl_type>(
+    : impl_(detail::allocate_shared_impl<impl_type, is_atomic>(
+        std::allocator<void>{},
         std::false_type{},
         std::forward<Arg0>(arg0),
         std::forward<Args>(args)...))
@@ -740,7 +1052,36 @@ template<class RatePolicy_, class Arg0, class... Args, class>
 basic_stream<Protocol, Executor, RatePolicy>::
 basic_stream(
     RatePolicy_&& policy, Arg0&& arg0, Args&&... args)
-    : impl_(std::make_shared<impl_type>(
+    : impl_(detail::allocate_shared_impl<impl_type, is_atomic>(
+        std::allocator<void>{},
+        std::true_type{},
+        std::forward<RatePolicy_>(policy),
+        std::forward<Arg0>(arg0),
+        std::forward<Args>(args)...))
+{
+}
+
+template<class Protocol, class Executor, class RatePolicy>
+template<class Allocator, class Arg0, class... Args, class>
+basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream(std::allocator_arg_t,
+    Allocator const& alloc, Arg0&& arg0, Args&&... args)
+    : impl_(detail::allocate_shared_impl<impl_type, is_atomic>(
+        alloc,
+        std::false_type{},
+        std::forward<Arg0>(arg0),
+        std::forward<Args>(args)...))
+{
+}
+
+template<class Protocol, class Executor, class RatePolicy>
+template<class Allocator,
+    class RatePolicy_, class Arg0, class... Args, class>
+basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream(std::allocator_arg_t, Allocator const& alloc,
+    RatePolicy_&& policy, Arg0&& arg0, Args&&... args)
+    : impl_(detail::allocate_shared_impl<impl_type, is_atomic>(
+        alloc,
         std::true_type{},
         std::forward<RatePolicy_>(policy),
         std::forward<Arg0>(arg0),
@@ -751,8 +1092,7 @@ basic_stream(
 template<class Protocol, class Executor, class RatePolicy>
 basic_stream<Protocol, Executor, RatePolicy>::
 basic_stream(basic_stream&& other)
-    : impl_(std::make_shared<impl_type>(
-        std::move(*other.impl_)))
+    : impl_(other.impl_.make_moved())
 {
     // Explainer: Asio's sockets provide the guarantee that a moved-from socket
     // will be in a state as-if newly created. i.e.:
@@ -839,6 +1179,9 @@ basic_stream<Protocol, Executor, RatePolicy>::
 cancel()
 {
     error_code ec;
+#if BOOST_BEAST_HAS_IO_URING
+    detail::io_uring_cancel(impl_->socket);
+#endif
     impl_->socket.cancel(ec);
     impl_->timer.cancel();
 }
@@ -956,6 +1299,28 @@ async_connect(
             connect_condition);
 }
 
+template<class Protocol, class Executor, class RatePolicy>
+template<
+    class EndpointSequence,
+    ASIO_COMPLETION_TOKEN_FOR(void(error_code, typename Protocol::endpoint)) RangeConnectHandler,
+    class>
+ASIO_INITFN_RESULT_TYPE(RangeConnectHandler,void(error_code, typename Protocol::endpoint))
+basic_stream<Protocol, Executor, RatePolicy>::
+async_race_connect(
+    EndpointSequence const& endpoints,
+    std::chrono::steady_clock::duration attempt_delay,
+    RangeConnectHandler&& handler)
+{
+    return net::async_initiate<
+        RangeConnectHandler,
+        void(error_code, typename Protocol::endpoint)>(
+            typename ops::run_race_connect_op{},
+            handler,
+            this,
+            endpoints,
+            attempt_delay);
+}
+
 //------------------------------------------------------------------------------
 
 template<class Protocol, class Executor, class RatePolicy>
@@ -1012,6 +1377,9 @@ beast_close_socket(
     basic_stream<Protocol, Executor, RatePolicy>& stream)
 {
     error_code ec;
+#if BOOST_BEAST_HAS_IO_URING
+    detail::io_uring_cancel(stream.socket());
+#endif
     stream.socket().close(ec);
 }
 
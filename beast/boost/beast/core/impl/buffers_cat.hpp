@@ -138,6 +138,7 @@ class buffers_cat_view<Bn...>::const_iterator
         buffers_iterator_type<Bn>..., past_end, std::monostate> it_ = std::monostate{};
 
     friend class buffers_cat_view<Bn...>;
+    friend struct detail::buffers_flattener;
 
 public:
     using value_type = typename
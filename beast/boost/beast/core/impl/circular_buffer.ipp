@@ -0,0 +1,283 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_IMPL_CIRCULAR_BUFFER_IPP
+#define BOOST_BEAST_IMPL_CIRCULAR_BUFFER_IPP
+
+#include <boost/beast/core/circular_buffer.hpp>
+#include <asio/buffer.hpp>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+// The mirrored mapping needs memfd_create, from Linux 3.17
+#if ! defined(BOOST_BEAST_HAS_MIRRORED_BUFFER)
+# if defined(__linux__) && ! defined(BOOST_BEAST_NO_MIRRORED_BUFFER)
+#  define BOOST_BEAST_HAS_MIRRORED_BUFFER 1
+# endif
+#endif
+#if ! defined(BOOST_BEAST_HAS_MIRRORED_BUFFER)
+# define BOOST_BEAST_HAS_MIRRORED_BUFFER 0
+#endif
+
+#if BOOST_BEAST_HAS_MIRRORED_BUFFER
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace boost {
+namespace beast {
+
+char*
+circular_buffer::
+allocate(std::size_t n, bool& mirrored)
+{
+#if BOOST_BEAST_HAS_MIRRORED_BUFFER
+    // Map one file twice, back to back, in a reserved
+    // range so that the second view follows the first.
+    static std::size_t const page =
+        static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    if(n >= page && n % page == 0)
+    {
+        int const fd = static_cast<int>(::syscall(
+            __NR_memfd_create, "beast.circular_buffer",
+            1u)); // MFD_CLOEXEC
+        if(fd != -1)
+        {
+            void* p = MAP_FAILED;
+            if(::ftruncate(fd, static_cast<off_t>(n)) == 0)
+                p = ::mmap(nullptr, 2 * n, PROT_NONE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if(p != MAP_FAILED)
+            {
+                auto const base = static_cast<char*>(p);
+                if( ::mmap(base, n, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+                    ::mmap(base + n, n, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED)
+                {
+                    // the mappings keep the memory alive
+                    ::close(fd);
+                    mirrored = true;
+                    return base;
+                }
+                ::munmap(p, 2 * n);
+            }
+            ::close(fd);
+        }
+    }
+#endif
+    mirrored = false;
+    return static_cast<char*>(::operator new(n));
+}
+
+void
+circular_buffer::
+deallocate(char* p, std::size_t n, bool mirrored) noexcept
+{
+    if(! p)
+        return;
+#if BOOST_BEAST_HAS_MIRRORED_BUFFER
+    if(mirrored)
+    {
+        ::munmap(p, 2 * n);
+        return;
+    }
+#else
+    (void)mirrored;
+#endif
+    (void)n;
+    ::operator delete(p);
+}
+
+void
+circular_buffer::
+realloc(std::size_t n)
+{
+    std::size_t capacity = 0;
+    char* p = nullptr;
+    bool mirrored = false;
+    if(n > 0)
+    {
+        capacity = min_capacity;
+        while(capacity < n)
+        {
+            if(capacity > (std::numeric_limits<
+                    std::size_t>::max)() / 2)
+                throw std::length_error{"circular_buffer overflow"};
+            capacity *= 2;
+        }
+        p = allocate(capacity, mirrored);
+        net::buffer_copy(net::buffer(p, in_size_), data());
+    }
+    deallocate(begin_, capacity_, mirrored_);
+    begin_ = p;
+    capacity_ = capacity;
+    mirrored_ = mirrored;
+    in_off_ = 0;
+    out_size_ = 0;
+}
+
+circular_buffer::
+~circular_buffer()
+{
+    deallocate(begin_, capacity_, mirrored_);
+}
+
+circular_buffer::
+circular_buffer(circular_buffer&& other) noexcept
+    : begin_(std::exchange(other.begin_, nullptr))
+    , capacity_(std::exchange(other.capacity_, 0))
+    , in_off_(std::exchange(other.in_off_, 0))
+    , in_size_(std::exchange(other.in_size_, 0))
+    , out_size_(std::exchange(other.out_size_, 0))
+    , max_(other.max_)
+    , mirrored_(std::exchange(other.mirrored_, false))
+{
+}
+
+circular_buffer::
+circular_buffer(circular_buffer const& other)
+    : max_(other.max_)
+{
+    if(other.in_size_ == 0)
+        return;
+    realloc(other.in_size_);
+    in_size_ = net::buffer_copy(
+        net::buffer(begin_, other.in_size_), other.data());
+}
+
+auto
+circular_buffer::
+operator=(circular_buffer&& other) noexcept ->
+    circular_buffer&
+{
+    if(this == &other)
+        return *this;
+    deallocate(begin_, capacity_, mirrored_);
+    begin_ = std::exchange(other.begin_, nullptr);
+    capacity_ = std::exchange(other.capacity_, 0);
+    in_off_ = std::exchange(other.in_off_, 0);
+    in_size_ = std::exchange(other.in_size_, 0);
+    out_size_ = std::exchange(other.out_size_, 0);
+    max_ = other.max_;
+    mirrored_ = std::exchange(other.mirrored_, false);
+    return *this;
+}
+
+auto
+circular_buffer::
+operator=(circular_buffer const& other) ->
+    circular_buffer&
+{
+    if(this == &other)
+        return *this;
+    clear();
+    max_ = other.max_;
+    if(other.in_size_ > capacity_)
+        realloc(other.in_size_);
+    in_size_ = net::buffer_copy(
+        net::buffer(begin_, other.in_size_), other.data());
+    return *this;
+}
+
+void
+circular_buffer::
+reserve(std::size_t n)
+{
+    if(n > max_)
+        throw std::length_error{"circular_buffer overflow"};
+    if(n > capacity_)
+        realloc(n);
+}
+
+void
+circular_buffer::
+shrink_to_fit()
+{
+    if(in_size_ == 0)
+    {
+        realloc(0);
+        return;
+    }
+    auto capacity = min_capacity;
+    while(capacity < in_size_)
+        capacity *= 2;
+    if(capacity < capacity_)
+        realloc(in_size_);
+}
+
+auto
+circular_buffer::
+data() const noexcept ->
+    const_buffers_type
+{
+    if(mirrored_ || in_off_ + in_size_ <= capacity_)
+        return {
+            net::const_buffer{
+                begin_ + in_off_, in_size_},
+            net::const_buffer{
+                begin_, 0}};
+    return {
+        net::const_buffer{
+            begin_ + in_off_, capacity_ - in_off_},
+        net::const_buffer{
+            begin_, in_size_ - (capacity_ - in_off_)}};
+}
+
+auto
+circular_buffer::
+data() noexcept ->
+    mutable_buffers_type
+{
+    if(mirrored_ || in_off_ + in_size_ <= capacity_)
+        return {
+            net::mutable_buffer{
+                begin_ + in_off_, in_size_},
+            net::mutable_buffer{
+                begin_, 0}};
+    return {
+        net::mutable_buffer{
+            begin_ + in_off_, capacity_ - in_off_},
+        net::mutable_buffer{
+            begin_, in_size_ - (capacity_ - in_off_)}};
+}
+
+auto
+circular_buffer::
+prepare(std::size_t n) ->
+    mutable_buffers_type
+{
+    if(in_size_ > max_ || n > max_ - in_size_)
+        throw std::length_error{"circular_buffer overflow"};
+    if(n > capacity_ - in_size_)
+        realloc(in_size_ + n);
+    out_size_ = n;
+    if(capacity_ == 0)
+        return {};
+    auto const out_off =
+        (in_off_ + in_size_) & (capacity_ - 1);
+    if(mirrored_ || out_off + out_size_ <= capacity_)
+        return {
+            net::mutable_buffer{
+                begin_ + out_off, out_size_},
+            net::mutable_buffer{
+                begin_, 0}};
+    return {
+        net::mutable_buffer{
+            begin_ + out_off, capacity_ - out_off},
+        net::mutable_buffer{
+            begin_, out_size_ - (capacity_ - out_off)}};
+}
+
+} // beast
+} // boost
+
+#endif
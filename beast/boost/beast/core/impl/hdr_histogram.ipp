@@ -0,0 +1,134 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_IMPL_HDR_HISTOGRAM_IPP
+#define BOOST_BEAST_IMPL_HDR_HISTOGRAM_IPP
+
+#include <boost/beast/core/hdr_histogram.hpp>
+#include <cmath>
+
+namespace boost {
+namespace beast {
+
+std::uint64_t
+hdr_histogram::
+highest_equivalent(std::size_t i) noexcept
+{
+    if(i < 2 * sub_buckets)
+        return i;
+    auto const shift = static_cast<unsigned>(i / sub_buckets - 1);
+    auto const lowest =
+        static_cast<std::uint64_t>(i - shift * sub_buckets) << shift;
+    return lowest + ((std::uint64_t(1) << shift) - 1);
+}
+
+hdr_histogram::
+hdr_histogram() noexcept
+{
+    for(auto& c : counts_)
+        c.store(0, std::memory_order_relaxed);
+}
+
+hdr_histogram::
+hdr_histogram(hdr_histogram const& other) noexcept
+    : hdr_histogram()
+{
+    merge(other);
+}
+
+hdr_histogram&
+hdr_histogram::
+operator=(hdr_histogram const& other) noexcept
+{
+    if(this != &other)
+    {
+        reset();
+        merge(other);
+    }
+    return *this;
+}
+
+void
+hdr_histogram::
+merge(hdr_histogram const& other) noexcept
+{
+    auto constexpr relaxed = std::memory_order_relaxed;
+    std::uint64_t n = 0;
+    for(std::size_t i = 0; i < bucket_count; ++i)
+    {
+        auto const c = other.counts_[i].load(relaxed);
+        if(c == 0)
+            continue;
+        counts_[i].fetch_add(c, relaxed);
+        n += c;
+    }
+    if(n == 0)
+        return;
+    // use the counts seen in the buckets, so that
+    // percentiles stay consistent with the count
+    count_.fetch_add(n, relaxed);
+    sum_.fetch_add(other.sum_.load(relaxed), relaxed);
+    auto const lo = other.min_.load(relaxed);
+    if(lo < min_.load(relaxed))
+        min_.store(lo, relaxed);
+    auto const hi = other.max_.load(relaxed);
+    if(hi > max_.load(relaxed))
+        max_.store(hi, relaxed);
+}
+
+void
+hdr_histogram::
+reset() noexcept
+{
+    auto constexpr relaxed = std::memory_order_relaxed;
+    for(auto& c : counts_)
+        c.store(0, relaxed);
+    count_.store(0, relaxed);
+    sum_.store(0, relaxed);
+    min_.store((std::numeric_limits<
+        std::uint64_t>::max)(), relaxed);
+    max_.store(0, relaxed);
+}
+
+std::uint64_t
+hdr_histogram::
+value_at_percentile(double p) const noexcept
+{
+    auto constexpr relaxed = std::memory_order_relaxed;
+    std::uint64_t total = 0;
+    for(auto const& c : counts_)
+        total += c.load(relaxed);
+    if(total == 0)
+        return 0;
+    if(p < 0)
+        p = 0;
+    else if(p > 100)
+        p = 100;
+    auto target = static_cast<std::uint64_t>(
+        std::ceil(p / 100 * static_cast<double>(total)));
+    if(target == 0)
+        target = 1;
+    std::uint64_t seen = 0;
+    for(std::size_t i = 0; i < bucket_count; ++i)
+    {
+        seen += counts_[i].load(relaxed);
+        if(seen >= target)
+        {
+            auto const v = highest_equivalent(i);
+            auto const hi = max();
+            return v < hi ? v : hi;
+        }
+    }
+    return max();
+}
+
+} // beast
+} // boost
+
+#endif
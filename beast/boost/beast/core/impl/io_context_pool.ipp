@@ -0,0 +1,351 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_IMPL_IO_CONTEXT_POOL_IPP
+#define BOOST_BEAST_CORE_IMPL_IO_CONTEXT_POOL_IPP
+
+#include <boost/beast/core/io_context_pool.hpp>
+#include <asio/post.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <utility>
+
+#if defined(__linux__)
+# include <pthread.h>
+# include <sched.h>
+#elif defined(_WIN32)
+# include <windows.h>
+#endif
+
+namespace boost {
+namespace beast {
+
+namespace detail {
+
+struct io_context_pool_thread
+{
+    io_context_pool const* pool = nullptr;
+    std::size_t index = 0;
+};
+
+inline
+io_context_pool_thread&
+this_io_context_pool_thread() noexcept
+{
+    // the pool and context run by this thread, if any
+    thread_local io_context_pool_thread t;
+    return t;
+}
+
+inline
+void
+pin_thread(std::thread& t, std::size_t cpu) noexcept
+{
+#if defined(__linux__)
+    auto const n = std::thread::hardware_concurrency();
+    if(n == 0)
+        return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % n, &set);
+    ::pthread_setaffinity_np(
+        t.native_handle(), sizeof(set), &set);
+#elif defined(_WIN32)
+    auto const n = std::thread::hardware_concurrency();
+    if(n == 0 || n > 8 * sizeof(DWORD_PTR))
+        return;
+    ::SetThreadAffinityMask(t.native_handle(),
+        DWORD_PTR(1) << (cpu % n));
+#else
+    boost::ignore_unused(t, cpu);
+#endif
+}
+
+} // detail
+
+//------------------------------------------------------------------------------
+
+io_context_pool::
+lease::
+~lease()
+{
+    if(pool_)
+        pool_->cores_[index_]->load.fetch_sub(
+            1, std::memory_order_relaxed);
+}
+
+io_context_pool::
+lease::
+lease(lease&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr))
+    , index_(other.index_)
+{
+}
+
+auto
+io_context_pool::
+lease::
+operator=(lease&& other) noexcept ->
+    lease&
+{
+    lease tmp(std::move(*this));
+    pool_ = std::exchange(other.pool_, nullptr);
+    index_ = other.index_;
+    return *this;
+}
+
+auto
+io_context_pool::
+lease::
+get_executor() const noexcept ->
+    executor_type
+{
+    BOOST_ASSERT(pool_);
+    return pool_->cores_[index_]->ioc.get_executor();
+}
+
+//------------------------------------------------------------------------------
+
+// Runs at most one queued task. One runner is posted for every
+// task, so every task runs even if the runner finds it was stolen.
+struct io_context_pool::runner
+{
+    io_context_pool* pool;
+    std::size_t index;
+
+    void
+    operator()() const
+    {
+        pool->run_one_task(index);
+    }
+};
+
+io_context_pool::
+io_context_pool(std::size_t size)
+    : io_context_pool([size]
+        {
+            options opt;
+            opt.size = size;
+            return opt;
+        }())
+{
+}
+
+io_context_pool::
+io_context_pool(options const& opt)
+    : opt_(opt)
+{
+    auto n = opt_.size;
+    if(n == 0)
+        n = (std::max)(1u, std::thread::hardware_concurrency());
+    cores_.reserve(n);
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        cores_.push_back(std::make_unique<core>());
+        cores_.back()->work.emplace(
+            cores_.back()->ioc.get_executor());
+    }
+}
+
+io_context_pool::
+~io_context_pool()
+{
+    stop();
+    join();
+}
+
+std::size_t
+io_context_pool::
+pick() noexcept
+{
+    if(opt_.policy == assignment::least_loaded)
+    {
+        // start at a rotating offset so ties are spread out
+        auto const n = cores_.size();
+        auto const start = next_.fetch_add(
+            1, std::memory_order_relaxed) % n;
+        auto best = start;
+        auto best_load = load(start);
+        for(std::size_t k = 1; k < n && best_load > 0; ++k)
+        {
+            auto const i = (start + k) % n;
+            auto const l = load(i);
+            if(l < best_load)
+            {
+                best = i;
+                best_load = l;
+            }
+        }
+        return best;
+    }
+    return next_.fetch_add(1,
+        std::memory_order_relaxed) % cores_.size();
+}
+
+std::size_t
+io_context_pool::
+home() noexcept
+{
+    // Only thread-local state is read here, as run
+    // may be assigning the thread objects meanwhile.
+    auto const& t = detail::this_io_context_pool_thread();
+    if(t.pool == this)
+        return t.index;
+    return next_.fetch_add(1,
+        std::memory_order_relaxed) % cores_.size();
+}
+
+auto
+io_context_pool::
+get_executor() noexcept ->
+    executor_type
+{
+    return cores_[pick()]->ioc.get_executor();
+}
+
+auto
+io_context_pool::
+acquire() noexcept ->
+    lease
+{
+    auto const i = pick();
+    cores_[i]->load.fetch_add(1, std::memory_order_relaxed);
+    return lease(*this, i);
+}
+
+void
+io_context_pool::
+push(std::function<void()> f)
+{
+    auto const i = home();
+    auto& c = *cores_[i];
+    std::size_t depth;
+    {
+        std::lock_guard<std::mutex> lock(c.m);
+        c.tasks.push_back(std::move(f));
+        depth = c.tasks.size();
+    }
+    net::post(c.ioc, runner{this, i});
+
+    // a backlog is a hint that another context should help
+    if(opt_.work_stealing && depth > 1 && cores_.size() > 1)
+    {
+        auto const j = (i + 1 + next_.fetch_add(1,
+            std::memory_order_relaxed) % (cores_.size() - 1)) %
+                cores_.size();
+        net::post(cores_[j]->ioc, runner{this, j});
+    }
+}
+
+bool
+io_context_pool::
+run_one_task(std::size_t i)
+{
+    std::function<void()> f;
+    {
+        auto& c = *cores_[i];
+        std::lock_guard<std::mutex> lock(c.m);
+        if(! c.tasks.empty())
+        {
+            f = std::move(c.tasks.front());
+            c.tasks.pop_front();
+        }
+    }
+    if(! f && opt_.work_stealing)
+    {
+        // take the newest task of the first busy context
+        auto const n = cores_.size();
+        for(std::size_t k = 1; k < n && ! f; ++k)
+        {
+            auto& c = *cores_[(i + k) % n];
+            std::lock_guard<std::mutex> lock(c.m);
+            if(! c.tasks.empty())
+            {
+                f = std::move(c.tasks.back());
+                c.tasks.pop_back();
+            }
+        }
+        if(f)
+            cores_[i]->stolen.fetch_add(
+                1, std::memory_order_relaxed);
+    }
+    if(! f)
+        return false;
+    cores_[i]->executed.fetch_add(
+        1, std::memory_order_relaxed);
+    f();
+    return true;
+}
+
+void
+io_context_pool::
+run()
+{
+    for(std::size_t i = 0; i < cores_.size(); ++i)
+    {
+        auto& c = *cores_[i];
+        if(c.thread.joinable())
+        {
+            if(! c.ioc.stopped())
+                continue;
+            // the thread is on its way out
+            c.thread.join();
+        }
+        if(c.ioc.stopped())
+            c.ioc.restart();
+        if(! c.work)
+            c.work.emplace(c.ioc.get_executor());
+        c.thread = std::thread(
+            [this, &c, i]
+            {
+                auto& t = detail::this_io_context_pool_thread();
+                t = {this, i};
+                c.ioc.run();
+                t = {};
+            });
+        if(opt_.pin_threads)
+            detail::pin_thread(c.thread, i);
+    }
+}
+
+void
+io_context_pool::
+release() noexcept
+{
+    for(auto& c : cores_)
+        c->work.reset();
+}
+
+void
+io_context_pool::
+stop() noexcept
+{
+    for(auto& c : cores_)
+    {
+        c->work.reset();
+        c->ioc.stop();
+    }
+}
+
+void
+io_context_pool::
+join()
+{
+    // A thread cannot join itself
+    BOOST_ASSERT(detail::this_io_context_pool_thread().pool != this);
+    for(auto& c : cores_)
+        if(c->thread.joinable() &&
+            c->thread.get_id() != std::this_thread::get_id())
+            c->thread.join();
+}
+
+} // beast
+} // boost
+
+#endif
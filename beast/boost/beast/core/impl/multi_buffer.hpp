@@ -13,6 +13,7 @@
 #include <boost/beast/core/buffer_traits.hpp>
 #include <boost/config/workaround.hpp>
 #include <boost/assert.hpp>
+#include <boost/core/ignore_unused.hpp>
 #include <algorithm>
 #include <exception>
 #include <iterator>
@@ -24,6 +25,24 @@
 namespace boost {
 namespace beast {
 
+namespace detail {
+
+// Determines if an allocator reports the number of objects in
+// an allocation of n objects with a member function good_size
+template<class Allocator, class = void>
+struct has_good_size : std::false_type
+{
+};
+
+template<class Allocator>
+struct has_good_size<Allocator, std::void_t<decltype(
+    std::declval<Allocator const&>().good_size(std::size_t{}))>>
+    : std::true_type
+{
+};
+
+} // detail
+
 /*  These diagrams illustrate the layout and state variables.
 
 1   Input and output contained entirely in one element:
@@ -918,7 +937,7 @@ prepare(size_type n) ->
                             in_size_ * growth_factor - in_size_),
                         512,
                         n}));
-            auto& e = alloc(size);
+            auto& e = alloc(size, max_ - total);
             list_.push_back(e);
             if(out_ == list_.end())
                 out_ = list_.iterator_to(e);
@@ -1235,6 +1254,31 @@ alloc(std::size_t size) ->
     return *(::new(p) element(size));
 }
 
+template<class Allocator>
+auto
+basic_multi_buffer<Allocator>::
+alloc(std::size_t size, std::size_t limit) ->
+    element&
+{
+    // Use all of the memory the allocator hands out, as long
+    // as the element holds at most limit bytes. Allocators
+    // which do not say how much that is get exactly size.
+    if constexpr(! detail::has_good_size<rebind_type>::value)
+    {
+        boost::ignore_unused(limit);
+        return alloc(size);
+    }
+    else
+    {
+        auto const n = rebind_type{this->get()}.good_size(
+            (sizeof(element) + size + sizeof(align_type) - 1) /
+                sizeof(align_type));
+        if(n * sizeof(align_type) - sizeof(element) > limit)
+            return alloc(size);
+        return alloc(n * sizeof(align_type) - sizeof(element));
+    }
+}
+
 template<class Allocator>
 void
 basic_multi_buffer<Allocator>::
@@ -0,0 +1,383 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_IMPL_SEGMENT_POOL_IPP
+#define BOOST_BEAST_IMPL_SEGMENT_POOL_IPP
+
+#include <boost/beast/core/segment_pool.hpp>
+#include <atomic>
+#include <new>
+
+namespace boost {
+namespace beast {
+
+// The pool of one thread. It outlives the thread while
+// any segment it allocated from the heap is still in use,
+// counting those segments and the thread in refs_.
+class segment_pool::impl
+{
+    // Placed in the usable bytes of a free segment
+    struct node
+    {
+        node* next;
+    };
+
+    // Placed in the first header_size bytes of every segment
+    struct header
+    {
+        impl* owner;
+    };
+
+    static_assert(sizeof(header) <= header_size, "");
+
+    struct size_class
+    {
+        node* head = nullptr;
+        std::size_t count = 0;
+
+        // segments freed on other threads
+        std::atomic<node*> remote{nullptr};
+    };
+
+    size_class classes_[size_classes];
+    std::atomic<std::size_t> refs_{1};
+    statistics stats_;
+
+    // Marks the remote list of a thread which has exited
+    static
+    node*
+    closed() noexcept
+    {
+        static node n{nullptr};
+        return &n;
+    }
+
+    static
+    std::size_t
+    segment_size(std::size_t k) noexcept
+    {
+        return (min_segment << k) + slack + header_size;
+    }
+
+    static
+    std::size_t
+    limit(std::size_t k) noexcept
+    {
+        return BOOST_BEAST_SEGMENT_POOL_CACHE_SIZE / segment_size(k);
+    }
+
+    static
+    void*
+    segment(node* p) noexcept
+    {
+        return reinterpret_cast<char*>(p) - header_size;
+    }
+
+    static
+    impl*&
+    owner(void* p) noexcept
+    {
+        return reinterpret_cast<header*>(
+            static_cast<char*>(p) - header_size)->owner;
+    }
+
+    void
+    release_ref() noexcept
+    {
+        if(refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+
+    // Return one segment to the heap
+    void
+    free(node* p) noexcept
+    {
+        ::operator delete(segment(p));
+        release_ref();
+    }
+
+    // Free a list of segments, returning the number of segments.
+    // The last reference to *this must not be released here.
+    std::size_t
+    free_list(node* p) noexcept
+    {
+        std::size_t n = 0;
+        while(p)
+        {
+            auto const next = p->next;
+            ::operator delete(segment(p));
+            refs_.fetch_sub(1, std::memory_order_relaxed);
+            p = next;
+            ++n;
+        }
+        return n;
+    }
+
+    void
+    free_local() noexcept
+    {
+        for(auto& c : classes_)
+        {
+            stats_.heap_frees += free_list(c.head);
+            c.head = nullptr;
+            c.count = 0;
+        }
+    }
+
+    // Take back the segments freed on other threads
+    void
+    take_remote(std::size_t k) noexcept
+    {
+        auto& c = classes_[k];
+        auto p = c.remote.exchange(
+            nullptr, std::memory_order_acquire);
+        while(p)
+        {
+            auto const next = p->next;
+            ++stats_.remote_frees;
+            if(c.count < limit(k))
+            {
+                p->next = c.head;
+                c.head = p;
+                ++c.count;
+            }
+            else
+            {
+                ::operator delete(segment(p));
+                refs_.fetch_sub(1, std::memory_order_relaxed);
+                ++stats_.heap_frees;
+            }
+            p = next;
+        }
+    }
+
+    void
+    push_remote(std::size_t k, node* p) noexcept
+    {
+        auto& remote = classes_[k].remote;
+        auto head = remote.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            if(head == closed())
+            {
+                // the owning thread has exited
+                free(p);
+                return;
+            }
+            p->next = head;
+            if(remote.compare_exchange_weak(head, p,
+                    std::memory_order_release,
+                    std::memory_order_relaxed))
+                return;
+        }
+    }
+
+    // The pool of the calling thread, or null
+    static
+    impl*&
+    current() noexcept
+    {
+        thread_local impl* p = nullptr;
+        return p;
+    }
+
+    // Set once the calling thread has destroyed its pool
+    static
+    bool&
+    exited() noexcept
+    {
+        thread_local bool b = false;
+        return b;
+    }
+
+    struct holder
+    {
+        impl* p = new impl;
+
+        ~holder()
+        {
+            // segments freed from here on, by destructors of
+            // other thread_local objects, go to the heap
+            current() = nullptr;
+            exited() = true;
+            p->close();
+        }
+    };
+
+    void
+    close() noexcept
+    {
+        free_local();
+        for(auto& c : classes_)
+            free_list(c.remote.exchange(
+                closed(), std::memory_order_acq_rel));
+        release_ref();
+    }
+
+public:
+    // Return the pool of the calling thread, creating it
+    // on first use, or null once the thread has closed it.
+    static
+    impl*
+    local()
+    {
+        // the plain pointer avoids the guard of h on every call
+        auto& p = current();
+        if(! p && ! exited())
+        {
+            thread_local holder h;
+            p = h.p;
+        }
+        return p;
+    }
+
+    static
+    std::size_t
+    size_class_of(std::size_t n) noexcept
+    {
+        std::size_t k = 0;
+        while((min_segment << k) + slack < n)
+            ++k;
+        return k;
+    }
+
+    void*
+    allocate(std::size_t k)
+    {
+        auto& c = classes_[k];
+        ++stats_.allocations;
+        if(! c.head)
+            take_remote(k);
+        if(c.head)
+        {
+            auto const p = c.head;
+            c.head = p->next;
+            --c.count;
+            ++stats_.reused;
+            return p;
+        }
+        auto const p = static_cast<char*>(
+            ::operator new(segment_size(k)));
+        reinterpret_cast<header*>(p)->owner = this;
+        refs_.fetch_add(1, std::memory_order_relaxed);
+        ++stats_.heap_allocations;
+        return p + header_size;
+    }
+
+    // Allocate a segment which no pool owns, for a
+    // thread which has already closed its pool
+    static
+    void*
+    allocate_unowned(std::size_t k)
+    {
+        auto const p = static_cast<char*>(
+            ::operator new(segment_size(k)));
+        reinterpret_cast<header*>(p)->owner = nullptr;
+        return p + header_size;
+    }
+
+    static
+    void
+    deallocate(void* p, std::size_t k) noexcept
+    {
+        auto const n = static_cast<node*>(p);
+        auto const from = owner(p);
+        if(! from)
+            return ::operator delete(segment(n));
+        // after its pool is closed the owning thread frees
+        // through the remote list, which is marked closed
+        if(from != current())
+            return from->push_remote(k, n);
+        auto& c = from->classes_[k];
+        if(c.count < limit(k))
+        {
+            n->next = c.head;
+            c.head = n;
+            ++c.count;
+            return;
+        }
+        ++from->stats_.heap_frees;
+        from->free(n);
+    }
+
+    void
+    count_oversize() noexcept
+    {
+        ++stats_.oversize;
+    }
+
+    statistics
+    stats() const noexcept
+    {
+        auto result = stats_;
+        result.cached_bytes = 0;
+        for(std::size_t k = 0; k < size_classes; ++k)
+            result.cached_bytes +=
+                classes_[k].count * segment_size(k);
+        return result;
+    }
+
+    void
+    release() noexcept
+    {
+        for(std::size_t k = 0; k < size_classes; ++k)
+            stats_.heap_frees += free_list(classes_[k].remote.exchange(
+                nullptr, std::memory_order_acquire));
+        free_local();
+    }
+};
+
+void*
+segment_pool::
+allocate(std::size_t n)
+{
+    auto const p = impl::local();
+    if(n > max_segment + slack)
+    {
+        if(p)
+            p->count_oversize();
+        return ::operator new(n);
+    }
+    if(! p)
+        return impl::allocate_unowned(
+            impl::size_class_of(n));
+    return p->allocate(impl::size_class_of(n));
+}
+
+void
+segment_pool::
+deallocate(void* p, std::size_t n) noexcept
+{
+    if(n > max_segment + slack)
+        return ::operator delete(p);
+    impl::deallocate(p, impl::size_class_of(n));
+}
+
+auto
+segment_pool::
+stats() noexcept ->
+    statistics
+{
+    if(auto const p = impl::local())
+        return p->stats();
+    return {};
+}
+
+void
+segment_pool::
+release() noexcept
+{
+    if(auto const p = impl::local())
+        p->release();
+}
+
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,136 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_IMPL_SHARDED_STATISTICS_IPP
+#define BOOST_BEAST_IMPL_SHARDED_STATISTICS_IPP
+
+#include <boost/beast/core/sharded_statistics.hpp>
+#include <algorithm>
+
+namespace boost {
+namespace beast {
+
+namespace detail {
+
+// The shards of the calling thread, by the id of their
+// object. Ids are never reused, so the entries of
+// destroyed objects are never found again, and they
+// are dropped when the thread next adds an entry.
+struct local_shard
+{
+    std::uint64_t id;
+    std::weak_ptr<void> alive;
+    sharded_statistics::shard* s;
+};
+
+inline
+std::vector<local_shard>&
+local_shards()
+{
+    thread_local std::vector<local_shard> v;
+    return v;
+}
+
+inline
+std::uint64_t
+next_statistics_id() noexcept
+{
+    static std::atomic<std::uint64_t> id{0};
+    return ++id;
+}
+
+} // detail
+
+sharded_statistics::
+shard::
+shard(std::size_t counters, std::size_t histograms)
+    : lines_(new line[(counters + line::size - 1) / line::size])
+    , histograms_(new padded_histogram[histograms])
+    , counters_(counters)
+    , nhistograms_(histograms)
+{
+}
+
+sharded_statistics::
+sharded_statistics(
+    std::size_t counters,
+    std::size_t histograms)
+    : counters_(counters)
+    , histograms_(histograms)
+    , id_(detail::next_statistics_id())
+    , alive_(std::make_shared<char>())
+{
+}
+
+std::size_t
+sharded_statistics::
+shards() const
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return shards_.size();
+}
+
+auto
+sharded_statistics::
+make_shard() ->
+    shard&
+{
+    std::unique_ptr<shard> p(new shard(counters_, histograms_));
+    std::lock_guard<std::mutex> lock(m_);
+    shards_.push_back(std::move(p));
+    return *shards_.back();
+}
+
+auto
+sharded_statistics::
+local() ->
+    shard&
+{
+    auto& v = detail::local_shards();
+    for(auto const& e : v)
+        if(e.id == id_)
+            return *e.s;
+    auto& s = make_shard();
+    v.erase(std::remove_if(v.begin(), v.end(),
+        [](detail::local_shard const& e)
+        {
+            return e.alive.expired();
+        }), v.end());
+    v.push_back({id_, alive_, &s});
+    return s;
+}
+
+std::uint64_t
+sharded_statistics::
+counter(std::size_t i) const
+{
+    BOOST_ASSERT(i < counters_);
+    std::uint64_t n = 0;
+    std::lock_guard<std::mutex> lock(m_);
+    for(auto const& s : shards_)
+        n += s->counter(i);
+    return n;
+}
+
+hdr_histogram
+sharded_statistics::
+histogram(std::size_t i) const
+{
+    BOOST_ASSERT(i < histograms_);
+    hdr_histogram h;
+    std::lock_guard<std::mutex> lock(m_);
+    for(auto const& s : shards_)
+        h.merge(s->histogram(i));
+    return h;
+}
+
+} // beast
+} // boost
+
+#endif
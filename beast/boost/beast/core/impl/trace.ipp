@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_IMPL_TRACE_IPP
+#define BOOST_BEAST_IMPL_TRACE_IPP
+
+#include <boost/beast/core/trace.hpp>
+
+namespace boost {
+namespace beast {
+
+char const*
+to_string(trace_phase phase) noexcept
+{
+    switch(phase)
+    {
+    case trace_phase::resolve:              return "resolve";
+    case trace_phase::connect:              return "connect";
+    case trace_phase::tls_handshake:        return "tls_handshake";
+    case trace_phase::write_header:         return "write_header";
+    case trace_phase::write_body:           return "write_body";
+    case trace_phase::first_byte:           return "first_byte";
+    case trace_phase::read_header:          return "read_header";
+    case trace_phase::read_body:            return "read_body";
+    case trace_phase::websocket_handshake:  return "websocket_handshake";
+    }
+    return "<unknown-trace-phase>";
+}
+
+namespace detail {
+
+tracer*&
+current_tracer() noexcept
+{
+    thread_local tracer* t = nullptr;
+    return t;
+}
+
+} // detail
+
+trace_collector::
+trace_collector(trace_collector const& other) noexcept
+    : tracer()
+{
+    merge(other);
+}
+
+void
+trace_collector::
+on_phase(
+    trace_phase phase,
+    clock_type::duration elapsed,
+    error_code const& ec)
+{
+    auto const i = static_cast<std::size_t>(phase);
+    if(ec)
+    {
+        errors_[i].store(errors_[i].load(
+            std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+        return;
+    }
+    auto const ns = std::chrono::duration_cast<
+        std::chrono::nanoseconds>(elapsed).count();
+    h_[i].record(ns > 0 ? static_cast<std::uint64_t>(ns) : 0);
+}
+
+void
+trace_collector::
+merge(trace_collector const& other) noexcept
+{
+    for(std::size_t i = 0; i < trace_phase_count; ++i)
+    {
+        h_[i].merge(other.h_[i]);
+        errors_[i].fetch_add(other.errors_[i].load(
+            std::memory_order_relaxed),
+                std::memory_order_relaxed);
+    }
+}
+
+void
+trace_collector::
+reset() noexcept
+{
+    for(std::size_t i = 0; i < trace_phase_count; ++i)
+    {
+        h_[i].reset();
+        errors_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,314 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_IO_CONTEXT_POOL_HPP
+#define BOOST_BEAST_CORE_IO_CONTEXT_POOL_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <asio/executor_work_guard.hpp>
+#include <asio/io_context.hpp>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace boost {
+namespace beast {
+
+/** A set of I/O contexts, each run by its own thread.
+
+    This class implements the thread-per-core model: instead of one
+    `net::io_context` run by many threads, which serializes every
+    thread on the scheduler mutex of that context, the pool owns one
+    context per thread. A context is only ever run by its own thread,
+    so it is constructed with a concurrency hint of one, and a stream
+    which is given the executor of a context needs no strand.
+
+    New streams are spread across the contexts either round-robin or
+    to the context with the fewest outstanding @ref lease objects.
+    Threads may optionally be pinned to distinct processors.
+
+    CPU-bound tasks submitted with @ref post run on one of the pool's
+    threads. When work stealing is enabled, a context which has no
+    queued task of its own takes one from another context, so that a
+    burst of tasks submitted to one context is shared by idle ones.
+
+    @par Example
+    @code
+    io_context_pool pool(4);
+    pool.run();
+
+    tcp_stream stream(pool.get_executor());
+    ...
+    pool.join();
+    @endcode
+
+    @par Thread Safety
+    <em>Distinct objects</em>: Safe.@n
+    <em>Shared objects</em>: Safe, except for @ref run which must not
+    be called concurrently with itself, @ref stop or @ref join.
+*/
+class io_context_pool
+{
+public:
+    /// The type of executor handed out to streams
+    using executor_type = net::io_context::executor_type;
+
+    /// How new work is assigned to a context
+    enum class assignment
+    {
+        /// Each call picks the next context in turn
+        round_robin,
+
+        /// Each call picks the context with the fewest leases
+        least_loaded
+    };
+
+    /// Options for constructing the pool
+    struct options
+    {
+        /// The number of contexts, zero for one per processor
+        std::size_t size = 0;
+
+        /// How executors are assigned by @ref get_executor
+        assignment policy = assignment::round_robin;
+
+        /// Pin the thread of context `i` to processor `i`
+        bool pin_threads = false;
+
+        /// Allow contexts to run tasks posted to other contexts
+        bool work_stealing = true;
+    };
+
+    /** A reservation of one context, counted towards its load.
+
+        A lease should be held for as long as the stream (or other
+        object) which uses its executor is alive. When the
+        assignment policy is @ref assignment::least_loaded, new
+        leases go to the context with the fewest live leases.
+    */
+    class lease
+    {
+        friend class io_context_pool;
+
+        io_context_pool* pool_ = nullptr;
+        std::size_t index_ = 0;
+
+        lease(io_context_pool& pool, std::size_t index) noexcept
+            : pool_(&pool)
+            , index_(index)
+        {
+        }
+
+    public:
+        lease() = default;
+
+        BOOST_BEAST_DECL
+        ~lease();
+
+        BOOST_BEAST_DECL
+        lease(lease&& other) noexcept;
+
+        BOOST_BEAST_DECL
+        lease& operator=(lease&& other) noexcept;
+
+        /// Returns the index of the leased context
+        std::size_t
+        index() const noexcept
+        {
+            return index_;
+        }
+
+        /// Returns the executor of the leased context
+        BOOST_BEAST_DECL
+        executor_type
+        get_executor() const noexcept;
+    };
+
+private:
+    struct core
+    {
+        net::io_context ioc{1};
+        std::optional<net::executor_work_guard<
+            executor_type>> work;
+        std::mutex m;
+        std::deque<std::function<void()>> tasks;
+        std::atomic<std::size_t> load{0};
+        std::atomic<std::size_t> executed{0};
+        std::atomic<std::size_t> stolen{0};
+        std::thread thread;
+    };
+
+    struct runner;
+
+    options opt_;
+    std::vector<std::unique_ptr<core>> cores_;
+    std::atomic<std::size_t> next_{0};
+
+    BOOST_BEAST_DECL
+    std::size_t
+    pick() noexcept;
+
+    BOOST_BEAST_DECL
+    std::size_t
+    home() noexcept;
+
+    BOOST_BEAST_DECL
+    void
+    push(std::function<void()> f);
+
+    BOOST_BEAST_DECL
+    bool
+    run_one_task(std::size_t i);
+
+public:
+    /** Constructor
+
+        @param size The number of contexts, zero for one per processor.
+    */
+    BOOST_BEAST_DECL
+    explicit
+    io_context_pool(std::size_t size = 0);
+
+    /** Constructor
+
+        @param opt The options to use.
+    */
+    BOOST_BEAST_DECL
+    explicit
+    io_context_pool(options const& opt);
+
+    /** Destructor
+
+        Stops all contexts and joins all threads.
+
+        @note The pool must not be destroyed from one of its
+        own threads.
+    */
+    BOOST_BEAST_DECL
+    ~io_context_pool();
+
+    io_context_pool(io_context_pool const&) = delete;
+    io_context_pool& operator=(io_context_pool const&) = delete;
+
+    /// Returns the number of contexts
+    std::size_t
+    size() const noexcept
+    {
+        return cores_.size();
+    }
+
+    /// Returns the context at the specified index
+    net::io_context&
+    at(std::size_t i) noexcept
+    {
+        return cores_[i]->ioc;
+    }
+
+    /// Returns the number of leases held on the context at an index
+    std::size_t
+    load(std::size_t i) const noexcept
+    {
+        return cores_[i]->load.load(
+            std::memory_order_relaxed);
+    }
+
+    /// Returns the number of posted tasks run by the context at an index
+    std::size_t
+    executed(std::size_t i) const noexcept
+    {
+        return cores_[i]->executed.load(
+            std::memory_order_relaxed);
+    }
+
+    /// Returns the number of tasks the context at an index took from others
+    std::size_t
+    stolen(std::size_t i) const noexcept
+    {
+        return cores_[i]->stolen.load(
+            std::memory_order_relaxed);
+    }
+
+    /** Returns an executor for a new stream.
+
+        The context is chosen according to the assignment policy.
+        With @ref assignment::least_loaded the choice is based on
+        the live leases, see @ref acquire.
+    */
+    BOOST_BEAST_DECL
+    executor_type
+    get_executor() noexcept;
+
+    /** Returns a lease on a context for a new stream.
+
+        The context is chosen according to the assignment policy,
+        and counts the lease towards its load until the lease is
+        destroyed.
+    */
+    BOOST_BEAST_DECL
+    lease
+    acquire() noexcept;
+
+    /** Submit a CPU-bound task to the pool.
+
+        When called from one of the pool's threads the task is queued
+        on that thread's context, otherwise on the next context in
+        turn. With work stealing enabled, another context may run it.
+        The task must not throw.
+    */
+    template<class F>
+    void
+    post(F&& f)
+    {
+        push(std::function<void()>(std::forward<F>(f)));
+    }
+
+    /** Start one thread for each context.
+
+        The threads keep running, even with no outstanding work,
+        until @ref stop is called. After @ref stop or @ref release,
+        calling this again restarts the contexts and their threads.
+    */
+    BOOST_BEAST_DECL
+    void
+    run();
+
+    /** Allow the threads to exit when their contexts run out of work.
+    */
+    BOOST_BEAST_DECL
+    void
+    release() noexcept;
+
+    /// Stop all contexts as soon as possible
+    BOOST_BEAST_DECL
+    void
+    stop() noexcept;
+
+    /** Block until all threads have exited
+
+        This must not be called from one of the pool's threads.
+    */
+    BOOST_BEAST_DECL
+    void
+    join();
+};
+
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/impl/io_context_pool.ipp>
+#endif
+
+#endif
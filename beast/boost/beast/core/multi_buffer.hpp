@@ -579,6 +579,7 @@ private:
     void destroy(const_iter it);
     void destroy(element& e);
     element& alloc(std::size_t size);
+    element& alloc(std::size_t size, std::size_t limit);
     void debug_check() const;
 };
 
@@ -11,12 +11,20 @@
 #define BOOST_BEAST_CORE_RATE_POLICY_HPP
 
 #include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/detail/token_bucket.hpp>
+#include <chrono>
+#include <concepts>
 #include <cstdint>
 #include <limits>
+#include <memory>
+#include <utility>
 
 namespace boost {
 namespace beast {
 
+template<class>
+class statistics_policy;
+
 /** Helper class to assist implementing a <em>RatePolicy</em>.
 
     This class is used by the implementation to gain access to the
@@ -44,6 +52,9 @@ private:
     template<class, class, class>
     friend class basic_stream;
 
+    template<class>
+    friend class statistics_policy;
+
     template<class Policy>
     static
     std::size_t
@@ -85,6 +96,63 @@ private:
     {
         return policy.on_timer();
     }
+
+    // A policy which declares `refill_delay` refills on demand
+    // instead of once per second, and is polled after that delay.
+    template<class Policy>
+    static constexpr bool has_refill_delay =
+        requires (Policy& policy)
+        {
+            { policy.refill_delay(true) } ->
+                std::convertible_to<std::chrono::steady_clock::duration>;
+        };
+
+    template<class Policy>
+    static
+    std::chrono::steady_clock::duration
+    refill_delay(Policy& policy, bool is_read)
+    {
+        return policy.refill_delay(is_read);
+    }
+
+    // A policy which declares `on_wait_begin`, `on_wait_end` and
+    // `on_timeout` is told when an operation starts and stops waiting
+    // for the rate limit, and when an operation times out.
+    template<class Policy>
+    static constexpr bool has_events =
+        requires (Policy& policy)
+        {
+            policy.on_wait_begin(true);
+            policy.on_wait_end(true);
+            policy.on_timeout(true);
+        };
+
+    template<class Policy>
+    static
+    void
+    on_wait_begin(Policy& policy, bool is_read)
+    {
+        if constexpr(has_events<Policy>)
+            policy.on_wait_begin(is_read);
+    }
+
+    template<class Policy>
+    static
+    void
+    on_wait_end(Policy& policy, bool is_read)
+    {
+        if constexpr(has_events<Policy>)
+            policy.on_wait_end(is_read);
+    }
+
+    template<class Policy>
+    static
+    void
+    on_timeout(Policy& policy, bool is_read)
+    {
+        if constexpr(has_events<Policy>)
+            policy.on_timeout(is_read);
+    }
 };
 
 //------------------------------------------------------------------------------
@@ -214,6 +282,253 @@ public:
     }
 };
 
+//------------------------------------------------------------------------------
+
+/** A rate policy whose limits are shared by many streams.
+
+    Every stream constructed with a copy of the same policy draws
+    from one pair of token buckets, so the limits apply to the sum
+    of all reads and all writes on those streams, for example a
+    whole tenant or process. The buckets are lock-free and may be
+    used by streams running on any number of threads.
+
+    Tokens refill continuously rather than in once-per-second slices,
+    and no per-stream timer runs while there is budget available. A
+    stream which finds the bucket empty waits just long enough for
+    one quantum to accumulate, then competes for it again. Grants
+    are capped at one quantum each, so that a large transfer cannot
+    starve the other streams in the group.
+
+    @par Example
+    @code
+    auto limits = std::make_shared<shared_rate_policy::group>();
+    limits->write_limit(10 * 1024 * 1024);
+
+    basic_stream<net::ip::tcp, net::any_io_executor,
+        shared_rate_policy> stream(shared_rate_policy(limits), ioc);
+    @endcode
+
+    @par Concepts
+
+    @li <em>RatePolicy</em>
+
+    @see beast::basic_stream
+*/
+class shared_rate_policy
+{
+public:
+    /** The limits shared by a set of streams.
+
+        Limits may be changed at any time, from any thread.
+    */
+    class group
+    {
+        friend class shared_rate_policy;
+
+        detail::token_bucket rd_;
+        detail::token_bucket wr_;
+
+        static
+        void
+        limit(
+            detail::token_bucket& b,
+            std::size_t bytes_per_second,
+            std::size_t burst,
+            std::size_t quantum) noexcept
+        {
+            if(burst == 0)
+                burst = (std::max<std::size_t>)(
+                    bytes_per_second / 10, 1);
+            if(quantum == 0)
+                quantum = (std::max<std::size_t>)(burst / 8, 1);
+            b.limit(bytes_per_second, burst,
+                (std::min)(quantum, burst));
+        }
+
+    public:
+        /** Set the limit of bytes per second to read.
+
+            @param bytes_per_second The sustained rate.
+
+            @param burst The most bytes which may be read at once
+            after an idle period. If zero, one tenth of a second
+            worth of traffic is used.
+
+            @param quantum The most bytes handed to a single read
+            operation. If zero, one eighth of the burst is used.
+        */
+        void
+        read_limit(
+            std::size_t bytes_per_second,
+            std::size_t burst = 0,
+            std::size_t quantum = 0) noexcept
+        {
+            limit(rd_, bytes_per_second, burst, quantum);
+        }
+
+        /** Set the limit of bytes per second to write.
+
+            @param bytes_per_second The sustained rate.
+
+            @param burst The most bytes which may be written at
+            once after an idle period. If zero, one tenth of a
+            second worth of traffic is used.
+
+            @param quantum The most bytes handed to a single write
+            operation. If zero, one eighth of the burst is used.
+        */
+        void
+        write_limit(
+            std::size_t bytes_per_second,
+            std::size_t burst = 0,
+            std::size_t quantum = 0) noexcept
+        {
+            limit(wr_, bytes_per_second, burst, quantum);
+        }
+
+        /// Returns the number of bytes which may be read right now
+        std::size_t
+        available_read_bytes() const noexcept
+        {
+            return rd_.available(
+                detail::token_bucket::clock_type::now());
+        }
+
+        /// Returns the number of bytes which may be written right now
+        std::size_t
+        available_write_bytes() const noexcept
+        {
+            return wr_.available(
+                detail::token_bucket::clock_type::now());
+        }
+    };
+
+private:
+    friend class rate_policy_access;
+
+    using clock_type = detail::token_bucket::clock_type;
+
+    std::shared_ptr<group> group_;
+    std::size_t rd_reserved_ = 0;
+    std::size_t wr_reserved_ = 0;
+
+    // Tokens are reserved when a stream asks how many bytes
+    // it may transfer, and the unused part is returned once the
+    // transfer completes. This keeps concurrent streams from
+    // all spending the same budget.
+
+    std::size_t
+    available_read_bytes()
+    {
+        group_->rd_.release(rd_reserved_);
+        rd_reserved_ = group_->rd_.acquire(
+            detail::token_bucket::all, clock_type::now());
+        return rd_reserved_;
+    }
+
+    std::size_t
+    available_write_bytes()
+    {
+        group_->wr_.release(wr_reserved_);
+        wr_reserved_ = group_->wr_.acquire(
+            detail::token_bucket::all, clock_type::now());
+        return wr_reserved_;
+    }
+
+    void
+    transfer_read_bytes(std::size_t n) noexcept
+    {
+        settle(group_->rd_, rd_reserved_, n);
+    }
+
+    void
+    transfer_write_bytes(std::size_t n) noexcept
+    {
+        settle(group_->wr_, wr_reserved_, n);
+    }
+
+    void
+    on_timer() noexcept
+    {
+    }
+
+    clock_type::duration
+    refill_delay(bool is_read) const noexcept
+    {
+        auto const& b = is_read ? group_->rd_ : group_->wr_;
+        return b.delay(clock_type::now(),
+            std::chrono::milliseconds(1));
+    }
+
+    static
+    void
+    settle(
+        detail::token_bucket& b,
+        std::size_t& reserved,
+        std::size_t n) noexcept
+    {
+        if(n < reserved)
+            b.release(reserved - n);
+        else if(n > reserved)
+            b.consume(n - reserved, clock_type::now());
+        reserved = 0;
+    }
+
+public:
+    /** Constructor
+
+        The policy uses a new group of its own, with no limits.
+    */
+    shared_rate_policy()
+        : group_(std::make_shared<group>())
+    {
+    }
+
+    /** Constructor
+
+        @param g The group of limits to share.
+    */
+    explicit
+    shared_rate_policy(
+        std::shared_ptr<group> g) noexcept
+        : group_(std::move(g))
+    {
+    }
+
+    /// Constructor
+    shared_rate_policy(shared_rate_policy const& other)
+        : group_(other.group_)
+    {
+    }
+
+    /// Constructor
+    shared_rate_policy(shared_rate_policy&& other) noexcept
+        : group_(std::move(other.group_))
+        , rd_reserved_(std::exchange(other.rd_reserved_, 0))
+        , wr_reserved_(std::exchange(other.wr_reserved_, 0))
+    {
+    }
+
+    shared_rate_policy& operator=(shared_rate_policy const&) = delete;
+
+    /// Destructor
+    ~shared_rate_policy()
+    {
+        if(group_)
+        {
+            group_->rd_.release(rd_reserved_);
+            group_->wr_.release(wr_reserved_);
+        }
+    }
+
+    /// Returns the group of limits used by this policy
+    group&
+    limits() const noexcept
+    {
+        return *group_;
+    }
+};
+
 } // beast
 } // boost
 
@@ -0,0 +1,203 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_RECYCLING_ALLOCATOR_HPP
+#define BOOST_BEAST_CORE_RECYCLING_ALLOCATOR_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <cstddef>
+#include <new>
+
+#ifndef BOOST_BEAST_RECYCLING_ALLOCATOR_CACHE_SIZE
+#define BOOST_BEAST_RECYCLING_ALLOCATOR_CACHE_SIZE 64
+#endif
+
+namespace boost {
+namespace beast {
+
+namespace detail {
+
+// A per-thread free list of blocks which all have the same size
+template<std::size_t Size, std::size_t Align>
+class recycling_cache
+{
+    struct node
+    {
+        node* next;
+    };
+
+    node* head_ = nullptr;
+    std::size_t count_ = 0;
+
+    static std::size_t constexpr align =
+        Align < alignof(node) ? alignof(node) : Align;
+    static std::size_t constexpr size =
+        Size < sizeof(node) ? sizeof(node) : Size;
+
+public:
+    ~recycling_cache()
+    {
+        while(head_)
+        {
+            auto const next = head_->next;
+            ::operator delete(head_, std::align_val_t(align));
+            head_ = next;
+        }
+    }
+
+    static
+    recycling_cache&
+    get() noexcept
+    {
+        thread_local recycling_cache c;
+        return c;
+    }
+
+    void*
+    allocate()
+    {
+        if(head_)
+        {
+            auto const p = head_;
+            head_ = head_->next;
+            --count_;
+            return p;
+        }
+        return ::operator new(size, std::align_val_t(align));
+    }
+
+    void
+    deallocate(void* p) noexcept
+    {
+        if(count_ >= BOOST_BEAST_RECYCLING_ALLOCATOR_CACHE_SIZE)
+        {
+            ::operator delete(p, std::align_val_t(align));
+            return;
+        }
+        head_ = ::new(p) node{head_};
+        ++count_;
+    }
+
+    std::size_t
+    size_cached() const noexcept
+    {
+        return count_;
+    }
+};
+
+} // detail
+
+/** An allocator which recycles single objects on a per-thread free list.
+
+    Allocations of exactly one object are served from, and returned
+    to, a free list owned by the calling thread, with one list for
+    each distinct object size and alignment. Memory freed on a
+    different thread than the one which allocated it goes to the
+    freeing thread's list. Each list holds at most
+    `BOOST_BEAST_RECYCLING_ALLOCATOR_CACHE_SIZE` blocks, and the
+    remainder are returned to the global heap. Allocations of
+    arrays always use the global heap.
+
+    This is useful for objects which are created and destroyed at
+    a high rate, such as the shared state of a @ref basic_stream
+    used for short-lived connections.
+
+    @par Example
+    @code
+    tcp_stream stream(std::allocator_arg,
+        recycling_allocator<void>{}, ioc);
+    @endcode
+*/
+template<class T>
+class recycling_allocator
+{
+    template<class U>
+    using cache = detail::recycling_cache<
+        sizeof(U), alignof(U)>;
+
+public:
+    using value_type = T;
+
+    template<class U>
+    struct rebind
+    {
+        using other = recycling_allocator<U>;
+    };
+
+    recycling_allocator() = default;
+
+    template<class U>
+    recycling_allocator(
+        recycling_allocator<U> const&) noexcept
+    {
+    }
+
+    T*
+    allocate(std::size_t n)
+    {
+        if(n == 1)
+            return static_cast<T*>(
+                cache<T>::get().allocate());
+        return static_cast<T*>(::operator new(
+            n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        if(n == 1)
+            return cache<T>::get().deallocate(p);
+        ::operator delete(p, std::align_val_t(alignof(T)));
+    }
+
+    /// Returns the number of blocks cached for `U` on the calling thread
+    template<class U = T>
+    static
+    std::size_t
+    cached() noexcept
+    {
+        return cache<U>::get().size_cached();
+    }
+
+    template<class U>
+    friend
+    bool
+    operator==(
+        recycling_allocator const&,
+        recycling_allocator<U> const&) noexcept
+    {
+        return true;
+    }
+};
+
+template<>
+class recycling_allocator<void>
+{
+public:
+    using value_type = void;
+
+    template<class U>
+    struct rebind
+    {
+        using other = recycling_allocator<U>;
+    };
+
+    recycling_allocator() = default;
+
+    template<class U>
+    recycling_allocator(
+        recycling_allocator<U> const&) noexcept
+    {
+    }
+};
+
+} // beast
+} // boost
+
+#endif
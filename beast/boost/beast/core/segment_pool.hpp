@@ -0,0 +1,240 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_SEGMENT_POOL_HPP
+#define BOOST_BEAST_CORE_SEGMENT_POOL_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/multi_buffer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#ifndef BOOST_BEAST_SEGMENT_POOL_CACHE_SIZE
+#define BOOST_BEAST_SEGMENT_POOL_CACHE_SIZE (1024 * 1024)
+#endif
+
+namespace boost {
+namespace beast {
+
+/** A per-thread pool of fixed size memory segments.
+
+    Requests for up to @ref max_segment bytes are rounded up to one
+    of a small number of size classes, the powers of two from
+    @ref min_segment to @ref max_segment, which match the sizes
+    commonly used to read from sockets. Each segment also has room
+    for the bookkeeping of a container element, so that an element
+    holding a whole read of one of these sizes takes one segment
+    of that size. Each thread owns a free list
+    for every size class, holding up to
+    `BOOST_BEAST_SEGMENT_POOL_CACHE_SIZE` bytes, and the remainder
+    are returned to the global heap. Larger requests always use the
+    global heap.
+
+    A segment which is freed on a thread other than the one which
+    allocated it is returned to the allocating thread, which takes
+    it back the next time it allocates a segment of that size. When
+    a thread exits, the segments it owns which are still in use are
+    released to the global heap as they are freed.
+
+    All functions are static, and operate on the pool of the
+    calling thread. Use @ref segment_allocator to draw the storage
+    of containers, such as @ref basic_multi_buffer, from the pool.
+*/
+class segment_pool
+{
+public:
+    /// The size of the smallest segment, in bytes
+    static std::size_t constexpr min_segment = 4096;
+
+    /// The size of the largest segment, in bytes
+    static std::size_t constexpr max_segment = 65536;
+
+    /// The number of segment sizes
+    static std::size_t constexpr size_classes = 5;
+
+    /// Counters describing the activity of the pool on one thread
+    struct statistics
+    {
+        /// The number of segments allocated
+        std::uint64_t allocations = 0;
+
+        /// The number of segments allocated from a free list
+        std::uint64_t reused = 0;
+
+        /// The number of segments freed on a different thread and returned
+        std::uint64_t remote_frees = 0;
+
+        /// The number of segments allocated from the global heap
+        std::uint64_t heap_allocations = 0;
+
+        /// The number of segments returned to the global heap
+        std::uint64_t heap_frees = 0;
+
+        /// The number of requests too large for a segment
+        std::uint64_t oversize = 0;
+
+        /// The number of bytes of memory held on the free lists
+        std::size_t cached_bytes = 0;
+    };
+
+    /** Return the number of bytes which would be allocated for a request.
+
+        @param n The number of bytes requested.
+
+        @return The number of usable bytes, which is at least `n`.
+    */
+    static
+    std::size_t
+    good_size(std::size_t n) noexcept
+    {
+        if(n > max_segment + slack)
+            return n;
+        auto size = min_segment;
+        while(size + slack < n)
+            size *= 2;
+        return size + slack;
+    }
+
+    /** Allocate memory.
+
+        @param n The number of bytes requested. The memory is
+        aligned suitably for any fundamental type.
+
+        @throws std::bad_alloc if the memory cannot be allocated.
+    */
+    BOOST_BEAST_DECL
+    static
+    void*
+    allocate(std::size_t n);
+
+    /** Free memory.
+
+        @param p A pointer returned by @ref allocate.
+
+        @param n The number of bytes passed to @ref allocate.
+    */
+    BOOST_BEAST_DECL
+    static
+    void
+    deallocate(void* p, std::size_t n) noexcept;
+
+    /// Return the statistics of the calling thread's pool
+    BOOST_BEAST_DECL
+    static
+    statistics
+    stats() noexcept;
+
+    /** Return the free lists of the calling thread to the global heap.
+
+        Segments freed on other threads and not yet taken back
+        are also released.
+    */
+    BOOST_BEAST_DECL
+    static
+    void
+    release() noexcept;
+
+private:
+    // Extra usable bytes in every segment
+    static std::size_t constexpr slack = 48;
+
+    // Precedes every segment, and keeps the
+    // remainder aligned for any fundamental type
+    static std::size_t constexpr header_size =
+        alignof(std::max_align_t) < sizeof(void*) ?
+            sizeof(void*) : alignof(std::max_align_t);
+
+    class impl;
+};
+
+/** An allocator which draws memory from the @ref segment_pool.
+
+    Allocations which fit in a segment are served from the calling
+    thread's pool, and may be freed on any thread. This allocator
+    also reports the usable size of an allocation through the
+    member function `good_size`, which @ref basic_multi_buffer
+    uses to make each of its elements fill a whole segment.
+
+    @par Example
+    @code
+    http::response<http::basic_dynamic_body<pooled_multi_buffer>> res;
+    @endcode
+
+    @see pooled_multi_buffer
+*/
+template<class T>
+class segment_allocator
+{
+public:
+    using value_type = T;
+
+    template<class U>
+    struct rebind
+    {
+        using other = segment_allocator<U>;
+    };
+
+    segment_allocator() = default;
+
+    template<class U>
+    segment_allocator(
+        segment_allocator<U> const&) noexcept
+    {
+    }
+
+    T*
+    allocate(std::size_t n)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+            "Over-aligned types are not supported");
+        if(n > static_cast<std::size_t>(-1) / sizeof(T))
+            throw std::bad_array_new_length{};
+        return static_cast<T*>(
+            segment_pool::allocate(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        segment_pool::deallocate(p, n * sizeof(T));
+    }
+
+    /// Returns the number of objects which fit in an allocation of `n` objects
+    std::size_t
+    good_size(std::size_t n) const noexcept
+    {
+        if(n > static_cast<std::size_t>(-1) / sizeof(T))
+            return n;
+        return segment_pool::good_size(n * sizeof(T)) / sizeof(T);
+    }
+
+    template<class U>
+    friend
+    bool
+    operator==(
+        segment_allocator const&,
+        segment_allocator<U> const&) noexcept
+    {
+        return true;
+    }
+};
+
+/// A multi_buffer whose elements are segments from the @ref segment_pool
+using pooled_multi_buffer =
+    basic_multi_buffer<segment_allocator<char>>;
+
+} // beast
+} // boost
+
+#if BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/impl/segment_pool.ipp>
+#endif
+
+#endif
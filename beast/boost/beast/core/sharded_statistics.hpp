@@ -0,0 +1,241 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_SHARDED_STATISTICS_HPP
+#define BOOST_BEAST_CORE_SHARDED_STATISTICS_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/hdr_histogram.hpp>
+#include <boost/assert.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace boost {
+namespace beast {
+
+/** Counters and histograms which many threads update without contention.
+
+    The statistics are divided into shards, each written by a single
+    thread, so that updating them takes no lock, no read-modify-write
+    instruction, and no cache line shared with another thread. The
+    counters and histograms of all the shards are added together only
+    when they are read, which may be done at any time from any thread.
+
+    Counters and histograms are identified by their index, usually
+    the value of an enumeration, and their numbers are fixed when
+    the object is constructed. Histogram values are recorded in an
+    @ref hdr_histogram.
+
+    A thread obtains its shard either by calling @ref local, which
+    finds or creates the shard of the calling thread, or by keeping
+    the reference returned by @ref make_shard, which avoids looking
+    it up on each update.
+
+    @par Example
+    @code
+    enum { requests, failures, counter_count };
+    enum { latency, histogram_count };
+
+    sharded_statistics stats(counter_count, histogram_count);
+
+    // on any thread
+    auto& s = stats.local();
+    s.add(requests);
+    s.record(latency, ns);
+
+    // on any thread, at any time
+    std::cout << stats.counter(requests) << " requests, p99 " <<
+        stats.histogram(latency).value_at_percentile(99) << " ns\n";
+    @endcode
+
+    @par Thread Safety
+    <em>Distinct objects</em>: Safe.@n
+    <em>Shared objects</em>: Safe, except that a @ref shard must only
+    be updated by one thread at a time.
+*/
+class sharded_statistics
+{
+public:
+    /// The size of the cache lines which shards do not share
+    static std::size_t constexpr cache_line_size = 64;
+
+    /** The counters and histograms updated by one thread.
+
+        Updates are relaxed stores, which threads reading the
+        statistics observe without synchronization.
+    */
+    class alignas(cache_line_size) shard
+    {
+        // a line of counters, so that no other
+        // allocation shares the line
+        struct alignas(cache_line_size) line
+        {
+            static std::size_t constexpr size =
+                cache_line_size / sizeof(std::atomic<std::uint64_t>);
+
+            std::atomic<std::uint64_t> v[size] = {};
+        };
+
+        struct alignas(cache_line_size) padded_histogram
+        {
+            hdr_histogram h;
+        };
+
+        std::unique_ptr<line[]> lines_;
+        std::unique_ptr<padded_histogram[]> histograms_;
+        std::size_t counters_;
+        std::size_t nhistograms_;
+
+        friend class sharded_statistics;
+
+        BOOST_BEAST_DECL
+        shard(std::size_t counters, std::size_t histograms);
+
+        std::atomic<std::uint64_t>&
+        at(std::size_t i) const noexcept
+        {
+            return lines_[i / line::size].v[i % line::size];
+        }
+
+    public:
+        shard(shard const&) = delete;
+        shard& operator=(shard const&) = delete;
+
+        /** Add to a counter.
+
+            @param i The index of the counter.
+
+            @param n The amount to add.
+        */
+        void
+        add(std::size_t i, std::uint64_t n = 1) noexcept
+        {
+            BOOST_ASSERT(i < counters_);
+            auto& c = at(i);
+            c.store(c.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+        }
+
+        /** Record a value in a histogram.
+
+            @param i The index of the histogram.
+
+            @param v The value to record.
+        */
+        void
+        record(std::size_t i, std::uint64_t v) noexcept
+        {
+            BOOST_ASSERT(i < nhistograms_);
+            histograms_[i].h.record(v);
+        }
+
+        /// Returns the value of a counter in this shard
+        std::uint64_t
+        counter(std::size_t i) const noexcept
+        {
+            BOOST_ASSERT(i < counters_);
+            return at(i).load(std::memory_order_relaxed);
+        }
+
+        /// Returns a histogram of this shard
+        hdr_histogram const&
+        histogram(std::size_t i) const noexcept
+        {
+            BOOST_ASSERT(i < nhistograms_);
+            return histograms_[i].h;
+        }
+    };
+
+private:
+    std::size_t counters_;
+    std::size_t histograms_;
+    std::uint64_t id_;
+    std::shared_ptr<void> alive_;   // expires on destruction
+    mutable std::mutex m_;
+    std::vector<std::unique_ptr<shard>> shards_;
+
+public:
+    /** Constructor
+
+        @param counters The number of counters.
+
+        @param histograms The number of histograms.
+    */
+    BOOST_BEAST_DECL
+    explicit
+    sharded_statistics(
+        std::size_t counters,
+        std::size_t histograms = 0);
+
+    sharded_statistics(sharded_statistics const&) = delete;
+    sharded_statistics& operator=(sharded_statistics const&) = delete;
+
+    /// Returns the number of counters
+    std::size_t
+    counters() const noexcept
+    {
+        return counters_;
+    }
+
+    /// Returns the number of histograms
+    std::size_t
+    histograms() const noexcept
+    {
+        return histograms_;
+    }
+
+    /// Returns the number of shards
+    BOOST_BEAST_DECL
+    std::size_t
+    shards() const;
+
+    /** Create a shard.
+
+        The shard lives as long as this object. It must only be
+        updated by one thread at a time, usually by the thread
+        which created it.
+    */
+    BOOST_BEAST_DECL
+    shard&
+    make_shard();
+
+    /** Returns the shard of the calling thread.
+
+        The shard is created on the first call from each thread.
+        Each thread remembers its shard of every live object it
+        has used, in a few bytes which are released when the
+        thread exits or after the object is destroyed.
+    */
+    BOOST_BEAST_DECL
+    shard&
+    local();
+
+    /// Returns the sum of a counter over all the shards
+    BOOST_BEAST_DECL
+    std::uint64_t
+    counter(std::size_t i) const;
+
+    /// Returns the values recorded in a histogram by all the shards
+    BOOST_BEAST_DECL
+    hdr_histogram
+    histogram(std::size_t i) const;
+};
+
+} // beast
+} // boost
+
+#if BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/impl/sharded_statistics.ipp>
+#endif
+
+#endif
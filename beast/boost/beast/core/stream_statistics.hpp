@@ -0,0 +1,393 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_STREAM_STATISTICS_HPP
+#define BOOST_BEAST_CORE_STREAM_STATISTICS_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/rate_policy.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace boost {
+namespace beast {
+
+/** Counters describing the I/O performed on a stream.
+
+    Objects of this type are collected by @ref statistics_policy,
+    and may be added together to aggregate the statistics of many
+    streams.
+
+    @see statistics_policy, stream_statistics_group
+*/
+struct stream_statistics
+{
+    /// The type of clock used to measure time spent waiting
+    using clock_type = std::chrono::steady_clock;
+
+    /// The number of bytes read
+    std::uint64_t bytes_read = 0;
+
+    /// The number of bytes written
+    std::uint64_t bytes_written = 0;
+
+    /** The number of reads performed on the socket
+
+        Only reads which transferred bytes are counted, so that
+        timeouts, end of file and cancellations do not lower
+        @ref average_read_size.
+    */
+    std::uint64_t reads = 0;
+
+    /** The number of writes performed on the socket
+
+        Only writes which transferred bytes are counted.
+    */
+    std::uint64_t writes = 0;
+
+    /// The number of reads which completed with @ref error::timeout
+    std::uint64_t read_timeouts = 0;
+
+    /** The number of writes which completed with @ref error::timeout
+
+        A timeout of `async_connect` is counted here.
+    */
+    std::uint64_t write_timeouts = 0;
+
+    /// The number of times an operation waited for the rate limit
+    std::uint64_t rate_limit_waits = 0;
+
+    /// The total time operations spent waiting for the rate limit
+    clock_type::duration rate_limit_wait_time{};
+
+    /// Returns the average number of bytes per read
+    double
+    average_read_size() const noexcept
+    {
+        return reads ? static_cast<double>(bytes_read) / reads : 0;
+    }
+
+    /// Returns the average number of bytes per write
+    double
+    average_write_size() const noexcept
+    {
+        return writes ? static_cast<double>(bytes_written) / writes : 0;
+    }
+
+    /// Add the counters of another object to this one
+    stream_statistics&
+    operator+=(stream_statistics const& other) noexcept
+    {
+        bytes_read += other.bytes_read;
+        bytes_written += other.bytes_written;
+        reads += other.reads;
+        writes += other.writes;
+        read_timeouts += other.read_timeouts;
+        write_timeouts += other.write_timeouts;
+        rate_limit_waits += other.rate_limit_waits;
+        rate_limit_wait_time += other.rate_limit_wait_time;
+        return *this;
+    }
+
+    /// Returns the sum of the counters of two objects
+    friend
+    stream_statistics
+    operator+(
+        stream_statistics lhs,
+        stream_statistics const& rhs) noexcept
+    {
+        return lhs += rhs;
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** Totals of the statistics of many streams.
+
+    A group accumulates the statistics of each @ref statistics_policy
+    constructed with it when the policy is destroyed, that is, when
+    the last reference to the stream's state goes away. The totals
+    are lock-free and may be read and added to from any thread.
+
+    To include streams which are still open, add their statistics
+    to the value returned by @ref total.
+
+    @par Example
+    @code
+    auto totals = std::make_shared<stream_statistics_group>();
+
+    basic_stream<net::ip::tcp, net::any_io_executor,
+        statistics_policy<>> stream(statistics_policy<>(totals), ioc);
+    ...
+    stream_statistics const s = totals->total() + stream.statistics();
+    @endcode
+*/
+class stream_statistics_group
+{
+    std::atomic<std::uint64_t> bytes_read_{0};
+    std::atomic<std::uint64_t> bytes_written_{0};
+    std::atomic<std::uint64_t> reads_{0};
+    std::atomic<std::uint64_t> writes_{0};
+    std::atomic<std::uint64_t> read_timeouts_{0};
+    std::atomic<std::uint64_t> write_timeouts_{0};
+    std::atomic<std::uint64_t> rate_limit_waits_{0};
+    std::atomic<stream_statistics::clock_type::rep>
+        rate_limit_wait_time_{0};
+
+public:
+    /// Add statistics to the totals
+    void
+    add(stream_statistics const& s) noexcept
+    {
+        auto constexpr relaxed = std::memory_order_relaxed;
+        bytes_read_.fetch_add(s.bytes_read, relaxed);
+        bytes_written_.fetch_add(s.bytes_written, relaxed);
+        reads_.fetch_add(s.reads, relaxed);
+        writes_.fetch_add(s.writes, relaxed);
+        read_timeouts_.fetch_add(s.read_timeouts, relaxed);
+        write_timeouts_.fetch_add(s.write_timeouts, relaxed);
+        rate_limit_waits_.fetch_add(s.rate_limit_waits, relaxed);
+        rate_limit_wait_time_.fetch_add(
+            s.rate_limit_wait_time.count(), relaxed);
+    }
+
+    /** Returns the totals.
+
+        Each counter is read individually, so while other threads
+        are adding to the group, the result may include part of
+        their additions.
+    */
+    stream_statistics
+    total() const noexcept
+    {
+        auto constexpr relaxed = std::memory_order_relaxed;
+        stream_statistics s;
+        s.bytes_read = bytes_read_.load(relaxed);
+        s.bytes_written = bytes_written_.load(relaxed);
+        s.reads = reads_.load(relaxed);
+        s.writes = writes_.load(relaxed);
+        s.read_timeouts = read_timeouts_.load(relaxed);
+        s.write_timeouts = write_timeouts_.load(relaxed);
+        s.rate_limit_waits = rate_limit_waits_.load(relaxed);
+        s.rate_limit_wait_time = stream_statistics::clock_type::duration(
+            rate_limit_wait_time_.load(relaxed));
+        return s;
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** A rate policy which collects statistics about a stream.
+
+    This policy counts the bytes and operations of the asynchronous
+    reads and writes performed by a @ref basic_stream, the timeouts
+    of those operations, and the time they spend waiting for the
+    rate limit. The limits themselves are applied by another rate
+    policy, which this one wraps.
+
+    Streams whose rate policy is not a statistics policy do not
+    collect anything and pay nothing for this feature. The counters
+    of a stream are plain integers, updated by the operations of the
+    stream, and are read through @ref basic_stream::statistics.
+
+    Synchronous reads and writes, which bypass the rate policy, are
+    not counted.
+
+    @par Example
+    @code
+    basic_stream<net::ip::tcp, net::any_io_executor,
+        statistics_policy<simple_rate_policy>> stream(ioc);
+    stream.rate_policy().rate_policy().read_limit(10000);
+    ...
+    std::cout << stream.statistics().average_read_size();
+    @endcode
+
+    @tparam RatePolicy The rate policy which applies the limits.
+
+    @par Concepts
+
+    @li <em>RatePolicy</em>
+
+    @see basic_stream, stream_statistics, stream_statistics_group
+*/
+template<class RatePolicy = unlimited_rate_policy>
+class statistics_policy
+{
+    friend class rate_policy_access;
+
+    using clock_type = stream_statistics::clock_type;
+
+    [[no_unique_address]] RatePolicy policy_;
+    stream_statistics stats_;
+    clock_type::time_point read_wait_;
+    clock_type::time_point write_wait_;
+    std::shared_ptr<stream_statistics_group> group_;
+
+    std::size_t
+    available_read_bytes()
+    {
+        return rate_policy_access::available_read_bytes(policy_);
+    }
+
+    std::size_t
+    available_write_bytes()
+    {
+        return rate_policy_access::available_write_bytes(policy_);
+    }
+
+    void
+    transfer_read_bytes(std::size_t n)
+    {
+        if(n > 0)
+            ++stats_.reads;
+        stats_.bytes_read += n;
+        rate_policy_access::transfer_read_bytes(policy_, n);
+    }
+
+    void
+    transfer_write_bytes(std::size_t n)
+    {
+        if(n > 0)
+            ++stats_.writes;
+        stats_.bytes_written += n;
+        rate_policy_access::transfer_write_bytes(policy_, n);
+    }
+
+    void
+    on_timer()
+    {
+        rate_policy_access::on_timer(policy_);
+    }
+
+    clock_type::duration
+    refill_delay(bool is_read)
+        requires rate_policy_access::has_refill_delay<RatePolicy>
+    {
+        return rate_policy_access::refill_delay(policy_, is_read);
+    }
+
+    void
+    on_wait_begin(bool is_read) noexcept
+    {
+        ++stats_.rate_limit_waits;
+        (is_read ? read_wait_ : write_wait_) = clock_type::now();
+    }
+
+    void
+    on_wait_end(bool is_read) noexcept
+    {
+        stats_.rate_limit_wait_time += clock_type::now() -
+            (is_read ? read_wait_ : write_wait_);
+    }
+
+    void
+    on_timeout(bool is_read) noexcept
+    {
+        ++(is_read ? stats_.read_timeouts : stats_.write_timeouts);
+    }
+
+public:
+    /// Constructor
+    statistics_policy() = default;
+
+    /** Constructor
+
+        @param policy The rate policy which applies the limits.
+    */
+    explicit
+    statistics_policy(RatePolicy policy)
+        : policy_(std::move(policy))
+    {
+    }
+
+    /** Constructor
+
+        @param group The group to which the statistics are added
+        when this object is destroyed.
+
+        @param policy The rate policy which applies the limits.
+    */
+    explicit
+    statistics_policy(
+        std::shared_ptr<stream_statistics_group> group,
+        RatePolicy policy = {})
+        : policy_(std::move(policy))
+        , group_(std::move(group))
+    {
+    }
+
+    /** Constructor
+
+        The new object shares the group of `other`, and starts
+        with no statistics of its own.
+    */
+    statistics_policy(statistics_policy const& other)
+        : policy_(other.policy_)
+        , group_(other.group_)
+    {
+    }
+
+    /** Constructor
+
+        The statistics and the group are moved to the new object.
+    */
+    statistics_policy(statistics_policy&& other) noexcept(
+        std::is_nothrow_move_constructible<RatePolicy>::value)
+        : policy_(std::move(other.policy_))
+        , stats_(std::exchange(other.stats_, {}))
+        , group_(std::move(other.group_))
+    {
+    }
+
+    statistics_policy& operator=(statistics_policy const&) = delete;
+
+    /// Destructor
+    ~statistics_policy()
+    {
+        if(group_)
+            group_->add(stats_);
+    }
+
+    /// Returns the statistics collected so far
+    stream_statistics const&
+    statistics() const noexcept
+    {
+        return stats_;
+    }
+
+    /// Returns the rate policy which applies the limits
+    RatePolicy&
+    rate_policy() noexcept
+    {
+        return policy_;
+    }
+
+    /// Returns the rate policy which applies the limits
+    RatePolicy const&
+    rate_policy() const noexcept
+    {
+        return policy_;
+    }
+
+    /// Returns the group of this object, which may be null
+    std::shared_ptr<stream_statistics_group> const&
+    group() const noexcept
+    {
+        return group_;
+    }
+};
+
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,377 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_TRACE_HPP
+#define BOOST_BEAST_CORE_TRACE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/hdr_histogram.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace boost {
+namespace beast {
+
+/** The phases of a connection whose latency is traced.
+
+    @see tracer
+*/
+enum class trace_phase
+{
+    /** Resolving a host name.
+
+        Beast does not resolve names, so this phase is only
+        reported by callers, using a @ref trace_span.
+    */
+    resolve,
+
+    /// `basic_stream::async_connect`
+    connect,
+
+    /// `ssl_stream::async_handshake`
+    tls_handshake,
+
+    /** Writing the header of an HTTP message.
+
+        This ends when the last byte of the header has been
+        written. A header and a small body are often written
+        by the same call, and then the body takes no time.
+    */
+    write_header,
+
+    /// Writing the body of an HTTP message, after its header
+    write_body,
+
+    /** Waiting for the first byte of an HTTP message.
+
+        This is the time to first byte: from the start of a read
+        on an empty buffer until some of the message arrives.
+    */
+    first_byte,
+
+    /** Reading and parsing the header of an HTTP message.
+
+        This begins with the first byte of the message, or with
+        the read when the buffer already holds some of it.
+    */
+    read_header,
+
+    /// Reading the body of an HTTP message, after its header
+    read_body,
+
+    /// `websocket::stream::async_handshake`, including its HTTP phases
+    websocket_handshake
+};
+
+/// The number of values of @ref trace_phase
+std::size_t constexpr trace_phase_count = 9;
+
+/// Returns the name of a phase, such as "first_byte"
+BOOST_BEAST_DECL
+char const*
+to_string(trace_phase phase) noexcept;
+
+//------------------------------------------------------------------------------
+
+/** An interface to receive the duration of traced phases.
+
+    Asynchronous operations which begin while a tracer is installed
+    on the calling thread with @ref set_tracer or @ref scoped_tracer
+    measure the time spent in each of their phases. When a phase
+    ends, its duration is reported to the tracer installed on the
+    thread which ends it, if any. Operations which begin without a
+    tracer do not read the clock.
+
+    A tracer is called from the threads on which it is installed,
+    from within completion handlers, and should return quickly.
+
+    @see trace_collector, trace_phase, trace_span
+*/
+class tracer
+{
+public:
+    /// The clock used to measure phases
+    using clock_type = std::chrono::steady_clock;
+
+    /// Destructor
+    virtual ~tracer() = default;
+
+    /** Called when a phase ends.
+
+        @param phase The phase which ended.
+
+        @param elapsed The duration of the phase.
+
+        @param ec The error, if any, which ended the phase.
+    */
+    virtual
+    void
+    on_phase(
+        trace_phase phase,
+        clock_type::duration elapsed,
+        error_code const& ec) = 0;
+};
+
+namespace detail {
+
+BOOST_BEAST_DECL
+tracer*&
+current_tracer() noexcept;
+
+} // detail
+
+/// Returns the tracer installed on the calling thread, or `nullptr`
+inline
+tracer*
+get_tracer() noexcept
+{
+    return detail::current_tracer();
+}
+
+/** Install a tracer on the calling thread.
+
+    @param t The tracer to install, or `nullptr` to stop tracing.
+    The tracer must outlive its installation.
+
+    @return The tracer previously installed.
+*/
+inline
+tracer*
+set_tracer(tracer* t) noexcept
+{
+    auto& cur = detail::current_tracer();
+    auto const prev = cur;
+    cur = t;
+    return prev;
+}
+
+/** Install a tracer on the calling thread for the lifetime of this object.
+
+    @par Example
+    @code
+    trace_collector collector;
+    {
+        scoped_tracer st(collector);
+        ioc.run();
+    }
+    std::cout << collector.histogram(trace_phase::first_byte).value_at_percentile(99);
+    @endcode
+*/
+class scoped_tracer
+{
+    tracer* prev_;
+
+public:
+    /// Constructor
+    explicit
+    scoped_tracer(tracer& t) noexcept
+        : prev_(set_tracer(&t))
+    {
+    }
+
+    scoped_tracer(scoped_tracer const&) = delete;
+    scoped_tracer& operator=(scoped_tracer const&) = delete;
+
+    /// Destructor
+    ~scoped_tracer()
+    {
+        set_tracer(prev_);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** Measures a phase and reports it to the installed tracer.
+
+    A span started without a tracer installed on the calling
+    thread is inactive, and reports nothing. Operations hold a
+    span to measure their phases; callers may use one to trace
+    phases which Beast does not perform, such as resolving.
+
+    @par Example
+    @code
+    trace_span span;
+    resolver.async_resolve(host, port,
+        [span](error_code ec, tcp::resolver::results_type results) mutable
+        {
+            span.finish(trace_phase::resolve, ec);
+            ...
+        });
+    @endcode
+*/
+class trace_span
+{
+    using clock_type = tracer::clock_type;
+
+    // the epoch when inactive
+    clock_type::time_point start_;
+
+public:
+    /** Constructor
+
+        @param enable `false` to construct an inactive span.
+    */
+    explicit
+    trace_span(bool enable = true) noexcept
+    {
+        if(enable)
+            start();
+    }
+
+    /// Returns `true` if the span is measuring a phase
+    bool
+    active() const noexcept
+    {
+        return start_ != clock_type::time_point{};
+    }
+
+    /** Start measuring a phase.
+
+        The span becomes inactive if there is no tracer
+        installed on the calling thread.
+    */
+    void
+    start() noexcept
+    {
+        start_ = get_tracer() ?
+            clock_type::now() : clock_type::time_point{};
+    }
+
+    /** Report the phase, and start measuring the next one.
+
+        Nothing happens if the span is inactive.
+    */
+    void
+    lap(trace_phase phase, error_code const& ec = {})
+    {
+        if(! active())
+            return;
+        auto const now = clock_type::now();
+        if(auto const t = get_tracer())
+            t->on_phase(phase, now - start_, ec);
+        start_ = now;
+    }
+
+    /** Report the phase, and make the span inactive.
+
+        Nothing happens if the span is inactive.
+    */
+    void
+    finish(trace_phase phase, error_code const& ec = {})
+    {
+        if(! active())
+            return;
+        if(auto const t = get_tracer())
+            t->on_phase(phase, clock_type::now() - start_, ec);
+        start_ = {};
+    }
+
+    /// Make the span inactive without reporting
+    void
+    cancel() noexcept
+    {
+        start_ = {};
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** A tracer which counts the durations of each phase in histograms.
+
+    The duration of each phase which ends without an error is
+    recorded in nanoseconds, in a @ref hdr_histogram for the phase.
+    Phases which end with an error are counted separately.
+
+    Recording is lock-free, and a collector has a single writer:
+    it should be installed on one thread only. To trace several
+    threads, install a collector on each and merge them into
+    another when reporting, which may be done while they are in
+    use.
+
+    @par Example
+    @code
+    io_context_pool pool(4);
+    std::vector<trace_collector> collectors(pool.size());
+    for(std::size_t i = 0; i < pool.size(); ++i)
+        net::post(pool.at(i), [&collectors, i]{ set_tracer(&collectors[i]); });
+    pool.run();
+    ...
+    trace_collector total;
+    for(auto const& c : collectors)
+        total.merge(c);
+    @endcode
+*/
+class trace_collector : public tracer
+{
+    hdr_histogram h_[trace_phase_count];
+    std::atomic<std::uint64_t> errors_[trace_phase_count] = {};
+
+public:
+    /// Constructor
+    trace_collector() = default;
+
+    /// Constructor
+    BOOST_BEAST_DECL
+    trace_collector(trace_collector const& other) noexcept;
+
+    trace_collector& operator=(trace_collector const&) = delete;
+
+    /// Record the duration of a phase
+    BOOST_BEAST_DECL
+    void
+    on_phase(
+        trace_phase phase,
+        clock_type::duration elapsed,
+        error_code const& ec) override;
+
+    /// Returns the durations, in nanoseconds, of a phase which succeeded
+    hdr_histogram const&
+    histogram(trace_phase phase) const noexcept
+    {
+        return h_[static_cast<std::size_t>(phase)];
+    }
+
+    /// Returns the number of times a phase ended with an error
+    std::uint64_t
+    errors(trace_phase phase) const noexcept
+    {
+        return errors_[static_cast<std::size_t>(
+            phase)].load(std::memory_order_relaxed);
+    }
+
+    /** Add the phases recorded by another collector to this one.
+
+        This must not be called concurrently with the recording
+        of phases by this collector.
+    */
+    BOOST_BEAST_DECL
+    void
+    merge(trace_collector const& other) noexcept;
+
+    /** Remove all recorded phases.
+
+        This must not be called concurrently with the recording
+        of phases by this collector.
+    */
+    BOOST_BEAST_DECL
+    void
+    reset() noexcept;
+};
+
+} // beast
+} // boost
+
+#if BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/impl/trace.ipp>
+#endif
+
+#endif
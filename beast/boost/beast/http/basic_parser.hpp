@@ -12,12 +12,14 @@
 
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/core/error.hpp>
+#include <boost/beast/core/span.hpp>
 #include <boost/beast/core/string.hpp>
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/verb.hpp>
 #include <boost/beast/http/detail/basic_parser.hpp>
 #include <asio/buffer.hpp>
 #include <boost/assert.hpp>
+#include <boost/core/ignore_unused.hpp>
 #include <limits>
 #include <memory>
 #include <optional>
@@ -318,6 +320,13 @@ public:
         header_limit_ = v;
     }
 
+    /// Returns the limit on the total size of the header
+    std::uint32_t
+    header_limit() const noexcept
+    {
+        return header_limit_;
+    }
+
     /// Returns `true` if the eager parse option is set.
     bool
     eager() const
@@ -614,6 +623,38 @@ protected:
         string_view body,
         error_code& ec) = 0;
 
+    /** Called with the data of several complete chunks at once.
+
+        When the input holds more than one complete chunk in a row,
+        none of them with chunk extensions, the parser first offers
+        their data to this function, in order, before delivering the
+        chunks one by one with @ref on_chunk_header_impl and
+        @ref on_chunk_body_impl. Derived classes which do not need to
+        see chunk boundaries can store the data with a single call to
+        the body.
+
+        The default implementation returns zero and leaves `ec` clear,
+        declining the chunks.
+
+        @param chunks The data of each chunk.
+
+        @param ec An output parameter which the function may set to indicate
+        an error. The error will be clear before this function is invoked.
+
+        @return The number of bytes of chunk data consumed. If this is
+        less than the total, the remaining data is presented again later.
+        Zero with no error declines the chunks.
+    */
+    virtual
+    std::size_t
+    on_chunks_impl(
+        span<net::const_buffer const> chunks,
+        error_code& ec)
+    {
+        boost::ignore_unused(chunks, ec);
+        return 0;
+    }
+
     /** Called once when the complete message is received.
 
         This virtual function is invoked once, after successfully parsing
@@ -678,6 +719,10 @@ private:
     parse_chunk_header(char const*& p,
         std::size_t n, error_code& ec);
 
+    bool
+    parse_chunks(char const*& p,
+        std::size_t n, error_code& ec);
+
     void
     parse_chunk_body(char const*& p,
         std::size_t n, error_code& ec);
@@ -134,6 +134,13 @@ struct basic_parser_base
     bool
     parse_hex(char const*& it, std::uint64_t& v);
 
+    BOOST_BEAST_DECL
+    static
+    char const*
+    parse_chunk_size(
+        char const* it, char const* last,
+            std::uint64_t& v);
+
     BOOST_BEAST_DECL
     static
     bool
@@ -201,6 +201,29 @@ parse_hex(char const*& it, std::uint64_t& v)
     return true;
 }
 
+// Parse a chunk-size with no chunk-ext and the CRLF which
+// follows it, returning the end of the line. Anything else,
+// including an incomplete line, returns nullptr.
+char const*
+basic_parser_base::
+parse_chunk_size(
+    char const* it, char const* last,
+        std::uint64_t& v)
+{
+    // More than 16 digits would overflow
+    auto const end = last - it > 18 ? it + 18 : last;
+    unsigned char d;
+    if(it == end || ! unhex(d, *it))
+        return nullptr;
+    std::uint64_t tmp = d;
+    while(++it != end && unhex(d, *it))
+        tmp = tmp * 16 + d;
+    if(end - it < 2 || it[0] != '\r' || it[1] != '\n')
+        return nullptr;
+    v = tmp;
+    return it + 2;
+}
+
 char const*
 basic_parser_base::
 find_eom(char const* p, char const* last)
@@ -17,6 +17,7 @@
 #include <boost/core/empty_value.hpp>
 #include <boost/intrusive/list.hpp>
 #include <boost/intrusive/set.hpp>
+#include <boost/type_traits/type_with_alignment.hpp>
 #include <optional>
 #include <algorithm>
 #include <cctype>
@@ -566,6 +567,35 @@ public:
     void
     swap(basic_fields<Alloc>& lhs, basic_fields<Alloc>& rhs);
 
+    /** Set whether the serialized header is cached.
+
+        When enabled, the serializer renders the start-line and the
+        fields into one contiguous buffer instead of presenting one
+        buffer for each field, and the rendered bytes are kept in the
+        container. A message which is sent again without changes
+        reuses them, so its header is written with no work per field.
+
+        The bytes are discarded when a field is inserted, set or
+        erased, when the method, target or reason changes, and when
+        the message is serialized with a different version, method or
+        status code than before.
+
+        @note While enabled, serializing a message updates the cache,
+        so the same message must not be serialized by more than one
+        thread at a time.
+
+        @param value `true` to enable the cache.
+    */
+    void
+    cache_serialized(bool value);
+
+    /// Returns `true` if the serialized header is cached
+    bool
+    cache_serialized() const noexcept
+    {
+        return wire_.enabled;
+    }
+
     //--------------------------------------------------------------------------
     //
     // Lookup
@@ -769,10 +799,42 @@ private:
     void
     swap(basic_fields& other, std::false_type);
 
+    void
+    invalidate_wire() noexcept
+    {
+        wire_.valid = false;
+    }
+
+    void
+    free_wire() const noexcept;
+
+    net::const_buffer
+    render_wire(
+        string_view s0,
+        string_view s1,
+        string_view s2,
+        bool request,
+        unsigned version,
+        unsigned code) const;
+
+    // The serialized start-line and fields, see cache_serialized
+    struct wire_cache
+    {
+        char* data = nullptr;
+        std::size_t capacity = 0;
+        std::size_t size = 0;
+        unsigned version = 0;
+        unsigned code = 0;
+        bool request = false;
+        bool valid = false;
+        bool enabled = false;
+    };
+
     set_t set_;
     list_t list_;
     string_view method_;
     string_view target_or_reason_;
+    mutable wire_cache wire_;
 };
 
 /// A typical HTTP header fields container
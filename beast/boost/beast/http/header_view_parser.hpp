@@ -0,0 +1,468 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_HEADER_VIEW_PARSER_HPP
+#define BOOST_BEAST_HTTP_HEADER_VIEW_PARSER_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/http/basic_parser.hpp>
+#include <boost/beast/http/field.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/status.hpp>
+#include <boost/beast/http/verb.hpp>
+#include <asio/async_result.hpp>
+#include <asio/buffer.hpp>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** An HTTP/1 parser which views the header in place.
+
+    This parser reads the start line and fields of a message without
+    copying them into a @ref basic_fields container. It remembers where
+    each name and value is in the caller's buffer, in a small array
+    inside the object which only spills to the heap for headers with
+    many fields, and returns views into the buffer. This suits
+    routing and proxying, where a few fields decide what happens to a
+    message. The header can be copied to a @ref header when the whole
+    message is needed.
+
+    The header is parsed by @ref put only once it is complete in the
+    buffer passed, which must be a single contiguous buffer such as
+    the readable bytes of a @ref flat_buffer. Until then, @ref put
+    consumes nothing and returns @ref error::need_more. The views
+    refer to that buffer and remain valid until it is modified or
+    its memory is released, so the caller should not consume the
+    header from a dynamic buffer while the views are in use. Values
+    of fields which use the obsolete line folding are the exception:
+    they are stored in the parser.
+
+    The body, if one is parsed, is discarded.
+
+    The parser derives privately from @ref basic_parser, so that it
+    is only ever given the header through its own @ref put, which
+    waits for the complete header. The generic stream algorithms
+    consume each line of the header as they parse it, which would
+    leave nothing for the views to refer to. Use the overloads of
+    @ref read_header and @ref async_read_header for this parser
+    instead, which leave the header in the buffer.
+
+    @tparam isRequest Indicates whether a request or response
+    will be parsed.
+
+    @par Example
+    @code
+    flat_buffer b;
+    header_view_parser<false> p;
+    auto const n = read_header(stream, b, p);
+    if(auto location = p.find(field::location))
+        ...
+    b.consume(n);
+    @endcode
+
+    @note A new instance of the parser is required for each message.
+*/
+template<bool isRequest>
+class header_view_parser
+    : private basic_parser<isRequest>
+{
+    using base_type = basic_parser<isRequest>;
+
+public:
+    /// A field in the header
+    struct value_type
+    {
+        /// The field name, or @ref field::unknown
+        field name;
+
+        /// The field name as it appears in the header
+        string_view name_string;
+
+        /// The field value
+        string_view value;
+    };
+
+    /// The number of fields stored without allocating
+    static std::size_t constexpr inline_fields = 16;
+
+    /// Constructor
+    header_view_parser() = default;
+
+    using base_type::got_some;
+    using base_type::is_done;
+    using base_type::is_header_done;
+    using base_type::upgrade;
+    using base_type::chunked;
+    using base_type::keep_alive;
+    using base_type::content_length;
+    using base_type::content_length_remaining;
+    using base_type::need_eof;
+    using base_type::body_limit;
+    using base_type::header_limit;
+    using base_type::put_eof;
+
+    /** Parse the header in a buffer.
+
+        If the buffer holds a complete header, the header is parsed
+        and the number of bytes it occupies is returned. Otherwise
+        nothing is consumed and the error is @ref error::need_more,
+        or @ref error::header_limit if the buffer is already as
+        large as the header limit.
+
+        Once the header is done, further bytes are parsed as the
+        body of the message and discarded, as by
+        @ref basic_parser::put.
+
+        @param buffer The bytes received so far.
+
+        @param ec Set to the error, if any occurred.
+
+        @return The number of bytes consumed.
+    */
+    std::size_t
+    put(net::const_buffer buffer, error_code& ec);
+
+    /** Returns the size of the header in bytes.
+
+        @note The return value is undefined unless
+              @ref is_header_done would return `true`.
+    */
+    std::size_t
+    header_size() const noexcept
+    {
+        return header_size_;
+    }
+
+    /// Returns the number of fields in the header
+    std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    /// Returns the field at index `i`, in the order received
+    value_type
+    operator[](std::size_t i) const;
+
+    /// Returns the value of the first field named `name`, if any
+    std::optional<string_view>
+    find(field name) const;
+
+    /// Returns the value of the first field named `name`, if any
+    std::optional<string_view>
+    find(string_view name) const;
+
+    /// Returns the number of fields named `name`
+    std::size_t
+    count(field name) const;
+
+    /// Returns the HTTP version, for example 11 for HTTP/1.1
+    unsigned
+    version() const noexcept
+    {
+        return version_;
+    }
+
+    /// Returns the request method. Requests only.
+    verb
+    method() const noexcept
+    {
+        static_assert(isRequest, "Requests only");
+        return method_;
+    }
+
+    /// Returns the request method as a string. Requests only.
+    string_view
+    method_string() const noexcept
+    {
+        static_assert(isRequest, "Requests only");
+        return view(first_);
+    }
+
+    /// Returns the request target. Requests only.
+    string_view
+    target() const noexcept
+    {
+        static_assert(isRequest, "Requests only");
+        return view(second_);
+    }
+
+    /// Returns the response status code. Responses only.
+    unsigned
+    result_int() const noexcept
+    {
+        static_assert(! isRequest, "Responses only");
+        return status_;
+    }
+
+    /// Returns the response status. Responses only.
+    status
+    result() const noexcept
+    {
+        static_assert(! isRequest, "Responses only");
+        return int_to_status(status_);
+    }
+
+    /// Returns the reason phrase. Responses only.
+    string_view
+    reason() const noexcept
+    {
+        static_assert(! isRequest, "Responses only");
+        return view(second_);
+    }
+
+    /** Returns a copy of the header in a @ref header.
+
+        @param args Arguments forwarded to the
+        @ref basic_fields constructor, such as an allocator.
+    */
+    template<
+        class Allocator = std::allocator<char>,
+        class... Args>
+    header<isRequest, basic_fields<Allocator>>
+    to_header(Args&&... args) const;
+
+private:
+    // A range of the header, or of folded_ if `folded`
+    struct range
+    {
+        std::uint32_t pos = 0;
+        std::uint32_t size = 0;
+        bool folded = false;
+    };
+
+    struct entry
+    {
+        field name;
+        range name_string;
+        range value;
+    };
+
+    string_view
+    view(range r) const noexcept
+    {
+        return {(r.folded ? folded_.data() : base_) + r.pos, r.size};
+    }
+
+    range
+    make_range(string_view s);
+
+    entry const&
+    at(std::size_t i) const noexcept
+    {
+        return i < inline_fields ?
+            small_[i] : big_[i - inline_fields];
+    }
+
+    void
+    on_request_impl(
+        verb method,
+        string_view method_str,
+        string_view target,
+        int version,
+        error_code& ec) override;
+
+    void
+    on_response_impl(
+        int code,
+        string_view reason,
+        int version,
+        error_code& ec) override;
+
+    void
+    on_field_impl(
+        field name,
+        string_view name_string,
+        string_view value,
+        error_code& ec) override;
+
+    void
+    on_header_impl(error_code&) override
+    {
+    }
+
+    void
+    on_body_init_impl(
+        std::optional<std::uint64_t> const&,
+        error_code&) override
+    {
+    }
+
+    std::size_t
+    on_body_impl(
+        string_view body,
+        error_code&) override
+    {
+        return body.size();
+    }
+
+    void
+    on_chunk_header_impl(
+        std::uint64_t,
+        string_view,
+        error_code&) override
+    {
+    }
+
+    std::size_t
+    on_chunk_body_impl(
+        std::uint64_t,
+        string_view body,
+        error_code&) override
+    {
+        return body.size();
+    }
+
+    void
+    on_finish_impl(error_code&) override
+    {
+    }
+
+    char const* base_ = nullptr;    // the header in the caller's buffer
+    std::size_t header_size_ = 0;
+    std::size_t scanned_ = 0;       // searched for the end of the header
+    entry small_[inline_fields];
+    std::vector<entry> big_;
+    std::size_t size_ = 0;
+    std::string folded_;            // values with obs-fold
+    range first_;                   // method or unused
+    range second_;                  // target or reason
+    verb method_ = verb::unknown;
+    unsigned status_ = 0;
+    unsigned version_ = 0;
+};
+
+/** Read a header into a header_view_parser.
+
+    Bytes are read from the stream into the dynamic buffer until
+    the buffer holds a complete header, which is then parsed. The
+    header is not consumed from the buffer, as the views returned
+    by the parser refer to it; the caller consumes the returned
+    number of bytes once the views are no longer needed.
+
+    @param stream The stream from which the data is to be read.
+
+    @param buffer Storage for the bytes received. Its readable
+    bytes must form a single contiguous buffer, as with
+    @ref flat_buffer.
+
+    @param parser The parser to use.
+
+    @return The size of the header, in bytes.
+
+    @throws system_error Thrown on failure.
+*/
+template<
+    class SyncReadStream,
+    class DynamicBuffer,
+    bool isRequest>
+std::size_t
+read_header(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    header_view_parser<isRequest>& parser);
+
+/** Read a header into a header_view_parser.
+
+    Bytes are read from the stream into the dynamic buffer until
+    the buffer holds a complete header, which is then parsed. The
+    header is not consumed from the buffer, as the views returned
+    by the parser refer to it; the caller consumes the returned
+    number of bytes once the views are no longer needed.
+
+    @param stream The stream from which the data is to be read.
+
+    @param buffer Storage for the bytes received. Its readable
+    bytes must form a single contiguous buffer, as with
+    @ref flat_buffer.
+
+    @param parser The parser to use.
+
+    @param ec Set to the error, if any occurred.
+
+    @return The size of the header, in bytes.
+*/
+template<
+    class SyncReadStream,
+    class DynamicBuffer,
+    bool isRequest>
+std::size_t
+read_header(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    header_view_parser<isRequest>& parser,
+    error_code& ec);
+
+/** Read a header into a header_view_parser asynchronously.
+
+    Bytes are read from the stream into the dynamic buffer until
+    the buffer holds a complete header, which is then parsed. The
+    header is not consumed from the buffer, as the views returned
+    by the parser refer to it; the caller consumes the size passed
+    to the handler once the views are no longer needed.
+
+    @param stream The stream from which the data is to be read.
+
+    @param buffer Storage for the bytes received. Its readable
+    bytes must form a single contiguous buffer, as with
+    @ref flat_buffer. The object must remain valid until the
+    handler is called.
+
+    @param parser The parser to use. The object must remain
+    valid until the handler is called.
+
+    @param handler The completion handler to invoke when the
+    operation completes. The signature of the handler must be:
+    @code
+    void handler(
+        error_code const& error,        // result of operation
+        std::size_t bytes_transferred   // the size of the header
+    );
+    @endcode
+    The handler is not invoked from within this function.
+*/
+template<
+    class AsyncReadStream,
+    class DynamicBuffer,
+    bool isRequest,
+    BOOST_BEAST_ASYNC_TPARAM2 ReadHandler =
+        net::default_completion_token_t<
+            executor_type<AsyncReadStream>>>
+BOOST_BEAST_ASYNC_RESULT2(ReadHandler)
+async_read_header(
+    AsyncReadStream& stream,
+    DynamicBuffer& buffer,
+    header_view_parser<isRequest>& parser,
+    ReadHandler&& handler =
+        net::default_completion_token_t<
+            executor_type<AsyncReadStream>>{});
+
+/// A header_view_parser for requests
+using request_header_view_parser = header_view_parser<true>;
+
+/// A header_view_parser for responses
+using response_header_view_parser = header_view_parser<false>;
+
+} // http
+} // beast
+} // boost
+
+#include <boost/beast/http/impl/header_view_parser.hpp>
+
+#endif
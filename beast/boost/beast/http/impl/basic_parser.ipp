@@ -617,6 +617,8 @@ parse_chunk_header(char const*& p0,
 
     if(! (f_ & flagFinalChunk))
     {
+        if(parse_chunks(p0, n, ec))
+            return;
         if(n < skip_ + 2)
         {
             ec = error::need_more;
@@ -731,6 +733,83 @@ parse_chunk_header(char const*& p0,
     state_ = state::complete;
 }
 
+// Offer a run of complete chunks without extensions to
+// on_chunks_impl. Returns `false` if there was no such
+// run, or it was declined.
+template<bool isRequest>
+bool
+basic_parser<isRequest>::
+parse_chunks(char const*& p0,
+    std::size_t n, error_code& ec)
+{
+    std::size_t constexpr max_chunks = 64;
+    net::const_buffer chunks[max_chunks];
+    std::size_t count = 0;
+    std::uint64_t total = 0;
+    auto p = p0;
+    auto const pend = p + n;
+    while(count < max_chunks)
+    {
+        auto q = p;
+        if(count > 0 || (f_ & flagExpectCRLF))
+        {
+            if(pend - q < 2 || q[0] != '\r' || q[1] != '\n')
+                break;
+            q += 2;
+        }
+        std::uint64_t size;
+        q = parse_chunk_size(q, pend, size);
+        if(! q || size == 0)
+            break;
+        if(static_cast<std::uint64_t>(pend - q) < size)
+            break;
+        if(body_limit_.has_value() && size > *body_limit_ - total)
+            break;
+        chunks[count++] = net::const_buffer(
+            q, static_cast<std::size_t>(size));
+        total += size;
+        p = q + size;
+    }
+    if(count < 2)
+        return false;
+
+    auto used = this->on_chunks_impl(
+        span<net::const_buffer const>(chunks, count), ec);
+    if(used == 0)
+        return static_cast<bool>(ec);
+    BOOST_ASSERT(used <= total);
+
+    // Resume after the data consumed, as if the
+    // chunks had been parsed one by one.
+    std::size_t i = 0;
+    std::uint64_t started = 0;
+    while(used >= chunks[i].size())
+    {
+        used -= chunks[i].size();
+        started += chunks[i].size();
+        if(++i == count)
+            break;
+    }
+    f_ |= flagExpectCRLF;
+    skip_ = 2;
+    if(i < count && used > 0)
+    {
+        started += chunks[i].size();
+        p0 = static_cast<char const*>(chunks[i].data()) + used;
+        len_ = chunks[i].size() - used;
+        state_ = state::chunk_body;
+    }
+    else
+    {
+        p0 = static_cast<char const*>(
+            chunks[i - 1].data()) + chunks[i - 1].size();
+        state_ = state::chunk_header;
+    }
+    if(body_limit_.has_value())
+        *body_limit_ -= started;
+    return true;
+}
+
 template<bool isRequest>
 void
 basic_parser<isRequest>::
@@ -212,6 +212,19 @@ writer(basic_fields const& f,
     buf_[9] = '\r';
     buf_[10]= '\n';
 
+    if(f_.wire_.enabled)
+    {
+        view_.emplace(
+            f_.render_wire(sv, f_.target_or_reason_,
+                {buf_, 11}, true, version,
+                    static_cast<unsigned>(v)),
+            net::const_buffer{nullptr, 0},
+            net::const_buffer{nullptr, 0},
+            field_range(f_.list_.end(), f_.list_.end()),
+            chunk_crlf());
+        return;
+    }
+
     view_.emplace(
         net::const_buffer{sv.data(), sv.size()},
         net::const_buffer{
@@ -254,6 +267,18 @@ writer(basic_fields const& f,
     else
         sv = obsolete_reason(static_cast<status>(code));
 
+    if(f_.wire_.enabled)
+    {
+        view_.emplace(
+            f_.render_wire({buf_, 13}, sv, "\r\n",
+                false, version, code),
+            net::const_buffer{nullptr, 0},
+            net::const_buffer{nullptr, 0},
+            field_range(f_.list_.end(), f_.list_.end()),
+            chunk_crlf{});
+        return;
+    }
+
     view_.emplace(
         net::const_buffer{buf_, 13},
         net::const_buffer{sv.data(), sv.size()},
@@ -349,6 +374,7 @@ template<class Allocator>
 basic_fields<Allocator>::
 ~basic_fields()
 {
+    free_wire();
     delete_list();
     realloc_string(method_, {});
     realloc_string(
@@ -371,6 +397,7 @@ basic_fields(basic_fields&& other) noexcept
     , list_(std::move(other.list_))
     , method_(std::exchange(other.method_, {}))
     , target_or_reason_(std::exchange(other.target_or_reason_, {}))
+    , wire_(std::exchange(other.wire_, {}))
 {
 }
 
@@ -389,6 +416,7 @@ basic_fields(basic_fields&& other, Allocator const& alloc)
         list_ = std::move(other.list_);
         method_ = other.method_;
         target_or_reason_ = other.target_or_reason_;
+        wire_ = std::exchange(other.wire_, {});
     }
 }
 
@@ -530,6 +558,7 @@ void
 basic_fields<Allocator>::
 clear()
 {
+    invalidate_wire();
     delete_list();
     set_.clear();
     list_.clear();
@@ -561,6 +590,7 @@ basic_fields<Allocator>::
 insert(field name,
     string_view sname, string_view const& value)
 {
+    invalidate_wire();
     auto& e = new_element(name, sname,
         static_cast<string_view>(value));
     auto const before =
@@ -611,6 +641,7 @@ basic_fields<Allocator>::
 erase(const_iterator pos) ->
     const_iterator
 {
+    invalidate_wire();
     auto next = pos;
     auto& e = *next++;
     set_.erase(set_.iterator_to(e));
@@ -633,6 +664,7 @@ std::size_t
 basic_fields<Allocator>::
 erase(string_view name)
 {
+    invalidate_wire();
     std::size_t n =0;
     set_.erase_and_dispose(name, key_compare{},
         [&](element* e)
@@ -653,6 +685,16 @@ swap(basic_fields<Allocator>& other)
         alloc_traits::propagate_on_container_swap::value>{});
 }
 
+template<class Allocator>
+void
+basic_fields<Allocator>::
+cache_serialized(bool value)
+{
+    wire_.enabled = value;
+    if(! value)
+        free_wire();
+}
+
 template<class Allocator>
 void
 swap(
@@ -996,6 +1038,7 @@ void
 basic_fields<Allocator>::
 set_element(element& e)
 {
+    invalidate_wire();
     auto it = set_.lower_bound(
         e.name_string(), key_compare{});
     if(it == set_.end() || ! beast::iequals(
@@ -1028,6 +1071,7 @@ realloc_string(string_view& dest, string_view s)
 {
     if(dest.empty() && s.empty())
         return;
+    invalidate_wire();
     auto a = typename std::allocator_traits<
         Allocator>::template rebind_alloc<
             char>(this->get());
@@ -1057,6 +1101,7 @@ realloc_target(
     // the writer class.
     if(dest.empty() && s.empty())
         return;
+    invalidate_wire();
     auto a = typename std::allocator_traits<
         Allocator>::template rebind_alloc<
             char>(this->get());
@@ -1087,6 +1132,7 @@ copy_all(basic_fields<OtherAlloc> const& other)
     realloc_string(method_, other.method_);
     realloc_string(target_or_reason_,
         other.target_or_reason_);
+    wire_.enabled = other.wire_.enabled;
 }
 
 template<class Allocator>
@@ -1094,6 +1140,7 @@ void
 basic_fields<Allocator>::
 clear_all()
 {
+    free_wire();
     clear();
     realloc_string(method_, {});
     realloc_string(target_or_reason_, {});
@@ -1108,6 +1155,72 @@ delete_list()
         delete_element(*it++);
 }
 
+template<class Allocator>
+void
+basic_fields<Allocator>::
+free_wire() const noexcept
+{
+    if(wire_.data)
+    {
+        auto a = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<
+                char>(this->get());
+        a.deallocate(wire_.data, wire_.capacity);
+    }
+    wire_.data = nullptr;
+    wire_.capacity = 0;
+    wire_.size = 0;
+    wire_.valid = false;
+}
+
+template<class Allocator>
+net::const_buffer
+basic_fields<Allocator>::
+render_wire(
+    string_view s0,
+    string_view s1,
+    string_view s2,
+    bool request,
+    unsigned version,
+    unsigned code) const
+{
+    if( wire_.valid &&
+        wire_.request == request &&
+        wire_.version == version &&
+        wire_.code == code)
+        return {wire_.data, wire_.size};
+
+    auto n = s0.size() + s1.size() + s2.size();
+    for(auto const& e : list_)
+        n += e.buffer().size();
+    if(n > wire_.capacity)
+    {
+        auto a = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<
+                char>(this->get());
+        char* const p = a.allocate(n);
+        free_wire();
+        wire_.data = p;
+        wire_.capacity = n;
+    }
+    char* p = wire_.data;
+    p += s0.copy(p, s0.size());
+    p += s1.copy(p, s1.size());
+    p += s2.copy(p, s2.size());
+    for(auto const& e : list_)
+    {
+        auto const b = e.buffer();
+        std::memcpy(p, b.data(), b.size());
+        p += b.size();
+    }
+    wire_.size = n;
+    wire_.request = request;
+    wire_.version = version;
+    wire_.code = code;
+    wire_.valid = true;
+    return {wire_.data, wire_.size};
+}
+
 //------------------------------------------------------------------------------
 
 template<class Allocator>
@@ -1124,6 +1237,7 @@ move_assign(basic_fields& other, std::true_type)
     other.method_ = {};
     other.target_or_reason_ = {};
     this->get() = other.get();
+    wire_ = std::exchange(other.wire_, {});
 }
 
 template<class Allocator>
@@ -1145,6 +1259,7 @@ move_assign(basic_fields& other, std::false_type)
         target_or_reason_ = other.target_or_reason_;
         other.method_ = {};
         other.target_or_reason_ = {};
+        wire_ = std::exchange(other.wire_, {});
     }
 }
 
@@ -1181,6 +1296,7 @@ swap(basic_fields& other, std::true_type)
     swap(list_, other.list_);
     swap(method_, other.method_);
     swap(target_or_reason_, other.target_or_reason_);
+    swap(wire_, other.wire_);
 }
 
 template<class Allocator>
@@ -1195,6 +1311,7 @@ swap(basic_fields& other, std::false_type)
     swap(list_, other.list_);
     swap(method_, other.method_);
     swap(target_or_reason_, other.target_or_reason_);
+    swap(wire_, other.wire_);
 }
 
 } // http
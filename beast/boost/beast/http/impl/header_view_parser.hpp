@@ -0,0 +1,417 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_HEADER_VIEW_PARSER_HPP
+#define BOOST_BEAST_HTTP_IMPL_HEADER_VIEW_PARSER_HPP
+
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/read_size.hpp>
+#include <boost/beast/core/detail/buffer.hpp>
+#include <asio/compose.hpp>
+#include <asio/coroutine.hpp>
+#include <asio/error.hpp>
+#include <asio/post.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+template<bool isRequest>
+std::size_t
+header_view_parser<isRequest>::
+put(net::const_buffer buffer, error_code& ec)
+{
+    if(this->is_header_done())
+        return basic_parser<isRequest>::put(buffer, ec);
+
+    // Wait for the end of the header, searching
+    // only the bytes which are new since last time
+    auto const p = static_cast<char const*>(buffer.data());
+    string_view const s(p, (std::min<std::size_t>)(
+        buffer.size(), this->header_limit()));
+    auto const pos = s.find("\r\n\r\n",
+        scanned_ > 3 ? scanned_ - 3 : 0);
+    if(pos == string_view::npos)
+    {
+        scanned_ = s.size();
+        if(buffer.size() >= this->header_limit())
+            ec = error::header_limit;
+        else
+            ec = error::need_more;
+        return 0;
+    }
+    base_ = p;
+    header_size_ = pos + 4;
+    return basic_parser<isRequest>::put(
+        net::const_buffer(p, header_size_), ec);
+}
+
+template<bool isRequest>
+auto
+header_view_parser<isRequest>::
+operator[](std::size_t i) const ->
+    value_type
+{
+    BOOST_ASSERT(i < size_);
+    auto const& e = at(i);
+    return {e.name, view(e.name_string), view(e.value)};
+}
+
+template<bool isRequest>
+std::optional<string_view>
+header_view_parser<isRequest>::
+find(field name) const
+{
+    BOOST_ASSERT(name != field::unknown);
+    for(std::size_t i = 0; i < size_; ++i)
+        if(at(i).name == name)
+            return view(at(i).value);
+    return std::nullopt;
+}
+
+template<bool isRequest>
+std::optional<string_view>
+header_view_parser<isRequest>::
+find(string_view name) const
+{
+    auto const f = string_to_field(name);
+    if(f != field::unknown)
+        return find(f);
+    for(std::size_t i = 0; i < size_; ++i)
+        if(beast::iequals(view(at(i).name_string), name))
+            return view(at(i).value);
+    return std::nullopt;
+}
+
+template<bool isRequest>
+std::size_t
+header_view_parser<isRequest>::
+count(field name) const
+{
+    BOOST_ASSERT(name != field::unknown);
+    std::size_t n = 0;
+    for(std::size_t i = 0; i < size_; ++i)
+        if(at(i).name == name)
+            ++n;
+    return n;
+}
+
+template<bool isRequest>
+template<class Allocator, class... Args>
+header<isRequest, basic_fields<Allocator>>
+header_view_parser<isRequest>::
+to_header(Args&&... args) const
+{
+    BOOST_ASSERT(this->is_header_done());
+    header<isRequest, basic_fields<Allocator>> h(
+        std::forward<Args>(args)...);
+    h.version(version_);
+    if constexpr(isRequest)
+    {
+        if(method_ != verb::unknown)
+            h.method(method_);
+        else
+            h.method_string(view(first_));
+        h.target(view(second_));
+    }
+    else
+    {
+        h.result(status_);
+        h.reason(view(second_));
+    }
+    for(std::size_t i = 0; i < size_; ++i)
+    {
+        auto const& e = at(i);
+        h.insert(e.name, view(e.name_string), view(e.value));
+    }
+    return h;
+}
+
+template<bool isRequest>
+auto
+header_view_parser<isRequest>::
+make_range(string_view s) ->
+    range
+{
+    range r;
+    r.size = static_cast<std::uint32_t>(s.size());
+    std::less<char const*> const less;
+    if( ! less(s.data(), base_) &&
+        ! less(base_ + header_size_, s.data() + s.size()))
+    {
+        r.pos = static_cast<std::uint32_t>(s.data() - base_);
+        return r;
+    }
+    // The parser unfolded this value into its own storage
+    r.folded = true;
+    r.pos = static_cast<std::uint32_t>(folded_.size());
+    folded_.append(s.data(), s.size());
+    return r;
+}
+
+template<bool isRequest>
+void
+header_view_parser<isRequest>::
+on_request_impl(
+    verb method,
+    string_view method_str,
+    string_view target,
+    int version,
+    error_code&)
+{
+    method_ = method;
+    first_ = make_range(method_str);
+    second_ = make_range(target);
+    version_ = static_cast<unsigned>(version);
+}
+
+template<bool isRequest>
+void
+header_view_parser<isRequest>::
+on_response_impl(
+    int code,
+    string_view reason,
+    int version,
+    error_code&)
+{
+    status_ = static_cast<unsigned>(code);
+    second_ = make_range(reason);
+    version_ = static_cast<unsigned>(version);
+}
+
+template<bool isRequest>
+void
+header_view_parser<isRequest>::
+on_field_impl(
+    field name,
+    string_view name_string,
+    string_view value,
+    error_code&)
+{
+    entry e;
+    e.name = name;
+    e.name_string = make_range(name_string);
+    e.value = make_range(value);
+    if(size_ < inline_fields)
+        small_[size_] = e;
+    else
+        big_.push_back(e);
+    ++size_;
+}
+
+//------------------------------------------------------------------------------
+
+namespace detail {
+
+template<class DynamicBuffer>
+struct is_contiguous_dynamic_buffer
+    : std::is_convertible<
+        typename DynamicBuffer::const_buffers_type,
+        net::const_buffer>
+{
+};
+
+// Translate the end of the stream before a complete header
+inline
+void
+header_view_eof(std::size_t buffered, error_code& ec)
+{
+    if(buffered > 0)
+        ec = error::partial_message;
+    else
+        ec = error::end_of_stream;
+}
+
+template<class AsyncReadStream, class DynamicBuffer, bool isRequest>
+class read_header_view_op : ::asio::coroutine
+{
+    AsyncReadStream& s_;
+    DynamicBuffer& b_;
+    header_view_parser<isRequest>& p_;
+    bool cont_ = false;
+
+public:
+    read_header_view_op(
+        AsyncReadStream& s,
+        DynamicBuffer& b,
+        header_view_parser<isRequest>& p)
+        : s_(s)
+        , b_(b)
+        , p_(p)
+    {
+    }
+
+    template<class Self>
+    void operator()(
+        Self& self,
+        error_code ec = {},
+        std::size_t bytes_transferred = 0)
+    {
+        ASIO_CORO_REENTER(*this)
+        {
+            while(! p_.is_header_done())
+            {
+                p_.put(net::const_buffer(b_.data()), ec);
+                if(ec != error::need_more)
+                    break;
+                ec = {};
+                ASIO_CORO_YIELD
+                {
+                    cont_ = true;
+                    auto const size = read_size(b_, 65536);
+                    if(size == 0)
+                    {
+                        ec = error::buffer_overflow;
+                        goto upcall;
+                    }
+                    auto const mb =
+                        beast::detail::dynamic_buffer_prepare(
+                            b_, size, ec, error::buffer_overflow);
+                    if(ec)
+                        goto upcall;
+
+                    ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "http::async_read_header"));
+
+                    s_.async_read_some(*mb, std::move(self));
+                }
+                b_.commit(bytes_transferred);
+                if(ec == net::error::eof)
+                    header_view_eof(b_.size(), ec);
+                if(ec)
+                    break;
+            }
+
+        upcall:
+            if(! cont_)
+            {
+                ASIO_CORO_YIELD
+                {
+                    ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "http::async_read_header"));
+
+                    net::post(
+                        beast::bind_front_handler(std::move(self), ec));
+                }
+            }
+            self.complete(ec, ec ? 0 : p_.header_size());
+        }
+    }
+};
+
+} // detail
+
+template<
+    class SyncStream,
+    class DynamicBuffer,
+    bool isRequest>
+std::size_t
+read_header(
+    SyncStream& stream,
+    DynamicBuffer& buffer,
+    header_view_parser<isRequest>& parser)
+{
+    error_code ec;
+    auto const n = http::read_header(stream, buffer, parser, ec);
+    if(ec)
+        throw system_error{ec};
+    return n;
+}
+
+template<
+    class SyncStream,
+    class DynamicBuffer,
+    bool isRequest>
+std::size_t
+read_header(
+    SyncStream& stream,
+    DynamicBuffer& buffer,
+    header_view_parser<isRequest>& parser,
+    error_code& ec)
+{
+    static_assert(
+        SyncReadStream<SyncStream>,
+        "SyncReadStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    static_assert(
+        detail::is_contiguous_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer must hold its bytes in one buffer");
+    ec = {};
+    while(! parser.is_header_done())
+    {
+        parser.put(net::const_buffer(buffer.data()), ec);
+        if(ec != error::need_more)
+            break;
+        ec = {};
+        auto const size = read_size(buffer, 65536);
+        if(size == 0)
+        {
+            ec = error::buffer_overflow;
+            break;
+        }
+        auto const mb = beast::detail::dynamic_buffer_prepare(
+            buffer, size, ec, error::buffer_overflow);
+        if(ec)
+            break;
+        buffer.commit(stream.read_some(*mb, ec));
+        if(ec == net::error::eof)
+            detail::header_view_eof(buffer.size(), ec);
+        if(ec)
+            break;
+    }
+    if(ec)
+        return 0;
+    return parser.header_size();
+}
+
+template<
+    class AsyncStream,
+    class DynamicBuffer,
+    bool isRequest,
+    BOOST_BEAST_ASYNC_TPARAM2 ReadHandler>
+BOOST_BEAST_ASYNC_RESULT2(ReadHandler)
+async_read_header(
+    AsyncStream& stream,
+    DynamicBuffer& buffer,
+    header_view_parser<isRequest>& parser,
+    ReadHandler&& handler)
+{
+    static_assert(
+        AsyncReadStream<AsyncStream>,
+        "AsyncReadStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    static_assert(
+        detail::is_contiguous_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer must hold its bytes in one buffer");
+    return net::async_compose<
+        ReadHandler,
+        void(error_code, std::size_t)>(
+            detail::read_header_view_op<
+                AsyncStream,
+                DynamicBuffer,
+                isRequest>(stream, buffer, parser),
+            handler, stream);
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
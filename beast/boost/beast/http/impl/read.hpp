@@ -17,6 +17,7 @@
 #include <boost/beast/http/read.hpp>
 #include <boost/beast/core/async_base.hpp>
 #include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/trace.hpp>
 #include <boost/beast/core/detail/buffer.hpp>
 #include <boost/beast/core/detail/read.hpp>
 #include <asio/error.hpp>
@@ -156,6 +157,7 @@ class read_some_op : ::asio::coroutine
     basic_parser<isRequest>& p_;
     std::size_t bytes_transferred_;
     bool cont_;
+    trace_span span_;
 
 public:
     read_some_op(
@@ -167,6 +169,7 @@ public:
         , p_(p)
         , bytes_transferred_(0)
         , cont_(false)
+        , span_(! p.got_some())
     {
     }
 
@@ -188,6 +191,8 @@ public:
                     bytes_transferred_ += used;
                     b_.consume(used);
                 }
+                if(p_.is_header_done())
+                    span_.finish(trace_phase::read_header);
                 if(ec != http::error::need_more)
                     break;
 
@@ -215,6 +220,8 @@ public:
                     s_.async_read_some(*mb, std::move(self));
                 }
                 b_.commit(bytes_transferred);
+                if(bytes_transferred > 0 && ! p_.got_some())
+                    span_.lap(trace_phase::first_byte);
                 if(ec == net::error::eof)
                 {
                     BOOST_ASSERT(bytes_transferred == 0);
@@ -236,6 +243,10 @@ public:
             }
 
         upcall:
+            // still active if the header did not arrive
+            span_.finish(p_.got_some() ?
+                trace_phase::read_header :
+                trace_phase::first_byte, ec);
             if(! cont_)
             {
                 ASIO_CORO_YIELD
@@ -261,6 +272,8 @@ class read_op
     DynamicBuffer& b_;
     basic_parser<isRequest>& p_;
     std::size_t bytes_transferred_;
+    trace_span span_;
+    bool body_;
 
 public:
     read_op(Stream& s, DynamicBuffer& b, basic_parser<isRequest>& p)
@@ -268,6 +281,8 @@ public:
     , b_(b)
     , p_(p)
     , bytes_transferred_(0)
+    , span_(std::is_same<Condition, parser_is_done>::value)
+    , body_(p.is_header_done())
     {
     }
 
@@ -301,8 +316,17 @@ public:
                             s_, b_, p_, std::move(self));
                     }
                     bytes_transferred_ += bytes_transferred;
+                    if(! body_ && p_.is_header_done())
+                    {
+                        // the body begins where the header ends
+                        body_ = true;
+                        if(span_.active())
+                            span_.start();
+                    }
                 } while (!ec &&
                          !Condition{}(p_));
+                if(body_)
+                    span_.finish(trace_phase::read_body, ec);
             }
             self.complete(ec, bytes_transferred_);
         }
@@ -0,0 +1,643 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_RELAY_HPP
+#define BOOST_BEAST_HTTP_IMPL_RELAY_HPP
+
+#include <boost/beast/http/buffer_body.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/serializer.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/core/async_base.hpp>
+#include <boost/beast/core/buffers_prefix.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/detail/is_invocable.hpp>
+#include <boost/beast/core/detail/splice.hpp>
+#include <asio/basic_stream_socket.hpp>
+#include <asio/coroutine.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/write.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace http {
+namespace detail {
+
+template<class T>
+struct is_tcp_socket : std::false_type
+{
+};
+
+template<class Executor>
+struct is_tcp_socket<
+    net::basic_stream_socket<net::ip::tcp, Executor>>
+    : std::true_type
+{
+};
+
+/*  The state of a relay, which must not move while the
+    serializer refers to the message held by the parser.
+*/
+template<bool isRequest>
+struct relay_state
+{
+    static std::size_t constexpr buffer_size = 65536;
+
+    parser<isRequest, buffer_body> p;
+    serializer<isRequest, buffer_body> sr;
+#if BOOST_BEAST_HAS_SPLICE
+    beast::detail::splice_pipe pipe;
+#endif
+    char buf[buffer_size];
+
+    relay_state()
+        : sr(p.get())
+    {
+        p.body_limit(std::nullopt);
+    }
+
+    // Returns `true` if the body can be spliced from
+    // `Input` to `Output` once the header is written.
+    //
+    // The bytes are passed through unchanged, so this
+    // requires the header produced by the transform to
+    // frame the body exactly as the input did.
+    template<class Input, class Output>
+    bool
+    can_splice() const
+    {
+        if(! BOOST_BEAST_HAS_SPLICE ||
+            ! is_tcp_socket<Input>::value ||
+            ! is_tcp_socket<Output>::value)
+            return false;
+        if( p.is_done() ||
+            p.chunked() ||
+            ! p.content_length().has_value())
+            return false;
+        auto const& h = p.get();
+        if( h.chunked() ||
+            h.count(field::transfer_encoding) != 0 ||
+            h.count(field::content_length) != 1)
+            return false;
+        std::uint64_t n;
+        return
+            basic_parser_base::parse_dec(
+                h[field::content_length], n) &&
+            n == *p.content_length();
+    }
+
+    // Present the next piece of body to the parser
+    void
+    prepare_read()
+    {
+        p.get().body().data = buf;
+        p.get().body().size = buffer_size;
+    }
+
+    // Present what the parser wrote to the serializer,
+    // returning the number of bytes
+    std::size_t
+    prepare_write()
+    {
+        auto& body = p.get().body();
+        body.size = buffer_size - body.size;
+        body.data = buf;
+        body.more = ! p.is_done();
+        return body.size;
+    }
+
+    // Tell the serializer there is no more body
+    void
+    finish_write()
+    {
+        auto& body = p.get().body();
+        body.data = nullptr;
+        body.size = 0;
+        body.more = false;
+    }
+};
+
+template<
+    class AsyncInputStream,
+    class AsyncOutputStream,
+    class DynamicBuffer,
+    bool isRequest,
+    class Transform,
+    class Handler>
+class relay_op
+    : public beast::stable_async_base<
+        Handler, beast::executor_type<AsyncInputStream>>
+    , public ::asio::coroutine
+{
+    AsyncInputStream& in_;
+    AsyncOutputStream& out_;
+    DynamicBuffer& b_;
+    Transform tr_;
+    relay_state<isRequest>& d_;
+    std::uint64_t remain_ = 0;
+    std::size_t total_ = 0;
+    bool restore_ = false;
+    bool in_nb_ = false;
+    bool out_nb_ = false;
+
+public:
+    template<class Handler_, class Transform_>
+    relay_op(
+        Handler_&& h,
+        AsyncInputStream& in,
+        AsyncOutputStream& out,
+        DynamicBuffer& b,
+        Transform_&& tr)
+        : stable_async_base<
+            Handler, beast::executor_type<AsyncInputStream>>(
+                std::forward<Handler_>(h), in.get_executor())
+        , in_(in)
+        , out_(out)
+        , b_(b)
+        , tr_(std::forward<Transform_>(tr))
+        , d_(beast::allocate_stable<
+            relay_state<isRequest>>(*this))
+    {
+        (*this)();
+    }
+
+    void
+    operator()(
+        error_code ec = {},
+        std::size_t bytes_transferred = 0)
+    {
+        ASIO_CORO_REENTER(*this)
+        {
+            ASIO_CORO_YIELD
+            {
+                ASIO_HANDLER_LOCATION((
+                    __FILE__, __LINE__,
+                    "http::async_relay"));
+
+                http::async_read_header(
+                    in_, b_, d_.p, std::move(*this));
+            }
+            if(ec)
+                goto upcall;
+            tr_(d_.p.get(), ec);
+            if(ec)
+                goto upcall;
+            ASIO_CORO_YIELD
+            {
+                ASIO_HANDLER_LOCATION((
+                    __FILE__, __LINE__,
+                    "http::async_relay"));
+
+                http::async_write_header(
+                    out_, d_.sr, std::move(*this));
+            }
+            if(ec)
+                goto upcall;
+            if(d_.template can_splice<
+                    AsyncInputStream, AsyncOutputStream>())
+                goto do_splice;
+
+            do
+            {
+                if(! d_.p.is_done())
+                {
+                    d_.prepare_read();
+                    ASIO_CORO_YIELD
+                    {
+                        ASIO_HANDLER_LOCATION((
+                            __FILE__, __LINE__,
+                            "http::async_relay"));
+
+                        http::async_read(
+                            in_, b_, d_.p, std::move(*this));
+                    }
+                    if(ec == error::need_buffer)
+                        ec = {};
+                    if(ec)
+                        goto upcall;
+                    total_ += d_.prepare_write();
+                }
+                else
+                {
+                    d_.finish_write();
+                }
+                ASIO_CORO_YIELD
+                {
+                    ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "http::async_relay"));
+
+                    http::async_write(
+                        out_, d_.sr, std::move(*this));
+                }
+                if(ec == error::need_buffer)
+                    ec = {};
+                if(ec)
+                    goto upcall;
+            }
+            while(! d_.p.is_done() || ! d_.sr.is_done());
+            goto upcall;
+
+        do_splice:
+            // Body bytes which were read with the header
+            remain_ = *d_.p.content_length();
+            if(b_.size() > 0)
+            {
+                ASIO_CORO_YIELD
+                {
+                    ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "http::async_relay"));
+
+                    net::async_write(out_, beast::buffers_prefix(
+                        static_cast<std::size_t>((std::min<std::uint64_t>)(
+                            remain_, b_.size())), b_.data()),
+                        std::move(*this));
+                }
+                if(ec)
+                    goto upcall;
+                b_.consume(bytes_transferred);
+                remain_ -= bytes_transferred;
+                total_ += bytes_transferred;
+            }
+            if(remain_ == 0)
+                goto upcall;
+            if(! splice_open(ec))
+                goto upcall;
+            while(remain_ > 0 || splice_size() > 0)
+            {
+                if(splice_size() == 0)
+                {
+                    remain_ -= splice_fill(ec);
+                    if(ec == net::error::would_block)
+                    {
+                        ASIO_CORO_YIELD
+                        {
+                            ASIO_HANDLER_LOCATION((
+                                __FILE__, __LINE__,
+                                "http::async_relay"));
+
+                            splice_wait(in_,
+                                net::socket_base::wait_read);
+                        }
+                        if(ec)
+                            goto upcall;
+                        continue;
+                    }
+                    if(ec == net::error::eof)
+                        ec = error::partial_message;
+                    if(ec)
+                        goto upcall;
+                }
+                total_ += splice_drain(ec);
+                if(ec == net::error::would_block)
+                {
+                    ASIO_CORO_YIELD
+                    {
+                        ASIO_HANDLER_LOCATION((
+                            __FILE__, __LINE__,
+                            "http::async_relay"));
+
+                        splice_wait(out_,
+                            net::socket_base::wait_write);
+                    }
+                    if(ec)
+                        goto upcall;
+                    continue;
+                }
+                if(ec)
+                    goto upcall;
+            }
+
+        upcall:
+            splice_close();
+            this->complete_now(ec, total_);
+        }
+    }
+
+private:
+    // These are only called once can_splice has
+    // established that both streams are sockets.
+
+#if BOOST_BEAST_HAS_SPLICE
+    bool
+    splice_open(error_code& ec)
+    {
+        if constexpr(
+            is_tcp_socket<AsyncInputStream>::value &&
+            is_tcp_socket<AsyncOutputStream>::value)
+        {
+            // The sockets belong to the caller; their
+            // modes are put back by splice_close.
+            in_nb_ = in_.native_non_blocking();
+            out_nb_ = out_.native_non_blocking();
+            restore_ = true;
+            in_.native_non_blocking(true, ec);
+            if(! ec)
+                out_.native_non_blocking(true, ec);
+            if(! ec)
+                d_.pipe.open(ec);
+        }
+        return ! ec;
+    }
+
+    void
+    splice_close()
+    {
+        if constexpr(
+            is_tcp_socket<AsyncInputStream>::value &&
+            is_tcp_socket<AsyncOutputStream>::value)
+        {
+            if(! std::exchange(restore_, false))
+                return;
+            error_code ec;
+            in_.native_non_blocking(in_nb_, ec);
+            out_.native_non_blocking(out_nb_, ec);
+        }
+    }
+
+    std::size_t
+    splice_size() const noexcept
+    {
+        return d_.pipe.size();
+    }
+
+    std::size_t
+    splice_fill(error_code& ec)
+    {
+        if constexpr(is_tcp_socket<AsyncInputStream>::value)
+            return d_.pipe.fill(in_.native_handle(),
+                static_cast<std::size_t>((std::min<std::uint64_t>)(
+                    remain_, d_.pipe.max_fill)), ec);
+        else
+            return 0;
+    }
+
+    std::size_t
+    splice_drain(error_code& ec)
+    {
+        if constexpr(is_tcp_socket<AsyncOutputStream>::value)
+            return d_.pipe.drain(out_.native_handle(), ec);
+        else
+            return 0;
+    }
+
+    template<class Stream>
+    void
+    splice_wait(Stream& s, net::socket_base::wait_type w)
+    {
+        if constexpr(is_tcp_socket<Stream>::value)
+            s.async_wait(w, std::move(*this));
+    }
+#else
+    bool splice_open(error_code&) { return false; }
+    void splice_close() {}
+    std::size_t splice_size() const noexcept { return 0; }
+    std::size_t splice_fill(error_code&) { return 0; }
+    std::size_t splice_drain(error_code&) { return 0; }
+    template<class Stream>
+    void splice_wait(Stream&, net::socket_base::wait_type) {}
+#endif
+};
+
+struct run_relay_op
+{
+    template<
+        class RelayHandler,
+        class AsyncInputStream,
+        class AsyncOutputStream,
+        class DynamicBuffer,
+        bool isRequest,
+        class Transform>
+    void
+    operator()(
+        RelayHandler&& h,
+        AsyncInputStream* in,
+        AsyncOutputStream* out,
+        DynamicBuffer* b,
+        std::integral_constant<bool, isRequest>,
+        Transform&& tr)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<RelayHandler,
+            void(error_code, std::size_t)>::value,
+            "RelayHandler type requirements not met");
+
+        relay_op<
+            AsyncInputStream,
+            AsyncOutputStream,
+            DynamicBuffer,
+            isRequest,
+            typename std::decay<Transform>::type,
+            typename std::decay<RelayHandler>::type>(
+                std::forward<RelayHandler>(h), *in, *out, *b,
+                std::forward<Transform>(tr));
+    }
+};
+
+} // detail
+
+//------------------------------------------------------------------------------
+
+template<
+    bool isRequest,
+    class SyncInputStream,
+    class SyncOutputStream,
+    class DynamicBuffer,
+    class Transform>
+std::size_t
+relay(
+    SyncInputStream& input,
+    SyncOutputStream& output,
+    DynamicBuffer& buffer,
+    Transform&& transform,
+    error_code& ec)
+{
+    static_assert(
+        SyncReadStream<SyncInputStream>,
+        "SyncReadStream type requirements not met");
+    static_assert(
+        SyncWriteStream<SyncOutputStream>,
+        "SyncWriteStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    static_assert(
+        beast::detail::is_invocable<Transform,
+        void(header<isRequest>&, error_code&)>::value,
+        "Transform type requirements not met");
+
+    auto d = std::make_unique<detail::relay_state<isRequest>>();
+    std::size_t total = 0;
+    http::read_header(input, buffer, d->p, ec);
+    if(ec)
+        return total;
+    transform(d->p.get(), ec);
+    if(ec)
+        return total;
+    http::write_header(output, d->sr, ec);
+    if(ec)
+        return total;
+
+#if BOOST_BEAST_HAS_SPLICE
+    if constexpr(
+        detail::is_tcp_socket<SyncInputStream>::value &&
+        detail::is_tcp_socket<SyncOutputStream>::value)
+    {
+        if(d->template can_splice<
+            SyncInputStream, SyncOutputStream>())
+        {
+            // Body bytes which were read with the header
+            std::uint64_t remain = *d->p.content_length();
+            auto n = net::write(output, beast::buffers_prefix(
+                static_cast<std::size_t>((std::min<std::uint64_t>)(
+                    remain, buffer.size())), buffer.data()), ec);
+            buffer.consume(n);
+            remain -= n;
+            total += n;
+            if(ec || remain == 0)
+                return total;
+            d->pipe.open(ec);
+            if(ec)
+                return total;
+            while(remain > 0 || d->pipe.size() > 0)
+            {
+                if(d->pipe.size() == 0)
+                {
+                    remain -= d->pipe.fill(input.native_handle(),
+                        static_cast<std::size_t>((std::min<std::uint64_t>)(
+                            remain, d->pipe.max_fill)), ec);
+                    if(ec == net::error::would_block)
+                    {
+                        input.wait(net::socket_base::wait_read, ec);
+                        if(ec)
+                            return total;
+                        continue;
+                    }
+                    if(ec == net::error::eof)
+                        ec = error::partial_message;
+                    if(ec)
+                        return total;
+                }
+                total += d->pipe.drain(output.native_handle(), ec);
+                if(ec == net::error::would_block)
+                    output.wait(net::socket_base::wait_write, ec);
+                if(ec)
+                    return total;
+            }
+            return total;
+        }
+    }
+#endif
+
+    do
+    {
+        if(! d->p.is_done())
+        {
+            d->prepare_read();
+            http::read(input, buffer, d->p, ec);
+            if(ec == error::need_buffer)
+                ec = {};
+            if(ec)
+                return total;
+            total += d->prepare_write();
+        }
+        else
+        {
+            d->finish_write();
+        }
+        http::write(output, d->sr, ec);
+        if(ec == error::need_buffer)
+            ec = {};
+        if(ec)
+            return total;
+    }
+    while(! d->p.is_done() || ! d->sr.is_done());
+    return total;
+}
+
+template<
+    bool isRequest,
+    class SyncInputStream,
+    class SyncOutputStream,
+    class DynamicBuffer,
+    class Transform>
+std::size_t
+relay(
+    SyncInputStream& input,
+    SyncOutputStream& output,
+    DynamicBuffer& buffer,
+    Transform&& transform)
+{
+    error_code ec;
+    auto const bytes_transferred = http::relay<isRequest>(
+        input, output, buffer,
+        std::forward<Transform>(transform), ec);
+    if(ec)
+        throw system_error{ec};
+    return bytes_transferred;
+}
+
+template<
+    bool isRequest,
+    class AsyncInputStream,
+    class AsyncOutputStream,
+    class DynamicBuffer,
+    class Transform,
+    BOOST_BEAST_ASYNC_TPARAM2 RelayHandler>
+BOOST_BEAST_ASYNC_RESULT2(RelayHandler)
+async_relay(
+    AsyncInputStream& input,
+    AsyncOutputStream& output,
+    DynamicBuffer& buffer,
+    Transform&& transform,
+    RelayHandler&& handler)
+{
+    static_assert(
+        AsyncReadStream<AsyncInputStream>,
+        "AsyncReadStream type requirements not met");
+    static_assert(
+        AsyncWriteStream<AsyncOutputStream>,
+        "AsyncWriteStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    static_assert(
+        beast::detail::is_invocable<
+            typename std::decay<Transform>::type,
+        void(header<isRequest>&, error_code&)>::value,
+        "Transform type requirements not met");
+    return net::async_initiate<
+        RelayHandler,
+        void(error_code, std::size_t)>(
+            detail::run_relay_op{},
+            handler,
+            &input,
+            &output,
+            &buffer,
+            std::integral_constant<bool, isRequest>{},
+            std::forward<Transform>(transform));
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
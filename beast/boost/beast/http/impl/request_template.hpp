@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_REQUEST_TEMPLATE_HPP
+#define BOOST_BEAST_HTTP_IMPL_REQUEST_TEMPLATE_HPP
+
+#include <stdexcept>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+template<class Fields>
+request_template::
+request_template(
+    request<empty_body, Fields> const& req,
+    std::initializer_list<field> variable)
+{
+    std::vector<string_view> names;
+    names.reserve(variable.size());
+    for(auto f : variable)
+        if(f != field::unknown)
+            names.push_back(to_string(f));
+    construct(req, names.data(), names.size());
+}
+
+template<class Fields>
+request_template::
+request_template(
+    request<empty_body, Fields> const& req,
+    std::initializer_list<string_view> variable)
+{
+    construct(req, variable.begin(), variable.size());
+}
+
+template<class Fields>
+void
+request_template::
+construct(
+    request<empty_body, Fields> const& req,
+    string_view const* names,
+    std::size_t count)
+{
+    if(req.chunked())
+        throw std::invalid_argument{"chunked request template"};
+
+    fields_.reserve(count);
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        // the body decides the Content-Length
+        if(iequals(names[i], to_string(field::content_length)))
+            continue;
+        if(find(names[i]))
+            continue;
+        // known fields are sent with their usual spelling
+        auto const f = string_to_field(names[i]);
+        auto const name = f != field::unknown ?
+            to_string(f) : names[i];
+        fields_.push_back({std::string(name), {}});
+    }
+
+    start(req.method_string(), req.target(), req.version());
+    std::vector<bool> seen(fields_.size());
+    for(auto const& f : req)
+    {
+        if(f.name() == field::content_length)
+            continue;
+        auto const v = find(f.name_string());
+        if(! v)
+        {
+            append(f.name_string());
+            append(": ");
+            append(f.value());
+            append("\r\n");
+            continue;
+        }
+        auto const i = static_cast<std::size_t>(v - fields_.data());
+        if(! seen[i])
+        {
+            seen[i] = true;
+            v->value.assign(f.value().data(), f.value().size());
+        }
+    }
+    finish(req.has_content_length());
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
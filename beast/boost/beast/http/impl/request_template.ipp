@@ -0,0 +1,291 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_REQUEST_TEMPLATE_IPP
+#define BOOST_BEAST_HTTP_IMPL_REQUEST_TEMPLATE_IPP
+
+#include <boost/beast/http/request_template.hpp>
+#include <boost/assert.hpp>
+#include <charconv>
+#include <stdexcept>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/*  Layout of buffers_, for N variable fields:
+
+    0           method SP
+    1           request-target
+    2           SP HTTP-version CRLF, fixed fields, name of field 0
+    3 + 2i      value of field i
+    4 + 2i      CRLF, name of field i + 1 (or Content-Length, or CRLF)
+    3 + 2N      Content-Length value        (if has_body_)
+    4 + 2N      CRLF CRLF                   (if has_body_)
+    5 + 2N      body                        (if has_body_)
+*/
+
+request_template::
+request_template(request_template const& other)
+    : fixed_(other.fixed_)
+    , target_(other.target_)
+    , fields_(other.fields_)
+    , length_size_(other.length_size_)
+    , body_(other.body_)
+    , has_body_(other.has_body_)
+{
+    std::copy(other.length_,
+        other.length_ + length_size_, length_);
+    bind();
+}
+
+request_template::
+request_template(request_template&& other)
+    : fixed_(std::move(other.fixed_))
+    , target_(std::move(other.target_))
+    , fields_(std::move(other.fields_))
+    , length_size_(other.length_size_)
+    , body_(other.body_)
+    , has_body_(other.has_body_)
+{
+    std::copy(other.length_,
+        other.length_ + length_size_, length_);
+    bind();
+    other.reset();
+}
+
+auto
+request_template::
+operator=(request_template const& other) ->
+    request_template&
+{
+    if(this == &other)
+        return *this;
+    fixed_ = other.fixed_;
+    target_ = other.target_;
+    fields_ = other.fields_;
+    length_size_ = other.length_size_;
+    std::copy(other.length_,
+        other.length_ + length_size_, length_);
+    body_ = other.body_;
+    has_body_ = other.has_body_;
+    bind();
+    return *this;
+}
+
+auto
+request_template::
+operator=(request_template&& other) ->
+    request_template&
+{
+    if(this == &other)
+        return *this;
+    fixed_ = std::move(other.fixed_);
+    target_ = std::move(other.target_);
+    fields_ = std::move(other.fields_);
+    length_size_ = other.length_size_;
+    std::copy(other.length_,
+        other.length_ + length_size_, length_);
+    body_ = other.body_;
+    has_body_ = other.has_body_;
+    bind();
+    other.reset();
+    return *this;
+}
+
+std::size_t
+request_template::
+size() const noexcept
+{
+    std::size_t n = 0;
+    for(auto const& b : buffers_)
+        n += b.size();
+    return n;
+}
+
+void
+request_template::
+target(string_view s)
+{
+    for(auto const c : s)
+        if(static_cast<unsigned char>(c) <= ' ' || c == '\x7f')
+            throw std::invalid_argument{"invalid request-target"};
+    target_.assign(s.data(), s.size());
+    if(! buffers_.empty())
+        buffers_[1] = net::buffer(target_);
+}
+
+string_view
+request_template::
+at(field name) const
+{
+    return at(to_string(name));
+}
+
+string_view
+request_template::
+at(string_view name) const
+{
+    auto const v = find(name);
+    if(! v)
+        throw std::out_of_range{"field not variable"};
+    return v->value;
+}
+
+void
+request_template::
+set(field name, string_view value)
+{
+    set(to_string(name), value);
+}
+
+void
+request_template::
+set(string_view name, string_view value)
+{
+    auto const v = find(name);
+    if(! v)
+        throw std::out_of_range{"field not variable"};
+    for(auto const c : value)
+        if(c == '\r' || c == '\n' || c == '\0')
+            throw std::invalid_argument{"invalid field value"};
+    v->value.assign(value.data(), value.size());
+    buffers_[3 + 2 * (v - fields_.data())] =
+        net::buffer(v->value);
+}
+
+void
+request_template::
+body(net::const_buffer b)
+{
+    if(! has_body_)
+        throw std::logic_error{"no Content-Length"};
+    body_ = b;
+    auto const r = std::to_chars(
+        length_, length_ + sizeof(length_), b.size());
+    BOOST_ASSERT(r.ec == std::errc{});
+    length_size_ = static_cast<std::size_t>(r.ptr - length_);
+    auto const i = 3 + 2 * fields_.size();
+    buffers_[i] = net::const_buffer(length_, length_size_);
+    buffers_[i + 2] = body_;
+}
+
+void
+request_template::
+reset() noexcept
+{
+    fixed_.clear();
+    target_.clear();
+    fields_.clear();
+    length_size_ = 0;
+    body_ = {};
+    has_body_ = false;
+    buffers_.clear();
+}
+
+void
+request_template::
+append(string_view s)
+{
+    fixed_.back().append(s.data(), s.size());
+}
+
+void
+request_template::
+start(
+    string_view method,
+    string_view target,
+    unsigned version)
+{
+    fixed_.emplace_back(method.data(), method.size());
+    fixed_.back().push_back(' ');
+    target_.assign(target.data(), target.size());
+    char v[] = " HTTP/x.x\r\n";
+    v[6] = static_cast<char>('0' + version / 10);
+    v[8] = static_cast<char>('0' + version % 10);
+    fixed_.emplace_back(v, sizeof(v) - 1);
+}
+
+void
+request_template::
+finish(bool has_body)
+{
+    for(auto const& v : fields_)
+    {
+        append(v.name);
+        append(": ");
+        fixed_.emplace_back("\r\n");
+    }
+    has_body_ = has_body;
+    if(has_body_)
+    {
+        append("Content-Length: ");
+        length_[0] = '0';
+        length_size_ = 1;
+        fixed_.emplace_back("\r\n\r\n");
+    }
+    else
+    {
+        append("\r\n");
+    }
+    bind();
+}
+
+auto
+request_template::
+find(string_view name) ->
+    variable*
+{
+    for(auto& v : fields_)
+        if(iequals(v.name, name))
+            return &v;
+    return nullptr;
+}
+
+auto
+request_template::
+find(string_view name) const ->
+    variable const*
+{
+    for(auto const& v : fields_)
+        if(iequals(v.name, name))
+            return &v;
+    return nullptr;
+}
+
+void
+request_template::
+bind()
+{
+    buffers_.clear();
+    if(fixed_.empty())
+        return; // moved-from
+    buffers_.reserve(fixed_.size() + fields_.size() + 1 +
+        (has_body_ ? 2 : 0));
+    buffers_.push_back(net::buffer(fixed_[0]));
+    buffers_.push_back(net::buffer(target_));
+    buffers_.push_back(net::buffer(fixed_[1]));
+    for(std::size_t i = 0; i < fields_.size(); ++i)
+    {
+        buffers_.push_back(net::buffer(fields_[i].value));
+        buffers_.push_back(net::buffer(fixed_[2 + i]));
+    }
+    if(has_body_)
+    {
+        buffers_.push_back(net::const_buffer(length_, length_size_));
+        buffers_.push_back(net::buffer(fixed_.back()));
+        buffers_.push_back(body_);
+    }
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
@@ -13,9 +13,11 @@
 #include <boost/beast/http/type_traits.hpp>
 #include <boost/beast/core/async_base.hpp>
 #include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/buffers_flatten.hpp>
 #include <boost/beast/core/buffers_range.hpp>
 #include <boost/beast/core/make_printable.hpp>
 #include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/trace.hpp>
 #include <boost/beast/core/detail/is_invocable.hpp>
 #include <asio/coroutine.hpp>
 #include <asio/post.hpp>
@@ -28,6 +30,11 @@ namespace beast {
 namespace http {
 namespace detail {
 
+// The serializer's buffers are flattened into an array of
+// this many, the most that a socket sends in one call, so
+// that the stream iterates them cheaply.
+std::size_t constexpr max_write_buffers = 64;
+
 template<
     class Handler,
     class Stream,
@@ -65,7 +72,8 @@ class write_some_op
             invoked = true;
             ec = {};
             op_.s_.async_write_some(
-                buffers, std::move(op_));
+                beast::buffers_flatten<max_write_buffers>(buffers),
+                    std::move(op_));
         }
     };
 
@@ -176,6 +184,8 @@ class write_op
     Stream& s_;
     serializer<isRequest, Body, Fields>& sr_;
     std::size_t bytes_transferred_ = 0;
+    trace_span span_;
+    bool header_;
 
 public:
     template<class Handler_>
@@ -188,6 +198,8 @@ public:
                 std::forward<Handler_>(h), s.get_executor())
         , s_(s)
         , sr_(sr)
+        , span_(! Predicate{}(sr))
+        , header_(sr.is_header_done())
     {
         (*this)();
     }
@@ -227,10 +239,20 @@ public:
                 bytes_transferred_ += bytes_transferred;
                 if(ec)
                     goto upcall;
+                if(! header_ && sr_.is_header_done())
+                {
+                    header_ = true;
+                    span_.lap(trace_phase::write_header);
+                }
                 if(Predicate{}(sr_))
                     break;
             }
         upcall:
+            if(! header_)
+                span_.finish(trace_phase::write_header, ec);
+            else if(std::is_same<
+                    Predicate, serializer_is_done>::value)
+                span_.finish(trace_phase::write_body, ec);
             this->complete_now(ec, bytes_transferred_);
         }
     }
@@ -433,8 +455,8 @@ public:
         ConstBufferSequence const& buffers)
     {
         invoked = true;
-        bytes_transferred =
-            stream_.write_some(buffers, ec);
+        bytes_transferred = stream_.write_some(
+            beast::buffers_flatten<max_write_buffers>(buffers), ec);
     }
 };
 
@@ -459,8 +481,8 @@ public:
         ConstBufferSequence const& buffers)
     {
         invoked = true;
-        bytes_transferred = net::write(
-            stream_, buffers, ec);
+        bytes_transferred = net::write(stream_,
+            beast::buffers_flatten<max_write_buffers>(buffers), ec);
     }
 };
 
@@ -479,6 +479,17 @@ private:
             body.data(), body.size()), ec);
     }
 
+    std::size_t
+    on_chunks_impl(
+        span<net::const_buffer const> chunks,
+        error_code& ec) override
+    {
+        // Chunk callbacks see each chunk
+        if(cb_h_ || cb_b_)
+            return 0;
+        return rd_.put(chunks, ec);
+    }
+
     void
     on_finish_impl(
         error_code& ec) override
@@ -0,0 +1,233 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_RELAY_HPP
+#define BOOST_BEAST_HTTP_RELAY_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/http/message.hpp>
+#include <asio/async_result.hpp>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** Relay a message from one stream to another.
+
+    This function reads a message header from the input stream,
+    lets the caller change it, writes it to the output stream and
+    then copies the body from the input to the output as it
+    arrives. The call will block until one of the following
+    conditions is true:
+
+    @li The complete message has been written to the output.
+
+    @li An error occurs.
+
+    The body passes through a fixed size buffer, so the memory
+    used does not depend on the size of the message. Its framing
+    is taken from the header as it is after the transformation: a
+    body which was received with the chunked transfer coding is
+    chunked again as it is written, and a body with a known length
+    is written as is. The parser used has no body limit.
+
+    When both streams are plain TCP sockets on Linux, and the body
+    is delimited by a Content-Length which the transformation did
+    not replace with chunked encoding, the body is moved between the
+    sockets with `splice(2)` and is never copied into user space.
+    This may be disabled by defining `BOOST_BEAST_NO_SPLICE`.
+
+    The implementation may read additional bytes from the input
+    that lie past the end of the message being relayed. These
+    additional bytes are stored in the dynamic buffer, which must
+    be preserved for subsequent reads.
+
+    @param input The stream from which the message is read. The
+    type must meet the <em>SyncReadStream</em> requirements.
+
+    @param output The stream to which the message is written. The
+    type must meet the <em>SyncWriteStream</em> requirements.
+
+    @param buffer Storage for additional bytes read from the input.
+    On entry, any bytes already in the buffer are used first.
+
+    @param transform A function object invoked with the header once
+    it has been read, before it is written. The equivalent function
+    signature must be:
+    @code
+    void transform(
+        header<isRequest>& h,   // the header to change
+        error_code& ec          // set to stop the relay
+    );
+    @endcode
+
+    @param ec Set to the error, if any occurred.
+
+    @return The number of bytes of body written to the output.
+
+    @note Responses to HEAD requests, which have no body whatever
+    their fields say, cannot be relayed with this function.
+*/
+template<
+    bool isRequest,
+    class SyncInputStream,
+    class SyncOutputStream,
+    class DynamicBuffer,
+    class Transform>
+std::size_t
+relay(
+    SyncInputStream& input,
+    SyncOutputStream& output,
+    DynamicBuffer& buffer,
+    Transform&& transform,
+    error_code& ec);
+
+/** Relay a message from one stream to another.
+
+    This function reads a message header from the input stream,
+    lets the caller change it, writes it to the output stream and
+    then copies the body from the input to the output as it
+    arrives. See the overload which takes an `error_code` for
+    details.
+
+    @throws system_error Thrown on failure.
+
+    @return The number of bytes of body written to the output.
+*/
+template<
+    bool isRequest,
+    class SyncInputStream,
+    class SyncOutputStream,
+    class DynamicBuffer,
+    class Transform>
+std::size_t
+relay(
+    SyncInputStream& input,
+    SyncOutputStream& output,
+    DynamicBuffer& buffer,
+    Transform&& transform);
+
+/** Relay a message from one stream to another asynchronously.
+
+    This function is used to asynchronously read a message header
+    from the input stream, let the caller change it, write it to
+    the output stream and then copy the body from the input to the
+    output as it arrives. The function call always returns
+    immediately. The asynchronous operation will continue until one
+    of the following conditions is true:
+
+    @li The complete message has been written to the output.
+
+    @li An error occurs.
+
+    This operation is implemented in terms of calls to the input's
+    `async_read_some` and the output's `async_write_some` functions,
+    and is known as a <em>composed operation</em>. The program must
+    ensure that no other reads are performed on the input, and no
+    other writes on the output, until this operation completes.
+
+    The body passes through a fixed size buffer, so the memory
+    used does not depend on the size of the message. Its framing
+    is taken from the header as it is after the transformation: a
+    body which was received with the chunked transfer coding is
+    chunked again as it is written, and a body with a known length
+    is written as is. The parser used has no body limit.
+
+    When both streams are plain TCP sockets on Linux, and the body
+    is delimited by a Content-Length which the transformation did
+    not replace with chunked encoding, the body is moved between the
+    sockets with `splice(2)` and is never copied into user space.
+    The sockets are then put in non-blocking mode. This may be
+    disabled by defining `BOOST_BEAST_NO_SPLICE`.
+
+    The implementation may read additional bytes from the input
+    that lie past the end of the message being relayed. These
+    additional bytes are stored in the dynamic buffer, which must
+    be preserved for subsequent reads.
+
+    @par Example
+    A reverse proxy forwarding a request to the upstream server:
+    @code
+    http::async_relay<true>(client, upstream, buffer,
+        [](http::request_header<>& h, error_code&)
+        {
+            h.set(http::field::host, "backend.local");
+            h.erase(http::field::proxy_authorization);
+        },
+        on_relay);
+    @endcode
+
+    @param input The stream from which the message is read. The
+    type must meet the <em>AsyncReadStream</em> requirements.
+
+    @param output The stream to which the message is written. The
+    type must meet the <em>AsyncWriteStream</em> requirements.
+
+    @param buffer Storage for additional bytes read from the input.
+    On entry, any bytes already in the buffer are used first. The
+    object must remain valid at least until the handler is called;
+    ownership is not transferred.
+
+    @param transform A function object invoked with the header once
+    it has been read, before it is written. The implementation takes
+    ownership of the function object by performing a decay-copy. The
+    equivalent function signature must be:
+    @code
+    void transform(
+        header<isRequest>& h,   // the header to change
+        error_code& ec          // set to stop the relay
+    );
+    @endcode
+
+    @param handler The completion handler to invoke when the operation
+    completes. The implementation takes ownership of the handler by
+    performing a decay-copy. The equivalent function signature of
+    the handler must be:
+    @code
+    void handler(
+        error_code const& error,        // result of operation
+        std::size_t bytes_transferred   // the number of bytes of body written
+    );
+    @endcode
+    Regardless of whether the asynchronous operation completes
+    immediately or not, the handler will not be invoked from within
+    this function. Invocation of the handler will be performed in a
+    manner equivalent to using `net::post`.
+
+    @note Responses to HEAD requests, which have no body whatever
+    their fields say, cannot be relayed with this function.
+*/
+template<
+    bool isRequest,
+    class AsyncInputStream,
+    class AsyncOutputStream,
+    class DynamicBuffer,
+    class Transform,
+    BOOST_BEAST_ASYNC_TPARAM2 RelayHandler =
+        net::default_completion_token_t<
+            executor_type<AsyncInputStream>>>
+BOOST_BEAST_ASYNC_RESULT2(RelayHandler)
+async_relay(
+    AsyncInputStream& input,
+    AsyncOutputStream& output,
+    DynamicBuffer& buffer,
+    Transform&& transform,
+    RelayHandler&& handler =
+        net::default_completion_token_t<
+            executor_type<AsyncInputStream>>{});
+
+} // http
+} // beast
+} // boost
+
+#include <boost/beast/http/impl/relay.hpp>
+
+#endif
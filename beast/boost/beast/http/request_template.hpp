@@ -0,0 +1,320 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_REQUEST_TEMPLATE_HPP
+#define BOOST_BEAST_HTTP_REQUEST_TEMPLATE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/span.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/field.hpp>
+#include <boost/beast/http/message.hpp>
+#include <asio/buffer.hpp>
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** A pre-serialized request with patchable parts.
+
+    Clients which send many requests that differ only in a few
+    places, such as the target, an authorization token or the
+    body, pay for serializing the same start-line and fields
+    again for every message. This class serializes a request
+    once, at construction, and keeps the result as fixed text
+    interleaved with the few parts which may change:
+
+    @li The request-target.
+
+    @li The values of the fields named at construction.
+
+    @li The body, if the request has a Content-Length field. The
+    value of Content-Length then follows the size of the body.
+
+    Changing one of these parts replaces one buffer in the
+    sequence returned by @ref buffers, which may be passed directly
+    to `net::write` or `net::async_write` on any stream, such as
+    @ref tcp_stream or `ssl_stream`, without going through the
+    @ref serializer.
+
+    The variable fields are sent after the other fields, in the
+    order in which they were named. The body is not copied; the
+    memory it refers to must remain valid until the write which
+    uses it completes.
+
+    @par Example
+    @code
+    request<empty_body> req{verb::post, "/", 11};
+    req.set(field::host, "example.com");
+    req.set(field::authorization, "Bearer x");
+    req.content_length(0);
+
+    request_template t(req, {field::authorization});
+    for(auto const& item : items)
+    {
+        t.target(item.path);
+        t.set(field::authorization, token());
+        t.body(net::buffer(item.payload));
+        net::write(stream, t.buffers());
+    }
+    @endcode
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Unsafe.
+*/
+class request_template
+{
+    struct variable
+    {
+        std::string name;
+        std::string value;
+    };
+
+    // fixed text, one piece between each pair of variable parts
+    std::vector<std::string> fixed_;
+    std::string target_;
+    std::vector<variable> fields_;
+    char length_[20];
+    std::size_t length_size_ = 0;
+    net::const_buffer body_;
+    bool has_body_ = false;
+
+    // the buffers presented to the caller
+    std::vector<net::const_buffer> buffers_;
+
+public:
+    /// The type of buffer sequence returned by @ref buffers
+    using const_buffers_type = span<net::const_buffer const>;
+
+    /** Constructor
+
+        The start-line and fields of the request are serialized.
+
+        @param req The request to serialize. If a Content-Length
+        field is present, the body of the template is variable
+        and initially empty.
+
+        @param variable The names of the fields whose values may
+        be changed with @ref set. Each field present in `req` is
+        given its first value there; a field which is not present
+        starts with an empty value.
+
+        @throws std::invalid_argument if the request uses the
+        chunked Transfer-Encoding, which a template cannot patch.
+    */
+    template<class Fields>
+    explicit
+    request_template(
+        request<empty_body, Fields> const& req,
+        std::initializer_list<field> variable = {});
+
+    /** Constructor
+
+        The start-line and fields of the request are serialized.
+
+        @param req The request to serialize. If a Content-Length
+        field is present, the body of the template is variable
+        and initially empty.
+
+        @param variable The names of the fields whose values may
+        be changed with @ref set. Each field present in `req` is
+        given its first value there; a field which is not present
+        starts with an empty value.
+
+        @throws std::invalid_argument if the request uses the
+        chunked Transfer-Encoding, which a template cannot patch.
+    */
+    template<class Fields>
+    request_template(
+        request<empty_body, Fields> const& req,
+        std::initializer_list<string_view> variable);
+
+    /// Constructor
+    BOOST_BEAST_DECL
+    request_template(request_template const& other);
+
+    /** Constructor
+
+        After the move, `other` is empty: it has no buffers,
+        no variable fields and no variable body.
+    */
+    BOOST_BEAST_DECL
+    request_template(request_template&& other);
+
+    /// Assignment
+    BOOST_BEAST_DECL
+    request_template&
+    operator=(request_template const& other);
+
+    /** Assignment
+
+        After the move, `other` is empty: it has no buffers,
+        no variable fields and no variable body.
+    */
+    BOOST_BEAST_DECL
+    request_template&
+    operator=(request_template&& other);
+
+    /** Return the serialized request.
+
+        The buffers remain valid until the template is modified
+        or destroyed.
+    */
+    const_buffers_type
+    buffers() const noexcept
+    {
+        return {buffers_.data(), buffers_.size()};
+    }
+
+    /// Return the total number of bytes in the serialized request
+    BOOST_BEAST_DECL
+    std::size_t
+    size() const noexcept;
+
+    /// Return the request-target
+    string_view
+    target() const noexcept
+    {
+        return target_;
+    }
+
+    /** Set the request-target
+
+        @throws std::invalid_argument if `s` contains whitespace
+        or control characters.
+    */
+    BOOST_BEAST_DECL
+    void
+    target(string_view s);
+
+    /** Return the value of a variable field.
+
+        @throws std::out_of_range if the field was not named
+        as variable at construction.
+    */
+    BOOST_BEAST_DECL
+    string_view
+    at(field name) const;
+
+    /** Return the value of a variable field.
+
+        @throws std::out_of_range if the field was not named
+        as variable at construction.
+    */
+    BOOST_BEAST_DECL
+    string_view
+    at(string_view name) const;
+
+    /** Set the value of a variable field.
+
+        @throws std::out_of_range if the field was not named
+        as variable at construction.
+
+        @throws std::invalid_argument if `value` contains a
+        CR, LF or NUL character.
+    */
+    BOOST_BEAST_DECL
+    void
+    set(field name, string_view value);
+
+    /** Set the value of a variable field.
+
+        @throws std::out_of_range if the field was not named
+        as variable at construction.
+
+        @throws std::invalid_argument if `value` contains a
+        CR, LF or NUL character.
+    */
+    BOOST_BEAST_DECL
+    void
+    set(string_view name, string_view value);
+
+    /// Returns `true` if the body of the template is variable
+    bool
+    has_body() const noexcept
+    {
+        return has_body_;
+    }
+
+    /// Return the body
+    net::const_buffer
+    body() const noexcept
+    {
+        return body_;
+    }
+
+    /** Set the body.
+
+        The Content-Length field is set to the size of the body.
+        The memory is not copied, and must remain valid until the
+        write using it completes.
+
+        @throws std::logic_error if the request given at
+        construction did not have a Content-Length field.
+    */
+    BOOST_BEAST_DECL
+    void
+    body(net::const_buffer b);
+
+private:
+    BOOST_BEAST_DECL
+    void
+    reset() noexcept;
+
+    BOOST_BEAST_DECL
+    void
+    append(string_view s);
+
+    BOOST_BEAST_DECL
+    void
+    start(
+        string_view method,
+        string_view target,
+        unsigned version);
+
+    BOOST_BEAST_DECL
+    void
+    finish(bool has_body);
+
+    BOOST_BEAST_DECL
+    variable*
+    find(string_view name);
+
+    BOOST_BEAST_DECL
+    variable const*
+    find(string_view name) const;
+
+    BOOST_BEAST_DECL
+    void
+    bind();
+
+    template<class Fields>
+    void
+    construct(
+        request<empty_body, Fields> const& req,
+        string_view const* names,
+        std::size_t count);
+};
+
+} // http
+} // beast
+} // boost
+
+#include <boost/beast/http/impl/request_template.hpp>
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/http/impl/request_template.ipp>
+#endif
+
+#endif
@@ -15,7 +15,9 @@
 // This include is necessary to work with `ssl::stream` and `boost::beast::websocket::stream`
 #include <boost/beast/websocket/ssl.hpp>
 
+#include <boost/beast/core/async_base.hpp>
 #include <boost/beast/core/flat_stream.hpp>
+#include <boost/beast/core/trace.hpp>
 
 // VFALCO We include this because anyone who uses ssl will
 //        very likely need to check for ssl::error::stream_truncated
@@ -78,6 +80,11 @@ class ssl_stream
 
     std::unique_ptr<stream_type> p_;
 
+    template<class Handler>
+    class handshake_op;
+
+    struct run_handshake_op;
+
 public:
     /// The native handle type of the SSL stream.
     using native_handle_type =
@@ -405,8 +412,13 @@ public:
     async_handshake(handshake_type type,
         ASIO_MOVE_ARG(HandshakeHandler) handler)
     {
-        return p_->next_layer().async_handshake(type,
-            ASIO_MOVE_CAST(HandshakeHandler)(handler));
+        return net::async_initiate<
+            HandshakeHandler,
+            void(std::error_code)>(
+                run_handshake_op{},
+                handler,
+                this,
+                type);
     }
 
     /** Start an asynchronous SSL handshake.
@@ -435,8 +447,14 @@ public:
     async_handshake(handshake_type type, ConstBufferSequence const& buffers,
         ASIO_MOVE_ARG(BufferedHandshakeHandler) handler)
     {
-        return p_->next_layer().async_handshake(type, buffers,
-            ASIO_MOVE_CAST(BufferedHandshakeHandler)(handler));
+        return net::async_initiate<
+            BufferedHandshakeHandler,
+            void(std::error_code, std::size_t)>(
+                run_handshake_op{},
+                handler,
+                this,
+                type,
+                buffers);
     }
 
     /** Shut down SSL on the stream.
@@ -668,6 +686,56 @@ public:
 };
 
 #if ! BOOST_BEAST_DOXYGEN
+// Reports the duration of the handshake to the tracer
+template<class NextLayer>
+template<class Handler>
+class ssl_stream<NextLayer>::handshake_op
+    : public async_base<Handler, executor_type>
+{
+    trace_span span_;
+
+public:
+    template<class Handler_, class... Args>
+    handshake_op(
+        Handler_&& h,
+        ssl_stream& s,
+        Args const&... args)
+        : async_base<Handler, executor_type>(
+            std::forward<Handler_>(h), s.get_executor())
+    {
+        s.p_->next_layer().async_handshake(
+            args..., std::move(*this));
+    }
+
+    template<class... Args>
+    void
+    operator()(std::error_code ec, Args... args)
+    {
+        span_.finish(trace_phase::tls_handshake, ec);
+        this->complete_now(ec, args...);
+    }
+};
+
+template<class NextLayer>
+struct ssl_stream<NextLayer>::run_handshake_op
+{
+    template<class Handler, class... Args>
+    void
+    operator()(
+        Handler&& h,
+        ssl_stream* s,
+        Args const&... args)
+    {
+        // Without a tracer there is nothing to measure
+        if(! get_tracer())
+            s->p_->next_layer().async_handshake(
+                args..., std::forward<Handler>(h));
+        else
+            handshake_op<typename std::decay<Handler>::type>(
+                std::forward<Handler>(h), *s, args...);
+    }
+};
+
 template<class SyncStream>
 void
 teardown(
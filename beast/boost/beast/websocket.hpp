@@ -13,7 +13,9 @@
 #include <boost/beast/core/detail/config.hpp>
 
 #include <boost/beast/websocket/error.hpp>
+#include <boost/beast/websocket/keepalive.hpp>
 #include <boost/beast/websocket/option.hpp>
+#include <boost/beast/websocket/prepared_message.hpp>
 #include <boost/beast/websocket/rfc6455.hpp>
 #include <boost/beast/websocket/stream.hpp>
 #include <boost/beast/websocket/stream_base.hpp>
@@ -163,6 +163,19 @@ struct impl_base<true>
         }
     }
 
+    // Returns the window bits of the compressor when each
+    // message is compressed on its own, so that a frame
+    // compressed in advance may be sent. Otherwise zero.
+    int
+    deflate_shared_bits(role_type role) const
+    {
+        if(role == role_type::client)
+            return pmd_config_.client_no_context_takeover ?
+                pmd_config_.client_max_window_bits : 0;
+        return pmd_config_.server_no_context_takeover ?
+            pmd_config_.server_max_window_bits : 0;
+    }
+
     void
     inflate(
         zlib::z_params& zs,
@@ -371,6 +384,12 @@ struct impl_base<false>
     {
     }
 
+    int
+    deflate_shared_bits(role_type) const
+    {
+        return 0;
+    }
+
     void
     inflate(
         zlib::z_params&,
@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_DETAIL_KEEPALIVE_WHEEL_HPP
+#define BOOST_BEAST_WEBSOCKET_DETAIL_KEEPALIVE_WHEEL_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <asio/any_io_executor.hpp>
+#include <asio/steady_timer.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+// A timing wheel which visits each entry when it is due. All
+// entries due in the same tick are visited in one pass, from
+// the completion of the single timer the wheel runs.
+//
+class keepalive_wheel
+    : public std::enable_shared_from_this<keepalive_wheel>
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    class entry
+    {
+    public:
+        std::uint64_t tick = 0;         // when the entry is due
+
+        virtual ~entry() = default;
+
+        // Returns `false` to remove the entry,
+        // else sets `next` to when it is due again.
+        virtual
+        bool
+        visit(
+            keepalive_wheel& w,
+            clock_type::time_point now,
+            clock_type::time_point& next) = 0;
+    };
+
+    using entry_ptr = std::unique_ptr<entry>;
+
+    // Counters, maintained by the wheel and the entries
+    std::size_t size = 0;
+    std::uint64_t passes = 0;
+    std::uint64_t pings = 0;
+    std::uint64_t pongs = 0;
+    std::uint64_t timeouts = 0;
+    clock_type::duration rtt_min{};
+    clock_type::duration rtt_max{};
+    clock_type::duration rtt_sum{};
+
+    BOOST_BEAST_DECL
+    keepalive_wheel(
+        net::any_io_executor const& ex,
+        clock_type::duration resolution,
+        std::size_t slots);
+
+    // Returns a new id, for an entry or a ping payload
+    std::uint64_t
+    next_id() noexcept
+    {
+        return ++id_;
+    }
+
+    // Add an entry due at `when`
+    BOOST_BEAST_DECL
+    void
+    insert(entry_ptr e, clock_type::time_point when);
+
+    BOOST_BEAST_DECL
+    void
+    on_rtt(clock_type::duration rtt);
+
+    // Remove all entries and stop the timer
+    BOOST_BEAST_DECL
+    void
+    clear();
+
+private:
+    BOOST_BEAST_DECL
+    std::uint64_t
+    tick_at(clock_type::time_point t) const;
+
+    BOOST_BEAST_DECL
+    void
+    place(entry_ptr e);
+
+    BOOST_BEAST_DECL
+    void
+    arm();
+
+    BOOST_BEAST_DECL
+    void
+    on_timer(error_code ec);
+
+    net::steady_timer timer_;
+    clock_type::duration resolution_;
+    clock_type::time_point start_;
+    std::vector<std::vector<entry_ptr>> slots_;
+    std::vector<entry_ptr> due_;
+    std::uint64_t tick_ = 0;            // last tick visited
+    std::uint64_t id_ = 0;
+    bool armed_ = false;
+};
+
+} // detail
+} // websocket
+} // beast
+} // boost
+
+#if BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/websocket/detail/keepalive_wheel.ipp>
+#endif
+
+#endif
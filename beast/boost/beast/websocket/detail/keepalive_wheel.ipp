@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_DETAIL_KEEPALIVE_WHEEL_IPP
+#define BOOST_BEAST_WEBSOCKET_DETAIL_KEEPALIVE_WHEEL_IPP
+
+#include <boost/beast/websocket/detail/keepalive_wheel.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+keepalive_wheel::
+keepalive_wheel(
+    net::any_io_executor const& ex,
+    clock_type::duration resolution,
+    std::size_t slots)
+    : timer_(ex)
+    , resolution_(resolution)
+    , start_(clock_type::now())
+    , slots_(slots)
+{
+    BOOST_ASSERT(resolution_.count() > 0);
+    BOOST_ASSERT(slots > 0);
+}
+
+void
+keepalive_wheel::
+insert(entry_ptr e, clock_type::time_point when)
+{
+    e->tick = tick_at(when);
+    place(std::move(e));
+    ++size;
+    arm();
+}
+
+void
+keepalive_wheel::
+on_rtt(clock_type::duration rtt)
+{
+    if(pongs == 0 || rtt < rtt_min)
+        rtt_min = rtt;
+    if(rtt > rtt_max)
+        rtt_max = rtt;
+    rtt_sum += rtt;
+    ++pongs;
+}
+
+void
+keepalive_wheel::
+clear()
+{
+    for(auto& slot : slots_)
+        slot.clear();
+    size = 0;
+    timer_.cancel();
+}
+
+// The first tick at or after `t`, and after the last one visited
+std::uint64_t
+keepalive_wheel::
+tick_at(clock_type::time_point t) const
+{
+    if(t <= start_)
+        return tick_ + 1;
+    auto const d = t - start_;
+    std::uint64_t const n =
+        (d + resolution_ - clock_type::duration(1)) / resolution_;
+    return (std::max)(n, tick_ + 1);
+}
+
+void
+keepalive_wheel::
+place(entry_ptr e)
+{
+    auto& slot = slots_[e->tick % slots_.size()];
+    slot.push_back(std::move(e));
+}
+
+void
+keepalive_wheel::
+arm()
+{
+    if(armed_ || size == 0)
+        return;
+    armed_ = true;
+    timer_.expires_at(start_ + resolution_ * (tick_ + 1));
+    timer_.async_wait(
+        [wp = weak_from_this()](error_code ec)
+        {
+            if(auto sp = wp.lock())
+                sp->on_timer(ec);
+        });
+}
+
+void
+keepalive_wheel::
+on_timer(error_code ec)
+{
+    armed_ = false;
+    if(ec == net::error::operation_aborted)
+    {
+        // cleared, or canceled and then given new entries
+        arm();
+        return;
+    }
+    auto const now = clock_type::now();
+    std::uint64_t const last =
+        (now - start_) / resolution_;
+    if(last <= tick_)
+    {
+        arm();
+        return;
+    }
+    ++passes;
+
+    // Collect everything due from the slots passed, going
+    // around the wheel at most once if the timer was late.
+    auto const n = (std::min)(
+        last - tick_, std::uint64_t(slots_.size()));
+    for(std::uint64_t i = 1; i <= n; ++i)
+    {
+        auto& slot = slots_[(tick_ + i) % slots_.size()];
+        std::size_t kept = 0;
+        for(auto& e : slot)
+        {
+            if(e->tick <= last)
+                due_.push_back(std::move(e));
+            else
+                slot[kept++] = std::move(e);
+        }
+        slot.resize(kept);
+    }
+    tick_ = last;
+
+    for(auto& e : due_)
+    {
+        clock_type::time_point next;
+        if(e->visit(*this, now, next))
+        {
+            e->tick = tick_at(next);
+            place(std::move(e));
+        }
+        else
+        {
+            --size;
+        }
+    }
+    due_.clear();
+    arm();
+}
+
+} // detail
+} // websocket
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_DETAIL_PAYLOAD_HPP
+#define BOOST_BEAST_WEBSOCKET_DETAIL_PAYLOAD_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/websocket/detail/mask.hpp>
+#include <boost/beast/websocket/detail/utf8_checker.hpp>
+#include <asio/buffer.hpp>
+#include <algorithm>
+#include <cstddef>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+// Copy payload in one pass, removing the mask when
+// `key` is not null and checking the text when `utf8`
+// is not null. `out` may equal `in`. Returns `false`
+// if the text is not valid UTF-8.
+//
+BOOST_BEAST_DECL
+bool
+copy_payload(
+    void* out,
+    void const* in,
+    std::size_t n,
+    prepared_key* key,
+    utf8_checker* utf8);
+
+// Copy up to `n` bytes of payload in one pass, removing
+// the mask when `key` is not null and checking the text
+// when `utf8` is not null. `out` may be the same sequence
+// as `in`. Returns `false` if the text is not valid UTF-8.
+//
+template<
+    class MutableBufferSequence,
+    class ConstBufferSequence>
+bool
+copy_payload(
+    MutableBufferSequence const& out,
+    ConstBufferSequence const& in,
+    std::size_t n,
+    prepared_key* key,
+    utf8_checker* utf8)
+{
+    auto out_it = net::buffer_sequence_begin(out);
+    auto const out_end = net::buffer_sequence_end(out);
+    auto in_it = net::buffer_sequence_begin(in);
+    auto const in_end = net::buffer_sequence_end(in);
+    net::mutable_buffer ob;
+    net::const_buffer ib;
+    while(n > 0)
+    {
+        if(ob.size() == 0)
+        {
+            if(out_it == out_end)
+                break;
+            ob = *out_it++;
+            continue;
+        }
+        if(ib.size() == 0)
+        {
+            if(in_it == in_end)
+                break;
+            ib = *in_it++;
+            continue;
+        }
+        auto const len = (std::min)(
+            {n, ob.size(), ib.size()});
+        if(! detail::copy_payload(
+                ob.data(), ib.data(), len, key, utf8))
+            return false;
+        ob += len;
+        ib += len;
+        n -= len;
+    }
+    return true;
+}
+
+} // detail
+} // websocket
+} // beast
+} // boost
+
+#if BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/websocket/detail/payload.ipp>
+#endif
+
+#endif
@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_DETAIL_PAYLOAD_IPP
+#define BOOST_BEAST_WEBSOCKET_DETAIL_PAYLOAD_IPP
+
+#include <boost/beast/websocket/detail/payload.hpp>
+#include <cstring>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+bool
+copy_payload(
+    void* out,
+    void const* in,
+    std::size_t n,
+    prepared_key* key,
+    utf8_checker* utf8)
+{
+    // Small enough that a block which is not all ASCII
+    // is still in the L1 cache when it is validated.
+    std::size_t constexpr block = 1024;
+    static_assert(block % sizeof(std::size_t) == 0, "");
+    static_assert(sizeof(std::size_t) % 4 == 0, "");
+    auto constexpr high = static_cast<std::size_t>(
+        0x8080808080808080 & ~std::size_t{0});
+
+    auto d = static_cast<unsigned char*>(out);
+    auto s = static_cast<unsigned char const*>(in);
+    if(! key && ! utf8)
+    {
+        if(d != s)
+            std::memcpy(d, s, n);
+        return true;
+    }
+
+    // the key repeated across a word, every
+    // block starts on a multiple of 4 bytes
+    prepared_key const k = key ? *key : prepared_key{};
+    std::size_t m;
+    for(std::size_t i = 0; i < sizeof(m); i += 4)
+        std::memcpy(reinterpret_cast<unsigned char*>(&m) + i,
+            k.data(), 4);
+
+    auto remain = n;
+    while(remain > 0)
+    {
+        auto const len = (std::min)(remain, block);
+        std::size_t bits = 0;
+        std::size_t i = 0;
+        for(; i + sizeof(std::size_t) <= len;
+            i += sizeof(std::size_t))
+        {
+            std::size_t w;
+            std::memcpy(&w, s + i, sizeof(w));
+            w ^= m;
+            std::memcpy(d + i, &w, sizeof(w));
+            bits |= w;
+        }
+        for(; i < len; ++i)
+        {
+            unsigned char const c = s[i] ^ k[i % 4];
+            d[i] = c;
+            bits |= c;
+        }
+
+        // Text which is all ASCII, between whole code
+        // points, is valid without looking at it again.
+        if(utf8 && ((bits & high) != 0 || utf8->partial()))
+            if(! utf8->write(d, len))
+                return false;
+        d += len;
+        s += len;
+        remain -= len;
+    }
+
+    if(key)
+        std::rotate(key->begin(),
+            key->begin() + n % 4, key->end());
+    return true;
+}
+
+} // detail
+} // websocket
+} // beast
+} // boost
+
+#endif
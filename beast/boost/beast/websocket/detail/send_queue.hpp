@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_DETAIL_SEND_QUEUE_HPP
+#define BOOST_BEAST_WEBSOCKET_DETAIL_SEND_QUEUE_HPP
+
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/websocket/stream_base.hpp>
+#include <boost/beast/websocket/detail/frame.hpp>
+#include <asio/buffer.hpp>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+// Messages waiting to be sent by a stream. Any thread may
+// push, the stream's executor takes them off in batches.
+//
+class send_queue
+{
+public:
+    // A queued message, which owns its completion handler
+    class message
+    {
+    public:
+        std::size_t size = 0;           // payload bytes
+        opcode op = opcode::text;
+
+        virtual ~message() = default;
+
+        // Append the payload buffers to `v`
+        virtual
+        void
+        buffers(std::vector<net::const_buffer>& v) const = 0;
+
+        // Copy the payload to `dest`
+        virtual
+        void
+        copy(void* dest) const = 0;
+
+        // Deliver the result, never from within this call's caller
+        virtual
+        void
+        complete(error_code ec) = 0;
+    };
+
+    using message_ptr = std::unique_ptr<message>;
+
+    // Limits on one batch, which always has at least one message
+    static std::size_t constexpr max_batch_bytes = 64 * 1024;
+    static std::size_t constexpr max_batch_size = 64;
+
+    // Returns `false` without taking `m` if it would put the
+    // queue over the limit. Otherwise sets `flush` when the
+    // caller must start the operation which sends the queue.
+    BOOST_BEAST_DECL
+    bool
+    push(message_ptr& m, bool& flush);
+
+    // Move the next batch to `batch`. Returns `false` and
+    // stops flushing if there is nothing left to send.
+    BOOST_BEAST_DECL
+    bool
+    take(std::vector<message_ptr>& batch);
+
+    // Move everything to `v` and stop flushing
+    BOOST_BEAST_DECL
+    void
+    take_all(std::vector<message_ptr>& v);
+
+    // Destroy the queued messages without completing them
+    BOOST_BEAST_DECL
+    void
+    clear();
+
+    BOOST_BEAST_DECL
+    void
+    limit(std::size_t bytes);
+
+    BOOST_BEAST_DECL
+    std::size_t
+    limit() const;
+
+    BOOST_BEAST_DECL
+    stream_base::send_queue_stats
+    stats() const;
+
+private:
+    mutable std::mutex m_;
+    std::deque<message_ptr> q_;
+    std::size_t limit_ = 16 * 1024 * 1024;
+    bool flushing_ = false;
+    stream_base::send_queue_stats stats_;
+};
+
+} // detail
+} // websocket
+} // beast
+} // boost
+
+#if BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/websocket/detail/send_queue.ipp>
+#endif
+
+#endif
@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_DETAIL_SEND_QUEUE_IPP
+#define BOOST_BEAST_WEBSOCKET_DETAIL_SEND_QUEUE_IPP
+
+#include <boost/beast/websocket/detail/send_queue.hpp>
+#include <algorithm>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+bool
+send_queue::
+push(message_ptr& m, bool& flush)
+{
+    std::lock_guard<std::mutex> lock(m_);
+    if(m->size > limit_ - (std::min)(limit_, stats_.bytes))
+        return false;
+    stats_.bytes += m->size;
+    q_.push_back(std::move(m));
+    stats_.depth = q_.size();
+    flush = ! flushing_;
+    flushing_ = true;
+    return true;
+}
+
+bool
+send_queue::
+take(std::vector<message_ptr>& batch)
+{
+    std::lock_guard<std::mutex> lock(m_);
+    if(q_.empty())
+    {
+        flushing_ = false;
+        return false;
+    }
+    std::size_t bytes = 0;
+    do
+    {
+        bytes += q_.front()->size;
+        batch.push_back(std::move(q_.front()));
+        q_.pop_front();
+    }
+    while(! q_.empty() &&
+        batch.size() < max_batch_size &&
+        bytes + q_.front()->size <= max_batch_bytes);
+    stats_.bytes -= bytes;
+    stats_.depth = q_.size();
+    stats_.batches += 1;
+    stats_.messages += batch.size();
+    stats_.largest_batch =
+        (std::max)(stats_.largest_batch, batch.size());
+    return true;
+}
+
+void
+send_queue::
+take_all(std::vector<message_ptr>& v)
+{
+    std::lock_guard<std::mutex> lock(m_);
+    for(auto& m : q_)
+        v.push_back(std::move(m));
+    q_.clear();
+    stats_.bytes = 0;
+    stats_.depth = 0;
+    flushing_ = false;
+}
+
+void
+send_queue::
+clear()
+{
+    std::deque<message_ptr> q;
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        q.swap(q_);
+        stats_.bytes = 0;
+        stats_.depth = 0;
+        flushing_ = false;
+    }
+}
+
+void
+send_queue::
+limit(std::size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_);
+    limit_ = bytes;
+}
+
+std::size_t
+send_queue::
+limit() const
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return limit_;
+}
+
+stream_base::send_queue_stats
+send_queue::
+stats() const
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return stats_;
+}
+
+} // detail
+} // websocket
+} // beast
+} // boost
+
+#endif
@@ -45,6 +45,14 @@ public:
     bool
     finish();
 
+    /** Returns `true` if the last code point written is incomplete
+    */
+    bool
+    partial() const noexcept
+    {
+        return need_ != 0;
+    }
+
     /** Check if text is valid UTF8
 
         @return `true` if the text is valid utf8 or false otherwise.
@@ -65,6 +65,8 @@ public:
         case error::bad_close_code:         return "The WebSocket close frame reason code was invalid";
         case error::bad_close_size:         return "The WebSocket close frame payload size was invalid";
         case error::bad_close_payload:      return "The WebSocket close frame payload was not valid utf8";
+
+        case error::send_queue_full:        return "The WebSocket send queue limit would be exceeded";
         }
     }
 
@@ -78,6 +80,7 @@ public:
         case error::buffer_overflow:
         case error::partial_deflate_block:
         case error::message_too_big:
+        case error::send_queue_full:
             return {ev, *this};
 
         case error::bad_http_version:
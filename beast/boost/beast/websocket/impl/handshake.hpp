@@ -19,6 +19,7 @@
 #include <boost/beast/core/async_base.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/trace.hpp>
 #include <asio/coroutine.hpp>
 #include <boost/assert.hpp>
 #include <memory>
@@ -59,6 +60,7 @@ class stream<NextLayer, deflateSupported>::handshake_op
     detail::sec_ws_key_type key_;
     response_type* res_p_;
     data& d_;
+    trace_span span_;
 
 public:
     template<class Handler_>
@@ -178,6 +180,7 @@ public:
                 swap(d_.p.get(), *res_p_);
 
         upcall:
+            span_.finish(trace_phase::websocket_handshake, ec);
             this->complete(cont ,ec);
         }
     }
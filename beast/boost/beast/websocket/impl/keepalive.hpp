@@ -0,0 +1,161 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_IMPL_KEEPALIVE_HPP
+#define BOOST_BEAST_WEBSOCKET_IMPL_KEEPALIVE_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+// The watch on one stream. The stream refers back to it by
+// owner and id, which remove() clears, and the entry is
+// dropped when it is next visited.
+template<class Impl>
+class keepalive::entry
+    : public detail::keepalive_wheel::entry
+{
+    using clock_type = detail::keepalive_wheel::clock_type;
+
+    std::weak_ptr<Impl> wp_;
+    std::uint64_t id_;
+    duration interval_;
+    duration timeout_;
+    clock_type::time_point last_;       // when activity was seen
+    clock_type::time_point sent_;       // when the ping was sent
+    std::uint64_t seen_;                // the stream's activity count
+    bool waiting_ = false;              // for a pong
+
+public:
+    entry(
+        std::shared_ptr<Impl> const& sp,
+        std::uint64_t id,
+        duration interval,
+        duration timeout,
+        clock_type::time_point now)
+        : wp_(sp)
+        , id_(id)
+        , interval_(interval)
+        , timeout_(timeout)
+        , last_(now)
+        , seen_(sp->rd_activity)
+    {
+    }
+
+    bool
+    visit(
+        detail::keepalive_wheel& w,
+        clock_type::time_point now,
+        clock_type::time_point& next) override
+    {
+        auto sp = wp_.lock();
+        if(! sp || sp->ka_owner != &w || sp->ka_id != id_)
+            return false;
+        auto& impl = *sp;
+        if(! impl.is_open())
+        {
+            impl.ka_owner = nullptr;
+            return false;
+        }
+
+        if(waiting_ && ! impl.ka_waiting)
+        {
+            waiting_ = false;
+            w.on_rtt(impl.ka_pong - sent_);
+        }
+        if(impl.rd_activity != seen_)
+        {
+            seen_ = impl.rd_activity;
+            last_ = now;
+        }
+
+        if(now - last_ >= timeout_)
+        {
+            impl.ka_owner = nullptr;
+            impl.ka_waiting = false;
+            impl.time_out();
+            ++w.timeouts;
+            return false;
+        }
+
+        if(! waiting_ && now - last_ >= interval_)
+        {
+            ping_data payload;
+            auto const token = w.next_id();
+            payload.resize(sizeof(token));
+            std::memcpy(payload.data(), &token, sizeof(token));
+            if(impl.keepalive_ping(payload))
+            {
+                waiting_ = true;
+                sent_ = now;
+                ++w.pings;
+            }
+            else
+            {
+                // try again on the next tick
+                next = now;
+                return true;
+            }
+        }
+        if(waiting_)
+            // look for the pong after another interval
+            next = (std::min)(last_ + timeout_, now + interval_);
+        else
+            next = last_ + interval_;
+        return true;
+    }
+};
+
+template<class NextLayer, bool deflateSupported>
+void
+keepalive::
+add(
+    stream<NextLayer, deflateSupported>& ws,
+    duration ping_interval,
+    duration idle_timeout)
+{
+    if(ping_interval.count() <= 0)
+        throw std::invalid_argument{
+            "ping_interval must be positive"};
+    if(idle_timeout <= ping_interval)
+        throw std::invalid_argument{
+            "idle_timeout must be greater than ping_interval"};
+    auto const& sp = ws.impl_;
+    auto& w = *impl_;
+    sp->ka_owner = &w;
+    sp->ka_id = w.next_id();
+    sp->ka_waiting = false;
+    auto const now = clock_type::now();
+    w.insert(std::make_unique<entry<
+        typename std::decay<decltype(*sp)>::type>>(
+            sp, sp->ka_id, ping_interval, idle_timeout, now),
+        now + ping_interval);
+}
+
+template<class NextLayer, bool deflateSupported>
+void
+keepalive::
+remove(stream<NextLayer, deflateSupported>& ws)
+{
+    auto& impl = *ws.impl_;
+    if(impl.ka_owner != impl_.get())
+        return;
+    impl.ka_owner = nullptr;
+    impl.ka_waiting = false;
+}
+
+} // websocket
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,65 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_IMPL_KEEPALIVE_IPP
+#define BOOST_BEAST_WEBSOCKET_IMPL_KEEPALIVE_IPP
+
+#include <boost/beast/websocket/keepalive.hpp>
+#include <stdexcept>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+keepalive::
+keepalive(
+    net::any_io_executor const& ex,
+    duration resolution,
+    std::size_t slots)
+{
+    if(resolution.count() <= 0)
+        throw std::invalid_argument{"resolution must be positive"};
+    if(slots == 0)
+        throw std::invalid_argument{"slots must be positive"};
+    impl_ = std::make_shared<detail::keepalive_wheel>(
+        ex, resolution, slots);
+}
+
+keepalive::
+~keepalive()
+{
+    impl_->clear();
+}
+
+keepalive_stats
+keepalive::
+stats() const
+{
+    using std::chrono::nanoseconds;
+    using std::chrono::duration_cast;
+    auto const& w = *impl_;
+    keepalive_stats s;
+    s.streams = w.size;
+    s.passes = w.passes;
+    s.pings = w.pings;
+    s.pongs = w.pongs;
+    s.timeouts = w.timeouts;
+    s.rtt_min = duration_cast<nanoseconds>(w.rtt_min);
+    s.rtt_max = duration_cast<nanoseconds>(w.rtt_max);
+    if(w.pongs > 0)
+        s.rtt_mean = duration_cast<nanoseconds>(
+            w.rtt_sum / w.pongs);
+    return s;
+}
+
+} // websocket
+} // beast
+} // boost
+
+#endif
@@ -120,7 +120,8 @@ public:
             impl.op_close.maybe_invoke()
                 || impl.op_idle_ping.maybe_invoke()
                 || impl.op_rd.maybe_invoke()
-                || impl.op_wr.maybe_invoke();
+                || impl.op_wr.maybe_invoke()
+                || impl.op_send.maybe_invoke();
             this->complete(cont, ec);
         }
     }
@@ -151,7 +152,8 @@ public:
 
     idle_ping_op(
         std::shared_ptr<impl_type> const& sp,
-        Executor const& ex)
+        Executor const& ex,
+        ping_data const& payload = {})
         : boost::empty_value<Executor>(
             boost::empty_init_t{}, ex)
         , wp_(sp)
@@ -160,7 +162,6 @@ public:
         if(! sp->idle_pinging)
         {
             // Create the ping frame
-            ping_data payload; // empty for now
             sp->template write_ping<
                 flat_static_buffer_base>(*fb_,
                     detail::opcode::ping, payload);
@@ -232,7 +233,8 @@ public:
             impl.op_close.maybe_invoke()
                 || impl.op_ping.maybe_invoke()
                 || impl.op_rd.maybe_invoke()
-                || impl.op_wr.maybe_invoke();
+                || impl.op_wr.maybe_invoke()
+                || impl.op_send.maybe_invoke();
         }
     }
 };
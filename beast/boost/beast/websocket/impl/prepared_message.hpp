@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_IMPL_PREPARED_MESSAGE_HPP
+#define BOOST_BEAST_WEBSOCKET_IMPL_PREPARED_MESSAGE_HPP
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+template<class ConstBufferSequence>
+prepared_message::
+prepared_message(
+    bool text,
+    ConstBufferSequence const& payload)
+{
+    static_assert(net::is_const_buffer_sequence<
+        ConstBufferSequence>::value,
+            "ConstBufferSequence type requirements not met");
+    auto impl = std::make_shared<impl_type>();
+    auto const n = buffer_bytes(payload);
+    net::buffer_copy(net::buffer(
+        prepare(*impl, text, n), n), payload);
+    finish(*impl, nullptr);
+    impl_ = std::move(impl);
+}
+
+template<class ConstBufferSequence>
+prepared_message::
+prepared_message(
+    bool text,
+    ConstBufferSequence const& payload,
+    permessage_deflate const& opts)
+{
+    static_assert(net::is_const_buffer_sequence<
+        ConstBufferSequence>::value,
+            "ConstBufferSequence type requirements not met");
+    auto impl = std::make_shared<impl_type>();
+    auto const n = buffer_bytes(payload);
+    net::buffer_copy(net::buffer(
+        prepare(*impl, text, n), n), payload);
+    finish(*impl, &opts);
+    impl_ = std::move(impl);
+}
+
+} // websocket
+} // beast
+} // boost
+
+#endif
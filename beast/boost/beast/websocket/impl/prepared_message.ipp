@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_IMPL_PREPARED_MESSAGE_IPP
+#define BOOST_BEAST_WEBSOCKET_IMPL_PREPARED_MESSAGE_IPP
+
+#include <boost/beast/websocket/prepared_message.hpp>
+#include <boost/beast/websocket/detail/frame.hpp>
+#include <boost/beast/core/flat_static_buffer.hpp>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/assert.hpp>
+#include <cstring>
+#include <stdexcept>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+void*
+prepared_message::
+prepare(impl_type& impl, bool text, std::size_t size)
+{
+    // Leave room in front of the payload for the largest
+    // frame header, which is written once the size is known
+    impl.text = text;
+    impl.frame.resize(14 + size);
+    return impl.frame.data() + 14;
+}
+
+void
+prepared_message::
+finish(impl_type& impl, permessage_deflate const* opts)
+{
+    std::size_t constexpr max_header = 14;
+
+    // Write the header in front of the payload at `p`
+    auto const frame_at =
+        [&](unsigned char* p, std::size_t size, bool deflated)
+        {
+            detail::frame_header fh;
+            fh.op = impl.text ?
+                detail::opcode::text : detail::opcode::binary;
+            fh.fin = true;
+            fh.rsv1 = deflated;
+            fh.rsv2 = false;
+            fh.rsv3 = false;
+            fh.len = size;
+            fh.mask = false;
+            detail::fh_buffer fb;
+            detail::write<flat_static_buffer_base>(fb, fh);
+            auto const h = fb.size();
+            std::memcpy(p - h, fb.data().data(), h);
+            return net::const_buffer(p - h, h + size);
+        };
+
+    auto const p = impl.frame.data() + max_header;
+    auto const n = impl.frame.size() - max_header;
+    impl.payload = {p, n};
+    impl.frame_buf = frame_at(p, n, false);
+    if(! opts)
+        return;
+
+    if( opts->server_max_window_bits > 15 ||
+        opts->server_max_window_bits < 9)
+        throw std::invalid_argument{"invalid server_max_window_bits"};
+    if( opts->compLevel < 0 ||
+        opts->compLevel > 9)
+        throw std::invalid_argument{"invalid compLevel"};
+    if( opts->memLevel < 1 ||
+        opts->memLevel > 9)
+        throw std::invalid_argument{"invalid memLevel"};
+
+    // Compress as a stream with no context takeover would,
+    // ending in a sync flush whose marker is then removed.
+    zlib::deflate_stream zo;
+    zo.reset(
+        opts->compLevel,
+        opts->server_max_window_bits,
+        opts->memLevel,
+        zlib::Strategy::normal);
+    impl.deflated.resize(max_header + zo.upper_bound(n) + 16);
+    zlib::z_params zs;
+    zs.next_in = p;
+    zs.avail_in = n;
+    zs.next_out = impl.deflated.data() + max_header;
+    zs.avail_out = impl.deflated.size() - max_header;
+    error_code ec;
+    zo.write(zs, zlib::Flush::sync, ec);
+    BOOST_ASSERT(! ec);
+    BOOST_ASSERT(zs.avail_in == 0);
+    BOOST_ASSERT(zs.total_out >= 4);
+    auto const q = impl.deflated.data() + max_header;
+    BOOST_ASSERT(std::memcmp(q + zs.total_out - 4,
+        "\x00\x00\xff\xff", 4) == 0);
+    impl.deflated_buf = frame_at(q, zs.total_out - 4, true);
+    impl.window_bits = opts->server_max_window_bits;
+}
+
+} // websocket
+} // beast
+} // boost
+
+#endif
@@ -13,6 +13,7 @@
 #include <boost/beast/core/buffer_traits.hpp>
 #include <boost/beast/websocket/teardown.hpp>
 #include <boost/beast/websocket/detail/mask.hpp>
+#include <boost/beast/websocket/detail/payload.hpp>
 #include <boost/beast/websocket/impl/stream_impl.hpp>
 #include <boost/beast/core/async_base.hpp>
 #include <boost/beast/core/bind_handler.hpp>
@@ -55,6 +56,7 @@ class stream<NextLayer, deflateSupported>::read_some_op
     error_code result_;
     close_code code_;
     bool did_read_ = false;
+    bool masked_ = false;
 
 public:
     static constexpr int id = 1; // for soft_mutex
@@ -302,7 +304,8 @@ public:
                         impl.op_close.maybe_invoke()
                             || impl.op_idle_ping.maybe_invoke()
                             || impl.op_ping.maybe_invoke()
-                            || impl.op_wr.maybe_invoke();
+                            || impl.op_wr.maybe_invoke()
+                            || impl.op_send.maybe_invoke();
                         goto acquire_read_lock;
                     }
 
@@ -332,6 +335,7 @@ public:
                         ping_data payload;
                         detail::read_ping(payload, cb);
                         impl.rd_buf.consume(len);
+                        impl.on_pong(payload);
                         // Ignore pong when closing
                         if(! impl.wr_close && impl.ctrl_cb)
                             impl.ctrl_cb(frame_type::pong, payload);
@@ -424,35 +428,44 @@ public:
                         if(impl.check_stop_now(ec))
                             goto upcall;
                         impl.reset_idle();
-                        if(impl.rd_fh.mask)
-                            detail::mask_inplace(buffers_prefix(clamp(
-                                impl.rd_remain), impl.rd_buf.data()),
-                                    impl.rd_key);
+                        // The mask is removed as the
+                        // payload is copied out, below.
+                        masked_ = impl.rd_fh.mask;
                     }
                     if(impl.rd_buf.size() > 0)
                     {
-                        // Copy from the read buffer.
-                        // The mask was already applied.
-                        bytes_transferred = net::buffer_copy(cb_,
-                            impl.rd_buf.data(), clamp(impl.rd_remain));
-                        auto const mb = buffers_prefix(
-                            bytes_transferred, cb_);
+                        // Copy from the read buffer, removing the
+                        // mask if it is still there and checking
+                        // text in the same pass.
+                        bytes_transferred = (std::min)({
+                            buffer_bytes(cb_), impl.rd_buf.size(),
+                                clamp(impl.rd_remain)});
                         impl.rd_remain -= bytes_transferred;
-                        if(impl.rd_op == detail::opcode::text)
+                        if(! detail::copy_payload(cb_,
+                            impl.rd_buf.data(), bytes_transferred,
+                            masked_ ? &impl.rd_key : nullptr,
+                            impl.rd_op == detail::opcode::text ?
+                                &impl.rd_utf8 : nullptr) || (
+                            impl.rd_op == detail::opcode::text &&
+                            impl.rd_remain == 0 && impl.rd_fh.fin &&
+                                ! impl.rd_utf8.finish()))
                         {
-                            if(! impl.rd_utf8.write(mb) ||
-                                (impl.rd_remain == 0 && impl.rd_fh.fin &&
-                                    ! impl.rd_utf8.finish()))
-                            {
-                                // _Fail the WebSocket Connection_
-                                code_ = close_code::bad_payload;
-                                result_ = error::bad_frame_payload;
-                                goto close;
-                            }
+                            // _Fail the WebSocket Connection_
+                            code_ = close_code::bad_payload;
+                            result_ = error::bad_frame_payload;
+                            goto close;
                         }
                         bytes_written_ += bytes_transferred;
                         impl.rd_size += bytes_transferred;
                         impl.rd_buf.consume(bytes_transferred);
+                        if(masked_)
+                        {
+                            // The rest of the frame stays buffered
+                            masked_ = false;
+                            detail::mask_inplace(buffers_prefix(clamp(
+                                impl.rd_remain), impl.rd_buf.data()),
+                                    impl.rd_key);
+                        }
                     }
                     else
                     {
@@ -477,19 +490,20 @@ public:
                         auto const mb = buffers_prefix(
                             bytes_transferred, cb_);
                         impl.rd_remain -= bytes_transferred;
-                        if(impl.rd_fh.mask)
-                            detail::mask_inplace(mb, impl.rd_key);
-                        if(impl.rd_op == detail::opcode::text)
+                        // Unmask and check text in one pass
+                        if(! detail::copy_payload(mb, mb,
+                            bytes_transferred,
+                            impl.rd_fh.mask ? &impl.rd_key : nullptr,
+                            impl.rd_op == detail::opcode::text ?
+                                &impl.rd_utf8 : nullptr) || (
+                            impl.rd_op == detail::opcode::text &&
+                            impl.rd_remain == 0 && impl.rd_fh.fin &&
+                                ! impl.rd_utf8.finish()))
                         {
-                            if(! impl.rd_utf8.write(mb) ||
-                                (impl.rd_remain == 0 && impl.rd_fh.fin &&
-                                    ! impl.rd_utf8.finish()))
-                            {
-                                // _Fail the WebSocket Connection_
-                                code_ = close_code::bad_payload;
-                                result_ = error::bad_frame_payload;
-                                goto close;
-                            }
+                            // _Fail the WebSocket Connection_
+                            code_ = close_code::bad_payload;
+                            result_ = error::bad_frame_payload;
+                            goto close;
                         }
                         bytes_written_ += bytes_transferred;
                         impl.rd_size += bytes_transferred;
@@ -599,9 +613,9 @@ public:
                 }
                 if(impl.rd_op == detail::opcode::text)
                 {
-                    // check utf8
-                    if(! impl.rd_utf8.write(
-                        buffers_prefix(bytes_written_, bs_)) || (
+                    // check utf8, the output may be empty
+                    if((bytes_written_ > 0 && ! impl.rd_utf8.write(
+                        buffers_prefix(bytes_written_, bs_))) || (
                             impl.rd_done && ! impl.rd_utf8.finish()))
                     {
                         // _Fail the WebSocket Connection_
@@ -701,7 +715,8 @@ public:
                 impl.op_close.maybe_invoke()
                     || impl.op_idle_ping.maybe_invoke()
                     || impl.op_ping.maybe_invoke()
-                    || impl.op_wr.maybe_invoke();
+                    || impl.op_wr.maybe_invoke()
+                    || impl.op_send.maybe_invoke();
             this->complete(cont, ec, bytes_written_);
         }
     }
@@ -793,6 +808,87 @@ public:
     }
 };
 
+//------------------------------------------------------------------------------
+
+/*  Read a complete message, completing with a view of it.
+
+    A read of no bytes leaves the next data frame header parsed
+    and some of its payload in the read buffer. If that is the
+    whole message it is lent in place, otherwise it is read into
+    the stream's own buffer.
+*/
+template<class NextLayer, bool deflateSupported>
+template<class Handler>
+class stream<NextLayer, deflateSupported>::read_view_op
+    : public beast::async_base<
+        Handler, beast::executor_type<stream>>
+    , public ::asio::coroutine
+{
+    std::weak_ptr<impl_type> wp_;
+    message_view view_;
+
+public:
+    template<class Handler_>
+    read_view_op(
+        Handler_&& h,
+        std::shared_ptr<impl_type> const& sp)
+        : async_base<Handler,
+            beast::executor_type<stream>>(
+                std::forward<Handler_>(h),
+                    sp->stream().get_executor())
+        , wp_(sp)
+    {
+        (*this)({}, 0, false);
+    }
+
+    void operator()(
+        error_code ec = {},
+        std::size_t = 0,
+        bool cont = true)
+    {
+        auto sp = wp_.lock();
+        if(! sp)
+        {
+            ec = net::error::operation_aborted;
+            return this->complete(cont, ec, message_view{});
+        }
+        auto& impl = *sp;
+        ASIO_CORO_REENTER(*this)
+        {
+            ASIO_CORO_YIELD
+            {
+                ASIO_HANDLER_LOCATION((
+                    __FILE__, __LINE__,
+                    "websocket::async_read_view"));
+
+                read_some_op<read_view_op, net::mutable_buffer>(
+                    std::move(*this), sp, net::mutable_buffer{});
+            }
+            if(ec || impl.take_view(view_))
+                goto upcall;
+
+            impl.rd_view_buf.clear();
+            ASIO_CORO_YIELD
+            {
+                ASIO_HANDLER_LOCATION((
+                    __FILE__, __LINE__,
+                    "websocket::async_read_view"));
+
+                read_op<read_view_op, flat_buffer>(
+                    std::move(*this), sp, impl.rd_view_buf, 0, false);
+            }
+            if(! ec)
+                view_ = message_view(
+                    impl.rd_view_buf.data(), net::const_buffer{});
+
+        upcall:
+            this->complete(cont, ec, view_);
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+
 template<class NextLayer, bool deflateSupported>
 struct stream<NextLayer, deflateSupported>::
     run_read_some_op
@@ -859,6 +955,32 @@ struct stream<NextLayer, deflateSupported>::
     }
 };
 
+template<class NextLayer, bool deflateSupported>
+struct stream<NextLayer, deflateSupported>::
+    run_read_view_op
+{
+    template<class ReadHandler>
+    void
+    operator()(
+        ReadHandler&& h,
+        std::shared_ptr<impl_type> const& sp)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<ReadHandler,
+                void(error_code, message_view)>::value,
+            "ReadHandler type requirements not met");
+
+        read_view_op<
+            typename std::decay<ReadHandler>::type>(
+                std::forward<ReadHandler>(h),
+                sp);
+    }
+};
+
 //------------------------------------------------------------------------------
 
 template<class NextLayer, bool deflateSupported>
@@ -925,6 +1047,63 @@ async_read(DynamicBuffer& buffer, ReadHandler&& handler)
 
 //------------------------------------------------------------------------------
 
+template<class NextLayer, bool deflateSupported>
+auto
+stream<NextLayer, deflateSupported>::
+read_view() ->
+    message_view
+{
+    static_assert(SyncStream<next_layer_type>,
+        "SyncStream type requirements not met");
+    error_code ec;
+    auto const view = read_view(ec);
+    if(ec)
+        throw system_error{ec};
+    return view;
+}
+
+template<class NextLayer, bool deflateSupported>
+auto
+stream<NextLayer, deflateSupported>::
+read_view(error_code& ec) ->
+    message_view
+{
+    static_assert(SyncStream<next_layer_type>,
+        "SyncStream type requirements not met");
+    auto& impl = *impl_;
+    message_view view;
+    read_some(net::mutable_buffer{}, ec);
+    if(ec || impl.take_view(view))
+        return view;
+    impl.rd_view_buf.clear();
+    read(impl.rd_view_buf, ec);
+    if(ec)
+        return view;
+    return message_view(
+        impl.rd_view_buf.data(), net::const_buffer{});
+}
+
+template<class NextLayer, bool deflateSupported>
+template<ASIO_COMPLETION_TOKEN_FOR(void(error_code,
+    typename stream<NextLayer, deflateSupported>::message_view))
+        ReadHandler>
+ASIO_INITFN_AUTO_RESULT_TYPE(ReadHandler, void(error_code,
+    typename stream<NextLayer, deflateSupported>::message_view))
+stream<NextLayer, deflateSupported>::
+async_read_view(ReadHandler&& handler)
+{
+    static_assert(AsyncStream<next_layer_type>,
+        "AsyncStream type requirements not met");
+    return net::async_initiate<
+        ReadHandler,
+        void(error_code, message_view)>(
+            run_read_view_op{},
+            handler,
+            impl_);
+}
+
+//------------------------------------------------------------------------------
+
 template<class NextLayer, bool deflateSupported>
 template<class DynamicBuffer>
 std::size_t
@@ -1118,6 +1297,7 @@ loop:
                 ping_data payload;
                 detail::read_ping(payload, b);
                 impl.rd_buf.consume(len);
+                impl.on_pong(payload);
                 if(impl.ctrl_cb)
                     impl.ctrl_cb(frame_type::pong, payload);
                 goto loop;
@@ -1165,6 +1345,7 @@ loop:
     {
         if(impl.rd_remain > 0)
         {
+            bool masked = false;
             if(impl.rd_buf.size() == 0 && impl.rd_buf.max_size() >
                 (std::min)(clamp(impl.rd_remain),
                     buffer_bytes(buffers)))
@@ -1176,36 +1357,41 @@ loop:
                         impl.rd_buf.max_size())), ec));
                 if(impl.check_stop_now(ec))
                     return bytes_written;
-                if(impl.rd_fh.mask)
-                    detail::mask_inplace(
-                        buffers_prefix(clamp(impl.rd_remain),
-                            impl.rd_buf.data()), impl.rd_key);
+                // The mask is removed as the
+                // payload is copied out, below.
+                masked = impl.rd_fh.mask;
             }
             if(impl.rd_buf.size() > 0)
             {
-                // Copy from the read buffer.
-                // The mask was already applied.
-                auto const bytes_transferred = net::buffer_copy(
-                    buffers, impl.rd_buf.data(),
-                        clamp(impl.rd_remain));
-                auto const mb = buffers_prefix(
-                    bytes_transferred, buffers);
+                // Copy from the read buffer, removing the
+                // mask if it is still there and checking
+                // text in the same pass.
+                auto const bytes_transferred = (std::min)({
+                    buffer_bytes(buffers), impl.rd_buf.size(),
+                        clamp(impl.rd_remain)});
                 impl.rd_remain -= bytes_transferred;
-                if(impl.rd_op == detail::opcode::text)
+                if(! detail::copy_payload(buffers,
+                    impl.rd_buf.data(), bytes_transferred,
+                    masked ? &impl.rd_key : nullptr,
+                    impl.rd_op == detail::opcode::text ?
+                        &impl.rd_utf8 : nullptr) || (
+                    impl.rd_op == detail::opcode::text &&
+                    impl.rd_remain == 0 && impl.rd_fh.fin &&
+                        ! impl.rd_utf8.finish()))
                 {
-                    if(! impl.rd_utf8.write(mb) ||
-                        (impl.rd_remain == 0 && impl.rd_fh.fin &&
-                            ! impl.rd_utf8.finish()))
-                    {
-                        // _Fail the WebSocket Connection_
-                        do_fail(close_code::bad_payload,
-                            error::bad_frame_payload, ec);
-                        return bytes_written;
-                    }
+                    // _Fail the WebSocket Connection_
+                    do_fail(close_code::bad_payload,
+                        error::bad_frame_payload, ec);
+                    return bytes_written;
                 }
                 bytes_written += bytes_transferred;
                 impl.rd_size += bytes_transferred;
                 impl.rd_buf.consume(bytes_transferred);
+                // The rest of the frame stays buffered
+                if(masked)
+                    detail::mask_inplace(
+                        buffers_prefix(clamp(impl.rd_remain),
+                            impl.rd_buf.data()), impl.rd_key);
             }
             else
             {
@@ -1224,19 +1410,19 @@ loop:
                 auto const mb = buffers_prefix(
                     bytes_transferred, buffers);
                 impl.rd_remain -= bytes_transferred;
-                if(impl.rd_fh.mask)
-                    detail::mask_inplace(mb, impl.rd_key);
-                if(impl.rd_op == detail::opcode::text)
+                // Unmask and check text in one pass
+                if(! detail::copy_payload(mb, mb, bytes_transferred,
+                    impl.rd_fh.mask ? &impl.rd_key : nullptr,
+                    impl.rd_op == detail::opcode::text ?
+                        &impl.rd_utf8 : nullptr) || (
+                    impl.rd_op == detail::opcode::text &&
+                    impl.rd_remain == 0 && impl.rd_fh.fin &&
+                        ! impl.rd_utf8.finish()))
                 {
-                    if(! impl.rd_utf8.write(mb) ||
-                        (impl.rd_remain == 0 && impl.rd_fh.fin &&
-                            ! impl.rd_utf8.finish()))
-                    {
-                        // _Fail the WebSocket Connection_
-                        do_fail(close_code::bad_payload,
-                            error::bad_frame_payload, ec);
-                        return bytes_written;
-                    }
+                    // _Fail the WebSocket Connection_
+                    do_fail(close_code::bad_payload,
+                        error::bad_frame_payload, ec);
+                    return bytes_written;
                 }
                 bytes_written += bytes_transferred;
                 impl.rd_size += bytes_transferred;
@@ -1345,9 +1531,9 @@ loop:
         }
         if(impl.rd_op == detail::opcode::text)
         {
-            // check utf8
-            if(! impl.rd_utf8.write(beast::buffers_prefix(
-                bytes_written, buffers)) || (
+            // check utf8, the output may be empty
+            if((bytes_written > 0 && ! impl.rd_utf8.write(
+                beast::buffers_prefix(bytes_written, buffers))) || (
                     impl.rd_done && ! impl.rd_utf8.finish()))
             {
                 // _Fail the WebSocket Connection_
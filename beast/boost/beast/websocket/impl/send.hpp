@@ -0,0 +1,372 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_IMPL_SEND_HPP
+#define BOOST_BEAST_WEBSOCKET_IMPL_SEND_HPP
+
+#include <boost/beast/websocket/detail/mask.hpp>
+#include <boost/beast/websocket/detail/frame.hpp>
+#include <boost/beast/websocket/detail/send_queue.hpp>
+#include <boost/beast/websocket/impl/stream_impl.hpp>
+#include <boost/beast/core/async_base.hpp>
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/buffers_range.hpp>
+#include <boost/beast/core/flat_static_buffer.hpp>
+#include <boost/beast/core/span.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/detail/type_traits.hpp>
+#include <asio/coroutine.hpp>
+#include <asio/post.hpp>
+#include <asio/write.hpp>
+#include <boost/assert.hpp>
+#include <boost/core/empty_value.hpp>
+#include <cstring>
+#include <memory>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+/*
+    A message in the send queue. It holds the completion
+    handler and the caller's buffers until the batch which
+    contains the message has been written.
+*/
+template<class NextLayer, bool deflateSupported>
+template<class Handler, class Buffers>
+class stream<NextLayer, deflateSupported>::send_op
+    : public detail::send_queue::message
+    , public beast::async_base<
+        Handler, beast::executor_type<stream>>
+{
+    Buffers bs_;
+
+public:
+    template<class Handler_>
+    send_op(
+        Handler_&& h,
+        std::shared_ptr<impl_type> const& sp,
+        Buffers const& bs)
+        : beast::async_base<Handler,
+            beast::executor_type<stream>>(
+                std::forward<Handler_>(h),
+                    sp->stream().get_executor())
+        , bs_(bs)
+    {
+        this->size = buffer_bytes(bs_);
+        this->op = sp->wr_opcode;
+    }
+
+    void
+    buffers(std::vector<net::const_buffer>& v) const override
+    {
+        for(net::const_buffer b : beast::buffers_range_ref(bs_))
+            if(b.size() > 0)
+                v.push_back(b);
+    }
+
+    void
+    copy(void* dest) const override
+    {
+        net::buffer_copy(net::buffer(dest, this->size), bs_);
+    }
+
+    void
+    complete(error_code ec) override
+    {
+        this->async_base<Handler, beast::executor_type<stream>>::
+            complete(false, ec, ec ? 0 : this->size);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/*
+    This composed operation sends the send queue. There is at
+    most one for each stream, it writes batches of messages
+    until the queue is empty and then finishes.
+*/
+template<class NextLayer, bool deflateSupported>
+template<class Executor>
+class stream<NextLayer, deflateSupported>::flush_op
+    : public ::asio::coroutine
+    , public boost::empty_value<Executor>
+{
+    std::weak_ptr<impl_type> wp_;
+    std::vector<detail::send_queue::message_ptr> batch_;
+
+public:
+    static constexpr int id = 6; // for soft_mutex
+
+    using executor_type = Executor;
+
+    executor_type
+    get_executor() const noexcept
+    {
+        return this->get();
+    }
+
+    flush_op(
+        std::shared_ptr<impl_type> const& sp,
+        Executor const& ex)
+        : boost::empty_value<Executor>(
+            boost::empty_init_t{}, ex)
+        , wp_(sp)
+    {
+    }
+
+    void operator()(
+        error_code ec = {},
+        std::size_t bytes_transferred = 0)
+    {
+        boost::ignore_unused(bytes_transferred);
+        auto sp = wp_.lock();
+        if(! sp)
+            return;
+        auto& impl = *sp;
+        ASIO_CORO_REENTER(*this)
+        {
+            for(;;)
+            {
+                // Acquire the write lock
+                if(! impl.wr_block.try_lock(this))
+                {
+                do_suspend:
+                    ASIO_CORO_YIELD
+                    {
+                        ASIO_HANDLER_LOCATION((
+                            __FILE__, __LINE__,
+                            "websocket::async_send"));
+
+                        impl.op_send.emplace(std::move(*this));
+                    }
+                    impl.wr_block.lock(this);
+                    ASIO_CORO_YIELD
+                    {
+                        ASIO_HANDLER_LOCATION((
+                            __FILE__, __LINE__,
+                            "websocket::async_send"));
+
+                        net::post(std::move(*this));
+                    }
+                    BOOST_ASSERT(impl.wr_block.is_locked(this));
+                }
+                if(impl.check_stop_now(ec))
+                    goto fail;
+                if(impl.wr_close)
+                {
+                    ec = net::error::operation_aborted;
+                    goto fail;
+                }
+                if(impl.wr_cont)
+                {
+                    // Wait for the message which
+                    // async_write_some is sending
+                    impl.wr_block.unlock(this);
+                    goto do_suspend;
+                }
+                if(! impl.sq.take(batch_))
+                    goto upcall;
+
+                serialize(impl);
+                ASIO_CORO_YIELD
+                {
+                    ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "websocket::async_send"));
+
+                    net::async_write(impl.stream(),
+                        span<net::const_buffer const>(
+                            impl.sq_bufs.data(), impl.sq_bufs.size()),
+                        std::move(*this));
+                }
+                if(impl.check_stop_now(ec))
+                    goto fail;
+                for(auto& m : batch_)
+                    m->complete({});
+                batch_.clear();
+
+                // Let waiting operations have a turn
+                impl.wr_block.unlock(this);
+                impl.op_close.maybe_invoke()
+                    || impl.op_idle_ping.maybe_invoke()
+                    || impl.op_rd.maybe_invoke()
+                    || impl.op_ping.maybe_invoke()
+                    || impl.op_wr.maybe_invoke();
+            }
+
+        fail:
+            impl.sq.take_all(batch_);
+            for(auto& m : batch_)
+                m->complete(ec);
+            batch_.clear();
+
+        upcall:
+            impl.wr_block.unlock(this);
+            impl.op_close.maybe_invoke()
+                || impl.op_idle_ping.maybe_invoke()
+                || impl.op_rd.maybe_invoke()
+                || impl.op_ping.maybe_invoke()
+                || impl.op_wr.maybe_invoke();
+        }
+    }
+
+private:
+    // Lay out the frames of the batch in sq_bufs. Headers, and
+    // payloads which are masked or small, are copied to sq_buf
+    // so that consecutive frames are one buffer.
+    void
+    serialize(impl_type& impl)
+    {
+        std::size_t constexpr max_header = 14;
+        bool const mask = impl.role == role_type::client;
+        auto const small = (std::min)(
+            impl.wr_buf_opt, detail::send_queue::max_batch_bytes);
+        std::size_t n = 0;
+        for(auto const& m : batch_)
+            n += max_header +
+                (mask || m->size <= small ? m->size : 0);
+        impl.sq_buf.clear();
+        impl.sq_bufs.clear();
+        auto const p0 = static_cast<unsigned char*>(
+            impl.sq_buf.prepare(n).data());
+        auto p = p0;
+        auto q = p0;
+        for(auto const& m : batch_)
+        {
+            detail::frame_header fh;
+            fh.op = m->op;
+            fh.fin = true;
+            fh.rsv1 = false;
+            fh.rsv2 = false;
+            fh.rsv3 = false;
+            fh.len = m->size;
+            fh.mask = mask;
+            if(mask)
+                fh.key = impl.create_mask();
+            detail::fh_buffer fb;
+            detail::write<flat_static_buffer_base>(fb, fh);
+            std::memcpy(p, fb.data().data(), fb.size());
+            p += fb.size();
+            if(mask || m->size <= small)
+            {
+                m->copy(p);
+                if(mask)
+                {
+                    detail::prepared_key key;
+                    detail::prepare_key(key, fh.key);
+                    detail::mask_inplace(
+                        net::buffer(p, m->size), key);
+                }
+                p += m->size;
+                continue;
+            }
+            impl.sq_bufs.emplace_back(q, p - q);
+            m->buffers(impl.sq_bufs);
+            q = p;
+        }
+        if(p != q)
+            impl.sq_bufs.emplace_back(q, p - q);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+template<class NextLayer, bool deflateSupported>
+struct stream<NextLayer, deflateSupported>::
+    run_send_op
+{
+    template<
+        class WriteHandler,
+        class ConstBufferSequence>
+    void
+    operator()(
+        WriteHandler&& h,
+        std::shared_ptr<impl_type> const& sp,
+        ConstBufferSequence const& b)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<WriteHandler,
+                void(error_code, std::size_t)>::value,
+            "WriteHandler type requirements not met");
+
+        detail::send_queue::message_ptr m(
+            new send_op<
+                typename std::decay<WriteHandler>::type,
+                ConstBufferSequence>(
+                    std::forward<WriteHandler>(h), sp, b));
+        bool flush;
+        if(! sp->sq.push(m, flush))
+        {
+            m->complete(error::send_queue_full);
+            return;
+        }
+        if(flush)
+            net::post(flush_op<executor_type>(
+                sp, sp->stream().get_executor()));
+    }
+};
+
+//------------------------------------------------------------------------------
+
+template<class NextLayer, bool deflateSupported>
+template<class ConstBufferSequence, BOOST_BEAST_ASYNC_TPARAM2 WriteHandler>
+BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
+stream<NextLayer, deflateSupported>::
+async_send(
+    ConstBufferSequence const& bs, WriteHandler&& handler)
+{
+    static_assert(AsyncStream<next_layer_type>,
+        "AsyncStream type requirements not met");
+    static_assert(net::is_const_buffer_sequence<
+        ConstBufferSequence>::value,
+            "ConstBufferSequence type requirements not met");
+    return net::async_initiate<
+        WriteHandler,
+        void(error_code, std::size_t)>(
+            run_send_op{},
+            handler,
+            impl_,
+            bs);
+}
+
+template<class NextLayer, bool deflateSupported>
+void
+stream<NextLayer, deflateSupported>::
+send_queue_limit(std::size_t amount)
+{
+    impl_->sq.limit(amount);
+}
+
+template<class NextLayer, bool deflateSupported>
+std::size_t
+stream<NextLayer, deflateSupported>::
+send_queue_limit() const
+{
+    return impl_->sq.limit();
+}
+
+template<class NextLayer, bool deflateSupported>
+auto
+stream<NextLayer, deflateSupported>::
+send_stats() const ->
+    send_queue_stats
+{
+    return impl_->sq.stats();
+}
+
+} // websocket
+} // beast
+} // boost
+
+#endif
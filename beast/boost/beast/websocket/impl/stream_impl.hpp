@@ -10,12 +10,14 @@
 #ifndef BOOST_BEAST_WEBSOCKET_IMPL_STREAM_IMPL_HPP
 #define BOOST_BEAST_WEBSOCKET_IMPL_STREAM_IMPL_HPP
 
+#include <boost/beast/websocket/prepared_message.hpp>
 #include <boost/beast/websocket/rfc6455.hpp>
 #include <boost/beast/websocket/detail/frame.hpp>
 #include <boost/beast/websocket/detail/hybi13.hpp>
 #include <boost/beast/websocket/detail/mask.hpp>
 #include <boost/beast/websocket/detail/pmd_extension.hpp>
 #include <boost/beast/websocket/detail/prng.hpp>
+#include <boost/beast/websocket/detail/send_queue.hpp>
 #include <boost/beast/websocket/detail/service.hpp>
 #include <boost/beast/websocket/detail/soft_mutex.hpp>
 #include <boost/beast/websocket/detail/utf8_checker.hpp>
@@ -25,6 +27,7 @@
 #include <boost/beast/core/buffers_cat.hpp>
 #include <boost/beast/core/buffers_prefix.hpp>
 #include <boost/beast/core/buffers_suffix.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/core/flat_static_buffer.hpp>
 #include <boost/beast/core/saved_handler.hpp>
 #include <boost/beast/core/static_buffer.hpp>
@@ -32,6 +35,8 @@
 #include <boost/beast/core/detail/clamp.hpp>
 #include <asio/steady_timer.hpp>
 #include <boost/core/empty_value.hpp>
+#include <chrono>
+#include <vector>
 
 namespace boost {
 namespace beast {
@@ -83,6 +88,8 @@ struct stream<NextLayer, deflateSupported>::impl_type
     bool                    rd_cont         /* `true` if the next frame is a continuation */ = false;
     bool                    rd_done         /* set when a message is done */ = true;
     bool                    rd_close        /* did we read a close frame? */ = false;
+    std::size_t             rd_view         /* bytes of rd_buf lent by read_view */ = 0;
+    flat_buffer             rd_view_buf;    // read_view copies here when it must
     detail::soft_mutex      rd_block;       // op currently reading
 
     role_type               role            /* server or client */ = role_type::client;
@@ -101,12 +108,17 @@ struct stream<NextLayer, deflateSupported>::impl_type
     std::size_t             wr_buf_size     /* write buffer size (current message) */ = 0;
     std::size_t             wr_buf_opt      /* write buffer size option setting */ = 4096;
     detail::fh_buffer       wr_fb;          // header buffer used for writes
+    detail::send_queue      sq;             // messages from async_send
+    flat_buffer             sq_buf;         // frames serialized for a batch
+    std::vector<
+        net::const_buffer>  sq_bufs;        // the batch written to the next layer
 
     saved_handler           op_rd;          // paused read op
     saved_handler           op_wr;          // paused write op
     saved_handler           op_ping;        // paused ping op
     saved_handler           op_idle_ping;   // paused idle ping op
     saved_handler           op_close;       // paused close op
+    saved_handler           op_send;        // paused send queue op
     saved_handler           op_r_rd;        // paused read op (async read)
     saved_handler           op_r_close;     // paused close op (async read)
 
@@ -115,6 +127,13 @@ struct stream<NextLayer, deflateSupported>::impl_type
     bool    ec_delivered = false;
     bool    timed_out = false;
     int     idle_counter = 0;
+    std::uint64_t rd_activity = 0;      // reads from the next layer
+
+    void const* ka_owner = nullptr;     // keepalive watching the stream
+    std::uint64_t ka_id = 0;            // its entry for the stream
+    ping_data ka_token;                 // payload of the keepalive ping
+    bool ka_waiting = false;            // no pong for ka_token yet
+    std::chrono::steady_clock::time_point ka_pong; // when it came
 
     detail::decorator       decorator_opt;  // Decorator for HTTP messages
     timeout                 timeout_opt;    // Timeout/idle settings
@@ -142,8 +161,10 @@ struct stream<NextLayer, deflateSupported>::impl_type
         op_ping.reset();
         op_idle_ping.reset();
         op_close.reset();
+        op_send.reset();
         op_r_rd.reset();
         op_r_close.reset();
+        sq.clear();
     }
 
     void
@@ -158,6 +179,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
         rd_remain = 0;
         rd_cont = false;
         rd_done = true;
+        rd_view = 0;
         // Can't clear this because accept uses it
         //rd_buf.reset();
         rd_fh.fin = false;
@@ -192,6 +214,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
         rd_remain = 0;
         rd_cont = false;
         rd_done = true;
+        rd_view = 0;
         rd_buf.consume(rd_buf.size());
         rd_fh.fin = false;
         rd_close = false;
@@ -274,6 +297,64 @@ struct stream<NextLayer, deflateSupported>::impl_type
     parse_fh(detail::frame_header& fh,
         DynamicBuffer& b, error_code& ec);
 
+    // Lend the payload of the current message in place when
+    // it is one frame held entirely in rd_buf, the bytes stay
+    // there until the next frame header is parsed. Returns
+    // `false` if the payload has to be copied, which includes
+    // invalid text so that the copying read reports it.
+    bool
+    take_view(beast::detail::buffers_pair<false>& view)
+    {
+        if( this->rd_deflated() || ! rd_fh.fin ||
+            rd_size != 0 || rd_remain > rd_buf.size())
+            return false;
+        auto const n = static_cast<std::size_t>(rd_remain);
+        auto const it = rd_buf.data().begin();
+        net::const_buffer b0 = it[0];
+        net::const_buffer b1 = it[1];
+        if(n <= b0.size())
+        {
+            b0 = net::const_buffer(b0.data(), n);
+            b1 = {};
+        }
+        else
+        {
+            b1 = net::const_buffer(b1.data(), n - b0.size());
+        }
+        if(rd_op == detail::opcode::text)
+        {
+            detail::utf8_checker utf8;
+            for(auto const& b : {b0, b1})
+                if(b.size() > 0 && ! utf8.write(
+                        static_cast<std::uint8_t const*>(
+                            b.data()), b.size()))
+                    return false;
+            if(! utf8.finish())
+                return false;
+        }
+        view = {b0, b1};
+        rd_view = n;
+        rd_size = n;
+        rd_remain = 0;
+        rd_done = true;
+        return true;
+    }
+
+    // Returns the frame of a prepared message if this stream
+    // can send it as it is, otherwise an empty buffer.
+    net::const_buffer
+    shared_frame(prepared_message const& m) const
+    {
+        if(role != role_type::server || wr_cont)
+            return {};
+        if(! this->pmd_enabled() || ! wr_compress_opt)
+            return m.frame();
+        if( m.window_bits() == 0 ||
+            this->deflate_shared_bits(role) < m.window_bits())
+            return {};
+        return m.deflated_frame();
+    }
+
     std::uint32_t
     create_mask()
     {
@@ -400,6 +481,38 @@ struct stream<NextLayer, deflateSupported>::impl_type
     reset_idle()
     {
         idle_counter = 0;
+        ++rd_activity;
+    }
+
+    // Called for every pong received
+    void
+    on_pong(ping_data const& payload)
+    {
+        if(ka_waiting && payload == ka_token)
+        {
+            ka_waiting = false;
+            ka_pong = std::chrono::steady_clock::now();
+        }
+    }
+
+    bool
+    is_open() const
+    {
+        return status_ == status::open;
+    }
+
+    // Sends a ping for the keepalive watching the stream,
+    // unless one can't be sent now.
+    bool
+    keepalive_ping(ping_data const& payload)
+    {
+        if(status_ != status::open || wr_close || idle_pinging)
+            return false;
+        ka_token = payload;
+        ka_waiting = true;
+        idle_ping_op<executor_type>(shared_this(),
+            this->stream().get_executor(), payload);
+        return true;
     }
 
     // Maintain the expiration timer
@@ -696,6 +809,12 @@ parse_fh(
     DynamicBuffer& b,
     error_code& ec)
 {
+    // Give back the payload lent by read_view
+    if(rd_view > 0)
+    {
+        rd_buf.consume(rd_view);
+        rd_view = 0;
+    }
     if(buffer_bytes(b.data()) < 2)
     {
         // need more bytes
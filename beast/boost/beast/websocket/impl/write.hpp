@@ -499,7 +499,8 @@ operator()(
         impl.op_close.maybe_invoke()
             || impl.op_idle_ping.maybe_invoke()
             || impl.op_rd.maybe_invoke()
-            || impl.op_ping.maybe_invoke();
+            || impl.op_ping.maybe_invoke()
+            || impl.op_send.maybe_invoke();
         this->complete(cont, ec, bytes_transferred_);
     }
 }
@@ -848,6 +849,232 @@ async_write(
             bs);
 }
 
+//------------------------------------------------------------------------------
+
+/*
+    This composed operation sends the frame of a prepared
+    message, which is shared with other streams, as it is.
+*/
+template<class NextLayer, bool deflateSupported>
+template<class Handler>
+class stream<NextLayer, deflateSupported>::write_prepared_op
+    : public beast::async_base<
+        Handler, beast::executor_type<stream>>
+    , public ::asio::coroutine
+{
+    std::weak_ptr<impl_type> wp_;
+    prepared_message m_;
+    net::const_buffer frame_;
+
+public:
+    static constexpr int id = 2; // for soft_mutex, as write_some_op
+
+    template<class Handler_>
+    write_prepared_op(
+        Handler_&& h,
+        std::shared_ptr<impl_type> const& sp,
+        prepared_message const& m,
+        net::const_buffer frame)
+        : beast::async_base<Handler,
+            beast::executor_type<stream>>(
+                std::forward<Handler_>(h),
+                    sp->stream().get_executor())
+        , wp_(sp)
+        , m_(m)
+        , frame_(frame)
+    {
+        (*this)({}, 0, false);
+    }
+
+    void operator()(
+        error_code ec = {},
+        std::size_t bytes_transferred = 0,
+        bool cont = true)
+    {
+        boost::ignore_unused(bytes_transferred);
+        auto sp = wp_.lock();
+        if(! sp)
+        {
+            ec = net::error::operation_aborted;
+            return this->complete(cont, ec, 0);
+        }
+        auto& impl = *sp;
+        ASIO_CORO_REENTER(*this)
+        {
+            // Acquire the write lock
+            if(! impl.wr_block.try_lock(this))
+            {
+                ASIO_CORO_YIELD
+                {
+                    ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "websocket::async_write"));
+
+                    impl.op_wr.emplace(std::move(*this));
+                }
+                impl.wr_block.lock(this);
+                ASIO_CORO_YIELD
+                {
+                    ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "websocket::async_write"));
+
+                    net::post(std::move(*this));
+                }
+                BOOST_ASSERT(impl.wr_block.is_locked(this));
+            }
+            if(impl.check_stop_now(ec))
+                goto upcall;
+            ASIO_CORO_YIELD
+            {
+                ASIO_HANDLER_LOCATION((
+                    __FILE__, __LINE__,
+                    "websocket::async_write"));
+
+                net::async_write(impl.stream(), frame_,
+                    beast::detail::bind_continuation(std::move(*this)));
+            }
+            if(impl.check_stop_now(ec))
+                goto upcall;
+
+        upcall:
+            impl.wr_block.unlock(this);
+            impl.op_close.maybe_invoke()
+                || impl.op_idle_ping.maybe_invoke()
+                || impl.op_rd.maybe_invoke()
+                || impl.op_ping.maybe_invoke()
+                || impl.op_send.maybe_invoke();
+            this->complete(cont, ec, ec ? 0 : m_.size());
+        }
+    }
+};
+
+namespace detail {
+
+// Makes the type of a prepared message the opcode of the
+// stream for one write, which takes its opcode from there,
+// and restores the stream's own afterwards.
+template<class Impl>
+class prepared_opcode
+{
+    Impl& impl_;
+    opcode op_;
+
+public:
+    prepared_opcode(Impl& impl, bool text) noexcept
+        : impl_(impl)
+        , op_(impl.wr_opcode)
+    {
+        impl_.wr_opcode = text ? opcode::text : opcode::binary;
+    }
+
+    prepared_opcode(prepared_opcode const&) = delete;
+    prepared_opcode& operator=(prepared_opcode const&) = delete;
+
+    ~prepared_opcode()
+    {
+        impl_.wr_opcode = op_;
+    }
+};
+
+} // detail
+
+template<class NextLayer, bool deflateSupported>
+struct stream<NextLayer, deflateSupported>::
+    run_write_prepared_op
+{
+    template<class WriteHandler>
+    void
+    operator()(
+        WriteHandler&& h,
+        std::shared_ptr<impl_type> const& sp,
+        prepared_message const& m)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<WriteHandler,
+                void(error_code, std::size_t)>::value,
+            "WriteHandler type requirements not met");
+
+        auto const frame = sp->shared_frame(m);
+        if(frame.size() > 0)
+        {
+            write_prepared_op<
+                typename std::decay<WriteHandler>::type>(
+                    std::forward<WriteHandler>(h), sp, m, frame);
+        }
+        else
+        {
+            // The message holds its payload, so it can be
+            // written as any other buffer sequence. The
+            // operation sets up its frame header at once.
+            detail::prepared_opcode<impl_type> op(*sp, m.text());
+            write_some_op<
+                typename std::decay<WriteHandler>::type,
+                prepared_message>(
+                    std::forward<WriteHandler>(h), sp, true, m);
+        }
+    }
+};
+
+template<class NextLayer, bool deflateSupported>
+std::size_t
+stream<NextLayer, deflateSupported>::
+write(prepared_message const& m)
+{
+    static_assert(SyncStream<next_layer_type>,
+        "SyncStream type requirements not met");
+    error_code ec;
+    auto const bytes_transferred = write(m, ec);
+    if(ec)
+        throw system_error{ec};
+    return bytes_transferred;
+}
+
+template<class NextLayer, bool deflateSupported>
+std::size_t
+stream<NextLayer, deflateSupported>::
+write(prepared_message const& m, error_code& ec)
+{
+    static_assert(SyncStream<next_layer_type>,
+        "SyncStream type requirements not met");
+    auto& impl = *impl_;
+    auto const frame = impl.shared_frame(m);
+    if(frame.size() == 0)
+    {
+        detail::prepared_opcode<impl_type> op(impl, m.text());
+        return write_some(true, m, ec);
+    }
+    ec = {};
+    if(impl.check_stop_now(ec))
+        return 0;
+    net::write(impl.stream(), frame, ec);
+    if(impl.check_stop_now(ec))
+        return 0;
+    return m.size();
+}
+
+template<class NextLayer, bool deflateSupported>
+template<BOOST_BEAST_ASYNC_TPARAM2 WriteHandler>
+BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
+stream<NextLayer, deflateSupported>::
+async_write(
+    prepared_message const& m, WriteHandler&& handler)
+{
+    static_assert(AsyncStream<next_layer_type>,
+        "AsyncStream type requirements not met");
+    return net::async_initiate<
+        WriteHandler,
+        void(error_code, std::size_t)>(
+            run_write_prepared_op{},
+            handler,
+            impl_,
+            m);
+}
+
 } // websocket
 } // beast
 } // boost
@@ -0,0 +1,180 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_KEEPALIVE_HPP
+#define BOOST_BEAST_WEBSOCKET_KEEPALIVE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/websocket/stream.hpp>
+#include <boost/beast/websocket/detail/keepalive_wheel.hpp>
+#include <asio/any_io_executor.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+/// Statistics of a @ref keepalive
+struct keepalive_stats
+{
+    /// Streams watched, including those removed but not yet visited
+    std::size_t streams = 0;
+
+    /// Passes over the wheel which visited at least one tick
+    std::uint64_t passes = 0;
+
+    /// Pings sent
+    std::uint64_t pings = 0;
+
+    /// Pongs received in reply to those pings
+    std::uint64_t pongs = 0;
+
+    /// Streams closed because they were idle for too long
+    std::uint64_t timeouts = 0;
+
+    /// The smallest round trip time measured
+    std::chrono::nanoseconds rtt_min{};
+
+    /// The largest round trip time measured
+    std::chrono::nanoseconds rtt_max{};
+
+    /// The average round trip time measured
+    std::chrono::nanoseconds rtt_mean{};
+};
+
+/** Sends keepalive pings and closes idle streams, for many streams.
+
+    Each stream watched by this object is pinged when nothing
+    was received on it for the ping interval, and closed when
+    nothing was received for the idle timeout, as with the
+    @ref stream_base::timeout::idle_timeout option. The round trip
+    time of each ping is measured from the pong which answers it.
+
+    All streams share one timing wheel and one timer instead of a
+    timer for each stream: streams due in the same tick are visited
+    in a single pass. Times are rounded up to the resolution of the
+    wheel, and activity on a stream is only noticed when the stream
+    is visited, so a stream may be pinged or closed up to one ping
+    interval later than its exact idle time.
+
+    A stream which is timed out has its socket closed, and its
+    pending operations complete with @ref beast::error::timeout.
+    A stream is no longer watched once it is closed or destroyed.
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Unsafe. The object and every stream it
+    watches must be used from the same implicit or explicit strand,
+    usually one thread running an `io_context`. Applications with
+    several such threads use one object for each of them.
+
+    @par Example
+    @code
+    websocket::keepalive ka(ioc.get_executor());
+    ...
+    // after the handshake
+    ka.add(ws, std::chrono::seconds(15), std::chrono::seconds(45));
+    @endcode
+*/
+class keepalive
+{
+    std::shared_ptr<detail::keepalive_wheel> impl_;
+
+    template<class Impl>
+    class entry;
+
+public:
+    /// The clock used for timing
+    using clock_type = std::chrono::steady_clock;
+
+    /// The type of duration used
+    using duration = clock_type::duration;
+
+    /** Constructor
+
+        @param ex The executor of the timer. It must be the
+        executor, or belong to the strand, of the streams.
+
+        @param resolution The duration of one tick of the wheel.
+
+        @param slots The number of ticks in one turn of the wheel.
+        Streams due later than one turn wait for further turns.
+
+        @throws std::invalid_argument if `resolution` or
+        `slots` is zero.
+    */
+    BOOST_BEAST_DECL
+    explicit
+    keepalive(
+        net::any_io_executor const& ex,
+        duration resolution = std::chrono::milliseconds(100),
+        std::size_t slots = 512);
+
+    /** Destructor
+
+        Streams are no longer watched. Pings already sent
+        are not affected.
+    */
+    BOOST_BEAST_DECL
+    ~keepalive();
+
+    keepalive(keepalive const&) = delete;
+    keepalive& operator=(keepalive const&) = delete;
+
+    /** Start watching a stream.
+
+        The stream must be open, and should not also use the idle
+        timeout of @ref stream_base::timeout. If the stream is already
+        watched by this object, its settings are replaced.
+
+        For pongs to be noticed the stream must be reading, as it
+        must for the stream to reply to pings from the peer.
+
+        @param ws The stream to watch.
+
+        @param ping_interval How long the stream may be idle before
+        it is pinged.
+
+        @param idle_timeout How long the stream may be idle before
+        it is closed.
+
+        @throws std::invalid_argument if `ping_interval` is not
+        positive or `idle_timeout` is not greater than it.
+    */
+    template<class NextLayer, bool deflateSupported>
+    void
+    add(
+        stream<NextLayer, deflateSupported>& ws,
+        duration ping_interval,
+        duration idle_timeout);
+
+    /// Stop watching a stream
+    template<class NextLayer, bool deflateSupported>
+    void
+    remove(stream<NextLayer, deflateSupported>& ws);
+
+    /// Returns statistics
+    BOOST_BEAST_DECL
+    keepalive_stats
+    stats() const;
+};
+
+} // websocket
+} // beast
+} // boost
+
+#include <boost/beast/websocket/impl/keepalive.hpp>
+#if BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/websocket/impl/keepalive.ipp>
+#endif
+
+#endif
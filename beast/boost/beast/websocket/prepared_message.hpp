@@ -0,0 +1,185 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_PREPARED_MESSAGE_HPP
+#define BOOST_BEAST_WEBSOCKET_PREPARED_MESSAGE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/websocket/option.hpp>
+#include <asio/buffer.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+/** A complete message which is framed once and sent to many streams.
+
+    Objects of this type hold a message payload together with the
+    frame which carries it, serialized once into memory which is
+    shared by all copies of the object and never modified. Copies
+    are cheap, and may be used from any thread.
+
+    When a prepared message is written by a @ref stream in the
+    server role, and the stream is not compressing or each message
+    it sends is compressed on its own (no context takeover), every
+    stream writes the same bytes without framing, copying or
+    compressing the payload again. Other streams, for example in
+    the client role where each frame needs its own mask, send the
+    payload as they would any other message.
+
+    The type also meets the requirements of <em>ConstBufferSequence</em>,
+    representing the payload.
+
+    @par Example
+    Sending one message to every connected session:
+    @code
+    websocket::prepared_message msg(true, net::buffer(text), pmd);
+    for(auto& ws : sessions)
+        ws.async_write(msg, on_write);
+    @endcode
+
+    @see stream::write, stream::async_write
+*/
+class prepared_message
+{
+    struct impl_type
+    {
+        std::vector<unsigned char> frame;
+        std::vector<unsigned char> deflated;
+        net::const_buffer frame_buf;
+        net::const_buffer deflated_buf;
+        net::const_buffer payload;
+        int window_bits = 0;
+        bool text = true;
+    };
+
+    std::shared_ptr<impl_type const> impl_;
+
+    BOOST_BEAST_DECL
+    static
+    void*
+    prepare(impl_type& impl, bool text, std::size_t size);
+
+    BOOST_BEAST_DECL
+    static
+    void
+    finish(impl_type& impl, permessage_deflate const* opts);
+
+public:
+    /// The type of buffer in the payload sequence
+    using value_type = net::const_buffer;
+
+    /// The type of iterator over the payload sequence
+    using const_iterator = net::const_buffer const*;
+
+    /** Constructor
+
+        Creates a message whose frame is sent uncompressed.
+
+        @param text `true` for a text message,
+        `false` for a binary message.
+
+        @param payload The message payload, which is copied.
+    */
+    template<class ConstBufferSequence>
+    prepared_message(
+        bool text,
+        ConstBufferSequence const& payload);
+
+    /** Constructor
+
+        Creates a message which also has a compressed frame, made
+        with the server window bits and compression settings in
+        `opts`. The compressed frame is sent by server streams which
+        negotiated permessage-deflate with no context takeover and
+        a window at least as large.
+
+        @param text `true` for a text message,
+        `false` for a binary message.
+
+        @param payload The message payload, which is copied.
+
+        @param opts The compression settings.
+    */
+    template<class ConstBufferSequence>
+    prepared_message(
+        bool text,
+        ConstBufferSequence const& payload,
+        permessage_deflate const& opts);
+
+    /// Returns `true` if this is a text message
+    bool
+    text() const noexcept
+    {
+        return impl_->text;
+    }
+
+    /// Returns the size of the payload in bytes
+    std::size_t
+    size() const noexcept
+    {
+        return impl_->payload.size();
+    }
+
+    /// Returns the serialized uncompressed frame
+    net::const_buffer
+    frame() const noexcept
+    {
+        return impl_->frame_buf;
+    }
+
+    /** Returns the serialized compressed frame.
+
+        The buffer is empty if the message was not compressed.
+    */
+    net::const_buffer
+    deflated_frame() const noexcept
+    {
+        return impl_->deflated_buf;
+    }
+
+    /** Returns the window bits of the compressed frame.
+
+        The value is zero if the message was not compressed.
+    */
+    int
+    window_bits() const noexcept
+    {
+        return impl_->window_bits;
+    }
+
+    /// Returns an iterator to the first buffer of the payload
+    const_iterator
+    begin() const noexcept
+    {
+        return &impl_->payload;
+    }
+
+    /// Returns an iterator to one past the last buffer of the payload
+    const_iterator
+    end() const noexcept
+    {
+        return &impl_->payload + 1;
+    }
+};
+
+} // websocket
+} // beast
+} // boost
+
+#include <boost/beast/websocket/impl/prepared_message.hpp>
+#if BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/websocket/impl/prepared_message.ipp>
+#endif
+
+#endif
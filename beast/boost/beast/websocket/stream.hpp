@@ -13,6 +13,7 @@
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/websocket/error.hpp>
 #include <boost/beast/websocket/option.hpp>
+#include <boost/beast/websocket/prepared_message.hpp>
 #include <boost/beast/websocket/rfc6455.hpp>
 #include <boost/beast/websocket/stream_base.hpp>
 #include <boost/beast/websocket/stream_fwd.hpp>
@@ -21,6 +22,7 @@
 #include <boost/beast/websocket/detail/pmd_extension.hpp>
 #include <boost/beast/websocket/detail/prng.hpp>
 #include <boost/beast/core/role.hpp>
+#include <boost/beast/core/detail/buffers_pair.hpp>
 #include <boost/beast/core/stream_traits.hpp>
 #include <boost/beast/core/string.hpp>
 #include <boost/beast/http/detail/type_traits.hpp>
@@ -138,6 +140,8 @@ class stream
     using control_cb_type =
         std::function<void(frame_type, string_view)>;
 
+    friend class keepalive;
+
     friend class close_test;
     friend class frame_test;
     friend class ping_test;
@@ -171,6 +175,17 @@ public:
     using executor_type =
         beast::executor_type<next_layer_type>;
 
+    /** The type of a read-only view of a received message.
+
+        This is a <em>ConstBufferSequence</em> of one or two
+        buffers, returned by @ref read_view and @ref async_read_view.
+    */
+#if BOOST_BEAST_DOXYGEN
+    using message_view = __implementation_defined__;
+#else
+    using message_view = beast::detail::buffers_pair<false>;
+#endif
+
     /** Destructor
 
         Destroys the stream and all associated resources.
@@ -558,6 +573,40 @@ public:
     std::size_t
     write_buffer_bytes() const;
 
+    /** Set the send queue limit.
+
+        This sets the largest number of payload bytes which may wait
+        in the send queue. A call to @ref async_send which would go
+        over the limit fails with @ref error::send_queue_full, leaving
+        the queue unchanged, so that producers which are faster than
+        the connection find out and can slow down.
+
+        The default setting is 16 megabytes.
+
+        This function may be called from any thread.
+
+        @par Example
+        Setting the send queue limit.
+        @code
+            ws.send_queue_limit(1024 * 1024);
+        @endcode
+
+        @param amount The limit in bytes.
+    */
+    void
+    send_queue_limit(std::size_t amount);
+
+    /// Returns the send queue limit.
+    std::size_t
+    send_queue_limit() const;
+
+    /** Return statistics about the send queue.
+
+        This function may be called from any thread.
+    */
+    send_queue_stats
+    send_stats() const;
+
     /** Set the text message write option.
 
         This controls whether or not outgoing message opcodes
@@ -1937,6 +1986,116 @@ public:
 
     //--------------------------------------------------------------------------
 
+    /** Read a complete message without copying it.
+
+        This function is used to read a complete message, returning
+        a read-only view of its payload in place of appending it to
+        a caller-provided buffer.
+
+        When the whole message is a single frame which is already
+        held in the stream's read buffer, as is usual for small
+        messages, the view refers to the read buffer itself and no
+        payload is copied. Otherwise, such as for messages larger
+        than the read buffer, messages split across several reads
+        or frames, or compressed messages, the payload is copied
+        into a buffer owned by the stream, whose memory is reused
+        from one message to the next.
+
+        The view, and the memory it refers to, remain valid until
+        the next read or close operation on the stream. The functions
+        @ref got_binary and @ref got_text may be used to query the
+        stream and determine the type of the received message.
+
+        The call blocks until a complete message is received, a
+        close frame is received, or an error occurs. Control frames
+        are handled as in @ref read.
+
+        This function must only be called when no message has been
+        partially read.
+
+        @return A view of the message payload.
+
+        @throws system_error Thrown on failure.
+    */
+    message_view
+    read_view();
+
+    /** Read a complete message without copying it.
+
+        This function is used to read a complete message, returning
+        a read-only view of its payload in place of appending it to
+        a caller-provided buffer.
+
+        When the whole message is a single frame which is already
+        held in the stream's read buffer, as is usual for small
+        messages, the view refers to the read buffer itself and no
+        payload is copied. Otherwise the payload is copied into a
+        buffer owned by the stream.
+
+        The view, and the memory it refers to, remain valid until
+        the next read or close operation on the stream.
+
+        This function must only be called when no message has been
+        partially read.
+
+        @return A view of the message payload.
+
+        @param ec Set to indicate what error occurred, if any.
+    */
+    message_view
+    read_view(error_code& ec);
+
+    /** Read a complete message asynchronously without copying it.
+
+        This function is used to asynchronously read a complete
+        message, completing with a read-only view of its payload
+        in place of appending it to a caller-provided buffer.
+
+        When the whole message is a single frame which is already
+        held in the stream's read buffer, as is usual for small
+        messages, the view refers to the read buffer itself and no
+        payload is copied. Otherwise, such as for messages larger
+        than the read buffer, messages split across several reads
+        or frames, or compressed messages, the payload is copied
+        into a buffer owned by the stream, whose memory is reused
+        from one message to the next.
+
+        The view, and the memory it refers to, remain valid until
+        the next read or close operation on the stream. Control
+        frames are handled as in @ref async_read, and the same
+        restrictions on other operations apply.
+
+        This function must only be called when no message has been
+        partially read.
+
+        @param handler The completion handler to invoke when the operation
+        completes. The implementation takes ownership of the handler by
+        performing a decay-copy. The equivalent function signature of
+        the handler must be:
+        @code
+        void handler(
+            error_code const& ec,       // Result of operation
+            message_view view           // The message payload
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+    */
+    template<
+        ASIO_COMPLETION_TOKEN_FOR(void(error_code, message_view))
+            ReadHandler = net::default_completion_token_t<
+                executor_type>>
+    ASIO_INITFN_AUTO_RESULT_TYPE(
+        ReadHandler, void(error_code, message_view))
+    async_read_view(
+        ReadHandler&& handler =
+            net::default_completion_token_t<
+                executor_type>{});
+
+    //--------------------------------------------------------------------------
+
     /** Read some message data.
 
         This function is used to read some message data.
@@ -2412,6 +2571,111 @@ public:
             net::default_completion_token_t<
                 executor_type>{});
 
+    /** Write a prepared message.
+
+        This function is used to send a message which was framed in
+        advance, usually in order to send it to many streams.
+
+        The call blocks until one of the following is true:
+
+        @li The complete message is written.
+
+        @li An error occurs.
+
+        The message type is the one the message was prepared with,
+        regardless of the @ref binary option. In the server role, when
+        the stream is not compressing messages, or compresses each one
+        on its own with a window no smaller than the message's, the
+        prepared frame is written as it is. Otherwise the message is
+        sent as by @ref write with its payload; the @ref auto_fragment
+        option then applies, and the @ref binary option must match the
+        message type.
+
+        @param message The message to send.
+
+        @return The number of payload bytes sent.
+
+        @throws system_error Thrown on failure.
+    */
+    std::size_t
+    write(prepared_message const& message);
+
+    /** Write a prepared message.
+
+        This function is used to send a message which was framed in
+        advance, usually in order to send it to many streams.
+
+        The call blocks until one of the following is true:
+
+        @li The complete message is written.
+
+        @li An error occurs.
+
+        See the overload above for when the prepared frame is used.
+
+        @param message The message to send.
+
+        @param ec Set to indicate what error occurred, if any.
+
+        @return The number of payload bytes sent.
+    */
+    std::size_t
+    write(prepared_message const& message, error_code& ec);
+
+    /** Write a prepared message asynchronously.
+
+        This function is used to asynchronously send a message which
+        was framed in advance, usually in order to send it to many
+        streams. Each stream refers to the same memory, which is kept
+        alive until the operation completes.
+
+        This call always returns immediately. The asynchronous operation
+        will continue until one of the following conditions is true:
+
+        @li The complete message is written.
+
+        @li An error occurs.
+
+        The program must ensure that no other calls to @ref write,
+        @ref write_some, @ref async_write, or @ref async_write_some are
+        performed until this operation completes.
+
+        In the server role, when the stream is not compressing messages,
+        or compresses each one on its own with a window no smaller than
+        the message's, the prepared frame is written as it is in a single
+        call to `net::async_write`. Otherwise the message is sent as by
+        @ref async_write with its payload; the @ref auto_fragment option
+        then applies, and the @ref binary option must match the message
+        type.
+
+        @param message The message to send.
+
+        @param handler The completion handler to invoke when the operation
+        completes. The implementation takes ownership of the handler by
+        performing a decay-copy. The equivalent function signature of
+        the handler must be:
+        @code
+        void handler(
+            error_code const& ec,           // Result of operation
+            std::size_t bytes_transferred   // Number of payload bytes sent
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+    */
+    template<
+        BOOST_BEAST_ASYNC_TPARAM2 WriteHandler =
+            net::default_completion_token_t<
+                executor_type>>
+    BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
+    async_write(
+        prepared_message const& message,
+        WriteHandler&& handler =
+            net::default_completion_token_t<
+                executor_type>{});
+
     /** Write some message data.
 
         This function is used to send part of a message.
@@ -2536,6 +2800,78 @@ public:
             net::default_completion_token_t<
                 executor_type>{});
 
+    /** Queue a complete message to be sent asynchronously.
+
+        This function appends a message to the send queue of the
+        stream and returns immediately. Unlike @ref async_write, it
+        may be called from any thread, and again before earlier
+        calls complete. The messages are sent in the order they
+        were queued.
+
+        Messages which are waiting when the stream is ready to
+        write are sent together: their frames are laid out one
+        after the other and passed to the next layer in a single
+        call to `net::async_write`, up to 64 messages or 64KB at
+        a time. Frame headers and small payloads are copied so
+        that the batch is mostly contiguous. Larger payloads are
+        written from the caller's buffers, except in the client
+        role, where they are copied in order to apply the mask.
+
+        Each message is sent as a single frame. The current setting
+        of the @ref binary option, when this function is called,
+        controls whether the opcode is text or binary. Queued
+        messages are not compressed, and are not fragmented.
+
+        If the payload would take the queue over the
+        @ref send_queue_limit, the operation completes with
+        @ref error::send_queue_full and nothing is queued.
+
+        The program must ensure that the stream's executor does not
+        run its completion handlers concurrently, for example by
+        using a strand. The program must not call this function
+        while a message is partially sent by @ref async_write_some;
+        if it does, the queue waits for that message to finish.
+        Calls to the synchronous write functions must not be mixed
+        with this function.
+
+        @param buffers A buffer sequence containing the entire message
+        payload. The implementation will make copies of this object
+        as needed, but ownership of the underlying memory is not
+        transferred. The caller is responsible for ensuring that
+        the memory locations pointed to by buffers remains valid
+        until the completion handler is called.
+
+        @param handler The completion handler to invoke when the
+        message has been written to the next layer, or when the
+        operation fails. The implementation takes ownership of the
+        handler by performing a decay-copy. The equivalent function
+        signature of the handler must be:
+        @code
+        void handler(
+            error_code const& ec,           // Result of operation
+            std::size_t bytes_transferred   // The size of the payload,
+                                            // or zero on error.
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+
+        @see send_queue_limit, send_stats
+    */
+    template<
+        class ConstBufferSequence,
+        BOOST_BEAST_ASYNC_TPARAM2 WriteHandler =
+            net::default_completion_token_t<
+                executor_type>>
+    BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
+    async_send(
+        ConstBufferSequence const& buffers,
+        WriteHandler&& handler =
+            net::default_completion_token_t<
+                executor_type>{});
+
 private:
     template<class, class>  class accept_op;
     template<class>         class close_op;
@@ -2544,9 +2880,13 @@ private:
     template<class>         class idle_ping_op;
     template<class, class>  class read_some_op;
     template<class, class>  class read_op;
+    template<class>         class read_view_op;
     template<class>         class response_op;
     template<class, class>  class write_some_op;
     template<class, class>  class write_op;
+    template<class>         class write_prepared_op;
+    template<class, class>  class send_op;
+    template<class>         class flush_op;
 
     struct run_accept_op;
     struct run_close_op;
@@ -2555,9 +2895,12 @@ private:
     struct run_idle_ping_op;
     struct run_read_some_op;
     struct run_read_op;
+    struct run_read_view_op;
     struct run_response_op;
     struct run_write_some_op;
     struct run_write_op;
+    struct run_write_prepared_op;
+    struct run_send_op;
 
     static void default_decorate_req(request_type&) {}
     static void default_decorate_res(response_type&) {}
@@ -2641,6 +2984,7 @@ seed_prng(std::seed_seq& ss)
 #include <boost/beast/websocket/impl/handshake.hpp>
 #include <boost/beast/websocket/impl/ping.hpp>
 #include <boost/beast/websocket/impl/read.hpp>
+#include <boost/beast/websocket/impl/send.hpp>
 #include <boost/beast/websocket/impl/stream.hpp>
 #include <boost/beast/websocket/impl/write.hpp>
 
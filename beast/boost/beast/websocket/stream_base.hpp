@@ -14,6 +14,8 @@
 #include <boost/beast/websocket/detail/decorator.hpp>
 #include <boost/beast/core/role.hpp>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 
 namespace boost {
@@ -159,6 +161,28 @@ struct stream_base
         }
     };
 
+    /** Statistics describing the send queue of a stream.
+
+        @see stream::async_send, stream::send_stats
+    */
+    struct send_queue_stats
+    {
+        /// The number of messages waiting to be sent
+        std::size_t depth = 0;
+
+        /// The number of payload bytes waiting to be sent
+        std::size_t bytes = 0;
+
+        /// The number of writes made to the next layer
+        std::uint64_t batches = 0;
+
+        /// The number of messages sent in those writes
+        std::uint64_t messages = 0;
+
+        /// The largest number of messages sent in one write
+        std::size_t largest_batch = 0;
+    };
+
 protected:
     enum class status
     {
@@ -0,0 +1,269 @@
+#include "bench.hpp"
+#include <array>
+#include <memory>
+#include <vector>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/read.hpp>
+#include <asio/write.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+
+// Loopback throughput and latency of tcp_stream. Build with
+// -DBEAST_USE_IO_URING=ON to measure the io_uring path; the
+// "io_uring" counter records which path was measured.
+
+namespace net = asio;
+namespace beast = boost::beast;
+using tcp = net::ip::tcp;
+
+namespace {
+
+using error_code = beast::error_code;
+
+struct stream_pair
+{
+    beast::tcp_stream client;
+    beast::tcp_stream server;
+};
+
+std::vector<std::unique_ptr<stream_pair>>
+make_pairs(net::io_context& ioc, std::size_t n)
+{
+    tcp::acceptor acceptor(ioc,
+        tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+    std::vector<std::unique_ptr<stream_pair>> v;
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        tcp::socket client(ioc);
+        client.connect(acceptor.local_endpoint());
+        client.set_option(tcp::no_delay(true));
+        auto server = acceptor.accept();
+        server.set_option(tcp::no_delay(true));
+        v.push_back(std::make_unique<stream_pair>(stream_pair{
+            beast::tcp_stream(std::move(client)),
+            beast::tcp_stream(std::move(server))}));
+    }
+    return v;
+}
+
+// Close every stream and let the canceled operations finish
+void
+close_pairs(
+    net::io_context& ioc,
+    std::vector<std::unique_ptr<stream_pair>>& v)
+{
+    for(auto& p : v)
+    {
+        p->client.close();
+        p->server.close();
+    }
+    ioc.restart();
+    ioc.run();
+}
+
+// counts io_uring_enter calls, when enabled
+struct enter_counter
+{
+#if BOOST_BEAST_HAS_IO_URING
+    beast::detail::io_uring_service* svc;
+    std::uint64_t start;
+
+    explicit
+    enter_counter(net::io_context& ioc)
+        : svc(beast::detail::io_uring_service::find(ioc))
+        , start(svc ? svc->stats().enters : 0)
+    {
+    }
+
+    void
+    report(bench::result& r) const
+    {
+        r.counters["io_uring"] = svc ? 1 : 0;
+        if(svc && r.iterations)
+            r.counters["enters_per_op"] =
+                double(svc->stats().enters - start) / r.iterations;
+    }
+#else
+    explicit
+    enter_counter(net::io_context&)
+    {
+    }
+
+    void
+    report(bench::result& r) const
+    {
+        r.counters["io_uring"] = 0;
+    }
+#endif
+};
+
+// The client sends a message, the server echoes it back
+class ping_pong
+{
+    stream_pair& p_;
+    std::size_t& done_;
+    std::array<char, 64> out_{};
+    std::array<char, 64> in_{};
+    std::array<char, 64> echo_{};
+    std::size_t remain_ = 0;
+
+public:
+    ping_pong(stream_pair& p, std::size_t& done)
+        : p_(p)
+        , done_(done)
+    {
+        serve();
+    }
+
+    void
+    start(std::size_t rounds)
+    {
+        remain_ = rounds;
+        ping();
+    }
+
+private:
+    void
+    ping()
+    {
+        net::async_write(p_.client, net::buffer(out_),
+            [this](error_code ec, std::size_t)
+            {
+                if(ec)
+                    return;
+                net::async_read(p_.client, net::buffer(in_),
+                    [this](error_code ec, std::size_t)
+                    {
+                        if(ec)
+                            return;
+                        if(--remain_ > 0)
+                            ping();
+                        else
+                            ++done_;
+                    });
+            });
+    }
+
+    void
+    serve()
+    {
+        net::async_read(p_.server, net::buffer(echo_),
+            [this](error_code ec, std::size_t)
+            {
+                if(ec)
+                    return;
+                net::async_write(p_.server, net::buffer(echo_),
+                    [this](error_code ec, std::size_t)
+                    {
+                        if(! ec)
+                            serve();
+                    });
+            });
+    }
+};
+
+void
+run_ping_pong(bench::context& ctx, std::size_t connections)
+{
+    std::size_t constexpr rounds = 200;
+
+    net::io_context ioc(1);
+    auto pairs = make_pairs(ioc, connections);
+    std::size_t done = 0;
+    std::vector<std::unique_ptr<ping_pong>> v;
+    for(auto& p : pairs)
+        v.push_back(std::make_unique<ping_pong>(*p, done));
+
+    enter_counter enters(ioc);
+    std::uint64_t n = 0;
+    auto const t0 = bench::clock_type::now();
+    std::chrono::duration<double> elapsed{};
+    while(elapsed.count() < ctx.min_time())
+    {
+        done = 0;
+        for(auto& pp : v)
+            pp->start(rounds);
+        while(done < connections)
+            ioc.run_one();
+        n += rounds * connections;
+        elapsed = bench::clock_type::now() - t0;
+    }
+
+    bench::result r;
+    r.name = "basic_stream/loopback/ping_pong/" +
+        std::to_string(connections);
+    r.iterations = n;
+    r.seconds = elapsed.count();
+    r.bytes = n * 2 * 64;
+    r.counters["connections"] = static_cast<double>(connections);
+    enters.report(r);
+    ctx.add(std::move(r));
+
+    close_pairs(ioc, pairs);
+}
+
+} // (anon)
+
+BENCH_CASE("basic_stream/loopback/bulk")
+{
+    std::size_t constexpr chunk = 256 * 1024;
+
+    net::io_context ioc(1);
+    auto pairs = make_pairs(ioc, 1);
+    auto& p = *pairs.front();
+    std::vector<char> out(chunk), in(chunk);
+
+    std::uint64_t writes = 0;
+    std::uint64_t received = 0;
+    bool stop = false;
+    std::function<void()> write =
+        [&]
+        {
+            p.client.async_write_some(net::buffer(out),
+                [&](error_code ec, std::size_t)
+                {
+                    ++writes;
+                    if(! ec && ! stop)
+                        write();
+                });
+        };
+    std::function<void()> read =
+        [&]
+        {
+            p.server.async_read_some(net::buffer(in),
+                [&](error_code ec, std::size_t n)
+                {
+                    received += n;
+                    if(! ec && ! stop)
+                        read();
+                });
+        };
+
+    enter_counter enters(ioc);
+    auto const t0 = bench::clock_type::now();
+    std::chrono::duration<double> elapsed{};
+    write();
+    read();
+    while(elapsed.count() < ctx.min_time())
+    {
+        ioc.run_one();
+        elapsed = bench::clock_type::now() - t0;
+    }
+    stop = true;
+
+    bench::result r;
+    r.name = "basic_stream/loopback/bulk";
+    r.iterations = writes;
+    r.seconds = elapsed.count();
+    r.bytes = received;
+    enters.report(r);
+    ctx.add(std::move(r));
+
+    close_pairs(ioc, pairs);
+}
+
+BENCH_CASE("basic_stream/loopback/ping_pong")
+{
+    for(std::size_t connections : {1, 16, 128})
+        run_ping_pong(ctx, connections);
+}
@@ -0,0 +1,86 @@
+#include "bench.hpp"
+#include <array>
+#include <string>
+#include <vector>
+#include <asio/buffer.hpp>
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/buffers_cat.hpp>
+
+// Visiting the buffers of a buffers_cat_view, whose iterator holds
+// a variant over the iterators of each concatenated sequence, and
+// copying from the view into a contiguous buffer.
+
+namespace net = asio;
+namespace beast = boost::beast;
+
+namespace {
+
+template<class ConstBufferSequence>
+std::size_t
+visit(ConstBufferSequence const& bs)
+{
+    std::size_t n = 0;
+    for(auto it = net::buffer_sequence_begin(bs),
+        end = net::buffer_sequence_end(bs); it != end; ++it)
+        n += net::const_buffer(*it).size();
+    return n;
+}
+
+template<class ConstBufferSequence>
+void
+run(bench::context& ctx, std::string const& name,
+    ConstBufferSequence const& bs)
+{
+    auto const bytes = beast::buffer_bytes(bs);
+    std::string out(bytes, 0);
+
+    ctx.measure(name + "/iterate",
+        [&](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+                bench::do_not_optimize(visit(bs));
+        },
+        bytes);
+
+    ctx.measure(name + "/buffer_copy",
+        [&](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+                bench::do_not_optimize(net::buffer_copy(
+                    net::buffer(&out[0], out.size()), bs));
+        },
+        bytes);
+}
+
+} // (anon)
+
+BENCH_CASE("buffers_cat")
+{
+    std::string const data(4096, 'x');
+    auto const b =
+        [&](std::size_t pos, std::size_t size)
+        {
+            return net::const_buffer(data.data() + pos, size);
+        };
+
+    // a header, a chunk header, a body and a crlf
+    run(ctx, "buffers_cat/small",
+        beast::buffers_cat(b(0, 200), b(200, 6), b(206, 1000),
+            b(1206, 2)));
+
+    // sequences of several buffers, some of them empty
+    std::vector<net::const_buffer> v;
+    for(std::size_t i = 0; i < 16; ++i)
+        v.push_back(b(i * 128, i % 4 == 0 ? 0 : 128));
+    std::array<net::const_buffer, 4> a{
+        b(2048, 256), b(2304, 256), b(2560, 0), b(2816, 256)};
+    run(ctx, "buffers_cat/sequences",
+        beast::buffers_cat(b(3072, 100), v, net::const_buffer{}, a));
+
+    // a concatenation of concatenations
+    run(ctx, "buffers_cat/nested",
+        beast::buffers_cat(
+            beast::buffers_cat(b(0, 100), v),
+            beast::buffers_cat(a, b(3072, 100)),
+            b(3172, 100)));
+}
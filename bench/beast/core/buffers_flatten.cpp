@@ -0,0 +1,159 @@
+#include "bench.hpp"
+#include <sys/uio.h>
+#include <array>
+#include <optional>
+#include <string>
+#include <utility>
+#include <asio/buffer.hpp>
+#include <boost/beast/core/buffers_flatten.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/http/serializer.hpp>
+#include <boost/beast/http/string_body.hpp>
+
+// Converting the buffer sequences produced by http::serializer into
+// an iovec array, as the socket does for writev: through the
+// iterators of the nested buffers_cat_view, buffers_suffix and
+// buffers_prefix_view, or from the array made by buffers_flatten.
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+namespace {
+
+std::size_t constexpr max_iov = 64;
+
+// A body of 16 separate buffers
+struct array_body
+{
+    using value_type = std::array<net::const_buffer, 16>;
+
+    static
+    std::uint64_t
+    size(value_type const& v)
+    {
+        return net::buffer_size(v);
+    }
+
+    class writer
+    {
+        value_type const& body_;
+
+    public:
+        using const_buffers_type = value_type;
+
+        template<bool isRequest, class Fields>
+        writer(http::header<isRequest, Fields> const&,
+                value_type const& b)
+            : body_(b)
+        {
+        }
+
+        void
+        init(beast::error_code& ec)
+        {
+            ec = {};
+        }
+
+        std::optional<std::pair<const_buffers_type, bool>>
+        get(beast::error_code& ec)
+        {
+            ec = {};
+            return {{body_, false}};
+        }
+    };
+};
+
+template<class ConstBufferSequence>
+std::size_t
+to_iovec(ConstBufferSequence const& bs, ::iovec* iov)
+{
+    std::size_t n = 0;
+    for(auto it = net::buffer_sequence_begin(bs),
+        end = net::buffer_sequence_end(bs);
+        it != end && n < max_iov; ++it)
+    {
+        net::const_buffer const b = *it;
+        iov[n].iov_base = const_cast<void*>(b.data());
+        iov[n].iov_len = b.size();
+        ++n;
+    }
+    return n;
+}
+
+// Measure the first sequence the serializer produces for m
+template<class Body>
+void
+run(bench::context& ctx, std::string const& name,
+    http::request<Body>& m)
+{
+    http::request_serializer<Body> sr(m);
+    beast::error_code ec;
+    sr.next(ec,
+        [&](beast::error_code&, auto const& buffers)
+        {
+            ::iovec iov[max_iov];
+            auto const bytes = beast::buffer_bytes(buffers);
+            ctx.measure(name + "/iterate",
+                [&](std::uint64_t n)
+                {
+                    for(std::uint64_t i = 0; i < n; ++i)
+                    {
+                        bench::do_not_optimize(to_iovec(buffers, iov));
+                        bench::do_not_optimize(iov[0].iov_base);
+                    }
+                },
+                bytes).counters["buffers"] =
+                    static_cast<double>(to_iovec(buffers, iov));
+            ctx.measure(name + "/flatten",
+                [&](std::uint64_t n)
+                {
+                    for(std::uint64_t i = 0; i < n; ++i)
+                    {
+                        auto const a =
+                            beast::buffers_flatten<max_iov>(buffers);
+                        bench::do_not_optimize(to_iovec(a, iov));
+                        bench::do_not_optimize(iov[0].iov_base);
+                    }
+                },
+                bytes);
+        });
+    if(ec)
+        throw beast::system_error{ec};
+}
+
+template<class Body>
+void
+prepare(http::request<Body>& m)
+{
+    m.method(http::verb::post);
+    m.target("/upload");
+    m.set(http::field::host, "www.example.com");
+    m.set(http::field::user_agent, "bench");
+    m.set(http::field::content_type, "application/octet-stream");
+}
+
+} // (anon)
+
+BENCH_CASE("buffers_flatten/serializer")
+{
+    // header and body (cb2_t)
+    http::request<http::string_body> req;
+    prepare(req);
+    req.body() = std::string(1000, 'x');
+    req.prepare_payload();
+    run(ctx, "buffers_flatten/serializer/sized", req);
+
+    // header, chunk header, body and crlf (cb4_t)
+    req.chunked(true);
+    run(ctx, "buffers_flatten/serializer/chunked", req);
+
+    // the same with a body of 16 buffers
+    http::request<array_body> areq;
+    prepare(areq);
+    std::string const data(16000, 'x');
+    for(std::size_t i = 0; i < 16; ++i)
+        areq.body()[i] = net::const_buffer(data.data() + i * 1000, 1000);
+    areq.chunked(true);
+    run(ctx, "buffers_flatten/serializer/chunked_16", areq);
+}
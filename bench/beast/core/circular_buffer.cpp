@@ -0,0 +1,141 @@
+#include "bench.hpp"
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <asio/buffer.hpp>
+#include <boost/beast/core/circular_buffer.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/parser.hpp>
+
+// A long-lived connection's read buffer: reads of a fixed size
+// are appended and consumed in pieces which do not line up with
+// them, so some bytes always remain. flat_buffer moves them to
+// the front, multi_buffer allocates and frees elements, and
+// circular_buffer wraps around.
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+namespace {
+
+std::size_t constexpr read_size = 4096;
+
+template<class DynamicBuffer>
+void
+churn(DynamicBuffer& b, std::string const& src,
+    std::size_t consume_size, std::uint64_t n)
+{
+    for(std::uint64_t i = 0; i < n; ++i)
+    {
+        b.commit(net::buffer_copy(
+            b.prepare(read_size), net::buffer(src)));
+        while(b.size() >= consume_size + read_size)
+        {
+            // look at the front, as a parser would
+            bench::do_not_optimize(
+                *static_cast<char const*>(
+                    (*net::buffer_sequence_begin(b.data())).data()));
+            b.consume(consume_size);
+        }
+    }
+}
+
+// Pipelined requests, received in reads which split them
+std::string
+make_pipeline(std::size_t count)
+{
+    std::string s;
+    for(std::size_t i = 0; i < count; ++i)
+        s +=
+            "GET /index/" + std::to_string(i) + ".html HTTP/1.1\r\n"
+            "Host: www.example.com\r\n"
+            "User-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n"
+            "Accept: text/html,application/xhtml+xml\r\n"
+            "Accept-Encoding: gzip, deflate\r\n"
+            "Connection: keep-alive\r\n"
+            "\r\n";
+    return s;
+}
+
+template<class DynamicBuffer>
+void
+pipeline(DynamicBuffer& b, std::string const& wire, std::uint64_t n)
+{
+    // start again from the first message
+    b.clear();
+    std::size_t pos = 0;
+    std::optional<http::request_parser<http::empty_body>> p;
+    p.emplace();
+    for(std::uint64_t i = 0; i < n;)
+    {
+        auto const size = (std::min)(read_size, wire.size() - pos);
+        b.commit(net::buffer_copy(b.prepare(size),
+            net::buffer(wire.data() + pos, size)));
+        pos = (pos + size) % wire.size();
+        while(b.size() > 0)
+        {
+            beast::error_code ec;
+            b.consume(p->put(b.data(), ec));
+            if(ec == http::error::need_more)
+                break;
+            if(ec)
+                throw beast::system_error{ec};
+            if(p->is_done())
+            {
+                bench::do_not_optimize(p->get().target().size());
+                p.emplace();
+                ++i;
+            }
+        }
+    }
+}
+
+template<class DynamicBuffer>
+void
+run(bench::context& ctx, char const* name)
+{
+    std::string const src(read_size, 'x');
+    auto const wire = make_pipeline(1000);
+    auto const message_size = wire.size() / 1000;
+    for(std::size_t consume_size : {100, 1000, 3000})
+    {
+        DynamicBuffer b;
+        ctx.measure(
+            std::string("dynamic_buffer/churn/") + name +
+                "/consume=" + std::to_string(consume_size),
+            [&](std::uint64_t n)
+            {
+                churn(b, src, consume_size, n);
+            },
+            read_size);
+    }
+    DynamicBuffer b;
+    ctx.measure(
+        std::string("dynamic_buffer/http_pipeline/") + name,
+        [&](std::uint64_t n)
+        {
+            pipeline(b, wire, n);
+        },
+        message_size);
+}
+
+} // (anon)
+
+BENCH_CASE("dynamic_buffer/flat_buffer")
+{
+    run<beast::flat_buffer>(ctx, "flat_buffer");
+}
+
+BENCH_CASE("dynamic_buffer/multi_buffer")
+{
+    run<beast::multi_buffer>(ctx, "multi_buffer");
+}
+
+BENCH_CASE("dynamic_buffer/circular_buffer")
+{
+    run<beast::circular_buffer>(ctx, "circular_buffer");
+}
@@ -0,0 +1,42 @@
+#include "bench.hpp"
+#include <random>
+#include <string>
+#include <boost/beast/core/detail/base64.hpp>
+
+// Encoding and decoding base64 of the sizes used by the websocket
+// handshake keys and by larger payloads such as credentials.
+
+namespace base64 = boost::beast::detail::base64;
+
+BENCH_CASE("base64")
+{
+    std::mt19937 g(1);
+    for(std::size_t size : {16, 1024, 65536})
+    {
+        std::string in(size, 0);
+        for(auto& c : in)
+            c = static_cast<char>(g());
+        std::string encoded(base64::encoded_size(size), 0);
+        encoded.resize(base64::encode(
+            &encoded[0], in.data(), in.size()));
+        std::string out(base64::decoded_size(encoded.size()), 0);
+
+        ctx.measure("base64/encode/" + std::to_string(size),
+            [&](std::uint64_t n)
+            {
+                for(std::uint64_t i = 0; i < n; ++i)
+                    bench::do_not_optimize(base64::encode(
+                        &encoded[0], in.data(), in.size()));
+            },
+            size);
+
+        ctx.measure("base64/decode/" + std::to_string(size),
+            [&](std::uint64_t n)
+            {
+                for(std::uint64_t i = 0; i < n; ++i)
+                    bench::do_not_optimize(base64::decode(
+                        &out[0], encoded.data(), encoded.size()));
+            },
+            encoded.size());
+    }
+}
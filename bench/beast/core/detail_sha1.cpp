@@ -0,0 +1,30 @@
+#include "bench.hpp"
+#include <string>
+#include <boost/beast/core/detail/sha1.hpp>
+
+// Hashing with SHA-1: the 60 bytes of a websocket handshake key
+// and its GUID, and larger inputs fed in one update.
+
+namespace detail = boost::beast::detail;
+
+BENCH_CASE("sha1")
+{
+    for(std::size_t size : {60, 1024, 65536})
+    {
+        std::string const in(size, 'x');
+        ctx.measure("sha1/" + std::to_string(size),
+            [&](std::uint64_t n)
+            {
+                for(std::uint64_t i = 0; i < n; ++i)
+                {
+                    detail::sha1_context c;
+                    detail::init(c);
+                    detail::update(c, in.data(), in.size());
+                    unsigned char digest[detail::sha1_context::digest_size];
+                    detail::finish(c, digest);
+                    bench::do_not_optimize(digest);
+                }
+            },
+            size);
+    }
+}
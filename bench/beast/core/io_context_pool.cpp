@@ -0,0 +1,165 @@
+#include "bench.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#include <boost/beast/core/io_context_pool.hpp>
+
+namespace net = asio;
+using boost::beast::io_context_pool;
+
+namespace {
+
+std::size_t constexpr chains = 64;
+std::size_t constexpr hops = 20000;
+
+// 1, 2, 4, ... up to the number of processors
+std::vector<std::size_t>
+thread_counts()
+{
+    std::vector<std::size_t> v;
+    auto const n = std::max(1u, std::thread::hardware_concurrency());
+    for(std::size_t i = 1; i < n; i *= 2)
+        v.push_back(i);
+    v.push_back(n);
+    return v;
+}
+
+// A handler which re-posts itself to the same executor
+template<class Executor>
+struct chain
+{
+    Executor ex;
+    std::size_t remain;
+    std::atomic<std::size_t>* done;
+
+    void
+    operator()()
+    {
+        if(--remain == 0)
+        {
+            ++*done;
+            return;
+        }
+        net::post(ex, std::move(*this));
+    }
+};
+
+bench::result
+make_result(
+    std::string name,
+    std::size_t threads,
+    std::size_t iterations,
+    bench::clock_type::duration elapsed)
+{
+    bench::result r;
+    r.name = std::move(name);
+    r.iterations = iterations;
+    r.seconds = std::chrono::duration<double>(elapsed).count();
+    r.counters["threads"] = static_cast<double>(threads);
+    return r;
+}
+
+// Busy work of roughly a few microseconds
+void
+spin()
+{
+    std::uint64_t x = 0;
+    for(int i = 0; i < 2000; ++i)
+        bench::do_not_optimize(x += i);
+}
+
+} // (anon)
+
+BENCH_CASE("io_context_pool/post_chains/shared_io_context")
+{
+    for(auto const threads : thread_counts())
+    {
+        net::io_context ioc(static_cast<int>(threads));
+        std::atomic<std::size_t> done{0};
+        for(std::size_t i = 0; i < chains; ++i)
+            net::post(ioc, chain<net::io_context::executor_type>{
+                ioc.get_executor(), hops, &done});
+        auto const t0 = bench::clock_type::now();
+        std::vector<std::thread> v;
+        for(std::size_t i = 0; i < threads; ++i)
+            v.emplace_back([&]{ ioc.run(); });
+        for(auto& t : v)
+            t.join();
+        ctx.add(make_result(
+            "io_context_pool/post_chains/shared_io_context/threads:" +
+                std::to_string(threads),
+            threads, chains * hops, bench::clock_type::now() - t0));
+    }
+}
+
+BENCH_CASE("io_context_pool/post_chains/pool")
+{
+    for(auto const threads : thread_counts())
+    {
+        io_context_pool::options opt;
+        opt.size = threads;
+        opt.pin_threads = true;
+        io_context_pool pool(opt);
+        std::atomic<std::size_t> done{0};
+        for(std::size_t i = 0; i < chains; ++i)
+        {
+            auto ex = pool.get_executor();
+            net::post(ex, chain<io_context_pool::executor_type>{
+                ex, hops, &done});
+        }
+        auto const t0 = bench::clock_type::now();
+        pool.release();
+        pool.run();
+        pool.join();
+        ctx.add(make_result(
+            "io_context_pool/post_chains/pool/threads:" +
+                std::to_string(threads),
+            threads, chains * hops, bench::clock_type::now() - t0));
+    }
+}
+
+// All tasks are submitted from the thread of context 0
+static
+void
+run_tasks(bench::context& ctx, bool stealing)
+{
+    std::size_t constexpr tasks = 20000;
+    for(auto const threads : thread_counts())
+    {
+        io_context_pool::options opt;
+        opt.size = threads;
+        opt.work_stealing = stealing;
+        io_context_pool pool(opt);
+        std::atomic<std::size_t> done{0};
+        net::post(pool.at(0),
+            [&]
+            {
+                for(std::size_t i = 0; i < tasks; ++i)
+                    pool.post([&]{ spin(); ++done; });
+            });
+        auto const t0 = bench::clock_type::now();
+        pool.run();
+        while(done.load() != tasks)
+            std::this_thread::yield();
+        auto const elapsed = bench::clock_type::now() - t0;
+        pool.stop();
+        pool.join();
+        ctx.add(make_result(
+            std::string("io_context_pool/cpu_tasks/") +
+                (stealing ? "stealing" : "no_stealing") +
+                "/threads:" + std::to_string(threads),
+            threads, tasks, elapsed));
+    }
+}
+
+BENCH_CASE("io_context_pool/cpu_tasks/no_stealing")
+{
+    run_tasks(ctx, false);
+}
+
+BENCH_CASE("io_context_pool/cpu_tasks/stealing")
+{
+    run_tasks(ctx, true);
+}
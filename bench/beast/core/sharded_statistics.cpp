@@ -0,0 +1,125 @@
+#include "bench.hpp"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <asio/executor_work_guard.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#include <asio/strand.hpp>
+#include <boost/beast/core/sharded_statistics.hpp>
+
+// Counting an event and recording its latency from several
+// threads: by posting to a strand which owns the statistics, as
+// the crawl example used to, with shared atomic counters, and
+// with the shards of a sharded_statistics.
+
+namespace net = asio;
+namespace beast = boost::beast;
+
+namespace {
+
+// Run f(n) on each of `threads` threads
+template<class F>
+void
+parallel(std::size_t threads, std::uint64_t n, F const& f)
+{
+    std::vector<std::thread> v;
+    for(std::size_t i = 0; i < threads; ++i)
+        v.emplace_back([&f, n]{ f(n); });
+    for(auto& t : v)
+        t.join();
+}
+
+struct shared_stats
+{
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> sum{0};
+};
+
+} // (anon)
+
+BENCH_CASE("sharded_statistics")
+{
+    for(std::size_t threads : {1, 4})
+    {
+        auto const suffix = "/threads=" + std::to_string(threads);
+
+        ctx.measure("sharded_statistics/strand" + suffix,
+            [threads](std::uint64_t n)
+            {
+                net::io_context ioc;
+                auto strand = net::make_strand(ioc);
+                std::uint64_t count = 0;
+                beast::hdr_histogram h;
+                {
+                    auto work = net::make_work_guard(ioc);
+                    std::thread t([&ioc]{ ioc.run(); });
+                    parallel(threads, n / threads,
+                        [&](std::uint64_t m)
+                        {
+                            for(std::uint64_t i = 0; i < m; ++i)
+                                net::post(strand,
+                                    [&count, &h, i]
+                                    {
+                                        ++count;
+                                        h.record(i & 1023);
+                                    });
+                        });
+                    work.reset();
+                    t.join();
+                }
+                bench::do_not_optimize(count);
+            });
+
+        ctx.measure("sharded_statistics/atomic" + suffix,
+            [threads](std::uint64_t n)
+            {
+                shared_stats s;
+                parallel(threads, n / threads,
+                    [&s](std::uint64_t m)
+                    {
+                        for(std::uint64_t i = 0; i < m; ++i)
+                        {
+                            s.count.fetch_add(1, std::memory_order_relaxed);
+                            s.sum.fetch_add(i & 1023, std::memory_order_relaxed);
+                        }
+                    });
+                bench::do_not_optimize(s.count);
+            });
+
+        ctx.measure("sharded_statistics/local" + suffix,
+            [threads](std::uint64_t n)
+            {
+                beast::sharded_statistics stats(1, 1);
+                parallel(threads, n / threads,
+                    [&stats](std::uint64_t m)
+                    {
+                        for(std::uint64_t i = 0; i < m; ++i)
+                        {
+                            auto& s = stats.local();
+                            s.add(0);
+                            s.record(0, i & 1023);
+                        }
+                    });
+                bench::do_not_optimize(stats.counter(0));
+            });
+
+        ctx.measure("sharded_statistics/shard" + suffix,
+            [threads](std::uint64_t n)
+            {
+                beast::sharded_statistics stats(1, 1);
+                parallel(threads, n / threads,
+                    [&stats](std::uint64_t m)
+                    {
+                        auto& s = stats.make_shard();
+                        for(std::uint64_t i = 0; i < m; ++i)
+                        {
+                            s.add(0);
+                            s.record(0, i & 1023);
+                        }
+                    });
+                bench::do_not_optimize(stats.counter(0));
+            });
+    }
+}
@@ -0,0 +1,69 @@
+#include "bench.hpp"
+#include <cstdint>
+#include <boost/beast/core/hdr_histogram.hpp>
+#include <boost/beast/core/trace.hpp>
+
+// The cost of tracing a phase: recording a value in a histogram,
+// and starting and finishing a span with no tracer installed,
+// with a collector, and with a tracer which does nothing.
+
+namespace beast = boost::beast;
+
+namespace {
+
+struct null_tracer : beast::tracer
+{
+    void
+    on_phase(
+        beast::trace_phase,
+        clock_type::duration,
+        beast::error_code const&) override
+    {
+    }
+};
+
+void
+spans(bench::context& ctx, std::string const& name)
+{
+    ctx.measure(name,
+        [](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+            {
+                beast::trace_span s;
+                bench::do_not_optimize(s);
+                s.finish(beast::trace_phase::read_body);
+            }
+        });
+}
+
+} // (anon)
+
+BENCH_CASE("trace")
+{
+    beast::hdr_histogram h;
+    ctx.measure("trace/hdr_histogram/record",
+        [&h](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+                h.record((i * 2654435761u) & 0xffffff);
+        });
+    ctx.measure("trace/hdr_histogram/p99",
+        [&h](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+                bench::do_not_optimize(h.value_at_percentile(99));
+        });
+
+    spans(ctx, "trace/span/disabled");
+    {
+        null_tracer t;
+        beast::scoped_tracer st(t);
+        spans(ctx, "trace/span/null_tracer");
+    }
+    {
+        beast::trace_collector c;
+        beast::scoped_tracer st(c);
+        spans(ctx, "trace/span/collector");
+    }
+}
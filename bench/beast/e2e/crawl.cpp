@@ -0,0 +1,219 @@
+#include "bench.hpp"
+#include "crawl_engine.hpp"
+#include "dns_cache.hpp"
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/io_context_pool.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+
+// The crawl engine of the http_crawl example against a farm of
+// local HTTP servers, one per host, each on its own loopback port.
+// Targets are spread over the hosts in turn until the measurement
+// time is up. The engine is run with connections kept alive and
+// closed after every request, and with one or several concurrent
+// connections per host.
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+using tcp = net::ip::tcp;
+
+namespace {
+
+std::size_t constexpr hosts = 16;
+std::size_t constexpr body_size = 512;
+
+// A keep-alive HTTP server on one connection
+class server_session
+    : public std::enable_shared_from_this<server_session>
+{
+    beast::tcp_stream stream_;
+    beast::flat_buffer buffer_;
+    http::request<http::empty_body> req_;
+    http::response<http::string_body> res_;
+
+public:
+    explicit
+    server_session(tcp::socket socket)
+        : stream_(std::move(socket))
+        , res_(http::status::ok, 11)
+    {
+        res_.set(http::field::server, "bench");
+        res_.set(http::field::content_type, "text/html");
+        res_.body() = std::string(body_size, 'x');
+    }
+
+    void
+    run()
+    {
+        req_ = {};
+        http::async_read(stream_, buffer_, req_,
+            [self = shared_from_this()](beast::error_code ec, std::size_t)
+            {
+                if(ec)
+                    return self->stream_.close();
+                self->respond();
+            });
+    }
+
+private:
+    void
+    respond()
+    {
+        res_.keep_alive(req_.keep_alive());
+        res_.prepare_payload();
+        http::async_write(stream_, res_,
+            [self = shared_from_this()](beast::error_code ec, std::size_t)
+            {
+                if(ec || ! self->res_.keep_alive())
+                    return self->stream_.close();
+                self->run();
+            });
+    }
+};
+
+// The servers, run by their own thread
+class farm
+{
+    net::io_context ioc_{1};
+    std::vector<tcp::acceptor> acceptors_;
+    std::vector<std::string> ports_;
+    std::thread thread_;
+
+    void
+    accept(tcp::acceptor& a)
+    {
+        a.async_accept(
+            [this, &a](beast::error_code ec, tcp::socket s)
+            {
+                if(ec)
+                    return;
+                std::make_shared<server_session>(std::move(s))->run();
+                accept(a);
+            });
+    }
+
+public:
+    explicit
+    farm(std::size_t n)
+    {
+        acceptors_.reserve(n);
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            acceptors_.emplace_back(ioc_,
+                tcp::endpoint(net::ip::address_v4::loopback(), 0));
+            ports_.push_back(std::to_string(
+                acceptors_.back().local_endpoint().port()));
+            accept(acceptors_.back());
+        }
+        thread_ = std::thread([this]{ ioc_.run(); });
+    }
+
+    ~farm()
+    {
+        ioc_.stop();
+        thread_.join();
+    }
+
+    std::vector<std::string> const&
+    ports() const noexcept
+    {
+        return ports_;
+    }
+};
+
+void
+run_crawl(
+    bench::context& ctx,
+    farm& f,
+    std::string name,
+    crawl::crawl_engine::options const& opt)
+{
+    using engine_type = crawl::crawl_engine;
+
+    beast::io_context_pool pool(2);
+    crawl::dns_cache dns;
+    engine_type engine(pool, dns, opt);
+
+    std::size_t next = 0;
+    auto const t0 = bench::clock_type::now();
+    auto const until = t0 + std::chrono::duration_cast<
+        bench::clock_type::duration>(
+            std::chrono::duration<double>(ctx.min_time()));
+    std::chrono::duration<double> elapsed{};
+    engine.run(
+        [&]() -> std::optional<crawl::crawl_target>
+        {
+            if(bench::clock_type::now() >= until)
+                return std::nullopt;
+            crawl::crawl_target t;
+            t.host = "127.0.0.1";
+            t.port = f.ports()[next++ % f.ports().size()];
+            return t;
+        },
+        nullptr,
+        [&]
+        {
+            elapsed = bench::clock_type::now() - t0;
+            pool.release();
+        });
+    pool.run();
+    pool.join();
+
+    auto const& s = engine.stats();
+    auto const h = s.histogram(engine_type::fetch);
+    auto const d = dns.stats();
+
+    bench::result r;
+    r.name = std::move(name);
+    r.iterations = s.counter(engine_type::responses);
+    r.seconds = elapsed.count();
+    r.bytes = s.counter(engine_type::body_bytes);
+    r.counters["failures"] = static_cast<double>(
+        s.counter(engine_type::connect_failures) +
+        s.counter(engine_type::write_failures) +
+        s.counter(engine_type::read_failures));
+    r.counters["opened"] = static_cast<double>(
+        s.counter(engine_type::connections_opened));
+    r.counters["reused"] = static_cast<double>(
+        s.counter(engine_type::connections_reused));
+    r.counters["dns_hits"] = static_cast<double>(d.hits + d.coalesced);
+    r.counters["dns_misses"] = static_cast<double>(d.misses);
+    r.counters["p50_us"] = static_cast<double>(h.value_at_percentile(50));
+    r.counters["p99_us"] = static_cast<double>(h.value_at_percentile(99));
+    ctx.add(std::move(r));
+}
+
+} // (anon)
+
+BENCH_CASE("e2e/crawl")
+{
+    farm f(hosts);
+
+    for(std::size_t per_host : {1, 4})
+    {
+        crawl::crawl_engine::options opt;
+        opt.max_connections = 32;
+        opt.max_connections_per_host = per_host;
+        opt.max_requests_per_connection = 1000;
+        run_crawl(ctx, f,
+            "e2e/crawl/keep_alive/per_host=" + std::to_string(per_host),
+            opt);
+
+        opt.max_requests_per_connection = 1;
+        run_crawl(ctx, f,
+            "e2e/crawl/close/per_host=" + std::to_string(per_host),
+            opt);
+    }
+}
@@ -0,0 +1,397 @@
+#ifndef BEAST_BENCH_E2E_HPP
+#define BEAST_BENCH_E2E_HPP
+
+// End-to-end measurements of a client and a server exchanging
+// messages over a transport, each thread running its own
+// io_context with several connections on it.
+//
+// A transport provides `pair`, holding the connected `client` and
+// `server` streams, and `make_pairs`, which connects them. A
+// session is constructed on a pair and a probe, may start
+// asynchronous setup (such as a handshake) in its constructor,
+// and begins exchanging messages when `start` is called. The
+// client times each exchange with the probe, and closes the pair
+// once the probe says the measurement has ended.
+
+#include "bench.hpp"
+#include "stream.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+
+#if BENCH_HAS_OPENSSL
+#include <asio/ssl.hpp>
+#include <boost/beast/ssl/ssl_stream.hpp>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+#endif
+
+namespace bench {
+namespace e2e {
+
+namespace net = ::asio;
+namespace beast = ::boost::beast;
+using tcp = net::ip::tcp;
+
+enum class phase
+{
+    warmup,
+    measure,
+    stop
+};
+
+// The latencies and bytes of the exchanges on one thread
+struct recorder
+{
+    std::vector<std::uint64_t> ns;
+    std::uint64_t bytes = 0;
+};
+
+// Passed to sessions to time their exchanges
+class probe
+{
+    recorder& rec_;
+    std::atomic<phase> const& phase_;
+
+public:
+    probe(recorder& rec, std::atomic<phase> const& ph)
+        : rec_(rec)
+        , phase_(ph)
+    {
+    }
+
+    // Returns true when no more exchanges should start
+    bool
+    stopped() const noexcept
+    {
+        return phase_.load(std::memory_order_relaxed) == phase::stop;
+    }
+
+    // Record an exchange which started at t0 and moved n bytes
+    void
+    record(clock_type::time_point t0, std::size_t n)
+    {
+        if(phase_.load(std::memory_order_relaxed) != phase::measure)
+            return;
+        rec_.ns.push_back(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock_type::now() - t0).count()));
+        rec_.bytes += n;
+    }
+};
+
+//------------------------------------------------------------------------------
+
+// beast::test::stream, connected in memory
+struct memory
+{
+    static constexpr char const* name = "memory";
+
+    struct pair
+    {
+        using stream_type = beast::test::stream;
+
+        stream_type client;
+        stream_type server;
+
+        explicit
+        pair(net::io_context& ioc)
+            : client(ioc)
+            , server(ioc)
+        {
+            client.connect(server);
+        }
+
+        void
+        close()
+        {
+            client.close();
+            server.close();
+        }
+    };
+
+    static
+    std::vector<std::unique_ptr<pair>>
+    make_pairs(net::io_context& ioc, std::size_t n)
+    {
+        std::vector<std::unique_ptr<pair>> v;
+        for(std::size_t i = 0; i < n; ++i)
+            v.push_back(std::make_unique<pair>(ioc));
+        return v;
+    }
+};
+
+// beast::tcp_stream, connected over loopback
+struct tcp_loopback
+{
+    static constexpr char const* name = "tcp";
+
+    struct pair
+    {
+        using stream_type = beast::tcp_stream;
+
+        stream_type client;
+        stream_type server;
+
+        void
+        close()
+        {
+            client.close();
+            server.close();
+        }
+    };
+
+    static
+    std::vector<std::unique_ptr<pair>>
+    make_pairs(net::io_context& ioc, std::size_t n)
+    {
+        tcp::acceptor acceptor(ioc,
+            tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+        std::vector<std::unique_ptr<pair>> v;
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            tcp::socket client(ioc);
+            client.connect(acceptor.local_endpoint());
+            client.set_option(tcp::no_delay(true));
+            auto server = acceptor.accept();
+            server.set_option(tcp::no_delay(true));
+            v.push_back(std::make_unique<pair>(pair{
+                pair::stream_type(std::move(client)),
+                pair::stream_type(std::move(server))}));
+        }
+        return v;
+    }
+};
+
+#if BENCH_HAS_OPENSSL
+
+// beast::ssl_stream over tcp_loopback, with a generated certificate
+struct tls_loopback
+{
+    static constexpr char const* name = "tls";
+
+    struct pair
+    {
+        using stream_type = beast::ssl_stream<beast::tcp_stream>;
+
+        stream_type client;
+        stream_type server;
+
+        void
+        close()
+        {
+            beast::get_lowest_layer(client).close();
+            beast::get_lowest_layer(server).close();
+        }
+    };
+
+    static
+    std::vector<std::unique_ptr<pair>>
+    make_pairs(net::io_context& ioc, std::size_t n)
+    {
+        auto tcp_pairs = tcp_loopback::make_pairs(ioc, n);
+        std::vector<std::unique_ptr<pair>> v;
+        for(auto& p : tcp_pairs)
+        {
+            v.push_back(std::make_unique<pair>(pair{
+                pair::stream_type(std::move(p->client), client_context()),
+                pair::stream_type(std::move(p->server), server_context())}));
+            v.back()->client.async_handshake(
+                net::ssl::stream_base::client,
+                [](beast::error_code ec)
+                {
+                    if(ec)
+                        throw beast::system_error{ec};
+                });
+            v.back()->server.async_handshake(
+                net::ssl::stream_base::server,
+                [](beast::error_code ec)
+                {
+                    if(ec)
+                        throw beast::system_error{ec};
+                });
+        }
+        ioc.run();
+        ioc.restart();
+        return v;
+    }
+
+private:
+    static
+    net::ssl::context&
+    client_context()
+    {
+        static net::ssl::context ctx(net::ssl::context::tls_client);
+        return ctx;
+    }
+
+    static
+    net::ssl::context&
+    server_context()
+    {
+        static net::ssl::context ctx = make_server_context();
+        return ctx;
+    }
+
+    // A server context with a self-signed P-256 certificate
+    static
+    net::ssl::context
+    make_server_context()
+    {
+        net::ssl::context ctx(net::ssl::context::tls_server);
+        EVP_PKEY* key = nullptr;
+        auto pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+        EVP_PKEY_keygen_init(pctx);
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(
+            pctx, NID_X9_62_prime256v1);
+        EVP_PKEY_keygen(pctx, &key);
+        EVP_PKEY_CTX_free(pctx);
+
+        X509* x = X509_new();
+        X509_set_version(x, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(x), 1);
+        X509_gmtime_adj(X509_getm_notBefore(x), 0);
+        X509_gmtime_adj(X509_getm_notAfter(x), 86400);
+        X509_set_pubkey(x, key);
+        auto const subject = X509_get_subject_name(x);
+        X509_NAME_add_entry_by_txt(subject, "CN", MBSTRING_ASC,
+            reinterpret_cast<unsigned char const*>("localhost"),
+            -1, -1, 0);
+        X509_set_issuer_name(x, subject);
+        X509_sign(x, key, EVP_sha256());
+
+        bool const ok =
+            SSL_CTX_use_certificate(ctx.native_handle(), x) == 1 &&
+            SSL_CTX_use_PrivateKey(ctx.native_handle(), key) == 1;
+        X509_free(x);
+        EVP_PKEY_free(key);
+        if(! ok)
+            throw std::runtime_error("server certificate");
+        return ctx;
+    }
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+
+// Run `connections` sessions on each of `threads` threads, for
+// a warmup and then min_time seconds, and record one result.
+template<class Transport, class Session, class... Args>
+result&
+run(
+    context& ctx,
+    std::string const& name,
+    std::size_t threads,
+    std::size_t connections,
+    Args const&... args)
+{
+    struct worker
+    {
+        net::io_context ioc{1};
+        std::vector<std::unique_ptr<typename Transport::pair>> pairs;
+        std::vector<std::unique_ptr<Session>> sessions;
+        recorder rec;
+    };
+
+    std::atomic<phase> ph{phase::warmup};
+    std::vector<std::unique_ptr<worker>> workers;
+    for(std::size_t i = 0; i < threads; ++i)
+    {
+        auto w = std::make_unique<worker>();
+        w->pairs = Transport::make_pairs(w->ioc, connections);
+        for(auto& p : w->pairs)
+            w->sessions.push_back(std::make_unique<Session>(
+                *p, probe(w->rec, ph), args...));
+        // complete the setup of every session
+        w->ioc.run();
+        w->ioc.restart();
+        workers.push_back(std::move(w));
+    }
+
+    std::vector<std::thread> v;
+    for(auto& w : workers)
+    {
+        for(auto& s : w->sessions)
+            s->start();
+        v.emplace_back([&ioc = w->ioc]{ ioc.run(); });
+    }
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(ctx.min_time() / 4));
+    ph = phase::measure;
+    auto const t0 = clock_type::now();
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(ctx.min_time()));
+    ph = phase::stop;
+    std::chrono::duration<double> const elapsed =
+        clock_type::now() - t0;
+    for(auto& t : v)
+        t.join();
+
+    std::vector<std::uint64_t> ns;
+    std::uint64_t bytes = 0;
+    for(auto& w : workers)
+    {
+        ns.insert(ns.end(), w->rec.ns.begin(), w->rec.ns.end());
+        bytes += w->rec.bytes;
+    }
+    auto const percentile =
+        [&ns](double p)
+        {
+            if(ns.empty())
+                return 0.0;
+            auto const it = ns.begin() +
+                static_cast<std::ptrdiff_t>(p * (ns.size() - 1));
+            std::nth_element(ns.begin(), it, ns.end());
+            return *it / 1000.0;
+        };
+
+    result r;
+    r.name = name + "/" + Transport::name +
+        "/threads=" + std::to_string(threads);
+    r.iterations = ns.size();
+    r.seconds = elapsed.count();
+    r.bytes = bytes;
+    r.counters["threads"] = static_cast<double>(threads);
+    r.counters["connections"] =
+        static_cast<double>(threads * connections);
+    r.counters["p50_us"] = percentile(0.50);
+    r.counters["p99_us"] = percentile(0.99);
+    return ctx.add(std::move(r));
+}
+
+// Run a session over every transport, for several thread counts
+template<template<class> class Session, class... Args>
+void
+run_all(
+    context& ctx,
+    std::string const& name,
+    std::size_t connections,
+    Args const&... args)
+{
+    for(std::size_t threads : {1, 2, 4})
+    {
+        run<memory, Session<memory::pair>>(
+            ctx, name, threads, connections, args...);
+        run<tcp_loopback, Session<tcp_loopback::pair>>(
+            ctx, name, threads, connections, args...);
+#if BENCH_HAS_OPENSSL
+        run<tls_loopback, Session<tls_loopback::pair>>(
+            ctx, name, threads, connections, args...);
+#endif
+    }
+}
+
+} // e2e
+} // bench
+
+#endif
@@ -0,0 +1,121 @@
+#include "e2e.hpp"
+#include <optional>
+#include <string>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+
+// HTTP/1.1 keep-alive: the client sends a request and reads the
+// response before sending the next. Each exchange is one
+// operation, timed from writing the request to reading the
+// complete response. With a large body most of the time is the
+// transfer of the body.
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace e2e = bench::e2e;
+
+namespace {
+
+template<class Pair>
+class session
+{
+    Pair& p_;
+    e2e::probe probe_;
+
+    // client
+    http::request<http::empty_body> req_;
+    beast::flat_buffer cbuf_;
+    std::optional<http::response_parser<http::string_body>> parser_;
+    bench::clock_type::time_point t0_;
+
+    // server
+    beast::flat_buffer sbuf_;
+    http::request<http::empty_body> sreq_;
+    http::response<http::string_body> res_;
+
+public:
+    session(Pair& p, e2e::probe probe, std::size_t body_size)
+        : p_(p)
+        , probe_(probe)
+        , req_(http::verb::get, "/index.html", 11)
+        , res_(http::status::ok, 11)
+    {
+        req_.set(http::field::host, "localhost");
+        req_.set(http::field::user_agent, "bench");
+        res_.set(http::field::server, "bench");
+        res_.set(http::field::content_type, "text/html");
+        res_.body() = std::string(body_size, 'x');
+        res_.prepare_payload();
+    }
+
+    void
+    start()
+    {
+        serve();
+        request();
+    }
+
+private:
+    void
+    request()
+    {
+        if(probe_.stopped())
+            return p_.close();
+        t0_ = bench::clock_type::now();
+        http::async_write(p_.client, req_,
+            [this](beast::error_code ec, std::size_t)
+            {
+                if(ec)
+                    return;
+                parser_.emplace();
+                parser_->body_limit(std::nullopt);
+                http::async_read(p_.client, cbuf_, *parser_,
+                    [this](beast::error_code ec, std::size_t)
+                    {
+                        if(ec)
+                            return;
+                        probe_.record(t0_,
+                            parser_->get().body().size());
+                        request();
+                    });
+            });
+    }
+
+    void
+    serve()
+    {
+        sreq_ = {};
+        http::async_read(p_.server, sbuf_, sreq_,
+            [this](beast::error_code ec, std::size_t)
+            {
+                if(ec)
+                    return;
+                http::async_write(p_.server, res_,
+                    [this](beast::error_code ec, std::size_t)
+                    {
+                        if(! ec)
+                            serve();
+                    });
+            });
+    }
+};
+
+} // (anon)
+
+BENCH_CASE("e2e/http/keep_alive")
+{
+    e2e::run_all<session>(ctx, "e2e/http/keep_alive",
+        4, std::size_t{256});
+}
+
+BENCH_CASE("e2e/http/large_body")
+{
+    e2e::run_all<session>(ctx, "e2e/http/large_body",
+        1, std::size_t{4 * 1024 * 1024});
+}
@@ -0,0 +1,125 @@
+#include "e2e.hpp"
+#include "corpus.hpp"
+#include <string>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/websocket/stream.hpp>
+
+// Websocket echo: the client sends a text message and reads the
+// server's copy of it before sending the next, with and without
+// permessage-deflate. Each round trip is one operation.
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+namespace e2e = bench::e2e;
+
+namespace {
+
+std::size_t constexpr message_size = 1024;
+
+struct options
+{
+    bool deflate;
+};
+
+template<class Pair>
+class session
+{
+    Pair& p_;
+    e2e::probe probe_;
+    websocket::stream<typename Pair::stream_type&> client_;
+    websocket::stream<typename Pair::stream_type&> server_;
+    std::string const message_;
+    beast::flat_buffer cbuf_;
+    beast::flat_buffer sbuf_;
+    bench::clock_type::time_point t0_;
+
+public:
+    session(Pair& p, e2e::probe probe, options const& opt)
+        : p_(p)
+        , probe_(probe)
+        , client_(p.client)
+        , server_(p.server)
+        , message_(bench::make_json(message_size))
+    {
+        websocket::permessage_deflate pmd;
+        pmd.client_enable = opt.deflate;
+        pmd.server_enable = opt.deflate;
+        client_.set_option(pmd);
+        server_.set_option(pmd);
+        client_.text(true);
+        client_.async_handshake("localhost", "/",
+            [](beast::error_code ec)
+            {
+                if(ec)
+                    throw beast::system_error{ec};
+            });
+        server_.async_accept(
+            [](beast::error_code ec)
+            {
+                if(ec)
+                    throw beast::system_error{ec};
+            });
+    }
+
+    void
+    start()
+    {
+        serve();
+        ping();
+    }
+
+private:
+    void
+    ping()
+    {
+        if(probe_.stopped())
+            return p_.close();
+        t0_ = bench::clock_type::now();
+        client_.async_write(net::buffer(message_),
+            [this](beast::error_code ec, std::size_t)
+            {
+                if(ec)
+                    return;
+                client_.async_read(cbuf_,
+                    [this](beast::error_code ec, std::size_t n)
+                    {
+                        if(ec)
+                            return;
+                        probe_.record(t0_, n);
+                        cbuf_.consume(n);
+                        ping();
+                    });
+            });
+    }
+
+    void
+    serve()
+    {
+        server_.async_read(sbuf_,
+            [this](beast::error_code ec, std::size_t)
+            {
+                if(ec)
+                    return;
+                server_.text(server_.got_text());
+                server_.async_write(sbuf_.data(),
+                    [this](beast::error_code ec, std::size_t n)
+                    {
+                        if(ec)
+                            return;
+                        sbuf_.consume(n);
+                        serve();
+                    });
+            });
+    }
+};
+
+} // (anon)
+
+BENCH_CASE("e2e/websocket/echo")
+{
+    e2e::run_all<session>(ctx, "e2e/websocket/echo",
+        4, options{false});
+    e2e::run_all<session>(ctx, "e2e/websocket/echo_deflate",
+        4, options{true});
+}
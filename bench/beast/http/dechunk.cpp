@@ -0,0 +1,157 @@
+#include "bench.hpp"
+#include <cstdio>
+#include <string>
+#include <asio/buffer.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/span.hpp>
+#include <boost/beast/http/basic_parser.hpp>
+
+// Parsing a chunked body of 1MB held entirely in the input
+// buffer, with chunks of 64B to 64KB: delivered chunk by chunk,
+// against runs of complete chunks taken by on_chunks_impl.
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+namespace {
+
+// Appends the body to a string, optionally
+// taking whole runs of chunks at once.
+template<bool Runs>
+class string_parser
+    : public http::basic_parser<false>
+{
+public:
+    std::string body;
+
+private:
+    void
+    on_request_impl(http::verb, beast::string_view,
+        beast::string_view, int, beast::error_code&) override
+    {
+    }
+
+    void
+    on_response_impl(int, beast::string_view,
+        int, beast::error_code&) override
+    {
+    }
+
+    void
+    on_field_impl(http::field, beast::string_view,
+        beast::string_view, beast::error_code&) override
+    {
+    }
+
+    void
+    on_header_impl(beast::error_code&) override
+    {
+    }
+
+    void
+    on_body_init_impl(std::optional<std::uint64_t> const&,
+        beast::error_code&) override
+    {
+        body.clear();
+    }
+
+    std::size_t
+    on_body_impl(beast::string_view s,
+        beast::error_code&) override
+    {
+        body.append(s.data(), s.size());
+        return s.size();
+    }
+
+    void
+    on_chunk_header_impl(std::uint64_t,
+        beast::string_view, beast::error_code&) override
+    {
+    }
+
+    std::size_t
+    on_chunk_body_impl(std::uint64_t, beast::string_view s,
+        beast::error_code&) override
+    {
+        body.append(s.data(), s.size());
+        return s.size();
+    }
+
+    std::size_t
+    on_chunks_impl(
+        beast::span<net::const_buffer const> chunks,
+        beast::error_code&) override
+    {
+        if(! Runs)
+            return 0;
+        std::size_t n = 0;
+        for(auto const& b : chunks)
+            n += b.size();
+        auto const size = body.size();
+        body.resize(size + n);
+        net::buffer_copy(
+            net::buffer(&body[size], n), chunks);
+        return n;
+    }
+
+    void
+    on_finish_impl(beast::error_code&) override
+    {
+    }
+};
+
+std::string
+make_message(std::size_t chunk, std::size_t total)
+{
+    std::string s =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n";
+    std::string const data(chunk, 'x');
+    char size[32];
+    std::snprintf(size, sizeof(size), "%zx\r\n", chunk);
+    for(std::size_t n = 0; n < total; n += chunk)
+        s += size + data + "\r\n";
+    s += "0\r\n\r\n";
+    return s;
+}
+
+template<bool Runs>
+void
+run(
+    bench::context& ctx,
+    std::string const& name,
+    std::string const& wire,
+    std::size_t total)
+{
+    ctx.measure(name,
+        [&](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+            {
+                string_parser<Runs> p;
+                p.eager(true);
+                p.body_limit(std::nullopt);
+                beast::error_code ec;
+                auto const used = p.put(net::buffer(wire), ec);
+                bench::do_not_optimize(used);
+                bench::do_not_optimize(p.body.data());
+            }
+        },
+        total);
+}
+
+} // (anon)
+
+BENCH_CASE("http/dechunk")
+{
+    std::size_t const total = 1024 * 1024;
+    for(std::size_t chunk : {64, 256, 1024, 4096, 16384, 65536})
+    {
+        auto const wire = make_message(chunk, total);
+        auto const prefix = "http/dechunk/" + std::to_string(chunk);
+        run<false>(ctx, prefix + "/per_chunk", wire, total);
+        run<true>(ctx, prefix + "/runs", wire, total);
+    }
+}
@@ -0,0 +1,130 @@
+#include "bench.hpp"
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <vector>
+#include <asio/buffer.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/core/segment_pool.hpp>
+#include <boost/beast/http/dynamic_body.hpp>
+#include <boost/beast/http/parser.hpp>
+
+// Many connections reading responses into dynamic_body, each
+// receiving one read at a time in turn, so that the elements of
+// their buffers and bodies are allocated and freed interleaved.
+// multi_buffer uses the global heap, and pooled_multi_buffer
+// takes fixed size segments from the calling thread's pool.
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+namespace {
+
+std::size_t constexpr read_size = 16384;
+
+std::string
+make_response(std::size_t body_size)
+{
+    return
+        "HTTP/1.1 200 OK\r\n"
+        "Server: bench\r\n"
+        "Content-Type: application/octet-stream\r\n"
+        "Content-Length: " + std::to_string(body_size) + "\r\n"
+        "\r\n" + std::string(body_size, 'x');
+}
+
+template<class DynamicBuffer>
+struct connection
+{
+    DynamicBuffer buffer;
+    std::optional<http::response_parser<
+        http::basic_dynamic_body<DynamicBuffer>>> parser;
+    std::size_t pos = 0;
+
+    void
+    reset()
+    {
+        parser.emplace();
+        parser->body_limit(std::nullopt);
+    }
+
+    // Receive one read
+    void
+    read(std::string const& wire)
+    {
+        auto const n = (std::min)(read_size, wire.size() - pos);
+        buffer.commit(net::buffer_copy(buffer.prepare(n),
+            net::buffer(wire.data() + pos, n)));
+        pos = (pos + n) % wire.size();
+        while(buffer.size() > 0)
+        {
+            beast::error_code ec;
+            buffer.consume(parser->put(buffer.data(), ec));
+            if(ec == http::error::need_more)
+                break;
+            if(ec)
+                throw beast::system_error{ec};
+            if(parser->is_done())
+            {
+                bench::do_not_optimize(
+                    parser->get().body().size());
+                reset();
+            }
+        }
+    }
+};
+
+template<class DynamicBuffer>
+void
+run(bench::context& ctx, char const* name)
+{
+    for(std::size_t body_size : {4000, 60000, 250000})
+    {
+        auto const wire = make_response(body_size);
+        for(std::size_t count : {1, 1000})
+        {
+            std::vector<connection<DynamicBuffer>> v(count);
+            for(std::size_t j = 0; j < count; ++j)
+            {
+                // start the connections at different places
+                v[j].reset();
+                for(std::size_t k = 0; k < j % 8; ++k)
+                    v[j].read(wire);
+            }
+            auto const s0 = beast::segment_pool::stats();
+            std::size_t i = 0;
+            auto& r = ctx.measure(
+                std::string("dynamic_body/read/") + name +
+                    "/body=" + std::to_string(body_size) +
+                    "/connections=" + std::to_string(count),
+                [&](std::uint64_t n)
+                {
+                    for(std::uint64_t j = 0; j < n; ++j)
+                    {
+                        v[i].read(wire);
+                        i = (i + 1) % v.size();
+                    }
+                },
+                read_size);
+            auto const s = beast::segment_pool::stats();
+            if(s.allocations > s0.allocations)
+                r.counters["heap_allocations_pct"] = 100.0 *
+                    (s.heap_allocations - s0.heap_allocations) /
+                    (s.allocations - s0.allocations);
+        }
+    }
+}
+
+} // (anon)
+
+BENCH_CASE("dynamic_body/multi_buffer")
+{
+    run<beast::multi_buffer>(ctx, "multi_buffer");
+}
+
+BENCH_CASE("dynamic_body/pooled_multi_buffer")
+{
+    run<beast::pooled_multi_buffer>(ctx, "pooled_multi_buffer");
+}
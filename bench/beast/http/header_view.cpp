@@ -0,0 +1,86 @@
+#include "bench.hpp"
+#include <string>
+#include <asio/buffer.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/header_view_parser.hpp>
+#include <boost/beast/http/parser.hpp>
+
+// What a proxy does with each response header: parse it and look
+// at a few fields. The full parser builds basic_fields, the view
+// parser records where the fields are.
+
+namespace net = asio;
+namespace http = boost::beast::http;
+
+namespace {
+
+std::string
+make_response(std::size_t fields)
+{
+    std::string s =
+        "HTTP/1.1 200 OK\r\n"
+        "Server: nginx/1.18.0\r\n"
+        "Date: Mon, 19 Oct 2026 10:00:00 GMT\r\n"
+        "Content-Type: text/html; charset=utf-8\r\n"
+        "Content-Length: 0\r\n"
+        "Connection: keep-alive\r\n"
+        "Cache-Control: private, max-age=0\r\n";
+    for(std::size_t i = 7; i < fields; ++i)
+        s += "X-Header-" + std::to_string(i) + ": value-" +
+            std::to_string(i * 7919) + "\r\n";
+    s += "\r\n";
+    return s;
+}
+
+template<class F>
+void
+run(
+    bench::context& ctx,
+    std::string const& name,
+    std::string const& wire,
+    F const& parse)
+{
+    ctx.measure(name,
+        [&](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+                bench::do_not_optimize(parse(wire));
+        },
+        wire.size());
+}
+
+} // (anon)
+
+BENCH_CASE("http/header_view")
+{
+    for(std::size_t fields : {8, 20, 40})
+    {
+        auto const wire = make_response(fields);
+        auto const prefix =
+            "http/header_view/" + std::to_string(fields) + "_fields";
+
+        run(ctx, prefix + "/response_parser", wire,
+            [](std::string const& s)
+            {
+                http::response_parser<http::empty_body> p;
+                boost::beast::error_code ec;
+                p.put(net::buffer(s), ec);
+                auto const& h = p.get();
+                return h[http::field::content_type].size() +
+                    h[http::field::cache_control].size() +
+                    h.result_int();
+            });
+
+        run(ctx, prefix + "/header_view_parser", wire,
+            [](std::string const& s)
+            {
+                http::response_header_view_parser p;
+                boost::beast::error_code ec;
+                p.put(net::buffer(s), ec);
+                return p.find(http::field::content_type)->size() +
+                    p.find(http::field::cache_control)->size() +
+                    p.result_int();
+            });
+    }
+}
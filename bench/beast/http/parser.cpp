@@ -0,0 +1,224 @@
+#include "bench.hpp"
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <asio/buffer.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/http/basic_parser.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/string_body.hpp>
+
+// Parsing corpora of complete requests and responses, each message
+// with a new parser: a basic_parser which ignores every callback,
+// measuring the parser alone, and http::parser storing the message
+// in a string_body.
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+namespace {
+
+template<bool isRequest>
+class null_parser : public http::basic_parser<isRequest>
+{
+    void
+    on_request_impl(http::verb, beast::string_view,
+        beast::string_view, int, beast::error_code&) override
+    {
+    }
+
+    void
+    on_response_impl(int, beast::string_view,
+        int, beast::error_code&) override
+    {
+    }
+
+    void
+    on_field_impl(http::field, beast::string_view,
+        beast::string_view, beast::error_code&) override
+    {
+    }
+
+    void
+    on_header_impl(beast::error_code&) override
+    {
+    }
+
+    void
+    on_body_init_impl(std::optional<std::uint64_t> const&,
+        beast::error_code&) override
+    {
+    }
+
+    std::size_t
+    on_body_impl(beast::string_view body,
+        beast::error_code&) override
+    {
+        return body.size();
+    }
+
+    void
+    on_chunk_header_impl(std::uint64_t,
+        beast::string_view, beast::error_code&) override
+    {
+    }
+
+    std::size_t
+    on_chunk_body_impl(std::uint64_t, beast::string_view body,
+        beast::error_code&) override
+    {
+        return body.size();
+    }
+
+    void
+    on_finish_impl(beast::error_code&) override
+    {
+    }
+};
+
+std::string
+chunked(std::string const& body, std::size_t chunk_size)
+{
+    static char const digits[] = "0123456789abcdef";
+    std::string s;
+    for(std::size_t i = 0; i < body.size(); i += chunk_size)
+    {
+        auto const n = (std::min)(chunk_size, body.size() - i);
+        std::string size;
+        for(auto v = n; v > 0; v /= 16)
+            size.insert(size.begin(), digits[v % 16]);
+        s += size + "\r\n" + body.substr(i, n) + "\r\n";
+    }
+    return s + "0\r\n\r\n";
+}
+
+std::vector<std::string>
+request_corpus()
+{
+    std::string const body(2000, 'x');
+    return {
+        "GET / HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "\r\n",
+
+        "GET /search?q=beast&lang=en HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:109.0) "
+            "Gecko/20100101 Firefox/118.0\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;"
+            "q=0.9,image/avif,image/webp,*/*;q=0.8\r\n"
+        "Accept-Language: en-US,en;q=0.5\r\n"
+        "Accept-Encoding: gzip, deflate, br\r\n"
+        "Referer: https://www.example.com/\r\n"
+        "Connection: keep-alive\r\n"
+        "Cookie: session=0123456789abcdef0123456789abcdef; "
+            "theme=dark; tz=UTC\r\n"
+        "Upgrade-Insecure-Requests: 1\r\n"
+        "Sec-Fetch-Dest: document\r\n"
+        "Sec-Fetch-Mode: navigate\r\n"
+        "Sec-Fetch-Site: same-origin\r\n"
+        "\r\n",
+
+        "POST /api/v1/items HTTP/1.1\r\n"
+        "Host: api.example.com\r\n"
+        "Content-Type: application/json\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "\r\n" + body,
+
+        "POST /upload HTTP/1.1\r\n"
+        "Host: api.example.com\r\n"
+        "Content-Type: application/octet-stream\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n" + chunked(body, 500)};
+}
+
+std::vector<std::string>
+response_corpus()
+{
+    std::string const body(4000, 'x');
+    return {
+        "HTTP/1.1 304 Not Modified\r\n"
+        "Date: Mon, 19 Oct 2026 12:00:00 GMT\r\n"
+        "ETag: \"0123456789\"\r\n"
+        "\r\n",
+
+        "HTTP/1.1 200 OK\r\n"
+        "Date: Mon, 19 Oct 2026 12:00:00 GMT\r\n"
+        "Server: bench\r\n"
+        "Content-Type: text/html; charset=utf-8\r\n"
+        "Cache-Control: private, max-age=0\r\n"
+        "Set-Cookie: session=0123456789abcdef; Path=/; HttpOnly\r\n"
+        "Vary: Accept-Encoding\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "\r\n" + body,
+
+        "HTTP/1.1 200 OK\r\n"
+        "Server: bench\r\n"
+        "Content-Type: application/json\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n" + chunked(body, 1000)};
+}
+
+template<class Parser>
+void
+parse(Parser& p, std::string const& s)
+{
+    p.eager(true);
+    beast::error_code ec;
+    p.put(net::buffer(s), ec);
+    if(ec)
+        throw beast::system_error{ec};
+    if(! p.is_done())
+        throw std::logic_error("incomplete message");
+}
+
+template<bool isRequest>
+void
+run(bench::context& ctx, std::string const& name,
+    std::vector<std::string> const& corpus)
+{
+    std::size_t bytes = 0;
+    for(auto const& s : corpus)
+        bytes += s.size();
+
+    ctx.measure(name + "/basic_parser",
+        [&](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+                for(auto const& s : corpus)
+                {
+                    null_parser<isRequest> p;
+                    parse(p, s);
+                }
+        },
+        bytes).counters["messages"] =
+            static_cast<double>(corpus.size());
+
+    ctx.measure(name + "/string_body",
+        [&](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+                for(auto const& s : corpus)
+                {
+                    http::parser<isRequest, http::string_body> p;
+                    parse(p, s);
+                    bench::do_not_optimize(p.get().body().size());
+                }
+        },
+        bytes);
+}
+
+} // (anon)
+
+BENCH_CASE("http/parser/request")
+{
+    run<true>(ctx, "http/parser/request", request_corpus());
+}
+
+BENCH_CASE("http/parser/response")
+{
+    run<false>(ctx, "http/parser/response", response_corpus());
+}
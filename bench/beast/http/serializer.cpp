@@ -0,0 +1,97 @@
+#include "bench.hpp"
+#include <string>
+#include <asio/buffer.hpp>
+#include <boost/beast/core/buffers_flatten.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/http/serializer.hpp>
+#include <boost/beast/http/string_body.hpp>
+
+// Serializing complete messages with http::serializer, handing
+// each buffer sequence to a sink which consumes all of it, as
+// a stream which never blocks would.
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+namespace {
+
+template<bool isRequest>
+std::size_t
+serialize(http::message<isRequest, http::string_body>& m)
+{
+    http::serializer<isRequest, http::string_body> sr(m);
+    std::size_t total = 0;
+    beast::error_code ec;
+    while(! sr.is_done())
+    {
+        sr.next(ec,
+            [&](beast::error_code&, auto const& buffers)
+            {
+                auto const a = beast::buffers_flatten<64>(buffers);
+                auto const n = beast::buffer_bytes(a);
+                bench::do_not_optimize(a);
+                total += n;
+                sr.consume(n);
+            });
+        if(ec)
+            throw beast::system_error{ec};
+    }
+    return total;
+}
+
+template<bool isRequest>
+void
+run(bench::context& ctx, std::string const& name,
+    http::message<isRequest, http::string_body>& m)
+{
+    auto const bytes = serialize(m);
+    ctx.measure(name,
+        [&](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+                bench::do_not_optimize(serialize(m));
+        },
+        bytes);
+}
+
+} // (anon)
+
+BENCH_CASE("http/serializer/request")
+{
+    http::request<http::string_body> req{
+        http::verb::get, "/search?q=beast&lang=en", 11};
+    req.set(http::field::host, "www.example.com");
+    req.set(http::field::user_agent, "bench");
+    req.set(http::field::accept, "text/html,application/xml;q=0.9");
+    req.set(http::field::accept_encoding, "gzip, deflate");
+    req.set(http::field::connection, "keep-alive");
+    run(ctx, "http/serializer/request/get", req);
+
+    req.method(http::verb::post);
+    req.set(http::field::content_type, "application/json");
+    req.body() = std::string(2000, 'x');
+    req.prepare_payload();
+    run(ctx, "http/serializer/request/post", req);
+}
+
+BENCH_CASE("http/serializer/response")
+{
+    for(std::size_t size : {0, 1000, 65536})
+    {
+        http::response<http::string_body> res{http::status::ok, 11};
+        res.set(http::field::server, "bench");
+        res.set(http::field::content_type, "text/html; charset=utf-8");
+        res.set(http::field::cache_control, "private, max-age=0");
+        res.body() = std::string(size, 'x');
+        res.prepare_payload();
+        run(ctx, "http/serializer/response/sized/body=" +
+            std::to_string(size), res);
+
+        if(size == 0)
+            continue;
+        res.chunked(true);
+        run(ctx, "http/serializer/response/chunked/body=" +
+            std::to_string(size), res);
+    }
+}
@@ -0,0 +1,157 @@
+#include "bench.hpp"
+#include <string>
+#include <asio/buffer.hpp>
+#include <asio/write.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/request_template.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+
+// http::write of the same request over and over, as a client which
+// resends nearly identical headers does, with and without the
+// contiguous header cache of basic_fields, and the same request
+// sent from a request_template with its target and body patched.
+
+namespace net = asio;
+namespace http = boost::beast::http;
+
+namespace {
+
+// A SyncWriteStream which discards everything, counting the buffers
+// it was given, so that the cost measured is that of serialization.
+struct null_stream
+{
+    std::uint64_t calls = 0;
+    std::uint64_t buffers = 0;
+
+    template<class ConstBufferSequence>
+    std::size_t
+    write_some(ConstBufferSequence const& bs)
+    {
+        boost::beast::error_code ec;
+        return write_some(bs, ec);
+    }
+
+    template<class ConstBufferSequence>
+    std::size_t
+    write_some(
+        ConstBufferSequence const& bs,
+        boost::beast::error_code& ec)
+    {
+        ec = {};
+        ++calls;
+        std::size_t n = 0;
+        for(auto it = net::buffer_sequence_begin(bs),
+            end = net::buffer_sequence_end(bs); it != end; ++it)
+        {
+            net::const_buffer const b = *it;
+            bench::do_not_optimize(b.data());
+            n += b.size();
+            ++buffers;
+        }
+        return n;
+    }
+};
+
+template<class Body>
+void
+add_fields(http::request<Body>& req, std::size_t n)
+{
+    req.set(http::field::host, "www.example.com");
+    req.set(http::field::user_agent, "Beast");
+    req.set(http::field::accept, "text/html,application/xhtml+xml");
+    req.set(http::field::accept_language, "en-US,en;q=0.5");
+    req.set(http::field::accept_encoding, "gzip, deflate, br");
+    for(std::size_t i = 5; i < n; ++i)
+        req.insert("X-Field-" + std::to_string(i),
+            "value-" + std::to_string(i * 7919));
+}
+
+template<class Body>
+void
+run(
+    bench::context& ctx,
+    std::string const& name,
+    http::request<Body>& req)
+{
+    null_stream s;
+    std::uint64_t bytes = 0;
+    {
+        null_stream probe;
+        bytes = http::write(probe, req);
+    }
+    auto& r = ctx.measure(name,
+        [&](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+                bench::do_not_optimize(http::write(s, req));
+        },
+        bytes);
+    r.counters["buffers_per_write"] = s.calls ?
+        double(s.buffers) / s.calls : 0;
+}
+
+void
+run_template(
+    bench::context& ctx,
+    std::string const& name,
+    http::request<http::empty_body> const& prototype,
+    std::string const& body)
+{
+    null_stream s;
+    http::request_template t(prototype);
+    std::string const targets[] = {"/submit", "/submit/2"};
+    t.body(net::buffer(body));
+    auto& r = ctx.measure(name,
+        [&](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+            {
+                t.target(targets[i & 1]);
+                t.body(net::buffer(body));
+                bench::do_not_optimize(net::write(s, t.buffers()));
+            }
+        },
+        t.size());
+    r.counters["buffers_per_write"] = s.calls ?
+        double(s.buffers) / s.calls : 0;
+}
+
+} // (anon)
+
+BENCH_CASE("http/write/repeated_request")
+{
+    for(std::size_t fields : {5, 25})
+    {
+        auto const suffix = "/" + std::to_string(fields) + "_fields";
+
+        http::request<http::empty_body> get{
+            http::verb::get, "/index.html", 11};
+        add_fields(get, fields);
+        run(ctx, "http/write/repeated_request/get" +
+            suffix + "/per_field", get);
+        get.cache_serialized(true);
+        run(ctx, "http/write/repeated_request/get" +
+            suffix + "/cached", get);
+
+        http::request<http::string_body> post{
+            http::verb::post, "/submit", 11};
+        add_fields(post, fields);
+        post.body() = std::string(256, 'x');
+        post.prepare_payload();
+        run(ctx, "http/write/repeated_request/post" +
+            suffix + "/per_field", post);
+        post.cache_serialized(true);
+        run(ctx, "http/write/repeated_request/post" +
+            suffix + "/cached", post);
+
+        http::request<http::empty_body> prototype{
+            http::verb::post, "/submit", 11};
+        add_fields(prototype, fields);
+        prototype.content_length(0);
+        run_template(ctx, "http/write/repeated_request/post" +
+            suffix + "/template", prototype, post.body());
+    }
+}
@@ -0,0 +1,167 @@
+#ifndef BEAST_BENCH_HPP
+#define BEAST_BENCH_HPP
+
+// A minimal benchmark harness.
+//
+// Cases are registered with BENCH_CASE and run by main.cpp, which
+// prints a table on stderr and, optionally, JSON which is stable
+// between runs (same names, same fields, same order).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+using clock_type = std::chrono::steady_clock;
+
+// One row of output
+struct result
+{
+    std::string name;
+    std::uint64_t iterations = 0;
+    double seconds = 0;
+
+    // optional, zero means not applicable
+    std::uint64_t bytes = 0;
+
+    // extra named values, such as latency percentiles
+    std::map<std::string, double> counters;
+
+    double
+    ns_per_op() const
+    {
+        return iterations ? seconds * 1e9 / iterations : 0;
+    }
+
+    double
+    ops_per_second() const
+    {
+        return seconds > 0 ? iterations / seconds : 0;
+    }
+
+    double
+    bytes_per_second() const
+    {
+        return seconds > 0 ? bytes / seconds : 0;
+    }
+};
+
+// Passed to every case to collect its results
+class context
+{
+    std::vector<result> results_;
+    double min_time_;
+
+public:
+    explicit
+    context(double min_time)
+        : min_time_(min_time)
+    {
+    }
+
+    std::vector<result> const&
+    results() const
+    {
+        return results_;
+    }
+
+    double
+    min_time() const
+    {
+        return min_time_;
+    }
+
+    // Record a result measured by the case itself
+    result&
+    add(result r)
+    {
+        results_.push_back(std::move(r));
+        return results_.back();
+    }
+
+    // Call f(n) with a growing n until it runs for at least
+    // min_time seconds, then record the time for the last n.
+    // `bytes` is the number of bytes processed per iteration.
+    template<class F>
+    result&
+    measure(
+        std::string name,
+        F&& f,
+        std::uint64_t bytes = 0)
+    {
+        std::uint64_t n = 1;
+        for(;;)
+        {
+            auto const t0 = clock_type::now();
+            f(n);
+            std::chrono::duration<double> const elapsed =
+                clock_type::now() - t0;
+            if(elapsed.count() >= min_time_ || n >= (1ull << 40))
+            {
+                result r;
+                r.name = std::move(name);
+                r.iterations = n;
+                r.seconds = elapsed.count();
+                r.bytes = bytes * n;
+                return add(std::move(r));
+            }
+            // aim a little past the target
+            auto const scale = elapsed.count() > 0 ?
+                1.5 * min_time_ / elapsed.count() : 100.0;
+            n = static_cast<std::uint64_t>(n *
+                std::clamp(scale, 2.0, 100.0));
+        }
+    }
+};
+
+// Prevent the optimizer from discarding a value
+template<class T>
+inline
+void
+do_not_optimize(T const& t)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(t) : "memory");
+#else
+    static T const volatile* volatile sink;
+    sink = &t;
+#endif
+}
+
+struct registry
+{
+    using function = std::function<void(context&)>;
+
+    static
+    std::vector<std::pair<std::string, function>>&
+    cases()
+    {
+        static std::vector<std::pair<std::string, function>> v;
+        return v;
+    }
+
+    registry(char const* name, function f)
+    {
+        cases().emplace_back(name, std::move(f));
+    }
+};
+
+} // bench
+
+#define BENCH_CAT2(a, b) a##b
+#define BENCH_CAT(a, b) BENCH_CAT2(a, b)
+
+#define BENCH_CASE(name) \
+    static void BENCH_CAT(bench_case_, __LINE__)(::bench::context&); \
+    static ::bench::registry BENCH_CAT(bench_reg_, __LINE__)( \
+        name, &BENCH_CAT(bench_case_, __LINE__)); \
+    static void BENCH_CAT(bench_case_, __LINE__)( \
+        [[maybe_unused]] ::bench::context& ctx)
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef BEAST_BENCH_CORPUS_HPP
+#define BEAST_BENCH_CORPUS_HPP
+
+// Generated inputs shared by several cases
+
+#include <random>
+#include <string>
+
+namespace bench {
+
+// JSON records with repeated keys and varying values, which
+// compress about as well as typical websocket messages
+inline
+std::string
+make_json(std::size_t n)
+{
+    static char const* const names[] = {
+        "alpha", "bravo", "charlie", "delta", "echo", "foxtrot"};
+    std::mt19937 g(1);
+    std::string s = "[";
+    while(s.size() < n)
+    {
+        s += "{\"id\":" + std::to_string(g() % 100000) +
+            ",\"name\":\"" + names[g() % 6] +
+            "\",\"price\":" + std::to_string(g() % 10000) +
+            ".5,\"tags\":[\"" + names[g() % 6] + "\",\"" +
+            names[g() % 6] + "\"],\"active\":" +
+            ((g() % 2) ? "true" : "false") + "},";
+    }
+    s.resize(n);
+    return s;
+}
+
+// Bytes which do not compress
+inline
+std::string
+make_random(std::size_t n)
+{
+    std::mt19937 g(1);
+    std::string s(n, 0);
+    for(auto& c : s)
+        c = static_cast<char>(g());
+    return s;
+}
+
+} // bench
+
+#endif
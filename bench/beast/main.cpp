@@ -0,0 +1,169 @@
+#include "bench.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifndef BENCH_BUILD_TYPE
+#define BENCH_BUILD_TYPE ""
+#endif
+
+// Incremented when the layout of the JSON output changes
+#define BENCH_SCHEMA_VERSION 1
+
+namespace {
+
+void
+usage()
+{
+    std::cerr <<
+        "Usage: bench [options] [filter...]\n"
+        "Options:\n"
+        "    --list          List the benchmark cases and exit\n"
+        "    --json <file>   Also write the results as JSON, - for stdout\n"
+        "    --min-time <s>  Minimum time for each measurement (default 0.2)\n"
+        "A case runs if its name contains any of the filters.\n";
+}
+
+std::string
+escape(std::string const& s)
+{
+    std::string out;
+    for(char c : s)
+    {
+        if(c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+void
+write_json(
+    std::ostream& os,
+    std::vector<bench::result> const& results)
+{
+    os << std::setprecision(9);
+    os << "{\n"
+          "  \"schema_version\": " << BENCH_SCHEMA_VERSION << ",\n"
+          "  \"build_type\": \"" << BENCH_BUILD_TYPE << "\",\n"
+          "  \"benchmarks\": [";
+    bool first = true;
+    for(auto const& r : results)
+    {
+        os << (first ? "\n" : ",\n");
+        first = false;
+        os << "    {\"name\": \"" << escape(r.name) << "\""
+           << ", \"iterations\": " << r.iterations
+           << ", \"seconds\": " << r.seconds
+           << ", \"ns_per_op\": " << r.ns_per_op()
+           << ", \"ops_per_second\": " << r.ops_per_second()
+           << ", \"bytes_per_second\": " << r.bytes_per_second()
+           << ", \"counters\": {";
+        bool first_counter = true;
+        for(auto const& c : r.counters)
+        {
+            os << (first_counter ? "" : ", ")
+               << "\"" << escape(c.first) << "\": " << c.second;
+            first_counter = false;
+        }
+        os << "}}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+void
+write_row(std::ostream& os, bench::result const& r)
+{
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1)
+       << std::left << std::setw(56) << r.name
+       << std::right << std::setw(14) << r.ns_per_op() << " ns/op"
+       << std::setw(14) << r.ops_per_second() << " op/s";
+    if(r.bytes)
+        ss << std::setw(10) << std::setprecision(1)
+           << r.bytes_per_second() / (1024 * 1024) << " MiB/s";
+    for(auto const& c : r.counters)
+        ss << "  " << c.first << "=" << c.second;
+    os << ss.str() << std::endl;
+}
+
+} // (anon)
+
+int
+main(int argc, char* argv[])
+{
+    std::vector<std::string> filters;
+    std::string json;
+    double min_time = 0.2;
+    bool list = false;
+    for(int i = 1; i < argc; ++i)
+    {
+        if(! std::strcmp(argv[i], "--list"))
+            list = true;
+        else if(! std::strcmp(argv[i], "--json") && i + 1 < argc)
+            json = argv[++i];
+        else if(! std::strcmp(argv[i], "--min-time") && i + 1 < argc)
+            min_time = std::atof(argv[++i]);
+        else if(argv[i][0] == '-')
+        {
+            usage();
+            return EXIT_FAILURE;
+        }
+        else
+            filters.emplace_back(argv[i]);
+    }
+
+    auto const selected =
+        [&](std::string const& name)
+        {
+            if(filters.empty())
+                return true;
+            for(auto const& f : filters)
+                if(name.find(f) != std::string::npos)
+                    return true;
+            return false;
+        };
+
+    // Run in name order, so the output does not depend
+    // on the order in which the cases were linked
+    auto cases = bench::registry::cases();
+    std::sort(cases.begin(), cases.end(),
+        [](auto const& a, auto const& b)
+        {
+            return a.first < b.first;
+        });
+
+    bench::context ctx(min_time);
+    for(auto const& c : cases)
+    {
+        if(! selected(c.first))
+            continue;
+        if(list)
+        {
+            std::cout << c.first << "\n";
+            continue;
+        }
+        auto const first = ctx.results().size();
+        c.second(ctx);
+        for(auto i = first; i < ctx.results().size(); ++i)
+            write_row(std::cerr, ctx.results()[i]);
+    }
+
+    if(json == "-")
+        write_json(std::cout, ctx.results());
+    else if(! json.empty())
+    {
+        std::ofstream os(json);
+        write_json(os, ctx.results());
+        if(! os)
+        {
+            std::cerr << "bench: failed to write " << json << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
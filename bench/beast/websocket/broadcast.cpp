@@ -0,0 +1,183 @@
+#include "bench.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+#include <asio/buffer.hpp>
+#include <asio/io_context.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/websocket/prepared_message.hpp>
+#include <boost/beast/websocket/stream.hpp>
+
+// Sending one message to many server streams: a write of the
+// payload on every stream, which frames (and compresses) it each
+// time, against a prepared_message framed once and shared.
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+
+namespace {
+
+// A SyncStream which reads an upgrade request once and discards
+// everything written to it, so that the cost measured is that of
+// the websocket stream.
+class null_stream
+{
+    net::io_context::executor_type ex_;
+    std::string in_;
+    std::size_t pos_ = 0;
+
+public:
+    using executor_type = net::io_context::executor_type;
+
+    null_stream(net::io_context& ioc, bool deflate)
+        : ex_(ioc.get_executor())
+        , in_(
+            "GET / HTTP/1.1\r\n"
+            "Host: localhost\r\n"
+            "Upgrade: websocket\r\n"
+            "Connection: upgrade\r\n"
+            "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+            "Sec-WebSocket-Version: 13\r\n")
+    {
+        if(deflate)
+            in_ += "Sec-WebSocket-Extensions: permessage-deflate; "
+                "server_no_context_takeover\r\n";
+        in_ += "\r\n";
+    }
+
+    executor_type
+    get_executor() const noexcept
+    {
+        return ex_;
+    }
+
+    template<class MutableBufferSequence>
+    std::size_t
+    read_some(MutableBufferSequence const& bs)
+    {
+        beast::error_code ec;
+        auto const n = read_some(bs, ec);
+        if(ec)
+            throw beast::system_error{ec};
+        return n;
+    }
+
+    template<class MutableBufferSequence>
+    std::size_t
+    read_some(
+        MutableBufferSequence const& bs,
+        beast::error_code& ec)
+    {
+        ec = {};
+        if(pos_ == in_.size())
+        {
+            ec = net::error::eof;
+            return 0;
+        }
+        auto const n = net::buffer_copy(bs,
+            net::buffer(in_.data() + pos_, in_.size() - pos_));
+        pos_ += n;
+        return n;
+    }
+
+    template<class ConstBufferSequence>
+    std::size_t
+    write_some(ConstBufferSequence const& bs)
+    {
+        beast::error_code ec;
+        return write_some(bs, ec);
+    }
+
+    template<class ConstBufferSequence>
+    std::size_t
+    write_some(
+        ConstBufferSequence const& bs,
+        beast::error_code& ec)
+    {
+        ec = {};
+        std::size_t n = 0;
+        for(auto it = net::buffer_sequence_begin(bs),
+            end = net::buffer_sequence_end(bs); it != end; ++it)
+        {
+            net::const_buffer const b = *it;
+            bench::do_not_optimize(b.data());
+            n += b.size();
+        }
+        return n;
+    }
+};
+
+using ws_type = websocket::stream<null_stream>;
+
+std::string
+make_payload(std::size_t n)
+{
+    std::string s;
+    while(s.size() < n)
+        s += "{\"id\":" + std::to_string(s.size()) +
+            ",\"price\":101.25,\"qty\":300},";
+    s.resize(n);
+    return s;
+}
+
+void
+run(
+    bench::context& ctx,
+    std::string const& name,
+    std::size_t streams,
+    std::size_t size,
+    bool deflate)
+{
+    net::io_context ioc;
+    websocket::permessage_deflate pmd;
+    pmd.server_enable = deflate;
+    std::vector<std::unique_ptr<ws_type>> v;
+    for(std::size_t i = 0; i < streams; ++i)
+    {
+        v.emplace_back(new ws_type(ioc, deflate));
+        v.back()->set_option(pmd);
+        v.back()->accept();
+        v.back()->text(true);
+    }
+    auto const payload = make_payload(size);
+
+    ctx.measure(name + "/per_stream",
+        [&](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+                for(auto& ws : v)
+                    bench::do_not_optimize(
+                        ws->write(net::buffer(payload)));
+        },
+        size * streams);
+
+    ctx.measure(name + "/prepared",
+        [&](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+            {
+                // the message is built once per broadcast
+                auto const m = deflate ?
+                    websocket::prepared_message(
+                        true, net::buffer(payload), pmd) :
+                    websocket::prepared_message(
+                        true, net::buffer(payload));
+                for(auto& ws : v)
+                    bench::do_not_optimize(ws->write(m));
+            }
+        },
+        size * streams);
+}
+
+} // (anon)
+
+BENCH_CASE("websocket/broadcast")
+{
+    for(std::size_t size : {128, 4096, 65536})
+    {
+        auto const suffix = "/64_streams/" + std::to_string(size);
+        run(ctx, "websocket/broadcast/plain" + suffix, 64, size, false);
+        run(ctx, "websocket/broadcast/deflate" + suffix, 64, size, true);
+    }
+}
@@ -0,0 +1,37 @@
+#include "bench.hpp"
+#include <string>
+#include <asio/buffer.hpp>
+#include <boost/beast/websocket/detail/mask.hpp>
+
+// Applying the websocket mask in place, to frames of typical
+// sizes and at an offset which leaves the data unaligned.
+
+namespace net = asio;
+namespace detail = boost::beast::websocket::detail;
+
+BENCH_CASE("websocket/mask_inplace")
+{
+    detail::prepared_key key0;
+    detail::prepare_key(key0, 0x12345678);
+    for(std::size_t size : {16, 1024, 65536})
+    {
+        for(std::size_t offset : {0, 1})
+        {
+            std::string s(size + offset, 'x');
+            auto const b = net::buffer(&s[offset], size);
+            ctx.measure("websocket/mask_inplace/" +
+                    std::to_string(size) +
+                    (offset ? "/unaligned" : "/aligned"),
+                [&](std::uint64_t n)
+                {
+                    for(std::uint64_t i = 0; i < n; ++i)
+                    {
+                        auto key = key0;
+                        detail::mask_inplace(b, key);
+                        bench::do_not_optimize(s[offset]);
+                    }
+                },
+                size);
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#include "bench.hpp"
+#include <random>
+#include <string>
+#include <asio/buffer.hpp>
+#include <boost/beast/websocket/detail/mask.hpp>
+#include <boost/beast/websocket/detail/payload.hpp>
+#include <boost/beast/websocket/detail/utf8_checker.hpp>
+
+// Moving a received text frame into the caller's buffer: the
+// separate unmask, copy and UTF-8 passes which the read path
+// used to make, against the single pass of copy_payload.
+
+namespace net = asio;
+namespace detail = boost::beast::websocket::detail;
+
+namespace {
+
+std::string
+make_text(std::size_t n, bool ascii)
+{
+    std::mt19937 g(1);
+    std::string s;
+    while(s.size() < n)
+    {
+        if(! ascii && g() % 16 == 0)
+            s += "\xe2\x82\xac";
+        else
+            s += static_cast<char>('a' + g() % 26);
+    }
+    s.resize(n);
+    if(! ascii)
+        while(static_cast<unsigned char>(s.back()) >= 0x80)
+            s.back() = 'a';
+    return s;
+}
+
+void
+run(
+    bench::context& ctx,
+    std::string const& name,
+    std::string const& text,
+    bool masked)
+{
+    detail::prepared_key key0;
+    detail::prepare_key(key0, 0x12345678);
+    std::string in = text;
+    if(masked)
+    {
+        auto key = key0;
+        detail::mask_inplace(net::buffer(&in[0], in.size()), key);
+    }
+    std::string out(in.size(), 0);
+
+    ctx.measure(name + "/separate",
+        [&](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+            {
+                auto src = in;
+                auto key = key0;
+                if(masked)
+                    detail::mask_inplace(
+                        net::buffer(&src[0], src.size()), key);
+                net::buffer_copy(net::buffer(&out[0], out.size()),
+                    net::buffer(src));
+                detail::utf8_checker utf8;
+                bench::do_not_optimize(
+                    utf8.write(net::buffer(out)) && utf8.finish());
+            }
+        },
+        in.size());
+
+    ctx.measure(name + "/fused",
+        [&](std::uint64_t n)
+        {
+            for(std::uint64_t i = 0; i < n; ++i)
+            {
+                // the same copy of the input as above
+                auto src = in;
+                auto key = key0;
+                detail::utf8_checker utf8;
+                bench::do_not_optimize(
+                    detail::copy_payload(
+                        net::buffer(&out[0], out.size()),
+                        net::buffer(src), src.size(),
+                        masked ? &key : nullptr, &utf8) &&
+                    utf8.finish());
+            }
+        },
+        in.size());
+}
+
+} // (anon)
+
+BENCH_CASE("websocket/read/text_payload")
+{
+    for(std::size_t size : {4096, 1024 * 1024})
+    {
+        for(bool ascii : {true, false})
+        {
+            auto const text = make_text(size, ascii);
+            auto const prefix = "websocket/read/text_payload/" +
+                std::to_string(size) + (ascii ? "/ascii" : "/utf8");
+            run(ctx, prefix + "/masked", text, true);
+            run(ctx, prefix + "/unmasked", text, false);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#include "bench.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <asio/buffer.hpp>
+#include <boost/beast/websocket/detail/utf8_checker.hpp>
+
+// Validating the UTF-8 of text frames: ASCII, which takes the fast
+// path, and text with multi-byte code points; whole and in pieces
+// which split code points between calls.
+
+namespace net = asio;
+namespace detail = boost::beast::websocket::detail;
+
+namespace {
+
+std::string
+make_text(std::size_t n, bool ascii)
+{
+    std::mt19937 g(1);
+    std::string s;
+    while(s.size() < n)
+    {
+        if(! ascii && g() % 8 == 0)
+            s += (g() % 2) ? "\xe2\x82\xac" : "\xc3\xa9";
+        else
+            s += static_cast<char>('a' + g() % 26);
+    }
+    s.resize(n);
+    if(! ascii)
+        while(static_cast<unsigned char>(s.back()) >= 0x80)
+            s.back() = 'a';
+    return s;
+}
+
+} // (anon)
+
+BENCH_CASE("websocket/utf8_checker")
+{
+    for(bool ascii : {true, false})
+    {
+        for(std::size_t size : {128, 65536})
+        {
+            auto const s = make_text(size, ascii);
+            auto const name = std::string("websocket/utf8_checker/") +
+                (ascii ? "ascii/" : "mixed/") + std::to_string(size);
+
+            ctx.measure(name,
+                [&](std::uint64_t n)
+                {
+                    for(std::uint64_t i = 0; i < n; ++i)
+                    {
+                        detail::utf8_checker c;
+                        bench::do_not_optimize(
+                            c.write(net::buffer(s)) && c.finish());
+                    }
+                },
+                size);
+
+            if(size < 1000)
+                continue;
+            ctx.measure(name + "/pieces",
+                [&](std::uint64_t n)
+                {
+                    for(std::uint64_t i = 0; i < n; ++i)
+                    {
+                        detail::utf8_checker c;
+                        bool ok = true;
+                        for(std::size_t pos = 0; pos < s.size(); pos += 1001)
+                            ok = ok && c.write(net::buffer(
+                                s.data() + pos,
+                                (std::min)(s.size() - pos,
+                                    std::size_t{1001})));
+                        bench::do_not_optimize(ok && c.finish());
+                    }
+                },
+                size);
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include "bench.hpp"
+#include "corpus.hpp"
+#include <stdexcept>
+#include <string>
+#include <boost/beast/zlib/deflate_stream.hpp>
+
+// Compressing complete messages with deflate_stream at several
+// levels, using the raw deflate format and window of permessage-
+// deflate. The stream is reset rather than rebuilt for each
+// message, as a websocket stream does.
+
+namespace beast = boost::beast;
+namespace zlib = beast::zlib;
+
+namespace {
+
+std::size_t
+compress(zlib::deflate_stream& ds,
+    std::string const& in, std::string& out)
+{
+    zlib::z_params zs;
+    zs.next_in = in.data();
+    zs.avail_in = in.size();
+    zs.next_out = &out[0];
+    zs.avail_out = out.size();
+    beast::error_code ec;
+    ds.write(zs, zlib::Flush::finish, ec);
+    if(ec != zlib::error::end_of_stream)
+        throw std::logic_error("deflate did not finish");
+    ds.reset();
+    return zs.total_out;
+}
+
+void
+run(bench::context& ctx, std::string const& name,
+    std::string const& in)
+{
+    for(int level : {1, 6, 9})
+    {
+        zlib::deflate_stream ds;
+        ds.reset(level, 15, 8, zlib::Strategy::normal);
+        std::string out(ds.upper_bound(in.size()), 0);
+        auto const size = compress(ds, in, out);
+        ctx.measure(name + "/level=" + std::to_string(level),
+            [&](std::uint64_t n)
+            {
+                for(std::uint64_t i = 0; i < n; ++i)
+                    bench::do_not_optimize(compress(ds, in, out));
+            },
+            in.size()).counters["ratio"] =
+                static_cast<double>(in.size()) / size;
+    }
+}
+
+} // (anon)
+
+BENCH_CASE("zlib/deflate_stream")
+{
+    for(std::size_t size : {1024, 65536})
+        run(ctx, "zlib/deflate_stream/json/" + std::to_string(size),
+            bench::make_json(size));
+    run(ctx, "zlib/deflate_stream/random/65536",
+        bench::make_random(65536));
+}
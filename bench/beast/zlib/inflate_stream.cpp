@@ -0,0 +1,90 @@
+#include "bench.hpp"
+#include "corpus.hpp"
+#include <stdexcept>
+#include <string>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
+
+// Decompressing complete messages with inflate_stream, both into
+// a buffer large enough for the whole message and through a small
+// buffer which is emptied after each call.
+
+namespace beast = boost::beast;
+namespace zlib = beast::zlib;
+
+namespace {
+
+std::string
+compress(std::string const& in)
+{
+    zlib::deflate_stream ds;
+    ds.reset(6, 15, 8, zlib::Strategy::normal);
+    std::string out(ds.upper_bound(in.size()), 0);
+    zlib::z_params zs;
+    zs.next_in = in.data();
+    zs.avail_in = in.size();
+    zs.next_out = &out[0];
+    zs.avail_out = out.size();
+    beast::error_code ec;
+    ds.write(zs, zlib::Flush::finish, ec);
+    if(ec != zlib::error::end_of_stream)
+        throw std::logic_error("deflate did not finish");
+    out.resize(zs.total_out);
+    return out;
+}
+
+std::size_t
+decompress(zlib::inflate_stream& is,
+    std::string const& in, std::string& out, std::size_t chunk)
+{
+    zlib::z_params zs;
+    zs.next_in = in.data();
+    zs.avail_in = in.size();
+    beast::error_code ec;
+    do
+    {
+        zs.next_out = &out[0];
+        zs.avail_out = chunk;
+        is.write(zs, zlib::Flush::sync, ec);
+    }
+    while(! ec && zs.avail_in > 0);
+    if(ec && ec != zlib::error::end_of_stream)
+        throw beast::system_error{ec};
+    is.reset();
+    return zs.total_out;
+}
+
+void
+run(bench::context& ctx, std::string const& name,
+    std::string const& text)
+{
+    auto const in = compress(text);
+    zlib::inflate_stream is;
+    is.reset(15);
+    std::string out(text.size() + 1024, 0);
+    for(std::size_t chunk : {out.size(), std::size_t{4096}})
+    {
+        if(decompress(is, in, out, chunk) != text.size())
+            throw std::logic_error("inflate size mismatch");
+        ctx.measure(name + (chunk == out.size() ?
+                "/whole" : "/chunk=" + std::to_string(chunk)),
+            [&](std::uint64_t n)
+            {
+                for(std::uint64_t i = 0; i < n; ++i)
+                    bench::do_not_optimize(
+                        decompress(is, in, out, chunk));
+            },
+            text.size());
+    }
+}
+
+} // (anon)
+
+BENCH_CASE("zlib/inflate_stream")
+{
+    for(std::size_t size : {1024, 65536})
+        run(ctx, "zlib/inflate_stream/json/" + std::to_string(size),
+            bench::make_json(size));
+    run(ctx, "zlib/inflate_stream/random/65536",
+        bench::make_random(65536));
+}
@@ -0,0 +1,792 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_EXAMPLE_HTTP_CLIENT_CRAWL_CRAWL_ENGINE_HPP
+#define BOOST_BEAST_EXAMPLE_HTTP_CLIENT_CRAWL_CRAWL_ENGINE_HPP
+
+#include "dns_cache.hpp"
+
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/version.hpp>
+#include <asio/dispatch.hpp>
+#include <asio/post.hpp>
+#include <asio/steady_timer.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace crawl {
+
+namespace beast = boost::beast;         // from <boost/beast.hpp>
+namespace http = beast::http;           // from <boost/beast/http.hpp>
+
+// A URL to fetch
+struct crawl_target
+{
+    std::string host;
+    std::string port = "80";
+    std::string target = "/";
+};
+
+/** Fetches many URLs concurrently over a pool of io_contexts.
+
+    Targets are pulled from a source into a bounded queue, so that
+    a source of any length is crawled in constant memory. Each of
+    `max_connections` fetchers repeatedly takes a target from a host
+    which is ready, fetches it and reports the result:
+
+    @li A host is ready when it has queued targets, fewer than
+    `max_connections_per_host` requests in progress, and its last
+    request started at least `min_host_interval` ago.
+
+    @li Names are resolved through a @ref dns_cache shared by all
+    the fetchers, and the addresses of a name are raced, so that
+    an unreachable address family costs a short delay instead of
+    the connect timeout.
+
+    @li Connections which the server keeps alive are returned to
+    their host and reused by its next request. When all the
+    connections are open, the one idle for the longest time is
+    closed to make room. A request which fails on a reused
+    connection, because the server closed it in the meantime, is
+    retried once on a new connection.
+
+    Fetchers with nothing to do wait on a timer, and are woken when
+    a host becomes ready. Counters and the latency of each fetch are
+    recorded in @ref stats.
+
+    The engine, the pool and the cache must outlive the crawl.
+*/
+class crawl_engine
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+    using response_type = http::response<http::string_body>;
+
+    // Returns the next target, or nothing when there are no more.
+    // Called with the engine locked, from any of the threads.
+    using source_type = std::function<std::optional<crawl_target>()>;
+
+    // Called from any of the threads with the result of each
+    // target. The response is null when the fetch failed.
+    using result_handler = std::function<void(
+        crawl_target const&, beast::error_code, response_type const*)>;
+
+    struct options
+    {
+        // The number of concurrent requests and of open connections
+        std::size_t max_connections = 256;
+
+        // The number of concurrent requests to one host
+        std::size_t max_connections_per_host = 2;
+
+        // The smallest time between starting two requests to one host
+        std::chrono::milliseconds min_host_interval{0};
+
+        // The number of targets pulled from the source ahead of time
+        std::size_t queue_capacity = 4096;
+
+        // The number of requests sent on a connection before closing it
+        std::size_t max_requests_per_connection = 100;
+
+        // The time allowed for each of connect, write and read
+        std::chrono::seconds timeout{10};
+
+        // The time to wait for a connection attempt before racing
+        // it with one to the next address, as in RFC 8305
+        std::chrono::milliseconds connection_attempt_delay{250};
+
+        // The largest response body accepted
+        std::uint64_t body_limit = 1024 * 1024;
+    };
+
+    // The counters in the statistics
+    enum counter
+    {
+        // Requests written, including retries
+        requests,
+
+        // Complete responses received
+        responses,
+
+        resolve_failures,
+        connect_failures,
+        write_failures,
+        read_failures,
+
+        // Requests retried after a reused connection failed
+        retries,
+
+        // Connections opened
+        connections_opened,
+
+        // Requests sent on a connection which was already used
+        connections_reused,
+
+        // Connections closed to make room for another host
+        connections_evicted,
+
+        // Idle connections closed, when evicted or after the crawl
+        connections_closed,
+
+        // The size of the response bodies
+        body_bytes,
+
+        counter_count
+    };
+
+    // The histograms in the statistics, in microseconds
+    enum histogram
+    {
+        // From taking a target to receiving the whole response
+        fetch,
+
+        histogram_count
+    };
+
+private:
+    struct host_state;
+
+    struct connection
+    {
+        beast::tcp_stream stream;
+        beast::flat_buffer buffer; // (Must persist between reads)
+        host_state* host;
+        std::size_t requests = 0;
+
+        // The position in the list of idle connections
+        std::list<connection*>::iterator lru;
+
+        connection(
+            net::io_context::executor_type ex,
+            host_state* h)
+            : stream(ex)
+            , host(h)
+        {
+        }
+
+        void
+        close()
+        {
+            beast::error_code ec;
+            stream.socket().shutdown(tcp::socket::shutdown_both, ec);
+            stream.close();
+        }
+    };
+
+    using ready_map =
+        std::multimap<clock_type::time_point, host_state*>;
+
+    struct host_state
+    {
+        std::string key;
+        std::deque<crawl_target> pending;
+        std::vector<std::unique_ptr<connection>> idle;
+        std::size_t active = 0;
+        clock_type::time_point next_start;
+
+        // The position in the map of ready hosts, if ready
+        bool ready = false;
+        ready_map::iterator ready_it;
+    };
+
+    class fetcher;
+
+    options opt_;
+    beast::io_context_pool& pool_;
+    dns_cache& dns_;
+    beast::sharded_statistics stats_;
+
+    // Everything below is guarded by the mutex
+    std::mutex m_;
+    source_type source_;
+    result_handler on_result_;
+    std::function<void()> done_;
+    std::unordered_map<std::string, host_state> hosts_;
+    ready_map ready_;
+    std::list<connection*> idle_;   // least recently used first
+    std::vector<fetcher*> parked_;
+    std::size_t queued_ = 0;
+    std::size_t open_ = 0;
+    std::size_t running_ = 0;
+    std::size_t closing_ = 0;
+    bool exhausted_ = false;
+
+    // Pull targets from the source until the queue is full
+    void
+    fill()
+    {
+        while(queued_ < opt_.queue_capacity && ! exhausted_)
+        {
+            auto t = source_();
+            if(! t)
+            {
+                exhausted_ = true;
+                break;
+            }
+            auto key = t->host + ':' + t->port;
+            auto& h = hosts_[key];
+            if(h.key.empty())
+                h.key = std::move(key);
+            h.pending.push_back(std::move(*t));
+            ++queued_;
+            schedule(h);
+        }
+    }
+
+    // Add a host to the ready map if it can start a request
+    void
+    schedule(host_state& h)
+    {
+        if( h.ready ||
+            h.pending.empty() ||
+            h.active >= opt_.max_connections_per_host)
+            return;
+        h.ready_it = ready_.emplace(h.next_start, &h);
+        h.ready = true;
+    }
+
+    // Remove a host which has nothing left
+    void
+    forget(host_state& h)
+    {
+        if( h.ready ||
+            h.active > 0 ||
+            ! h.pending.empty() ||
+            ! h.idle.empty())
+            return;
+        auto const key = std::move(h.key);
+        hosts_.erase(key);
+    }
+
+    // Take the least recently used idle connection,
+    // which must then be passed to close_on_its_executor
+    std::unique_ptr<connection>
+    evict()
+    {
+        auto c = idle_.front();
+        idle_.pop_front();
+        auto& h = *c->host;
+        auto it = std::find_if(h.idle.begin(), h.idle.end(),
+            [c](std::unique_ptr<connection> const& p)
+            {
+                return p.get() == c;
+            });
+        auto p = std::move(*it);
+        h.idle.erase(it);
+        --open_;
+        ++closing_;
+        forget(h);
+        return p;
+    }
+
+    // Close an evicted connection from any thread. Its stream may
+    // belong to another context of the pool, so the close runs there.
+    void
+    close_on_its_executor(std::unique_ptr<connection> c)
+    {
+        auto const ex = c->stream.get_executor();
+        net::post(ex,
+            [this, c = std::move(c)]
+            {
+                c->close();
+                stats_.local().add(connections_closed);
+                std::unique_lock<std::mutex> lock(m_);
+                if(--closing_ == 0 && running_ == 0)
+                    finish(lock);
+            });
+    }
+
+    // Report the end of the crawl, once the fetchers have
+    // exited and the last connection is closed
+    void
+    finish(std::unique_lock<std::mutex>& lock)
+    {
+        auto done = std::move(done_);
+        done_ = nullptr;
+        lock.unlock();
+        if(done)
+            done();
+    }
+
+    // Take the next target of a host which is starting a request
+    crawl_target
+    take(host_state& h, clock_type::time_point now)
+    {
+        if(h.ready)
+        {
+            ready_.erase(h.ready_it);
+            h.ready = false;
+        }
+        auto t = std::move(h.pending.front());
+        h.pending.pop_front();
+        --queued_;
+        h.next_start = now + opt_.min_host_interval;
+        schedule(h);
+        return t;
+    }
+
+    inline void wake_one();
+    inline void wake_all();
+
+public:
+    crawl_engine(
+        beast::io_context_pool& pool,
+        dns_cache& dns)
+        : crawl_engine(pool, dns, options())
+    {
+    }
+
+    crawl_engine(
+        beast::io_context_pool& pool,
+        dns_cache& dns,
+        options const& opt)
+        : opt_(opt)
+        , pool_(pool)
+        , dns_(dns)
+        , stats_(counter_count, histogram_count)
+    {
+    }
+
+    crawl_engine(crawl_engine const&) = delete;
+    crawl_engine& operator=(crawl_engine const&) = delete;
+
+    // Returns the statistics of the crawl
+    beast::sharded_statistics const&
+    stats() const noexcept
+    {
+        return stats_;
+    }
+
+    /** Start crawling the targets of a source.
+
+        The fetchers are spread over the contexts of the pool,
+        which must be running or run later. `done` is called
+        once every target has been reported and the connections
+        are closed.
+    */
+    inline
+    void
+    run(
+        source_type source,
+        result_handler on_result,
+        std::function<void()> done);
+};
+
+//------------------------------------------------------------------------------
+
+// Fetches one target at a time, on its own context
+class crawl_engine::fetcher
+    : public std::enable_shared_from_this<fetcher>
+{
+    friend class crawl_engine;
+
+    crawl_engine& e_;
+    net::io_context::executor_type ex_;
+    net::steady_timer timer_;
+    bool parked_ = false;
+
+    host_state* host_ = nullptr;
+    crawl_target target_;
+    std::unique_ptr<connection> conn_;
+    bool reused_ = false;
+    bool retried_ = false;
+    clock_type::time_point start_;
+    http::request<http::empty_body> req_;
+    std::optional<http::response_parser<http::string_body>> parser_;
+
+public:
+    fetcher(crawl_engine& e, net::io_context::executor_type ex)
+        : e_(e)
+        , ex_(ex)
+        , timer_(ex)
+    {
+        req_.version(11);
+        req_.method(http::verb::get);
+        req_.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
+    }
+
+    void
+    run()
+    {
+        net::post(ex_,
+            beast::bind_front_handler(
+                &fetcher::do_pick,
+                shared_from_this()));
+    }
+
+private:
+    // Take a target from a ready host, or wait for one.
+    // Always called on our own executor, so that a wakeup
+    // posted to it runs after the wait has started.
+    void
+    do_pick()
+    {
+        std::unique_lock<std::mutex> lock(e_.m_);
+        if(parked_)
+        {
+            // the timer expired instead of being woken
+            parked_ = false;
+            e_.parked_.erase(std::find(
+                e_.parked_.begin(), e_.parked_.end(), this));
+        }
+
+        e_.fill();
+        auto const now = clock_type::now();
+        if(e_.ready_.empty())
+        {
+            if(e_.exhausted_ && e_.queued_ == 0)
+                return do_exit(lock);
+
+            // every host with targets is at its limit
+            return do_park(lock, clock_type::time_point::max());
+        }
+        auto const first = e_.ready_.begin();
+        if(first->first > now)
+            return do_park(lock, first->first);
+
+        auto& h = *first->second;
+        host_ = &h;
+        ++h.active;
+        target_ = e_.take(h, now);
+
+        std::unique_ptr<connection> victim;
+        reused_ = ! h.idle.empty();
+        retried_ = false;
+        if(reused_)
+        {
+            conn_ = std::move(h.idle.back());
+            h.idle.pop_back();
+            e_.idle_.erase(conn_->lru);
+        }
+        else
+        {
+            if(e_.open_ >= e_.opt_.max_connections)
+                victim = e_.evict();
+            ++e_.open_;
+        }
+
+        // let another fetcher take what remains
+        e_.fill();
+        if(! e_.ready_.empty())
+            e_.wake_one();
+        lock.unlock();
+
+        if(victim)
+        {
+            e_.stats_.local().add(connections_evicted);
+            e_.close_on_its_executor(std::move(victim));
+        }
+        start_ = clock_type::now();
+        if(reused_)
+            return do_write();
+        do_resolve();
+    }
+
+    void
+    do_park(
+        std::unique_lock<std::mutex>& lock,
+        clock_type::time_point until)
+    {
+        parked_ = true;
+        e_.parked_.push_back(this);
+        lock.unlock();
+
+        timer_.expires_at(until);
+        timer_.async_wait(
+            [self = shared_from_this()](beast::error_code)
+            {
+                self->do_pick();
+            });
+    }
+
+    void
+    do_exit(std::unique_lock<std::mutex>& lock)
+    {
+        // the others have nothing left to do either
+        e_.wake_all();
+        if(--e_.running_ > 0)
+            return;
+
+        // the last one out closes the idle connections,
+        // and the last of those to close reports the end
+        std::vector<std::unique_ptr<connection>> idle;
+        while(! e_.idle_.empty())
+            idle.push_back(e_.evict());
+        if(e_.closing_ == 0)
+            return e_.finish(lock);
+        lock.unlock();
+
+        for(auto& c : idle)
+            e_.close_on_its_executor(std::move(c));
+    }
+
+    void
+    do_resolve()
+    {
+        e_.dns_.async_resolve(
+            ex_,
+            target_.host,
+            target_.port,
+            beast::bind_front_handler(
+                &fetcher::on_resolve,
+                shared_from_this()));
+    }
+
+    void
+    on_resolve(
+        beast::error_code ec,
+        tcp::resolver::results_type results)
+    {
+        if(ec)
+        {
+            e_.stats_.local().add(resolve_failures);
+            return complete(ec, false);
+        }
+
+        conn_ = std::make_unique<connection>(ex_, host_);
+        conn_->stream.expires_after(e_.opt_.timeout);
+        conn_->stream.async_race_connect(
+            results,
+            e_.opt_.connection_attempt_delay,
+            beast::bind_front_handler(
+                &fetcher::on_connect,
+                shared_from_this()));
+    }
+
+    void
+    on_connect(beast::error_code ec, tcp::endpoint)
+    {
+        if(ec)
+        {
+            e_.stats_.local().add(connect_failures);
+            return complete(ec, false);
+        }
+        e_.stats_.local().add(connections_opened);
+        do_write();
+    }
+
+    void
+    do_write()
+    {
+        auto& s = e_.stats_.local();
+        s.add(requests);
+        if(reused_)
+            s.add(connections_reused);
+
+        // Ask the server to close after the last request
+        ++conn_->requests;
+        req_.target(target_.target);
+        req_.set(http::field::host, target_.host);
+        req_.keep_alive(
+            conn_->requests < e_.opt_.max_requests_per_connection);
+
+        conn_->stream.expires_after(e_.opt_.timeout);
+        http::async_write(
+            conn_->stream,
+            req_,
+            beast::bind_front_handler(
+                &fetcher::on_write,
+                shared_from_this()));
+    }
+
+    void
+    on_write(beast::error_code ec, std::size_t)
+    {
+        if(ec)
+        {
+            if(retry(ec))
+                return;
+            e_.stats_.local().add(write_failures);
+            return complete(ec, false);
+        }
+
+        parser_.emplace();
+        parser_->body_limit(e_.opt_.body_limit);
+        conn_->stream.expires_after(e_.opt_.timeout);
+        http::async_read(
+            conn_->stream,
+            conn_->buffer,
+            *parser_,
+            beast::bind_front_handler(
+                &fetcher::on_read,
+                shared_from_this()));
+    }
+
+    void
+    on_read(beast::error_code ec, std::size_t)
+    {
+        if(ec)
+        {
+            if(retry(ec))
+                return;
+            e_.stats_.local().add(read_failures);
+            return complete(ec, false);
+        }
+
+        auto const& res = parser_->get();
+        auto& s = e_.stats_.local();
+        s.add(responses);
+        s.add(body_bytes, res.body().size());
+        s.record(fetch,
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                clock_type::now() - start_).count());
+        complete(ec, res.keep_alive() &&
+            conn_->requests < e_.opt_.max_requests_per_connection);
+    }
+
+    // Start over on a new connection if the server
+    // closed the reused one before answering
+    bool
+    retry(beast::error_code const& ec)
+    {
+        if(! reused_ || retried_)
+            return false;
+        if( ec != net::error::eof &&
+            ec != http::error::end_of_stream &&
+            ec != net::error::connection_reset &&
+            ec != net::error::connection_aborted &&
+            ec != net::error::broken_pipe)
+            return false;
+        e_.stats_.local().add(retries);
+        reused_ = false;
+        retried_ = true;
+        conn_->close();
+        conn_.reset();
+        do_resolve();
+        return true;
+    }
+
+    // Report the result, then either continue with the
+    // next target of the host or give back the connection
+    void
+    complete(beast::error_code ec, bool keep)
+    {
+        if(e_.on_result_)
+            e_.on_result_(target_, ec, ec ? nullptr : &parser_->get());
+        parser_.reset();
+
+        std::unique_ptr<connection> closed;
+        {
+            std::lock_guard<std::mutex> lock(e_.m_);
+            auto& h = *host_;
+            auto const now = clock_type::now();
+            if(keep && ! h.pending.empty() && h.next_start <= now)
+            {
+                // Stay on the connection, instead of returning it
+                // to the idle list where a request to another
+                // host could evict it before this host reuses it
+                target_ = e_.take(h, now);
+                e_.fill();
+                if(! e_.ready_.empty())
+                    e_.wake_one();
+            }
+            else
+            {
+                --h.active;
+                if(keep)
+                {
+                    conn_->lru = e_.idle_.insert(e_.idle_.end(), conn_.get());
+                    h.idle.push_back(std::move(conn_));
+                }
+                else
+                {
+                    closed = std::move(conn_);
+                    --e_.open_;
+                }
+                e_.schedule(h);
+                if(h.ready)
+                    e_.wake_one();
+                e_.forget(h);
+                host_ = nullptr;
+            }
+        }
+        if(host_)
+        {
+            reused_ = true;
+            retried_ = false;
+            start_ = clock_type::now();
+            return do_write();
+        }
+        if(closed)
+            closed->close();
+
+        // The completion may run on the executor of a
+        // reused connection, which is not necessarily ours
+        net::dispatch(ex_,
+            beast::bind_front_handler(
+                &fetcher::do_pick,
+                shared_from_this()));
+    }
+};
+
+//------------------------------------------------------------------------------
+
+void
+crawl_engine::
+wake_one()
+{
+    if(parked_.empty())
+        return;
+    auto f = parked_.back();
+    parked_.pop_back();
+    f->parked_ = false;
+    net::post(f->ex_,
+        [self = f->shared_from_this()]
+        {
+            self->timer_.cancel();
+        });
+}
+
+void
+crawl_engine::
+wake_all()
+{
+    while(! parked_.empty())
+        wake_one();
+}
+
+void
+crawl_engine::
+run(
+    source_type source,
+    result_handler on_result,
+    std::function<void()> done)
+{
+    std::vector<std::shared_ptr<fetcher>> v;
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        source_ = std::move(source);
+        on_result_ = std::move(on_result);
+        done_ = std::move(done);
+        exhausted_ = false;
+        running_ = opt_.max_connections;
+        for(std::size_t i = 0; i < opt_.max_connections; ++i)
+            v.push_back(std::make_shared<fetcher>(*this,
+                pool_.at(i % pool_.size()).get_executor()));
+    }
+    for(auto& f : v)
+        f->run();
+}
+
+} // crawl
+
+#endif
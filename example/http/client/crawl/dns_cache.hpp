@@ -0,0 +1,264 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_EXAMPLE_HTTP_CLIENT_CRAWL_DNS_CACHE_HPP
+#define BOOST_BEAST_EXAMPLE_HTTP_CLIENT_CRAWL_DNS_CACHE_HPP
+
+#include <boost/beast/core/error.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/post.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace crawl {
+
+namespace net = asio;                   // from <asio.hpp>
+using tcp = net::ip::tcp;               // from <asio/ip/tcp.hpp>
+
+/** A cache of name resolutions shared by many connections.
+
+    Results are kept for a fixed time to live, and failures for
+    a shorter one, so that a host which does not resolve is not
+    looked up again for each of its URLs. Lookups of a name which
+    is already being resolved wait for that resolution instead of
+    starting another.
+
+    The system resolver does not report the time to live of the
+    records it returns, so the same one is used for every name.
+
+    All member functions are thread-safe.
+*/
+class dns_cache
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+    using results_type = tcp::resolver::results_type;
+
+    struct options
+    {
+        // How long a successful resolution is kept
+        std::chrono::seconds ttl{300};
+
+        // How long a failed resolution is kept
+        std::chrono::seconds negative_ttl{30};
+
+        // Expired entries are removed when there are more than this
+        std::size_t max_entries = 100000;
+    };
+
+    // Counts of the lookups
+    struct counters
+    {
+        // Answered from a resolution in the cache
+        std::uint64_t hits = 0;
+
+        // Answered with a failure in the cache
+        std::uint64_t negative_hits = 0;
+
+        // Waited for a resolution already in progress
+        std::uint64_t coalesced = 0;
+
+        // Resolved by the system resolver
+        std::uint64_t misses = 0;
+    };
+
+private:
+    // A type-erased completion handler which may be move-only,
+    // unlike std::function
+    class waiter
+    {
+        struct base
+        {
+            virtual ~base() = default;
+
+            virtual
+            void
+            invoke(boost::beast::error_code ec, results_type results) = 0;
+        };
+
+        template<class Handler>
+        struct impl final : base
+        {
+            Handler h;
+
+            explicit
+            impl(Handler&& h_)
+                : h(std::move(h_))
+            {
+            }
+
+            void
+            invoke(boost::beast::error_code ec, results_type results) override
+            {
+                h(ec, std::move(results));
+            }
+        };
+
+        std::unique_ptr<base> p_;
+
+    public:
+        template<class Handler>
+        explicit
+        waiter(Handler&& h)
+            : p_(std::make_unique<impl<std::decay_t<Handler>>>(
+                std::forward<Handler>(h)))
+        {
+        }
+
+        void
+        operator()(boost::beast::error_code ec, results_type results)
+        {
+            p_->invoke(ec, std::move(results));
+        }
+    };
+
+    struct entry
+    {
+        bool pending = true;
+        boost::beast::error_code ec;
+        results_type results;
+        clock_type::time_point expires;
+        std::vector<waiter> waiters;
+    };
+
+    options opt_;
+    std::mutex m_;
+    std::unordered_map<std::string, entry> map_;
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> negative_hits_{0};
+    std::atomic<std::uint64_t> coalesced_{0};
+    std::atomic<std::uint64_t> misses_{0};
+
+    // Remove the expired entries, with the lock held
+    void
+    prune(clock_type::time_point now)
+    {
+        for(auto it = map_.begin(); it != map_.end();)
+        {
+            if(! it->second.pending && it->second.expires <= now)
+                it = map_.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    void
+    complete(
+        std::string const& key,
+        boost::beast::error_code ec,
+        results_type results)
+    {
+        std::vector<waiter> waiters;
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            auto& e = map_[key];
+            e.pending = false;
+            e.ec = ec;
+            e.results = results;
+            e.expires = clock_type::now() +
+                (ec ? opt_.negative_ttl : opt_.ttl);
+            waiters.swap(e.waiters);
+        }
+        for(auto& h : waiters)
+            h(ec, results);
+    }
+
+public:
+    dns_cache() = default;
+
+    explicit
+    dns_cache(options const& opt)
+        : opt_(opt)
+    {
+    }
+
+    /** Resolve a host and service.
+
+        The handler is invoked as if by `net::post` on the
+        executor `ex`, with the signature
+        `void(error_code, results_type)`. It may be move-only.
+    */
+    template<class Executor, class Handler>
+    void
+    async_resolve(
+        Executor const& ex,
+        std::string const& host,
+        std::string const& service,
+        Handler&& handler)
+    {
+        waiter h(
+            [ex, h = std::forward<Handler>(handler)](
+                boost::beast::error_code ec, results_type results) mutable
+            {
+                net::post(ex,
+                    [h = std::move(h), ec, results]() mutable
+                    {
+                        h(ec, results);
+                    });
+            });
+
+        auto key = host + ':' + service;
+        std::unique_lock<std::mutex> lock(m_);
+        auto const now = clock_type::now();
+        auto it = map_.find(key);
+        if(it != map_.end() && it->second.pending)
+        {
+            ++coalesced_;
+            it->second.waiters.push_back(std::move(h));
+            return;
+        }
+        if(it != map_.end() && it->second.expires > now)
+        {
+            auto const ec = it->second.ec;
+            auto const results = it->second.results;
+            lock.unlock();
+            ++(ec ? negative_hits_ : hits_);
+            return h(ec, results);
+        }
+        if(it == map_.end() && map_.size() >= opt_.max_entries)
+            prune(now);
+        auto& e = map_[key];
+        e.pending = true;
+        e.waiters.push_back(std::move(h));
+        lock.unlock();
+        ++misses_;
+
+        auto r = std::make_shared<tcp::resolver>(ex);
+        r->async_resolve(host, service,
+            [this, r, key = std::move(key)](
+                boost::beast::error_code ec, results_type results)
+            {
+                complete(key, ec, results);
+            });
+    }
+
+    // Returns the counts of the lookups
+    counters
+    stats() const noexcept
+    {
+        counters c;
+        c.hits = hits_.load(std::memory_order_relaxed);
+        c.negative_hits = negative_hits_.load(std::memory_order_relaxed);
+        c.coalesced = coalesced_.load(std::memory_order_relaxed);
+        c.misses = misses_.load(std::memory_order_relaxed);
+        return c;
+    }
+};
+
+} // crawl
+
+#endif
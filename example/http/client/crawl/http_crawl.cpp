@@ -13,27 +13,24 @@
 //
 //------------------------------------------------------------------------------
 
+#include "crawl_engine.hpp"
+#include "dns_cache.hpp"
 #include "urls_large_data.hpp"
 
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
-#include <boost/beast/version.hpp>
-#include <asio/bind_executor.hpp>
-#include <asio/connect.hpp>
 #include <asio/ip/tcp.hpp>
 #include <asio/post.hpp>
-#include <asio/strand.hpp>
 #include <atomic>
 #include <chrono>
 #include <cstdlib>
-#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <string>
 #include <thread>
 #include <vector>
-#include <map>
 
 namespace chrono = std::chrono;         // from <chrono>
 namespace beast = boost::beast;         // from <boost/beast.hpp>
@@ -43,281 +40,174 @@ using tcp = net::ip::tcp;               // from <asio/ip/tcp.hpp>
 
 //------------------------------------------------------------------------------
 
-// This structure aggregates statistics on all the sites
+// This structure aggregates statistics on all the sites.
+//
+// Each thread adds to its own shard of the statistics, so
+// that the fetchers never wait for each other. The shards
+// are added together when the report is printed.
 class crawl_report
 {
-    net::strand<
-        net::io_context::executor_type> strand_;
-    std::atomic<std::size_t> index_;
+    std::size_t index_;
     std::vector<char const*> const& hosts_;
-    std::size_t count_ = 0;
 
 public:
-    crawl_report(net::io_context& ioc)
-        : strand_(ioc.get_executor())
-        , index_(0)
+    // The counters in the statistics
+    enum counter
+    {
+        // Counts the responses of each class of status code,
+        // from status_class + 0 for 1xx to status_class + 4 for 5xx
+        status_class,
+
+        // Counts the responses with a status code outside 1xx to 5xx
+        status_other = status_class + 5,
+
+        counter_count
+    };
+
+    // The histograms in the statistics, in microseconds, are
+    // the phases reported by the operations, indexed by
+    // beast::trace_phase.
+    enum histogram
+    {
+        histogram_count = beast::trace_phase_count
+    };
+
+    beast::sharded_statistics stats;
+    crawl::crawl_engine const* engine = nullptr;
+    crawl::dns_cache const* dns = nullptr;
+    chrono::nanoseconds elapsed{};
+
+    crawl_report()
+        : index_(0)
         , hosts_(urls_large_data())
+        , stats(counter_count, histogram_count)
     {
     }
 
-    // Run an aggregation function on the strand.
-    // This allows synchronization without a mutex.
-    template<class F>
-    void
-    aggregate(F const& f)
+    // Returns the counter of a status code
+    static
+    std::size_t
+    status_counter(unsigned code)
     {
-        net::post(
-            strand_,
-            [&, f]
-            {
-                f(*this);
-                if(count_ % 100 == 0)
-                {
-                    std::cerr <<
-                        "Progress: " << count_ << " of " << hosts_.size() << "\n";
-                    //std::cerr << *this;
-                }
-                ++count_;
-            });
+        auto const n = code / 100;
+        if(n < 1 || n > 5)
+            return status_other;
+        return status_class + n - 1;
     }
 
-    // Returns the next host to check
-    char const*
+    // Returns the next host to check. The engine
+    // calls this with its lock held.
+    std::optional<crawl::crawl_target>
     get_host()
     {
         auto const n = index_++;
         if(n >= hosts_.size())
-            return nullptr;
-        return hosts_[n];
+            return std::nullopt;
+        if(n % 100 == 0)
+            std::cerr << "Progress: " + std::to_string(n) +
+                " of " + std::to_string(hosts_.size()) + "\n";
+        crawl::crawl_target t;
+        t.host = hosts_[n];
+        return t;
     }
-
-    // Counts the number of timer failures
-    std::size_t timer_failures = 0;
-
-    // Counts the number of name resolution failures
-    std::size_t resolve_failures = 0;
-
-    // Counts the number of connection failures
-    std::size_t connect_failures = 0;
-
-    // Counts the number of write failures
-    std::size_t write_failures = 0;
-
-    // Counts the number of read failures
-    std::size_t read_failures = 0;
-
-    // Counts the number of success reads
-    std::size_t success = 0;
-
-    // Counts the number received of each status code
-    std::map<unsigned, std::size_t> status_codes;
 };
 
 std::ostream&
 operator<<(std::ostream& os, crawl_report const& report)
 {
+    using engine = crawl::crawl_engine;
+    auto const& stats = report.stats;
+    auto const& es = report.engine->stats();
+    auto const dns = report.dns->stats();
+    auto const seconds =
+        chrono::duration<double>(report.elapsed).count();
+
     // Print the report
     os <<
         "Crawl report\n" <<
         "   Failure counts\n" <<
-        "       Timer   : " << report.timer_failures << "\n" <<
-        "       Resolve : " << report.resolve_failures << "\n" <<
-        "       Connect : " << report.connect_failures << "\n" <<
-        "       Write   : " << report.write_failures << "\n" <<
-        "       Read    : " << report.read_failures << "\n" <<
-        "       Success : " << report.success << "\n" <<
+        "       Resolve : " << es.counter(engine::resolve_failures) << "\n" <<
+        "       Connect : " << es.counter(engine::connect_failures) << "\n" <<
+        "       Write   : " << es.counter(engine::write_failures) << "\n" <<
+        "       Read    : " << es.counter(engine::read_failures) << "\n" <<
+        "       Success : " << es.counter(engine::responses) << "\n" <<
+        "   Throughput\n" <<
+        "       Requests/s  : " << std::fixed << std::setprecision(1) <<
+            (seconds > 0 ? es.counter(engine::responses) / seconds : 0) << "\n" <<
+        "       Body bytes  : " << es.counter(engine::body_bytes) << "\n" <<
+        "   Connections\n" <<
+        "       Opened  : " << es.counter(engine::connections_opened) << "\n" <<
+        "       Reused  : " << es.counter(engine::connections_reused) << "\n" <<
+        "       Evicted : " << es.counter(engine::connections_evicted) << "\n" <<
+        "       Closed  : " << es.counter(engine::connections_closed) << "\n" <<
+        "       Retries : " << es.counter(engine::retries) << "\n" <<
+        "   Name resolution\n" <<
+        "       Hits      : " << dns.hits << "\n" <<
+        "       Negative  : " << dns.negative_hits << "\n" <<
+        "       Coalesced : " << dns.coalesced << "\n" <<
+        "       Misses    : " << dns.misses << "\n" <<
         "   Status codes\n"
         ;
-    for(auto const& result : report.status_codes)
+    for(unsigned n = 1; n <= 5; ++n)
         os <<
-        "       " << std::setw(3) << result.first << ": " << result.second <<
-                    " (" << http::obsolete_reason(static_cast<http::status>(result.first)) << ")\n";
+        "       " << n << "xx   : " <<
+            stats.counter(crawl_report::status_class + n - 1) << "\n";
+    os <<
+        "       Other : " << stats.counter(crawl_report::status_other) << "\n";
+
+    // Print the time taken by each phase of the successful requests
+    os <<
+        "   Phase timing (milliseconds)\n" <<
+        "       Phase                    count      p50      p90      p99      max\n";
+    auto const row =
+        [&os](char const* name, beast::hdr_histogram const& h)
+        {
+            if(h.count() == 0)
+                return;
+            os << "       " << std::left << std::setw(20) << name <<
+                std::right << std::setw(10) << h.count() <<
+                std::fixed << std::setprecision(1);
+            for(double p : {50.0, 90.0, 99.0, 100.0})
+                os << std::setw(9) << h.value_at_percentile(p) / 1000.0;
+            os << "\n";
+        };
+    for(std::size_t i = 0; i < beast::trace_phase_count; ++i)
+        row(beast::to_string(static_cast<beast::trace_phase>(i)),
+            stats.histogram(i));
+    row("fetch", es.histogram(engine::fetch));
     os.flush();
     return os;
 }
 
-//------------------------------------------------------------------------------
-
-// Performs HTTP GET requests and aggregates the results into a report
-class worker : public std::enable_shared_from_this<worker>
+// Records the duration of each phase which succeeds
+// in the statistics of the thread it is installed on
+class phase_tracer : public beast::tracer
 {
-    enum
-    {
-        // Use a small timeout to keep things lively
-        timeout = 5
-    };
-
-    crawl_report& report_;
-    net::strand<net::io_context::executor_type> ex_;
-    tcp::resolver resolver_;
-    beast::tcp_stream stream_;
-    beast::flat_buffer buffer_; // (Must persist between reads)
-    http::request<http::empty_body> req_;
-    http::response<http::string_body> res_;
+    beast::sharded_statistics::shard& stats_;
 
 public:
-    worker(worker&&) = default;
-
-    // Resolver and socket require an io_context
-    worker(
-        crawl_report& report,
-        net::io_context& ioc)
-        : report_(report)
-        , ex_(net::make_strand(ioc.get_executor()))
-        , resolver_(ex_)
-        , stream_(ex_)
+    explicit
+    phase_tracer(beast::sharded_statistics::shard& stats)
+        : stats_(stats)
     {
-        // Set up the common fields of the request
-        req_.version(11);
-        req_.method(http::verb::get);
-        req_.target("/");
-        req_.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
     }
 
-    // Start the asynchronous operation
     void
-    run()
-    {
-        do_get_host();
-    }
-
-    void
-    do_get_host()
-    {
-        // Grab another host
-        auto const host = report_.get_host();
-
-        // nullptr means no more work
-        if(! host)
-            return;
-
-        // The Host HTTP field is required
-        req_.set(http::field::host, host);
-
-        // Set up an HTTP GET request message
-        // Look up the domain name
-        resolver_.async_resolve(
-            host,
-            "http",
-            beast::bind_front_handler(
-                &worker::on_resolve,
-                shared_from_this()));
-    }
-
-    void
-    on_resolve(
-        beast::error_code ec,
-        tcp::resolver::results_type results)
+    on_phase(
+        beast::trace_phase phase,
+        clock_type::duration elapsed,
+        beast::error_code const& ec) override
     {
         if(ec)
-        {
-            report_.aggregate(
-            [](crawl_report& rep)
-            {
-                ++rep.resolve_failures;
-            });
-            return do_get_host();
-        }
-
-        // Set a timeout on the operation
-        stream_.expires_after(std::chrono::seconds(10));
-
-        // Make the connection on the IP address we get from a lookup
-        stream_.async_connect(
-            results,
-            beast::bind_front_handler(
-                &worker::on_connect,
-                shared_from_this()));
-    }
-
-    void
-    on_connect(beast::error_code ec, tcp::resolver::results_type::endpoint_type)
-    {
-        if(ec)
-        {
-            report_.aggregate(
-            [](crawl_report& rep)
-            {
-                ++rep.connect_failures;
-            });
-            return do_get_host();
-        }
-
-        // Set a timeout on the operation
-        stream_.expires_after(std::chrono::seconds(10));
-
-        // Send the HTTP request to the remote host
-        http::async_write(
-            stream_,
-            req_,
-            beast::bind_front_handler(
-                &worker::on_write,
-                shared_from_this()));
-    }
-
-    void
-    on_write(
-        beast::error_code ec,
-        std::size_t bytes_transferred)
-    {
-        boost::ignore_unused(bytes_transferred);
-
-        if(ec)
-        {
-            report_.aggregate(
-            [](crawl_report& rep)
-            {
-                ++rep.write_failures;
-            });
-            return do_get_host();
-        }
-
-        // Receive the HTTP response
-        res_ = {};
-        http::async_read(
-            stream_,
-            buffer_,
-            res_,
-            beast::bind_front_handler(
-                &worker::on_read,
-                shared_from_this()));
-    }
-
-    void
-    on_read(
-        beast::error_code ec,
-        std::size_t bytes_transferred)
-    {
-        boost::ignore_unused(bytes_transferred);
-
-        if(ec)
-        {
-            report_.aggregate(
-            [](crawl_report& rep)
-            {
-                ++rep.read_failures;
-            });
-            return do_get_host();
-        }
-
-        auto const code = res_.result_int();
-        report_.aggregate(
-        [code](crawl_report& rep)
-        {
-            ++rep.success;
-            ++rep.status_codes[code];
-        });
-
-        // Gracefully close the socket
-        stream_.socket().shutdown(tcp::socket::shutdown_both, ec);
-        stream_.close();
-
-        // If we get here then the connection is closed gracefully
-
-        do_get_host();
+            return;
+        stats_.record(static_cast<std::size_t>(phase),
+            chrono::duration_cast<chrono::microseconds>(
+                elapsed).count());
     }
 };
 
+//------------------------------------------------------------------------------
+
 class timer
 {
     using clock_type = chrono::system_clock;
@@ -342,61 +232,81 @@ public:
 int main(int argc, char* argv[])
 {
     // Check command line arguments.
-    if (argc != 2)
+    if (argc != 2 && argc != 3)
     {
         std::cerr <<
-            "Usage: http-crawl <threads>\n" <<
+            "Usage: http-crawl <connections> [<threads>]\n" <<
             "Example:\n" <<
-            "    http-crawl 100\n";
+            "    http-crawl 100 4\n";
         return EXIT_FAILURE;
     }
-    auto const threads = std::max<int>(1, std::atoi(argv[1]));
-
-    // The io_context is used to aggregate the statistics
-    net::io_context ioc;
+    auto const connections = std::max<int>(1, std::atoi(argv[1]));
+    auto const threads = argc == 3 ? std::max<int>(1, std::atoi(argv[2])) : 0;
 
     // The report holds the aggregated statistics
-    crawl_report report{ioc};
+    crawl_report report;
 
-    timer t;
+    // Each context of the pool has its own thread, and the
+    // asio resolver simulates asynchronous operation with a
+    // dedicated thread per io_context, so the number of threads
+    // is also the number of names resolved in parallel.
+    beast::io_context_pool pool(threads);
+
+    // Names are looked up once for all the fetchers
+    crawl::dns_cache dns;
 
-    // Create and launch the worker threads.
-    std::vector<std::thread> workers;
-    workers.reserve(threads + 1);
-    for(int i = 0; i < threads; ++i)
+    crawl::crawl_engine::options opt;
+    opt.max_connections = connections;
+
+    // Use a small timeout to keep things lively
+    opt.timeout = chrono::seconds(5);
+
+    crawl::crawl_engine engine(pool, dns, opt);
+    report.engine = &engine;
+    report.dns = &dns;
+
+    // Everything a thread records goes to its own shard,
+    // including the duration of each phase of the operations,
+    // measured while the tracer is installed on that thread.
+    std::vector<std::unique_ptr<phase_tracer>> tracers;
+    for(std::size_t i = 0; i < pool.size(); ++i)
     {
-        // Each worker will eventually add some data to the aggregated
-        // report. Outstanding work is tracked in each worker to
-        // represent the forthcoming delivery of this data by that
-        // worker.
-        auto reporting_work = net::require(
-            ioc.get_executor(),
-            net::execution::outstanding_work.tracked);
-
-        workers.emplace_back(
-            [&report, reporting_work] {
-                // We use a separate io_context for each worker because
-                // the asio resolver simulates asynchronous operation using
-                // a dedicated worker thread per io_context, and we want to
-                // do a lot of name resolutions in parallel.
-                net::io_context ioc;
-                std::make_shared<worker>(report, ioc)->run();
-                ioc.run();
+        tracers.push_back(std::make_unique<phase_tracer>(
+            report.stats.make_shard()));
+        net::post(pool.at(i),
+            [t = tracers.back().get()]
+            {
+                beast::set_tracer(t);
             });
     }
 
-    // Add another thread to run the main io_context which
-    // is used to aggregate the statistics
-    workers.emplace_back(
-    [&ioc]
-    {
-        ioc.run();
-    });
+    timer t;
+
+    engine.run(
+        [&report]
+        {
+            return report.get_host();
+        },
+        [&report](
+            crawl::crawl_target const&,
+            beast::error_code ec,
+            crawl::crawl_engine::response_type const* res)
+        {
+            if(! ec)
+                report.stats.local().add(
+                    crawl_report::status_counter(res->result_int()));
+        },
+        [&pool]
+        {
+            // Let the threads exit once the last handlers have run
+            pool.release();
+        });
 
     // Now block until all threads exit
-    for(std::size_t i = 0; i < workers.size(); ++i)
-        workers[i].join();
+    pool.run();
+    pool.join();
 
+    report.elapsed = chrono::duration_cast<chrono::nanoseconds>(t.elapsed());
     std::cout <<
         "Elapsed time:    " << chrono::duration_cast<chrono::seconds>(t.elapsed()).count() << " seconds\n";
     std::cout << report;
@@ -1,13 +1,19 @@
 #include "catch.hpp"
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <string_view>
+#include <system_error>
 #include <thread>
+#include <vector>
 #include <asio/io_context.hpp>
 #include <asio/strand.hpp>
 #include <asio/ip/tcp.hpp>
 #include <asio/write.hpp>
 #include <boost/beast/core/basic_stream.hpp>
+#include <boost/beast/core/recycling_allocator.hpp>
 #include <boost/beast/core/tcp_stream.hpp>
 #include <boost/beast/core/role.hpp>
 
@@ -98,6 +104,145 @@ TEST_CASE("testSpecialMembers rate policies 4", "basic_stream") {
             boost::beast::unlimited_rate_policy{}, ioc);
 }
 
+// Only used by the tests below, which run the io_context on one thread
+using st_executor = net::io_context::basic_executor_type<
+    std::allocator<int>, 0>;
+
+template<>
+struct boost::beast::is_single_threaded_executor<st_executor>
+    : std::true_type
+{
+};
+
+namespace {
+    // Counts the allocations made through any of its copies
+    template<class T>
+    struct counting_allocator
+    {
+        using value_type = T;
+
+        std::size_t* count;
+
+        explicit
+        counting_allocator(std::size_t& n) noexcept
+            : count(&n)
+        {
+        }
+
+        template<class U>
+        counting_allocator(counting_allocator<U> const& other) noexcept
+            : count(other.count)
+        {
+        }
+
+        T*
+        allocate(std::size_t n)
+        {
+            ++*count;
+            return std::allocator<T>{}.allocate(n);
+        }
+
+        void
+        deallocate(T* p, std::size_t n) noexcept
+        {
+            std::allocator<T>{}.deallocate(p, n);
+        }
+
+        template<class U>
+        bool
+        operator==(counting_allocator<U> const& other) const noexcept
+        {
+            return count == other.count;
+        }
+
+        template<class U>
+        bool
+        operator!=(counting_allocator<U> const& other) const noexcept
+        {
+            return count != other.count;
+        }
+    };
+}
+
+TEST_CASE("testSpecialMembers allocator", "basic_stream") {
+    using alloc_type = boost::beast::recycling_allocator<void>;
+    net::io_context ioc;
+    auto ex = ioc.get_executor();
+    using stream_type = boost::beast::basic_stream<tcp, executor,
+        boost::beast::simple_rate_policy>;
+    stream_type s1(std::allocator_arg, alloc_type{}, ioc);
+    stream_type s2(std::allocator_arg, alloc_type{}, ex, tcp::v4());
+    stream_type s3(std::allocator_arg, alloc_type{},
+        boost::beast::simple_rate_policy{}, ioc);
+    stream_type s4(std::move(s2));
+    REQUIRE(s1.get_executor() == ex);
+    REQUIRE(s3.get_executor() == ex);
+    REQUIRE(s4.get_executor() == ex);
+    REQUIRE(s4.socket().is_open());
+}
+
+TEST_CASE("testSpecialMembers allocator reuse", "basic_stream") {
+    using alloc_type = boost::beast::recycling_allocator<void>;
+    net::io_context ioc;
+    void const* p;
+    {
+        boost::beast::tcp_stream s(std::allocator_arg, alloc_type{}, ioc);
+        p = &s.socket();
+    }
+    {
+        boost::beast::tcp_stream s(std::allocator_arg, alloc_type{}, ioc);
+        REQUIRE(&s.socket() == p);
+    }
+}
+
+TEST_CASE("testSpecialMembers move allocator", "basic_stream") {
+    // a moved-to stream allocates its state like the original
+    net::io_context ioc;
+    std::size_t allocs = 0;
+    boost::beast::tcp_stream s1(std::allocator_arg,
+        counting_allocator<void>(allocs), ioc);
+    REQUIRE(allocs == 1);
+    s1.socket().open(tcp::v4());
+    boost::beast::tcp_stream s2(std::move(s1));
+    REQUIRE(allocs == 2);
+    REQUIRE(s2.socket().is_open());
+    REQUIRE(! s1.socket().is_open());
+    boost::beast::tcp_stream s3(std::move(s2));
+    REQUIRE(allocs == 3);
+    REQUIRE(s3.socket().is_open());
+}
+
+TEST_CASE("testSpecialMembers single threaded executor", "basic_stream") {
+    net::io_context ioc(1);
+    st_executor ex = net::require(ioc.get_executor(),
+        net::execution::allocator(std::allocator<int>{}));
+    using stream_type = boost::beast::basic_stream<tcp, st_executor>;
+    static_assert(boost::beast::AsyncReadStream<stream_type>);
+    static_assert(boost::beast::AsyncWriteStream<stream_type>);
+
+    tcp::acceptor a(ioc, tcp::endpoint(
+        net::ip::make_address("127.0.0.1"), 0));
+    tcp::socket peer(ioc);
+    stream_type s(ex);
+    s.socket().connect(a.local_endpoint());
+    a.accept(peer);
+    net::write(peer, net::buffer("*", 1));
+
+    char c = 0;
+    bool invoked = false;
+    s.expires_after(std::chrono::seconds(30));
+    s.async_read_some(net::buffer(&c, 1),
+        [&](std::error_code ec, std::size_t n)
+        {
+            REQUIRE(!ec);
+            REQUIRE(n == 1);
+            invoked = true;
+        });
+    ioc.run();
+    REQUIRE(invoked);
+    REQUIRE(c == '*');
+}
+
 using stream_type = boost::beast::basic_stream<tcp, executor>;
 TEST_CASE("testRead read_some", "basic_stream") {
     net::io_context ioc;
@@ -868,6 +1013,245 @@ TEST_CASE("testConnect async_connect abandoned operation", "basic_stream") {
     REQUIRE(checked);
 }
 
+namespace {
+    // A listener whose backlog is full, so that connection
+    // attempts to it are neither accepted nor refused
+    struct blackhole
+    {
+        net::io_context ioc;
+        net::ip::tcp::acceptor a;
+        net::ip::tcp::socket filler;
+        net::ip::tcp::endpoint ep;
+
+        explicit
+        blackhole(net::ip::address addr)
+            : a(ioc)
+            , filler(ioc)
+            , ep(addr, 0)
+        {
+            a.open(ep.protocol());
+            a.bind(ep);
+            a.listen(0);
+            ep = a.local_endpoint();
+            filler.connect(ep);
+        }
+    };
+
+    // An endpoint which refuses connections
+    net::ip::tcp::endpoint
+    refusing_endpoint()
+    {
+        net::io_context ioc;
+        net::ip::tcp::acceptor a(ioc,
+            net::ip::tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+        return a.local_endpoint();
+    }
+
+    struct race_result
+    {
+        bool invoked = false;
+        std::error_code ec;
+        tcp::endpoint ep;
+        std::chrono::steady_clock::duration elapsed{};
+    };
+
+    race_result
+    race(
+        stream_type& s,
+        std::vector<tcp::endpoint> const& eps,
+        std::chrono::steady_clock::duration delay)
+    {
+        race_result r;
+        auto const t0 = std::chrono::steady_clock::now();
+        s.async_race_connect(eps, delay,
+            [&](std::error_code ec, tcp::endpoint ep)
+            {
+                r.invoked = true;
+                r.ec = ec;
+                r.ep = ep;
+                r.elapsed = std::chrono::steady_clock::now() - t0;
+            });
+        s.get_executor().context().run();
+        s.get_executor().context().restart();
+        return r;
+    }
+}
+
+TEST_CASE("testConnect async_race_connect stalled first", "basic_stream") {
+    net::io_context ioc;
+    test_acceptor a;
+    blackhole bh(net::ip::make_address("127.0.0.1"));
+    stream_type s(ioc);
+    s.expires_after(std::chrono::seconds(30));
+    auto const r = race(s, {bh.ep, a.ep}, std::chrono::milliseconds(50));
+    REQUIRE(r.invoked);
+    REQUIRE(! r.ec);
+    REQUIRE(r.ep == a.ep);
+    REQUIRE(s.socket().remote_endpoint() == a.ep);
+    REQUIRE(r.elapsed < std::chrono::seconds(1));
+}
+
+TEST_CASE("testConnect async_race_connect refused first", "basic_stream") {
+    net::io_context ioc;
+    test_acceptor a;
+    stream_type s(ioc);
+    s.expires_never();
+
+    // a failure starts the next attempt without waiting for the delay
+    auto const r = race(s, {refusing_endpoint(), a.ep},
+        std::chrono::seconds(10));
+    REQUIRE(r.invoked);
+    REQUIRE(! r.ec);
+    REQUIRE(r.ep == a.ep);
+    REQUIRE(r.elapsed < std::chrono::seconds(5));
+}
+
+TEST_CASE("testConnect async_race_connect all refused", "basic_stream") {
+    net::io_context ioc;
+    stream_type s(ioc);
+    auto const r = race(s, {refusing_endpoint(), refusing_endpoint()},
+        std::chrono::milliseconds(50));
+    REQUIRE(r.invoked);
+    REQUIRE(r.ec == net::error::connection_refused);
+    REQUIRE(r.ep == tcp::endpoint());
+    REQUIRE(! s.socket().is_open());
+}
+
+TEST_CASE("testConnect async_race_connect empty", "basic_stream") {
+    net::io_context ioc;
+    stream_type s(ioc);
+    auto const r = race(s, {}, std::chrono::milliseconds(50));
+    REQUIRE(r.invoked);
+    REQUIRE(r.ec == net::error::not_found);
+}
+
+TEST_CASE("testConnect async_race_connect timeout", "basic_stream") {
+    net::io_context ioc;
+    blackhole bh1(net::ip::make_address("127.0.0.1"));
+    blackhole bh2(net::ip::make_address("127.0.0.1"));
+    stream_type s(ioc);
+    s.expires_after(std::chrono::milliseconds(200));
+    auto const r = race(s, {bh1.ep, bh2.ep}, std::chrono::milliseconds(50));
+    REQUIRE(r.invoked);
+    REQUIRE(r.ec == boost::beast::error::timeout);
+    REQUIRE(r.elapsed < std::chrono::seconds(1));
+}
+
+TEST_CASE("testConnect async_race_connect address families", "basic_stream") {
+    std::optional<blackhole> bh1;
+    std::optional<blackhole> bh2;
+    try
+    {
+        bh1.emplace(net::ip::make_address("::1"));
+        bh2.emplace(net::ip::make_address("::1"));
+    }
+    catch(std::system_error const&)
+    {
+        WARN("IPv6 loopback unavailable");
+        return;
+    }
+    net::io_context ioc;
+    test_acceptor a;
+    stream_type s(ioc);
+    s.expires_after(std::chrono::seconds(30));
+
+    // The IPv4 endpoint is tried second, after one delay,
+    // rather than after both of the IPv6 endpoints
+    auto const r = race(s, {bh1->ep, bh2->ep, a.ep},
+        std::chrono::milliseconds(500));
+    REQUIRE(r.invoked);
+    REQUIRE(! r.ec);
+    REQUIRE(r.ep == a.ep);
+    REQUIRE(r.elapsed >= std::chrono::milliseconds(500));
+    REQUIRE(r.elapsed < std::chrono::milliseconds(900));
+}
+
+TEST_CASE("testConnect async_race_connect threads", "basic_stream") {
+    net::io_context ioc;
+    test_acceptor a;
+    std::vector<tcp::endpoint> const eps{
+        refusing_endpoint(), refusing_endpoint(), a.ep};
+    std::size_t constexpr n = 32;
+    std::atomic<std::size_t> connected{0};
+    std::vector<std::unique_ptr<stream_type>> streams;
+
+    // with no delay, the attempts, the delay timer
+    // and the failures all race with each other
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        streams.push_back(std::make_unique<stream_type>(ioc));
+        streams.back()->async_race_connect(eps,
+            std::chrono::milliseconds(0),
+            [&](std::error_code ec, tcp::endpoint ep)
+            {
+                if(! ec && ep == a.ep)
+                    ++connected;
+            });
+    }
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 4; ++i)
+        threads.emplace_back([&ioc]{ ioc.run(); });
+    for(auto& t : threads)
+        t.join();
+    REQUIRE(connected == n);
+    for(auto& s : streams)
+        REQUIRE(s->socket().remote_endpoint() == a.ep);
+}
+
+TEST_CASE("testConnect async_race_connect allocator", "basic_stream") {
+    struct handler
+    {
+        using allocator_type = counting_allocator<void>;
+
+        allocator_type alloc;
+        bool* invoked;
+
+        allocator_type
+        get_allocator() const noexcept
+        {
+            return alloc;
+        }
+
+        void
+        operator()(std::error_code ec, tcp::endpoint)
+        {
+            *invoked = ! ec;
+        }
+    };
+
+    net::io_context ioc;
+    test_acceptor a;
+    stream_type s(ioc);
+    std::size_t allocs = 0;
+    bool invoked = false;
+    s.async_race_connect(std::vector<tcp::endpoint>{a.ep},
+        std::chrono::milliseconds(250),
+        handler{counting_allocator<void>(allocs), &invoked});
+    REQUIRE(allocs > 0);
+    ioc.run();
+    REQUIRE(invoked);
+}
+
+TEST_CASE("testConnect async_race_connect resolver results", "basic_stream") {
+    net::io_context ioc;
+    test_acceptor a;
+    stream_type s(ioc);
+    tcp::resolver resolver(ioc);
+    auto const results = resolver.resolve("127.0.0.1",
+        std::to_string(a.ep.port()),
+        tcp::resolver::numeric_host | tcp::resolver::numeric_service);
+    bool invoked = false;
+    s.async_race_connect(results, std::chrono::milliseconds(250),
+        [&](std::error_code ec, tcp::endpoint ep)
+        {
+            invoked = true;
+            REQUIRE(! ec);
+            REQUIRE(ep == a.ep);
+        });
+    ioc.run();
+    REQUIRE(invoked);
+}
+
 namespace {
     class member_handler
     {
@@ -1035,3 +1419,82 @@ TEST_CASE("testIssue2065", "basic_stream") {
         ioc.restart();
     }
 }
+
+#if BOOST_BEAST_HAS_IO_URING
+TEST_CASE("basic_stream io_uring", "basic_stream") {
+    net::io_context ioc;
+    tcp::acceptor a(ioc, tcp::endpoint(
+        net::ip::make_address("127.0.0.1"), 0));
+    auto const connect =
+        [&](stream_type& s1, stream_type& s2)
+        {
+            s1.socket().connect(a.local_endpoint());
+            a.accept(s2.socket());
+        };
+
+    auto const svc =
+        boost::beast::detail::io_uring_service::find(ioc);
+    REQUIRE(svc != nullptr);
+
+    // a transfer goes through the ring
+    {
+        stream_type s1(ioc);
+        stream_type s2(ioc);
+        connect(s1, s2);
+        char out[5] = {'h', 'e', 'l', 'l', 'o'};
+        char in[5] = {};
+        std::size_t n = 0;
+        s1.async_write_some(net::buffer(out),
+            [&](std::error_code ec, std::size_t)
+            {
+                REQUIRE(! ec);
+            });
+        s2.async_read_some(net::buffer(in),
+            [&](std::error_code ec, std::size_t bytes)
+            {
+                REQUIRE(! ec);
+                n = bytes;
+            });
+        ioc.run();
+        ioc.restart();
+        REQUIRE(n == 5);
+        REQUIRE(std::string_view(in, n) == "hello");
+        REQUIRE(svc->stats().submitted == 2);
+    }
+
+    // close cancels a pending read
+    {
+        stream_type s1(ioc);
+        stream_type s2(ioc);
+        connect(s1, s2);
+        char in[5];
+        bool aborted = false;
+        s2.async_read_some(net::buffer(in),
+            [&](std::error_code ec, std::size_t)
+            {
+                aborted = ec == net::error::operation_aborted;
+            });
+        net::post(ioc, [&]{ s2.close(); });
+        ioc.run();
+        ioc.restart();
+        REQUIRE(aborted);
+    }
+
+    // a timeout cancels a pending read
+    {
+        stream_type s1(ioc);
+        stream_type s2(ioc);
+        connect(s1, s2);
+        char in[5];
+        bool timeout = false;
+        s1.expires_after(std::chrono::milliseconds(10));
+        s1.async_read_some(net::buffer(in),
+            [&](std::error_code ec, std::size_t)
+            {
+                timeout = ec == boost::beast::error::timeout;
+            });
+        ioc.run();
+        REQUIRE(timeout);
+    }
+}
+#endif
@@ -0,0 +1,153 @@
+#include "catch.hpp"
+
+#include <boost/beast/core/buffers_flatten.hpp>
+#include <boost/beast/core/buffers_cat.hpp>
+#include <boost/beast/core/buffers_prefix.hpp>
+#include <boost/beast/core/buffers_suffix.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/http/serializer.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <asio/buffer.hpp>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "test_buffer.hpp"
+
+namespace net = asio;
+using namespace boost::beast;
+
+namespace {
+
+template<class BufferSequence>
+std::size_t
+count_non_empty(BufferSequence const& bs)
+{
+    std::size_t n = 0;
+    for(auto it = net::buffer_sequence_begin(bs),
+        end = net::buffer_sequence_end(bs); it != end; ++it)
+        if(net::const_buffer(*it).size() > 0)
+            ++n;
+    return n;
+}
+
+// Flattening gives the same bytes and buffers as iterating
+template<class BufferSequence>
+void
+check(BufferSequence const& bs)
+{
+    auto const a = buffers_flatten<64>(bs);
+    REQUIRE(buffers_to_string(a) == buffers_to_string(bs));
+    REQUIRE(a.count() == count_non_empty(bs));
+    for(auto const& b : a)
+        REQUIRE(b.size() > 0);
+}
+
+} // (anon)
+
+TEST_CASE("buffers_flatten sequences", "buffers_flatten") {
+    std::string const s = "Hello, world! This is a test.";
+    net::const_buffer b1(s.data(), 6);
+    net::const_buffer b2(s.data() + 6, 0);
+    std::vector<net::const_buffer> v{
+        net::const_buffer(s.data() + 6, 7),
+        net::const_buffer(s.data() + 13, 0),
+        net::const_buffer(s.data() + 13, 9)};
+    net::const_buffer b3(s.data() + 22, s.size() - 22);
+
+    check(b1);
+    check(v);
+    check(net::const_buffer{});
+    check(buffers_cat(b1, b2, v, b3));
+    check(buffers_cat(b2, buffers_cat(b1, v), b2, b3));
+
+    // every suffix and prefix of a nested concatenation
+    auto const cat = buffers_cat(b1, buffers_cat(b2, v), b3);
+    for(std::size_t i = 0; i <= s.size(); ++i)
+    {
+        buffers_suffix<decltype(cat)> cb(cat);
+        cb.consume(i);
+        check(cb);
+        REQUIRE(buffers_to_string(buffers_flatten<8>(cb)) ==
+            s.substr(i));
+        for(std::size_t j = 0; j <= s.size() - i; ++j)
+        {
+            auto const pb = buffers_prefix(j, cb);
+            check(pb);
+            REQUIRE(buffers_to_string(buffers_flatten<8>(pb)) ==
+                s.substr(i, j));
+
+            // a prefix in the middle of a concatenation
+            check(buffers_cat(pb, b3));
+        }
+    }
+}
+
+TEST_CASE("buffers_flatten capacity", "buffers_flatten") {
+    std::string const s = "abcdef";
+    std::vector<net::const_buffer> v;
+    for(std::size_t i = 0; i < s.size(); ++i)
+        v.emplace_back(s.data() + i, 1);
+    auto const a = buffers_flatten<4>(buffers_cat(
+        net::const_buffer(s.data(), 0), v));
+    REQUIRE(a.count() == 4);
+    REQUIRE(decltype(a)::max_count == 4);
+    REQUIRE(buffers_to_string(a) == "abcd");
+    test_buffer_sequence(a);
+}
+
+TEST_CASE("buffers_flatten mutable", "buffers_flatten") {
+    char buf[10] = {};
+    auto const a = buffers_flatten<4>(buffers_cat(
+        net::mutable_buffer(buf, 5),
+        net::mutable_buffer(buf + 5, 5)));
+    static_assert(std::is_same<
+        decltype(a)::value_type, net::mutable_buffer>::value, "");
+    net::buffer_copy(a, net::buffer(std::string("0123456789")));
+    REQUIRE(std::string(buf, 10) == "0123456789");
+    REQUIRE(std::is_same<decltype(buffers_flatten<4>(
+        buffers_cat(net::mutable_buffer(buf, 5),
+            net::const_buffer(buf, 5))))::value_type,
+                net::const_buffer>::value);
+}
+
+TEST_CASE("buffers_flatten serializer", "buffers_flatten") {
+    // the sequences produced for each kind of message
+    auto const run =
+        [](auto& m, std::size_t limit)
+        {
+            http::serializer<true,
+                typename std::decay_t<decltype(m)>::body_type> sr(m);
+            sr.limit(limit);
+            std::string out;
+            while(! sr.is_done())
+            {
+                error_code ec;
+                sr.next(ec,
+                    [&](error_code&, auto const& buffers)
+                    {
+                        check(buffers);
+                        auto const a = buffers_flatten<64>(buffers);
+                        auto const n = buffer_bytes(a);
+                        out += buffers_to_string(a);
+                        sr.consume(n);
+                    });
+                REQUIRE(! ec);
+            }
+            return out;
+        };
+    for(std::size_t limit : {7, 100, 100000})
+    {
+        http::request<http::string_body> req{
+            http::verb::post, "/", 11};
+        req.set(http::field::host, "example.com");
+        req.body() = std::string(5000, 'x');
+        req.prepare_payload();
+        auto const sized = run(req, limit);
+        REQUIRE(sized.size() > 5000);
+
+        req.chunked(true);
+        auto const chunked = run(req, limit);
+        REQUIRE(chunked.find("1388\r\n") != std::string::npos);
+        REQUIRE(chunked.substr(chunked.size() - 5) == "0\r\n\r\n");
+    }
+}
@@ -0,0 +1,214 @@
+#include "catch.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <asio/buffer.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/read.hpp>
+#include <boost/beast/core/buffered_read_stream.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/circular_buffer.hpp>
+#include <boost/beast/core/ostream.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/websocket/stream.hpp>
+#include "stream.hpp"
+#include "test_buffer.hpp"
+
+namespace net = asio;
+using namespace boost::beast;
+
+namespace {
+
+std::string
+make_data(std::size_t n, std::size_t seed)
+{
+    std::string s;
+    for(std::size_t i = 0; i < n; ++i)
+        s.push_back(static_cast<char>('a' + (i + seed) % 26));
+    return s;
+}
+
+void
+append(circular_buffer& b, std::string const& s)
+{
+    b.commit(net::buffer_copy(b.prepare(s.size()), net::buffer(s)));
+}
+
+std::size_t
+count(circular_buffer::const_buffers_type const& bs)
+{
+    return static_cast<std::size_t>(
+        std::distance(bs.begin(), bs.end()));
+}
+
+} // (anon)
+
+TEST_CASE("circular_buffer testDynamicBuffer", "circular_buffer") {
+    circular_buffer b(30);
+    REQUIRE(b.max_size() == 30);
+    test_dynamic_buffer(b);
+    test_dynamic_buffer(circular_buffer{});
+}
+
+TEST_CASE("circular_buffer members", "circular_buffer") {
+    circular_buffer b;
+    REQUIRE(b.capacity() == 0);
+    b.reserve(1000);
+    REQUIRE(b.capacity() == 1024);
+    b.reserve(10);
+    REQUIRE(b.capacity() == 1024);
+    ostream(b) << "Hello";
+    b.shrink_to_fit();
+    REQUIRE(b.capacity() == circular_buffer::min_capacity);
+    REQUIRE(buffers_to_string(b.data()) == "Hello");
+    b.clear();
+    REQUIRE(b.size() == 0);
+    b.shrink_to_fit();
+    REQUIRE(b.capacity() == 0);
+
+    circular_buffer b2(10);
+    REQUIRE_THROWS_AS(b2.reserve(11), std::length_error);
+    REQUIRE_THROWS_AS(b2.prepare(11), std::length_error);
+    b2.max_size(20);
+    b2.reserve(11);
+    REQUIRE(b2.capacity() == circular_buffer::min_capacity);
+}
+
+TEST_CASE("circular_buffer wrap", "circular_buffer") {
+    // small storage is ordinary memory, and wraps in two pieces
+    for(std::size_t capacity : {512u, 8192u, 65536u})
+    {
+        circular_buffer b;
+        b.reserve(capacity);
+        REQUIRE(b.capacity() == capacity);
+        std::string expected;
+        std::size_t seed = 0;
+        bool wrapped = false;
+        for(std::size_t i = 0; i < 200; ++i)
+        {
+            auto const s = make_data(
+                capacity / 3 + i % 17, seed++);
+            if(b.size() + s.size() > capacity)
+            {
+                auto const n = b.size() / 2 + 1;
+                b.consume(n);
+                expected.erase(0, n);
+            }
+            append(b, s);
+            expected += s;
+            REQUIRE(b.capacity() == capacity);
+            REQUIRE(buffers_to_string(b.data()) == expected);
+            if(b.mirrored())
+                REQUIRE(count(b.data()) == 1);
+            else if(count(b.data()) == 2)
+                wrapped = true;
+        }
+        REQUIRE(wrapped != b.mirrored());
+#if defined(__linux__) && ! defined(BOOST_BEAST_NO_MIRRORED_BUFFER)
+        REQUIRE(b.mirrored() == (capacity >= 8192));
+#endif
+
+        // growing keeps the readable bytes
+        append(b, make_data(capacity, 7));
+        expected += make_data(capacity, 7);
+        REQUIRE(b.capacity() >= 2 * capacity);
+        REQUIRE(buffers_to_string(b.data()) == expected);
+
+        // copies and moves keep the readable bytes
+        circular_buffer b2(b);
+        REQUIRE(buffers_to_string(b2.data()) == expected);
+        circular_buffer b3(std::move(b2));
+        REQUIRE(b2.capacity() == 0);
+        REQUIRE(buffers_to_string(b3.data()) == expected);
+    }
+}
+
+TEST_CASE("circular_buffer http read", "circular_buffer") {
+    std::string wire;
+    std::vector<std::string> bodies;
+    for(std::size_t i = 0; i < 50; ++i)
+    {
+        bodies.push_back(make_data(100 + i * 331, i));
+        wire +=
+            "POST / HTTP/1.1\r\n"
+            "Content-Length: " + std::to_string(bodies.back().size()) +
+            "\r\n\r\n" + bodies.back();
+    }
+    net::io_context ioc;
+    test::stream ts(ioc, wire);
+    ts.read_size(1000);
+    circular_buffer b;
+    std::size_t i = 0;
+    std::function<void()> next =
+        [&]
+        {
+            auto req = std::make_shared<
+                http::request<http::string_body>>();
+            http::async_read(ts, b, *req,
+                [&, req](error_code ec, std::size_t)
+                {
+                    REQUIRE(! ec);
+                    REQUIRE(req->body() == bodies[i]);
+                    if(++i < bodies.size())
+                        next();
+                });
+        };
+    next();
+    ioc.run();
+    REQUIRE(i == bodies.size());
+    REQUIRE(b.size() == 0);
+}
+
+TEST_CASE("circular_buffer buffered_read_stream", "circular_buffer") {
+    auto const s = make_data(100000, 3);
+    net::io_context ioc;
+    buffered_read_stream<test::stream, circular_buffer> brs(ioc, s);
+    brs.capacity(4096);
+    brs.next_layer().read_size(3000);
+    std::string got(s.size(), 0);
+    net::read(brs, net::buffer(got));
+    REQUIRE(got == s);
+}
+
+TEST_CASE("circular_buffer websocket read", "circular_buffer") {
+    using tcp = net::ip::tcp;
+    net::io_context ioc;
+    tcp::acceptor acceptor(ioc,
+        tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+    websocket::stream<tcp::socket> client(ioc);
+    websocket::stream<tcp::socket> server(ioc);
+    client.next_layer().connect(acceptor.local_endpoint());
+    acceptor.accept(server.next_layer());
+    std::thread t(
+        [&]
+        {
+            server.accept();
+            for(std::size_t i = 0; i < 40; ++i)
+                server.write(net::buffer(make_data(i * 1237, i)));
+        });
+    client.handshake("localhost", "/");
+    circular_buffer b;
+    std::string left;
+    for(std::size_t i = 0; i < 40; ++i)
+    {
+        client.async_read(b,
+            [&](error_code ec, std::size_t bytes)
+            {
+                REQUIRE(! ec);
+                REQUIRE(bytes == i * 1237);
+            });
+        ioc.restart();
+        ioc.run();
+        REQUIRE(buffers_to_string(b.data()) ==
+            left + make_data(i * 1237, i));
+
+        // keep some bytes so later messages wrap around
+        b.consume(b.size() - b.size() / 3);
+        left = buffers_to_string(b.data());
+    }
+    t.join();
+}
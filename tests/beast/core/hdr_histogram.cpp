@@ -0,0 +1,92 @@
+#include "catch.hpp"
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <boost/beast/core/hdr_histogram.hpp>
+
+using namespace boost::beast;
+
+TEST_CASE("hdr_histogram empty", "hdr_histogram") {
+    hdr_histogram h;
+    REQUIRE(h.count() == 0);
+    REQUIRE(h.min() == 0);
+    REQUIRE(h.max() == 0);
+    REQUIRE(h.mean() == 0);
+    REQUIRE(h.value_at_percentile(50) == 0);
+}
+
+TEST_CASE("hdr_histogram percentiles", "hdr_histogram") {
+    hdr_histogram h;
+    for(std::uint64_t v = 1; v <= 10000; ++v)
+        h.record(v * 1000);
+    REQUIRE(h.count() == 10000);
+    REQUIRE(h.min() == 1000);
+    REQUIRE(h.max() == 10000000);
+    REQUIRE(h.mean() == 5000500);
+
+    // within the precision of the buckets, and never below
+    auto const near =
+        [&](double p, std::uint64_t expected)
+        {
+            auto const v = h.value_at_percentile(p);
+            REQUIRE(v >= expected);
+            REQUIRE(v - expected <= expected / 64);
+        };
+    near(50, 5000000);
+    near(90, 9000000);
+    near(99, 9900000);
+    near(99.9, 9990000);
+    REQUIRE(h.value_at_percentile(100) == h.max());
+    REQUIRE(h.value_at_percentile(0) == h.value_at_percentile(0.001));
+    REQUIRE(h.value_at_percentile(0) < 1000 + 1000 / 64);
+}
+
+TEST_CASE("hdr_histogram range", "hdr_histogram") {
+    hdr_histogram h;
+    // small values are exact
+    for(std::uint64_t v = 0; v < 128; ++v)
+    {
+        h.reset();
+        h.record(v);
+        h.record(1000);
+        REQUIRE(h.value_at_percentile(50) == v);
+    }
+
+    auto const big = (std::numeric_limits<std::uint64_t>::max)();
+    h.reset();
+    h.record(big);
+    h.record(big / 3, 3);
+    REQUIRE(h.count() == 4);
+    REQUIRE(h.max() == big);
+    REQUIRE(h.value_at_percentile(100) == big);
+    auto const v = h.value_at_percentile(50);
+    REQUIRE(v >= big / 3);
+    REQUIRE(v - big / 3 <= big / 3 / 64);
+}
+
+TEST_CASE("hdr_histogram merge", "hdr_histogram") {
+    hdr_histogram a;
+    hdr_histogram b;
+    std::thread t(
+        [&]
+        {
+            for(std::uint64_t v = 0; v < 100000; ++v)
+                b.record(500 + v % 100);
+        });
+    for(std::uint64_t v = 0; v < 100000; ++v)
+        a.record(100 + v % 100);
+    t.join();
+
+    hdr_histogram c(a);
+    c.merge(b);
+    REQUIRE(c.count() == 200000);
+    REQUIRE(c.min() == 100);
+    REQUIRE(c.max() == 599);
+    REQUIRE(c.value_at_percentile(50) < 200);
+    REQUIRE(c.value_at_percentile(51) >= 500);
+
+    c = b;
+    REQUIRE(c.count() == 100000);
+    REQUIRE(c.min() == 500);
+    REQUIRE(c.mean() == b.mean());
+}
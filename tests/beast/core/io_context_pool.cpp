@@ -0,0 +1,157 @@
+#include "catch.hpp"
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <asio/post.hpp>
+#include <boost/beast/core/io_context_pool.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+
+namespace net = asio;
+using boost::beast::io_context_pool;
+
+TEST_CASE("io_context_pool round robin", "io_context_pool") {
+    io_context_pool pool(3);
+    REQUIRE(pool.size() == 3);
+    REQUIRE(pool.get_executor() == pool.at(0).get_executor());
+    REQUIRE(pool.get_executor() == pool.at(1).get_executor());
+    REQUIRE(pool.get_executor() == pool.at(2).get_executor());
+    REQUIRE(pool.get_executor() == pool.at(0).get_executor());
+}
+
+TEST_CASE("io_context_pool least loaded", "io_context_pool") {
+    io_context_pool::options opt;
+    opt.size = 3;
+    opt.policy = io_context_pool::assignment::least_loaded;
+    io_context_pool pool(opt);
+    auto l0 = pool.acquire();
+    auto l1 = pool.acquire();
+    auto l2 = pool.acquire();
+    std::set<std::size_t> used{l0.index(), l1.index(), l2.index()};
+    REQUIRE(used.size() == 3);
+    REQUIRE(pool.load(l1.index()) == 1);
+    auto const freed = l1.index();
+    l1 = {};
+    REQUIRE(pool.load(freed) == 0);
+    auto l3 = pool.acquire();
+    REQUIRE(l3.index() == freed);
+    REQUIRE(l3.get_executor() == pool.at(freed).get_executor());
+}
+
+TEST_CASE("io_context_pool one thread per context", "io_context_pool") {
+    io_context_pool pool(4);
+    pool.run();
+    std::atomic<int> done{0};
+    std::thread::id ids[4];
+    for(std::size_t i = 0; i < pool.size(); ++i)
+        net::post(pool.at(i),
+            [&, i]
+            {
+                ids[i] = std::this_thread::get_id();
+                ++done;
+            });
+    while(done != 4)
+        std::this_thread::yield();
+    pool.stop();
+    pool.join();
+    std::set<std::thread::id> unique(ids, ids + 4);
+    REQUIRE(unique.size() == 4);
+    REQUIRE(unique.count(std::this_thread::get_id()) == 0);
+}
+
+TEST_CASE("io_context_pool release", "io_context_pool") {
+    io_context_pool pool(2);
+    std::atomic<int> n{0};
+    pool.run();
+    for(int i = 0; i < 100; ++i)
+        pool.post([&]{ ++n; });
+    pool.release();
+    pool.join();
+    REQUIRE(n == 100);
+}
+
+TEST_CASE("io_context_pool restart", "io_context_pool") {
+    // after stop, run starts threads which wait for work again
+    io_context_pool pool(2);
+    pool.run();
+    pool.stop();
+    pool.join();
+    pool.run();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::atomic<int> n{0};
+    for(std::size_t i = 0; i < pool.size(); ++i)
+        net::post(pool.at(i), [&]{ ++n; });
+    auto const until = std::chrono::steady_clock::now() +
+        std::chrono::seconds(10);
+    while(n != 2 && std::chrono::steady_clock::now() < until)
+        std::this_thread::yield();
+    REQUIRE(n == 2);
+    pool.stop();
+    pool.join();
+}
+
+TEST_CASE("io_context_pool work stealing", "io_context_pool") {
+    io_context_pool pool(4);
+    std::atomic<int> n{0};
+
+    // queue everything on context 0 while its thread is blocked
+    std::atomic<bool> go{false};
+    net::post(pool.at(0), [&]{ while(! go) std::this_thread::yield(); });
+    pool.run();
+    net::post(pool.at(0),
+        [&]
+        {
+            for(int i = 0; i < 64; ++i)
+                pool.post(
+                    [&]
+                    {
+                        std::this_thread::sleep_for(
+                            std::chrono::milliseconds(1));
+                        ++n;
+                    });
+        });
+    go = true;
+    while(n != 64)
+        std::this_thread::yield();
+    pool.stop();
+    pool.join();
+    std::size_t stolen = 0;
+    std::size_t executed = 0;
+    for(std::size_t i = 0; i < pool.size(); ++i)
+    {
+        stolen += pool.stolen(i);
+        executed += pool.executed(i);
+    }
+    REQUIRE(executed == 64);
+    REQUIRE(stolen > 0);
+    REQUIRE(pool.executed(0) < 64);
+}
+
+TEST_CASE("io_context_pool no stealing", "io_context_pool") {
+    io_context_pool::options opt;
+    opt.size = 2;
+    opt.work_stealing = false;
+    opt.pin_threads = true;
+    io_context_pool pool(opt);
+    std::atomic<int> n{0};
+    pool.run();
+    net::post(pool.at(1),
+        [&]
+        {
+            for(int i = 0; i < 32; ++i)
+                pool.post([&]{ ++n; });
+        });
+    pool.release();
+    pool.join();
+    REQUIRE(n == 32);
+    REQUIRE(pool.executed(1) == 32);
+    REQUIRE(pool.stolen(0) == 0);
+}
+
+TEST_CASE("io_context_pool streams", "io_context_pool") {
+    io_context_pool pool(2);
+    boost::beast::tcp_stream s0(pool.get_executor());
+    boost::beast::tcp_stream s1(pool.get_executor());
+    REQUIRE(s0.get_executor() == pool.at(0).get_executor());
+    REQUIRE(s1.get_executor() == pool.at(1).get_executor());
+}
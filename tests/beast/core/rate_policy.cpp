@@ -0,0 +1,204 @@
+#include "catch.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/strand.hpp>
+#include <boost/beast/core/basic_stream.hpp>
+#include <boost/beast/core/rate_policy.hpp>
+
+namespace net = asio;
+using tcp = net::ip::tcp;
+using clock_type = std::chrono::steady_clock;
+using boost::beast::detail::token_bucket;
+using boost::beast::shared_rate_policy;
+
+TEST_CASE("token_bucket unlimited", "rate_policy") {
+    token_bucket b;
+    auto const now = clock_type::now();
+    REQUIRE(b.unlimited());
+    REQUIRE(b.available(now) == token_bucket::all);
+    REQUIRE(b.acquire(12345, now) == 12345);
+}
+
+TEST_CASE("token_bucket burst and refill", "rate_policy") {
+    token_bucket b;
+    b.limit(1000, 100, 100);
+    auto const now = clock_type::now();
+    REQUIRE(b.available(now) == 100);
+    REQUIRE(b.acquire(60, now) == 60);
+    REQUIRE(b.acquire(60, now) == 40);
+    REQUIRE(b.acquire(60, now) == 0);
+
+    // 1000 bytes per second is one byte per millisecond
+    auto const later = now + std::chrono::milliseconds(50);
+    REQUIRE(b.available(later) >= 49);
+    REQUIRE(b.available(later) <= 50);
+
+    // never more than one burst, however long we wait
+    REQUIRE(b.available(now + std::chrono::hours(1)) == 100);
+}
+
+TEST_CASE("token_bucket quantum", "rate_policy") {
+    token_bucket b;
+    b.limit(1000, 100, 10);
+    auto const now = clock_type::now();
+    REQUIRE(b.acquire(60, now) == 10);
+    REQUIRE(b.available(now) == 90);
+}
+
+TEST_CASE("token_bucket release and consume", "rate_policy") {
+    token_bucket b;
+    b.limit(1000, 100, 100);
+    auto const now = clock_type::now();
+    REQUIRE(b.acquire(100, now) == 100);
+    b.release(30);
+    REQUIRE(b.available(now) == 30);
+    b.consume(80, now);
+    REQUIRE(b.available(now) == 0);
+    REQUIRE(b.available(now + std::chrono::milliseconds(40)) == 0);
+    REQUIRE(b.available(now + std::chrono::milliseconds(60)) > 0);
+}
+
+TEST_CASE("token_bucket delay", "rate_policy") {
+    token_bucket b;
+    b.limit(1000, 100, 20);
+    auto const now = clock_type::now();
+    REQUIRE(b.acquire(100, now) == 20);
+    while(b.acquire(100, now) != 0)
+    {
+    }
+    auto const d = b.delay(now, std::chrono::milliseconds(1));
+    REQUIRE(d >= std::chrono::milliseconds(19));
+    REQUIRE(d <= std::chrono::milliseconds(21));
+    REQUIRE(b.available(now + d) >= 19);
+}
+
+TEST_CASE("token_bucket concurrent acquire", "rate_policy") {
+    std::size_t constexpr rate = 1000000;
+    std::size_t constexpr burst = 10000;
+    token_bucket b;
+    b.limit(rate, burst, 1000);
+
+    std::atomic<std::size_t> total{0};
+    auto const start = clock_type::now();
+    auto const stop = start + std::chrono::milliseconds(200);
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 8; ++i)
+        threads.emplace_back(
+            [&]
+            {
+                std::size_t n = 0;
+                for(auto now = clock_type::now(); now < stop;
+                    now = clock_type::now())
+                    n += b.acquire(4096, now);
+                total += n;
+            });
+    for(auto& t : threads)
+        t.join();
+    auto const elapsed = std::chrono::duration<double>(
+        clock_type::now() - start).count();
+    REQUIRE(total.load() <= rate * elapsed + burst);
+    REQUIRE(total.load() >= rate * 0.1);
+}
+
+TEST_CASE("shared_rate_policy construction", "rate_policy") {
+    net::io_context ioc;
+    auto limits = std::make_shared<shared_rate_policy::group>();
+    using stream_type = boost::beast::basic_stream<tcp,
+        net::io_context::executor_type, shared_rate_policy>;
+    stream_type s1(ioc);
+    stream_type s2(shared_rate_policy(limits), ioc);
+    stream_type s3(limits, ioc);
+    stream_type s4(std::move(s3));
+    REQUIRE(&s2.rate_policy().limits() == limits.get());
+    REQUIRE(&s4.rate_policy().limits() == limits.get());
+    REQUIRE(&s1.rate_policy().limits() != limits.get());
+}
+
+TEST_CASE("shared_rate_policy aggregate write limit", "rate_policy") {
+    using stream_type = boost::beast::basic_stream<tcp,
+        net::strand<net::io_context::executor_type>,
+        shared_rate_policy>;
+
+    std::size_t constexpr rate = 2 * 1024 * 1024;
+    std::size_t constexpr burst = 64 * 1024;
+    std::size_t constexpr streams = 16;
+    auto const duration = std::chrono::milliseconds(500);
+
+    net::io_context ioc;
+    auto limits = std::make_shared<shared_rate_policy::group>();
+    limits->write_limit(rate, burst);
+
+    tcp::acceptor acceptor(ioc, tcp::endpoint(
+        net::ip::make_address_v4("127.0.0.1"), 0));
+    std::vector<std::unique_ptr<tcp::socket>> peers;
+    std::vector<std::unique_ptr<stream_type>> clients;
+    for(std::size_t i = 0; i < streams; ++i)
+    {
+        clients.push_back(std::make_unique<stream_type>(
+            limits, net::make_strand(ioc)));
+        clients.back()->connect(acceptor.local_endpoint());
+        peers.push_back(std::make_unique<tcp::socket>(
+            net::make_strand(ioc)));
+        acceptor.accept(*peers.back());
+    }
+
+    // the peers drain everything, as fast as possible
+    std::vector<std::vector<char>> sinks(
+        streams, std::vector<char>(65536));
+    std::function<void(tcp::socket&, std::vector<char>&)> drain =
+        [&](tcp::socket& s, std::vector<char>& sink)
+        {
+            s.async_read_some(net::buffer(sink),
+                [&](std::error_code ec, std::size_t)
+                {
+                    if(! ec)
+                        drain(s, sink);
+                });
+        };
+    for(std::size_t i = 0; i < streams; ++i)
+        drain(*peers[i], sinks[i]);
+
+    // the clients write as fast as the policy lets them
+    std::atomic<std::size_t> total{0};
+    std::atomic<bool> done{false};
+    std::vector<char> const data(1024 * 1024);
+    std::function<void(stream_type&)> pump =
+        [&](stream_type& s)
+        {
+            s.async_write_some(net::buffer(data),
+                [&](std::error_code ec, std::size_t n)
+                {
+                    total += n;
+                    if(! ec && ! done)
+                        pump(s);
+                });
+        };
+    auto const start = clock_type::now();
+    for(auto& c : clients)
+        pump(*c);
+
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 4; ++i)
+        threads.emplace_back([&]{ ioc.run(); });
+    std::this_thread::sleep_for(duration);
+    done = true;
+    auto const elapsed = std::chrono::duration<double>(
+        clock_type::now() - start).count();
+    auto const written = total.load();
+    for(auto& c : clients)
+        net::post(c->get_executor(), [&c]{ c->close(); });
+    for(auto& p : peers)
+        net::post(p->get_executor(), [&p]{ p->close(); });
+    for(auto& t : threads)
+        t.join();
+
+    // the sum over all streams respects the shared limit
+    REQUIRE(written <= rate * elapsed + burst + 64 * 1024);
+    REQUIRE(written >= rate * elapsed / 2);
+}
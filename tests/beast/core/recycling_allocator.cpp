@@ -0,0 +1,72 @@
+#include "catch.hpp"
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <boost/beast/core/recycling_allocator.hpp>
+
+namespace {
+struct alignas(64) big
+{
+    char data[200];
+};
+}
+
+TEST_CASE("recycling_allocator reuse", "recycling_allocator") {
+    using alloc_type = boost::beast::recycling_allocator<big>;
+    alloc_type a;
+    auto const n0 = alloc_type::cached();
+    big* p = a.allocate(1);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(p) % 64 == 0);
+    a.deallocate(p, 1);
+    REQUIRE(alloc_type::cached() == n0 + 1);
+    big* q = a.allocate(1);
+    REQUIRE(q == p);
+    REQUIRE(alloc_type::cached() == n0);
+    a.deallocate(q, 1);
+}
+
+TEST_CASE("recycling_allocator arrays", "recycling_allocator") {
+    using alloc_type = boost::beast::recycling_allocator<big>;
+    alloc_type a;
+    auto const n0 = alloc_type::cached();
+    big* p = a.allocate(3);
+    a.deallocate(p, 3);
+    REQUIRE(alloc_type::cached() == n0);
+}
+
+TEST_CASE("recycling_allocator rebind", "recycling_allocator") {
+    boost::beast::recycling_allocator<void> a;
+    auto sp = std::allocate_shared<int>(a, 42);
+    REQUIRE(*sp == 42);
+    boost::beast::recycling_allocator<int> b(a);
+    REQUIRE(b == boost::beast::recycling_allocator<char>(b));
+}
+
+TEST_CASE("recycling_allocator cache limit", "recycling_allocator") {
+    using alloc_type = boost::beast::recycling_allocator<big>;
+    alloc_type a;
+    std::vector<big*> v;
+    for(int i = 0; i < BOOST_BEAST_RECYCLING_ALLOCATOR_CACHE_SIZE * 2; ++i)
+        v.push_back(a.allocate(1));
+    for(auto p : v)
+        a.deallocate(p, 1);
+    REQUIRE(alloc_type::cached() ==
+        BOOST_BEAST_RECYCLING_ALLOCATOR_CACHE_SIZE);
+}
+
+TEST_CASE("recycling_allocator cross thread", "recycling_allocator") {
+    using alloc_type = boost::beast::recycling_allocator<big>;
+    alloc_type a;
+    big* p = a.allocate(1);
+    std::size_t cached = 0;
+    std::thread t(
+        [&]
+        {
+            auto const n0 = alloc_type::cached();
+            a.deallocate(p, 1);
+            cached = alloc_type::cached() - n0;
+        });
+    t.join();
+    REQUIRE(cached == 1);
+}
@@ -0,0 +1,220 @@
+#include "catch.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <asio/buffer.hpp>
+#include <asio/io_context.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/ostream.hpp>
+#include <boost/beast/core/segment_pool.hpp>
+#include <boost/beast/http/dynamic_body.hpp>
+#include <boost/beast/http/read.hpp>
+#include "stream.hpp"
+#include "test_buffer.hpp"
+
+namespace net = asio;
+using namespace boost::beast;
+
+TEST_CASE("segment_pool reuse", "segment_pool") {
+    segment_pool::release();
+    auto const s0 = segment_pool::stats();
+    REQUIRE(s0.cached_bytes == 0);
+    REQUIRE(segment_pool::good_size(1) >= segment_pool::min_segment);
+    REQUIRE(segment_pool::good_size(16384) < 32768);
+    REQUIRE(segment_pool::good_size(segment_pool::good_size(5000)) ==
+        segment_pool::good_size(5000));
+    REQUIRE(segment_pool::good_size(1000000) == 1000000);
+
+    void* p = segment_pool::allocate(5000);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(p) %
+        alignof(std::max_align_t) == 0);
+    segment_pool::deallocate(p, 5000);
+    REQUIRE(segment_pool::stats().cached_bytes > 8192);
+    REQUIRE(segment_pool::stats().cached_bytes < 8192 + 128);
+
+    // any size in the same class gets the same segment
+    void* q = segment_pool::allocate(segment_pool::good_size(5000));
+    REQUIRE(q == p);
+    segment_pool::deallocate(q, segment_pool::good_size(5000));
+
+    void* big = segment_pool::allocate(1000000);
+    segment_pool::deallocate(big, 1000000);
+
+    auto const s = segment_pool::stats();
+    REQUIRE(s.allocations - s0.allocations == 2);
+    REQUIRE(s.reused - s0.reused == 1);
+    REQUIRE(s.heap_allocations - s0.heap_allocations == 1);
+    REQUIRE(s.oversize - s0.oversize == 1);
+
+    segment_pool::release();
+    REQUIRE(segment_pool::stats().cached_bytes == 0);
+    REQUIRE(segment_pool::stats().heap_frees - s0.heap_frees == 1);
+}
+
+TEST_CASE("segment_pool cache limit", "segment_pool") {
+    segment_pool::release();
+    std::vector<void*> v;
+    for(int i = 0; i < BOOST_BEAST_SEGMENT_POOL_CACHE_SIZE / 4096 * 2; ++i)
+        v.push_back(segment_pool::allocate(100));
+    for(auto p : v)
+        segment_pool::deallocate(p, 100);
+    REQUIRE(segment_pool::stats().cached_bytes <=
+        BOOST_BEAST_SEGMENT_POOL_CACHE_SIZE);
+    REQUIRE(segment_pool::stats().cached_bytes >
+        BOOST_BEAST_SEGMENT_POOL_CACHE_SIZE - 4096 - 128);
+    segment_pool::release();
+}
+
+TEST_CASE("segment_pool cross thread", "segment_pool") {
+    segment_pool::release();
+    auto const s0 = segment_pool::stats();
+    std::vector<void*> v;
+    for(int i = 0; i < 10; ++i)
+        v.push_back(segment_pool::allocate(20000));
+    std::thread t(
+        [&]
+        {
+            for(auto p : v)
+                segment_pool::deallocate(p, 20000);
+            // nothing is kept by the freeing thread
+            REQUIRE(segment_pool::stats().cached_bytes == 0);
+        });
+    t.join();
+
+    // the owner takes the segments back
+    void* p = segment_pool::allocate(20000);
+    auto const s = segment_pool::stats();
+    REQUIRE(s.remote_frees - s0.remote_frees == 10);
+    REQUIRE(s.reused - s0.reused == 1);
+    REQUIRE(s.cached_bytes > 9 * 32768);
+    REQUIRE(s.cached_bytes < 9 * (32768 + 128));
+    segment_pool::deallocate(p, 20000);
+    segment_pool::release();
+
+    // segments outlive the thread which allocated them
+    std::vector<void*> orphans;
+    std::thread t2(
+        [&]
+        {
+            for(int i = 0; i < 10; ++i)
+                orphans.push_back(segment_pool::allocate(i * 6000));
+            segment_pool::deallocate(orphans.back(), 9 * 6000);
+            orphans.pop_back();
+        });
+    t2.join();
+    for(std::size_t i = 0; i < orphans.size(); ++i)
+    {
+        std::memset(orphans[i], 'x', i * 6000);
+        segment_pool::deallocate(orphans[i], i * 6000);
+    }
+    REQUIRE(segment_pool::stats().cached_bytes == 0);
+}
+
+namespace {
+
+// Frees its segments when the thread exits, after the
+// pool of the thread has been destroyed
+struct late_free
+{
+    std::vector<void*> v;
+    bool* ran;
+
+    ~late_free()
+    {
+        for(auto p : v)
+            segment_pool::deallocate(p, 5000);
+        // the pool is not recreated
+        void* p = segment_pool::allocate(5000);
+        segment_pool::deallocate(p, 5000);
+        *ran = segment_pool::stats().allocations == 0;
+    }
+};
+
+} // (anon)
+
+TEST_CASE("segment_pool thread exit", "segment_pool") {
+    bool ran = false;
+    std::thread t(
+        [&]
+        {
+            // constructed before the pool, destroyed after it
+            thread_local late_free f;
+            f.ran = &ran;
+            for(int i = 0; i < 3; ++i)
+                f.v.push_back(segment_pool::allocate(5000));
+            segment_pool::deallocate(f.v.back(), 5000);
+            f.v.back() = segment_pool::allocate(5000);
+        });
+    t.join();
+    REQUIRE(ran);
+}
+
+TEST_CASE("segment_allocator", "segment_pool") {
+    segment_allocator<void> a;
+    segment_allocator<int> b(a);
+    REQUIRE(b == segment_allocator<char>(b));
+    REQUIRE(b.good_size(1) * sizeof(int) ==
+        segment_pool::good_size(sizeof(int)));
+    auto const p = b.allocate(b.good_size(1));
+    p[b.good_size(1) - 1] = 42;
+    b.deallocate(p, b.good_size(1));
+}
+
+TEST_CASE("pooled_multi_buffer", "segment_pool") {
+    pooled_multi_buffer b0(30);
+    test_dynamic_buffer(b0);
+
+    // each element fills a segment
+    pooled_multi_buffer b;
+    b.prepare(100);
+    REQUIRE(b.capacity() >= 4096);
+    REQUIRE(b.capacity() < 4096 + 128);
+
+    // an allocator without good_size gets exactly what is asked
+    multi_buffer m;
+    m.prepare(100);
+    REQUIRE(m.capacity() == 512);
+    std::string s(100000, 'a');
+    ostream(b) << s;
+    REQUIRE(buffers_to_string(b.data()) == s);
+
+    // freeing the buffer on another thread
+    std::thread t([b = std::move(b)]() mutable
+        {
+            b.consume(b.size());
+            b.shrink_to_fit();
+        });
+    t.join();
+    segment_pool::release();
+}
+
+TEST_CASE("segment_pool dynamic_body", "segment_pool") {
+    std::string body(300000, 0);
+    for(std::size_t i = 0; i < body.size(); ++i)
+        body[i] = static_cast<char>('a' + i % 26);
+    std::string wire;
+    for(int i = 0; i < 10; ++i)
+        wire +=
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "\r\n" + body;
+    net::io_context ioc;
+    test::stream ts(ioc, wire);
+    ts.read_size(16384);
+    pooled_multi_buffer b;
+    auto const s0 = segment_pool::stats();
+    for(int i = 0; i < 10; ++i)
+    {
+        http::response_parser<
+            http::basic_dynamic_body<pooled_multi_buffer>> p;
+        p.body_limit(std::nullopt);
+        http::read(ts, b, p);
+        REQUIRE(buffers_to_string(p.get().body().data()) == body);
+    }
+    auto const s = segment_pool::stats();
+    REQUIRE(s.reused - s0.reused > 0);
+    REQUIRE(s.heap_allocations - s0.heap_allocations <
+        (s.allocations - s0.allocations) / 2);
+}
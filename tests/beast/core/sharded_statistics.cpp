@@ -0,0 +1,106 @@
+#include "catch.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <boost/beast/core/sharded_statistics.hpp>
+
+using namespace boost::beast;
+
+namespace {
+
+enum { hits, misses, counter_count = 70 };
+enum { latency, size, histogram_count };
+
+} // (anon)
+
+TEST_CASE("sharded_statistics shards", "sharded_statistics") {
+    sharded_statistics stats(counter_count, histogram_count);
+    REQUIRE(stats.counters() == counter_count);
+    REQUIRE(stats.histograms() == histogram_count);
+    REQUIRE(stats.shards() == 0);
+    REQUIRE(stats.counter(hits) == 0);
+    REQUIRE(stats.histogram(latency).count() == 0);
+
+    // one shard per thread
+    auto& s = stats.local();
+    REQUIRE(&stats.local() == &s);
+    REQUIRE(stats.shards() == 1);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(&s) %
+        sharded_statistics::cache_line_size == 0);
+
+    // and per object
+    sharded_statistics other(1);
+    REQUIRE(&other.local() != static_cast<void*>(&s));
+    REQUIRE(&stats.local() == &s);
+
+    auto& m = stats.make_shard();
+    REQUIRE(&m != &s);
+    REQUIRE(stats.shards() == 2);
+
+    s.add(hits);
+    s.add(hits, 4);
+    m.add(hits);
+    m.add(counter_count - 1, 7);
+    s.record(latency, 100);
+    m.record(latency, 300);
+    m.record(size, 5);
+    REQUIRE(s.counter(hits) == 5);
+    REQUIRE(stats.counter(hits) == 6);
+    REQUIRE(stats.counter(misses) == 0);
+    REQUIRE(stats.counter(counter_count - 1) == 7);
+    REQUIRE(s.histogram(latency).count() == 1);
+    auto const h = stats.histogram(latency);
+    REQUIRE(h.count() == 2);
+    REQUIRE(h.min() == 100);
+    REQUIRE(h.max() == 300);
+    REQUIRE(stats.histogram(size).count() == 1);
+}
+
+TEST_CASE("sharded_statistics threads", "sharded_statistics") {
+    sharded_statistics stats(counter_count, histogram_count);
+    std::size_t constexpr threads = 4;
+    std::uint64_t constexpr n = 100000;
+    std::vector<sharded_statistics::shard*> shards(threads);
+    std::atomic<bool> ok{true};
+    std::vector<std::thread> v;
+    for(std::size_t i = 0; i < threads; ++i)
+        v.emplace_back(
+            [&, i]
+            {
+                auto& s = stats.local();
+                shards[i] = &s;
+                for(std::uint64_t j = 0; j < n; ++j)
+                {
+                    s.add(hits);
+                    s.record(latency, j % 1000);
+                    // read while others write
+                    if(j % 10000 == 0 && stats.counter(hits) < j)
+                        ok = false;
+                }
+            });
+    for(auto& t : v)
+        t.join();
+    REQUIRE(ok);
+    REQUIRE(stats.shards() == threads);
+    for(std::size_t i = 0; i < threads; ++i)
+        for(std::size_t j = i + 1; j < threads; ++j)
+            REQUIRE(shards[i] != shards[j]);
+    REQUIRE(stats.counter(hits) == threads * n);
+    auto const h = stats.histogram(latency);
+    REQUIRE(h.count() == threads * n);
+    REQUIRE(h.max() == 999);
+}
+
+TEST_CASE("sharded_statistics destroyed objects", "sharded_statistics") {
+    // objects often reuse the address of a destroyed one,
+    // which must not hand them its shard
+    for(int i = 0; i < 1000; ++i)
+    {
+        auto p = std::make_unique<sharded_statistics>(1);
+        p->local().add(0);
+        REQUIRE(p->shards() == 1);
+        REQUIRE(p->counter(0) == 1);
+    }
+}
@@ -0,0 +1,242 @@
+#include "catch.hpp"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/read.hpp>
+#include <asio/write.hpp>
+#include <boost/beast/core/basic_stream.hpp>
+#include <boost/beast/core/stream_statistics.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+
+namespace net = asio;
+using tcp = net::ip::tcp;
+using namespace boost::beast;
+
+namespace {
+
+template<class RatePolicy>
+using stream_type = basic_stream<tcp,
+    net::io_context::executor_type, statistics_policy<RatePolicy>>;
+
+// Connect a stream to a socket over loopback
+template<class Stream>
+void
+connect(Stream& s, tcp::socket& peer)
+{
+    tcp::acceptor acceptor(peer.get_executor(), tcp::endpoint(
+        net::ip::make_address_v4("127.0.0.1"), 0));
+    s.connect(acceptor.local_endpoint());
+    acceptor.accept(peer);
+}
+
+template<class Stream>
+constexpr bool has_statistics =
+    requires (Stream& s) { s.statistics(); };
+
+} // (anon)
+
+static_assert(! has_statistics<tcp_stream>,
+    "statistics require a statistics_policy");
+static_assert(has_statistics<stream_type<unlimited_rate_policy>>,
+    "statistics_policy provides statistics");
+
+TEST_CASE("stream_statistics arithmetic", "stream_statistics") {
+    stream_statistics a;
+    REQUIRE(a.average_read_size() == 0);
+    REQUIRE(a.average_write_size() == 0);
+    a.bytes_read = 100;
+    a.reads = 4;
+    a.bytes_written = 30;
+    a.writes = 3;
+    a.read_timeouts = 1;
+    a.rate_limit_waits = 2;
+    a.rate_limit_wait_time = std::chrono::milliseconds(5);
+    REQUIRE(a.average_read_size() == 25);
+    REQUIRE(a.average_write_size() == 10);
+
+    auto const b = a + a;
+    REQUIRE(b.bytes_read == 200);
+    REQUIRE(b.reads == 8);
+    REQUIRE(b.bytes_written == 60);
+    REQUIRE(b.writes == 6);
+    REQUIRE(b.read_timeouts == 2);
+    REQUIRE(b.write_timeouts == 0);
+    REQUIRE(b.rate_limit_waits == 4);
+    REQUIRE(b.rate_limit_wait_time == std::chrono::milliseconds(10));
+    REQUIRE(b.average_read_size() == 25);
+}
+
+TEST_CASE("statistics_policy reads and writes", "stream_statistics") {
+    net::io_context ioc;
+    stream_type<unlimited_rate_policy> s(ioc);
+    tcp::socket peer(ioc);
+    connect(s, peer);
+
+    std::string const out(1000, 'x');
+    std::string in(1000, 0);
+    net::async_write(s, net::buffer(out),
+        [](error_code ec, std::size_t n)
+        {
+            REQUIRE(! ec);
+            REQUIRE(n == 1000);
+        });
+    net::async_read(peer, net::buffer(in),
+        [](error_code ec, std::size_t)
+        {
+            REQUIRE(! ec);
+        });
+    ioc.run();
+    ioc.restart();
+    REQUIRE(s.statistics().bytes_written == 1000);
+    REQUIRE(s.statistics().writes >= 1);
+
+    net::write(peer, net::buffer(out.data(), 300));
+    char buf[1000];
+    std::size_t total = 0;
+    std::size_t reads = 0;
+    while(total < 300)
+    {
+        s.async_read_some(net::buffer(buf),
+            [&](error_code ec, std::size_t n)
+            {
+                REQUIRE(! ec);
+                total += n;
+                ++reads;
+            });
+        ioc.run();
+        ioc.restart();
+    }
+    REQUIRE(s.statistics().bytes_read == 300);
+    REQUIRE(s.statistics().reads == reads);
+    REQUIRE(s.statistics().average_read_size() == 300.0 / reads);
+    REQUIRE(s.statistics().read_timeouts == 0);
+    REQUIRE(s.statistics().rate_limit_waits == 0);
+
+    // synchronous operations are not counted
+    s.write_some(net::buffer(out));
+    REQUIRE(s.statistics().bytes_written == 1000);
+}
+
+TEST_CASE("statistics_policy timeouts", "stream_statistics") {
+    net::io_context ioc;
+    stream_type<unlimited_rate_policy> s(ioc);
+    tcp::socket peer(ioc);
+    connect(s, peer);
+
+    char buf[16];
+    s.expires_after(std::chrono::milliseconds(10));
+    s.async_read_some(net::buffer(buf),
+        [](error_code ec, std::size_t)
+        {
+            REQUIRE(ec == error::timeout);
+        });
+    ioc.run();
+    REQUIRE(s.statistics().read_timeouts == 1);
+    REQUIRE(s.statistics().write_timeouts == 0);
+    REQUIRE(s.statistics().reads == 0);
+    REQUIRE(s.statistics().bytes_read == 0);
+}
+
+TEST_CASE("statistics_policy end of file", "stream_statistics") {
+    // a read which transfers nothing is not counted
+    net::io_context ioc;
+    stream_type<unlimited_rate_policy> s(ioc);
+    tcp::socket peer(ioc);
+    connect(s, peer);
+
+    net::write(peer, net::buffer("abc", 3));
+    peer.shutdown(tcp::socket::shutdown_send);
+    char buf[16];
+    std::size_t n = 0;
+    error_code result;
+    for(int i = 0; i < 2; ++i)
+    {
+        s.async_read_some(net::buffer(buf),
+            [&](error_code ec, std::size_t bytes)
+            {
+                result = ec;
+                n += bytes;
+            });
+        ioc.run();
+        ioc.restart();
+    }
+    REQUIRE(result == net::error::eof);
+    REQUIRE(n == 3);
+    REQUIRE(s.statistics().reads == 1);
+    REQUIRE(s.statistics().bytes_read == 3);
+    REQUIRE(s.statistics().average_read_size() == 3.0);
+}
+
+TEST_CASE("statistics_policy rate limit", "stream_statistics") {
+    net::io_context ioc;
+    auto limits = std::make_shared<shared_rate_policy::group>();
+    limits->write_limit(64 * 1024, 4096);
+    stream_type<shared_rate_policy> s(
+        statistics_policy<shared_rate_policy>(
+            shared_rate_policy(limits)), ioc);
+    tcp::socket peer(ioc);
+    connect(s, peer);
+
+    std::string const out(16384, 'x');
+    std::string in(16384, 0);
+    auto const start = std::chrono::steady_clock::now();
+    net::async_write(s, net::buffer(out),
+        [](error_code ec, std::size_t n)
+        {
+            REQUIRE(! ec);
+            REQUIRE(n == 16384);
+        });
+    net::async_read(peer, net::buffer(in),
+        [](error_code ec, std::size_t)
+        {
+            REQUIRE(! ec);
+        });
+    ioc.run();
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+
+    auto const& st = s.statistics();
+    REQUIRE(st.bytes_written == 16384);
+    REQUIRE(st.writes > 1);
+    REQUIRE(st.rate_limit_waits > 0);
+    REQUIRE(st.rate_limit_wait_time > std::chrono::milliseconds(50));
+    REQUIRE(st.rate_limit_wait_time <= elapsed);
+    REQUIRE(&s.rate_policy().rate_policy().limits() == limits.get());
+}
+
+TEST_CASE("stream_statistics_group", "stream_statistics") {
+    net::io_context ioc;
+    auto totals = std::make_shared<stream_statistics_group>();
+    statistics_policy<> const policy(totals);
+    std::vector<tcp::socket> peers;
+    std::string const out(100, 'x');
+    stream_statistics live;
+    {
+        stream_type<unlimited_rate_policy> s1(policy, ioc);
+        stream_type<unlimited_rate_policy> s2(policy, ioc);
+        for(auto* s : {&s1, &s2})
+        {
+            peers.emplace_back(ioc);
+            connect(*s, peers.back());
+            net::async_write(*s, net::buffer(out),
+                [](error_code ec, std::size_t)
+                {
+                    REQUIRE(! ec);
+                });
+        }
+        ioc.run();
+        REQUIRE(totals->total().bytes_written == 0);
+
+        // a moved-from stream starts over
+        stream_type<unlimited_rate_policy> s3(std::move(s2));
+        REQUIRE(s2.statistics().bytes_written == 0);
+        REQUIRE(s3.statistics().bytes_written == 100);
+        live = s1.statistics() + s3.statistics();
+    }
+    REQUIRE(live.bytes_written == 200);
+    REQUIRE(totals->total().bytes_written == 200);
+    REQUIRE(totals->total().writes == live.writes);
+    REQUIRE(policy.statistics().bytes_written == 0);
+}
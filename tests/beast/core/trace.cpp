@@ -0,0 +1,228 @@
+#include "catch.hpp"
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/core/trace.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/websocket/stream.hpp>
+#include "stream.hpp"
+
+namespace net = asio;
+using tcp = net::ip::tcp;
+using namespace boost::beast;
+
+namespace {
+
+// Remembers the phases reported, in order
+struct recorder : tracer
+{
+    std::vector<std::pair<trace_phase, error_code>> phases;
+
+    void
+    on_phase(
+        trace_phase phase,
+        clock_type::duration elapsed,
+        error_code const& ec) override
+    {
+        REQUIRE(elapsed >= clock_type::duration::zero());
+        phases.emplace_back(phase, ec);
+    }
+
+    std::size_t
+    count(trace_phase phase, bool failed = false) const
+    {
+        return static_cast<std::size_t>(std::count_if(
+            phases.begin(), phases.end(),
+            [&](auto const& p)
+            {
+                return p.first == phase &&
+                    static_cast<bool>(p.second) == failed;
+            }));
+    }
+};
+
+} // (anon)
+
+TEST_CASE("trace span", "trace") {
+    REQUIRE(get_tracer() == nullptr);
+    trace_span s0;
+    REQUIRE(! s0.active());
+    s0.finish(trace_phase::resolve);
+
+    recorder r;
+    {
+        scoped_tracer st(r);
+        REQUIRE(get_tracer() == &r);
+        trace_span s;
+        REQUIRE(s.active());
+        REQUIRE(! trace_span(false).active());
+        s.lap(trace_phase::resolve);
+        REQUIRE(s.active());
+        s.finish(trace_phase::connect, net::error::connection_refused);
+        REQUIRE(! s.active());
+        s.finish(trace_phase::connect);
+
+        recorder r2;
+        {
+            scoped_tracer st2(r2);
+            REQUIRE(get_tracer() == &r2);
+        }
+        REQUIRE(get_tracer() == &r);
+
+        // reported to the tracer of the thread which ends the phase
+        s.start();
+        set_tracer(&r2);
+        s.cancel();
+        s.finish(trace_phase::resolve);
+        s.start();
+        s.finish(trace_phase::resolve);
+        REQUIRE(r2.phases.size() == 1);
+        set_tracer(&r);
+    }
+    REQUIRE(get_tracer() == nullptr);
+    REQUIRE(r.phases.size() == 2);
+    REQUIRE(r.count(trace_phase::resolve) == 1);
+    REQUIRE(r.count(trace_phase::connect, true) == 1);
+    REQUIRE(std::string(to_string(trace_phase::first_byte)) == "first_byte");
+}
+
+TEST_CASE("trace collector", "trace") {
+    trace_collector c;
+    c.on_phase(trace_phase::connect, std::chrono::microseconds(100), {});
+    c.on_phase(trace_phase::connect, std::chrono::microseconds(300), {});
+    c.on_phase(trace_phase::connect, std::chrono::microseconds(1),
+        net::error::connection_refused);
+    REQUIRE(c.histogram(trace_phase::connect).count() == 2);
+    REQUIRE(c.histogram(trace_phase::connect).min() == 100000);
+    REQUIRE(c.histogram(trace_phase::connect).max() == 300000);
+    REQUIRE(c.errors(trace_phase::connect) == 1);
+    REQUIRE(c.histogram(trace_phase::read_body).count() == 0);
+
+    trace_collector total(c);
+    total.merge(c);
+    REQUIRE(total.histogram(trace_phase::connect).count() == 4);
+    REQUIRE(total.errors(trace_phase::connect) == 2);
+    total.reset();
+    REQUIRE(total.histogram(trace_phase::connect).count() == 0);
+    REQUIRE(total.errors(trace_phase::connect) == 0);
+}
+
+TEST_CASE("trace connect", "trace") {
+    net::io_context ioc;
+    tcp::acceptor acceptor(ioc, tcp::endpoint(
+        net::ip::make_address_v4("127.0.0.1"), 0));
+    auto const ep = acceptor.local_endpoint();
+    tcp::socket peer(ioc);
+    acceptor.async_accept(peer, [](error_code) {});
+
+    recorder r;
+    scoped_tracer st(r);
+    tcp_stream s1(ioc);
+    s1.async_connect(ep, [](error_code ec) { REQUIRE(! ec); });
+    ioc.run();
+    REQUIRE(r.count(trace_phase::connect) == 1);
+
+    // refused, once the port is closed
+    acceptor.close();
+    ioc.restart();
+    tcp_stream s2(ioc);
+    s2.async_connect(ep, [](error_code ec) { REQUIRE(ec); });
+    ioc.run();
+    REQUIRE(r.count(trace_phase::connect, true) == 1);
+
+    // nothing is measured without a tracer
+    set_tracer(nullptr);
+    ioc.restart();
+    tcp_stream s3(ioc);
+    s3.async_connect(ep, [](error_code) {});
+    ioc.run();
+    set_tracer(&r);
+    REQUIRE(r.phases.size() == 2);
+}
+
+TEST_CASE("trace http", "trace") {
+    net::io_context ioc;
+    test::stream client(ioc);
+    test::stream server(ioc);
+    test::connect(client, server);
+
+    http::request<http::string_body> req{http::verb::post, "/", 11};
+    req.body() = std::string(100000, 'x');
+    req.prepare_payload();
+
+    recorder r;
+    scoped_tracer st(r);
+    flat_buffer b;
+    http::request<http::string_body> got;
+    http::async_read(server, b, got,
+        [](error_code ec, std::size_t) { REQUIRE(! ec); });
+    http::async_write(client, req,
+        [](error_code ec, std::size_t) { REQUIRE(! ec); });
+    ioc.run();
+    REQUIRE(got.body() == req.body());
+    REQUIRE(r.count(trace_phase::write_header) == 1);
+    REQUIRE(r.count(trace_phase::write_body) == 1);
+    REQUIRE(r.count(trace_phase::first_byte) == 1);
+    REQUIRE(r.count(trace_phase::read_header) == 1);
+    REQUIRE(r.count(trace_phase::read_body) == 1);
+    REQUIRE(r.phases.size() == 5);
+
+    // header and body read separately, from a buffer
+    // which already holds the start of the message
+    r.phases.clear();
+    http::write(client, req);
+    b.commit(server.read_some(b.prepare(10)));
+    http::request_parser<http::string_body> p;
+    http::async_read_header(server, b, p,
+        [](error_code ec, std::size_t) { REQUIRE(! ec); });
+    ioc.restart();
+    ioc.run();
+    REQUIRE(r.phases.size() == 1);
+    REQUIRE(r.count(trace_phase::read_header) == 1);
+    http::async_read(server, b, p,
+        [](error_code ec, std::size_t) { REQUIRE(! ec); });
+    ioc.restart();
+    ioc.run();
+    REQUIRE(r.phases.size() == 2);
+    REQUIRE(r.count(trace_phase::read_body) == 1);
+
+    // the peer closes before the message arrives
+    r.phases.clear();
+    http::async_read(server, b, got,
+        [](error_code ec, std::size_t)
+        {
+            REQUIRE(ec == http::error::end_of_stream);
+        });
+    client.close();
+    ioc.restart();
+    ioc.run();
+    REQUIRE(r.phases.size() == 1);
+    REQUIRE(r.count(trace_phase::first_byte, true) == 1);
+}
+
+TEST_CASE("trace websocket handshake", "trace") {
+    net::io_context ioc;
+    websocket::stream<test::stream> client(ioc);
+    websocket::stream<test::stream> server(ioc);
+    test::connect(client.next_layer(), server.next_layer());
+
+    trace_collector c;
+    {
+        scoped_tracer st(c);
+        server.async_accept([](error_code ec) { REQUIRE(! ec); });
+        client.async_handshake("localhost", "/",
+            [](error_code ec) { REQUIRE(! ec); });
+        ioc.run();
+    }
+    REQUIRE(c.histogram(trace_phase::websocket_handshake).count() == 1);
+    REQUIRE(c.histogram(trace_phase::write_header).count() == 2);
+    REQUIRE(c.histogram(trace_phase::read_header).count() == 2);
+    REQUIRE(c.errors(trace_phase::websocket_handshake) == 0);
+}
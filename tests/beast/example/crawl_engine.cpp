@@ -0,0 +1,230 @@
+#include "catch.hpp"
+#include "crawl_engine.hpp"
+#include "dns_cache.hpp"
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/io_context_pool.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+using tcp = net::ip::tcp;
+using crawl::crawl_engine;
+
+namespace {
+
+// A keep-alive HTTP server on one connection
+class server_session
+    : public std::enable_shared_from_this<server_session>
+{
+    beast::tcp_stream stream_;
+    beast::flat_buffer buffer_;
+    http::request<http::empty_body> req_;
+    http::response<http::string_body> res_;
+
+public:
+    explicit
+    server_session(tcp::socket socket)
+        : stream_(std::move(socket))
+        , res_(http::status::ok, 11)
+    {
+        res_.body() = "hello";
+    }
+
+    void
+    run()
+    {
+        req_ = {};
+        http::async_read(stream_, buffer_, req_,
+            [self = shared_from_this()](beast::error_code ec, std::size_t)
+            {
+                if(ec)
+                    return self->stream_.close();
+                self->respond();
+            });
+    }
+
+private:
+    void
+    respond()
+    {
+        res_.keep_alive(req_.keep_alive());
+        res_.prepare_payload();
+        http::async_write(stream_, res_,
+            [self = shared_from_this()](beast::error_code ec, std::size_t)
+            {
+                if(ec || ! self->res_.keep_alive())
+                    return self->stream_.close();
+                self->run();
+            });
+    }
+};
+
+// Servers on loopback ports, run by their own thread
+class servers
+{
+    net::io_context ioc_{1};
+    std::vector<tcp::acceptor> acceptors_;
+    std::vector<std::string> ports_;
+    std::thread thread_;
+
+    void
+    accept(tcp::acceptor& a)
+    {
+        a.async_accept(
+            [this, &a](beast::error_code ec, tcp::socket s)
+            {
+                if(ec)
+                    return;
+                std::make_shared<server_session>(std::move(s))->run();
+                accept(a);
+            });
+    }
+
+public:
+    explicit
+    servers(std::size_t n)
+    {
+        acceptors_.reserve(n);
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            acceptors_.emplace_back(ioc_,
+                tcp::endpoint(net::ip::address_v4::loopback(), 0));
+            ports_.push_back(std::to_string(
+                acceptors_.back().local_endpoint().port()));
+            accept(acceptors_.back());
+        }
+        thread_ = std::thread([this]{ ioc_.run(); });
+    }
+
+    ~servers()
+    {
+        ioc_.stop();
+        thread_.join();
+    }
+
+    std::vector<std::string> const&
+    ports() const noexcept
+    {
+        return ports_;
+    }
+};
+
+struct outcome
+{
+    std::atomic<std::size_t> results{0};
+    std::atomic<std::size_t> failures{0};
+    std::size_t done_calls = 0;
+
+    // the counters when done was called
+    std::size_t results_at_done = 0;
+    std::size_t opened = 0;
+    std::size_t reused = 0;
+    std::size_t evicted = 0;
+    std::size_t closed = 0;
+};
+
+// Fetch n targets, spread over the servers in turn
+void
+crawl_all(
+    servers& srv,
+    std::size_t n,
+    crawl_engine::options const& opt,
+    outcome& out)
+{
+    beast::io_context_pool pool(2);
+    crawl::dns_cache dns;
+    crawl_engine engine(pool, dns, opt);
+
+    std::size_t next = 0;
+    engine.run(
+        [&]() -> std::optional<crawl::crawl_target>
+        {
+            if(next == n)
+                return std::nullopt;
+            crawl::crawl_target t;
+            t.host = "127.0.0.1";
+            t.port = srv.ports()[next++ % srv.ports().size()];
+            return t;
+        },
+        [&](crawl::crawl_target const&,
+            beast::error_code ec,
+            crawl_engine::response_type const* res)
+        {
+            if(ec || res->body() != "hello")
+                ++out.failures;
+            ++out.results;
+        },
+        [&]
+        {
+            auto const& s = engine.stats();
+            ++out.done_calls;
+            out.results_at_done = out.results;
+            out.opened = s.counter(crawl_engine::connections_opened);
+            out.reused = s.counter(crawl_engine::connections_reused);
+            out.evicted = s.counter(crawl_engine::connections_evicted);
+            out.closed = s.counter(crawl_engine::connections_closed);
+            pool.release();
+        });
+    pool.run();
+    pool.join();
+}
+
+} // (anon)
+
+TEST_CASE("crawl_engine connection reuse", "crawl_engine") {
+    servers srv(1);
+    crawl_engine::options opt;
+    opt.max_connections = 2;
+    outcome out;
+    crawl_all(srv, 50, opt, out);
+
+    REQUIRE(out.done_calls == 1);
+    REQUIRE(out.results_at_done == 50);
+    REQUIRE(out.failures == 0);
+    REQUIRE(out.opened >= 1);
+    REQUIRE(out.opened <= 2);
+    REQUIRE(out.reused == 50 - out.opened);
+    REQUIRE(out.evicted == 0);
+
+    // every connection was kept alive, and is
+    // closed by the time done is called
+    REQUIRE(out.closed == out.opened);
+}
+
+TEST_CASE("crawl_engine eviction", "crawl_engine") {
+    servers srv(3);
+    crawl_engine::options opt;
+    opt.max_connections = 2;
+    opt.max_connections_per_host = 1;
+    outcome out;
+    crawl_all(srv, 60, opt, out);
+
+    REQUIRE(out.done_calls == 1);
+    REQUIRE(out.results_at_done == 60);
+    REQUIRE(out.failures == 0);
+    REQUIRE(out.opened >= 3);
+    REQUIRE(out.evicted > 0);
+    REQUIRE(out.closed == out.opened);
+}
+
+TEST_CASE("crawl_engine empty source", "crawl_engine") {
+    servers srv(1);
+    outcome out;
+    crawl_all(srv, 0, {}, out);
+    REQUIRE(out.done_calls == 1);
+    REQUIRE(out.opened == 0);
+}
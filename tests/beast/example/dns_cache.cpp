@@ -0,0 +1,122 @@
+#include "catch.hpp"
+#include "dns_cache.hpp"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <asio/io_context.hpp>
+
+namespace net = asio;
+namespace beast = boost::beast;
+using crawl::dns_cache;
+
+namespace {
+
+// Records the outcome of one lookup. Move-only, which
+// the cache must accept.
+struct lookup
+{
+    struct result
+    {
+        bool invoked = false;
+        beast::error_code ec;
+        dns_cache::results_type results;
+    };
+
+    std::unique_ptr<int> move_only = std::make_unique<int>();
+    result* r;
+
+    void
+    operator()(beast::error_code ec, dns_cache::results_type results)
+    {
+        r->invoked = true;
+        r->ec = ec;
+        r->results = std::move(results);
+    }
+};
+
+lookup::result
+resolve(
+    net::io_context& ioc,
+    dns_cache& dns,
+    std::string const& host,
+    std::string const& service)
+{
+    lookup::result r;
+    dns.async_resolve(ioc.get_executor(), host, service, lookup{{}, &r});
+    REQUIRE(! r.invoked);
+    ioc.restart();
+    ioc.run();
+    REQUIRE(r.invoked);
+    return r;
+}
+
+} // (anon)
+
+TEST_CASE("dns_cache hit and miss", "dns_cache") {
+    net::io_context ioc;
+    dns_cache dns;
+
+    auto const r1 = resolve(ioc, dns, "127.0.0.1", "80");
+    REQUIRE(! r1.ec);
+    REQUIRE(r1.results.begin()->endpoint().port() == 80);
+    REQUIRE(dns.stats().misses == 1);
+    REQUIRE(dns.stats().hits == 0);
+
+    auto const r2 = resolve(ioc, dns, "127.0.0.1", "80");
+    REQUIRE(! r2.ec);
+    REQUIRE(r2.results.size() == r1.results.size());
+    REQUIRE(dns.stats().misses == 1);
+    REQUIRE(dns.stats().hits == 1);
+
+    // the service is part of the key
+    resolve(ioc, dns, "127.0.0.1", "8080");
+    REQUIRE(dns.stats().misses == 2);
+
+    // failures are cached too
+    auto const r3 = resolve(ioc, dns, "127.0.0.1", "no-such-service");
+    REQUIRE(r3.ec);
+    auto const r4 = resolve(ioc, dns, "127.0.0.1", "no-such-service");
+    REQUIRE(r4.ec == r3.ec);
+    REQUIRE(dns.stats().misses == 3);
+    REQUIRE(dns.stats().negative_hits == 1);
+}
+
+TEST_CASE("dns_cache coalescing", "dns_cache") {
+    net::io_context ioc;
+    dns_cache dns;
+
+    // lookups made while the name is resolving wait for it
+    lookup::result r[3];
+    for(auto& ri : r)
+        dns.async_resolve(ioc.get_executor(),
+            "127.0.0.1", "443", lookup{{}, &ri});
+    ioc.run();
+    for(auto const& ri : r)
+    {
+        REQUIRE(ri.invoked);
+        REQUIRE(! ri.ec);
+        REQUIRE(ri.results.begin()->endpoint().port() == 443);
+    }
+    REQUIRE(dns.stats().misses == 1);
+    REQUIRE(dns.stats().coalesced == 2);
+    REQUIRE(dns.stats().hits == 0);
+}
+
+TEST_CASE("dns_cache expiry", "dns_cache") {
+    net::io_context ioc;
+    dns_cache::options opt;
+    opt.ttl = std::chrono::seconds(0);
+    opt.negative_ttl = std::chrono::seconds(0);
+    dns_cache dns(opt);
+
+    // an expired resolution is looked up again
+    resolve(ioc, dns, "127.0.0.1", "80");
+    resolve(ioc, dns, "127.0.0.1", "80");
+    REQUIRE(dns.stats().misses == 2);
+    REQUIRE(dns.stats().hits == 0);
+
+    resolve(ioc, dns, "127.0.0.1", "no-such-service");
+    resolve(ioc, dns, "127.0.0.1", "no-such-service");
+    REQUIRE(dns.stats().misses == 4);
+    REQUIRE(dns.stats().negative_hits == 0);
+}
@@ -0,0 +1,189 @@
+#include "catch.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <asio/buffer.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/http/buffer_body.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/string_body.hpp>
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+namespace {
+
+struct message
+{
+    std::string wire;
+    std::string body;
+};
+
+// A chunked response with `n` chunks of varied sizes,
+// optionally with an extension on some of them.
+message
+make_message(std::size_t n, bool ext)
+{
+    message m;
+    m.wire =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n";
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        std::string const data(1 + (i * 37) % 300,
+            static_cast<char>('a' + i % 26));
+        char size[32];
+        std::snprintf(size, sizeof(size), i % 2 ? "%zx" : "%zX",
+            data.size());
+        m.wire += size;
+        if(ext && i % 5 == 3)
+            m.wire += ";name=value";
+        m.wire += "\r\n" + data + "\r\n";
+        m.body += data;
+    }
+    m.wire += "0\r\n\r\n";
+    return m;
+}
+
+// Feed the wire in pieces of at most `step` bytes,
+// keeping what the parser did not consume.
+template<class Parser>
+void
+feed(Parser& p, std::string const& wire, std::size_t step)
+{
+    std::string buf;
+    std::size_t pos = 0;
+    p.eager(true);
+    while(! p.is_done())
+    {
+        auto const k = (std::min)(step, wire.size() - pos);
+        buf.append(wire, pos, k);
+        pos += k;
+        beast::error_code ec;
+        auto const used = p.put(net::buffer(buf), ec);
+        buf.erase(0, used);
+        if(ec == http::error::need_more)
+        {
+            REQUIRE(k > 0);
+            continue;
+        }
+        REQUIRE(! ec);
+    }
+    REQUIRE(buf.empty());
+    REQUIRE(pos == wire.size());
+}
+
+} // (anon)
+
+TEST_CASE("http parser many chunks", "chunked") {
+    for(bool ext : {false, true})
+    {
+        auto const m = make_message(500, ext);
+        for(std::size_t step : {1u, 7u, 100u, 4096u, 1u << 20})
+        {
+            http::response_parser<http::string_body> p;
+            p.body_limit(1024 * 1024);
+            feed(p, m.wire, step);
+            REQUIRE(p.get().body() == m.body);
+        }
+    }
+}
+
+TEST_CASE("http parser chunk callbacks", "chunked") {
+    // callbacks still see every chunk
+    auto const m = make_message(100, false);
+    http::response_parser<http::string_body> p;
+    std::size_t headers = 0;
+    std::string body;
+    auto on_header =
+        [&](std::uint64_t, beast::string_view, beast::error_code&)
+        {
+            ++headers;
+        };
+    auto on_body =
+        [&](std::uint64_t, beast::string_view s, beast::error_code&)
+        {
+            body.append(s.data(), s.size());
+            return s.size();
+        };
+    p.on_chunk_header(on_header);
+    p.on_chunk_body(on_body);
+    feed(p, m.wire, std::size_t(1) << 20);
+    REQUIRE(headers == 101);
+    REQUIRE(body == m.body);
+    REQUIRE(p.get().body().empty());
+}
+
+TEST_CASE("http parser chunks partly consumed", "chunked") {
+    // a small buffer_body takes part of a run of chunks at a time
+    auto const m = make_message(200, false);
+    http::response_parser<http::buffer_body> p;
+    p.eager(true);
+    std::string body;
+    char out[97];
+    std::string buf = m.wire;
+    while(! p.is_done())
+    {
+        p.get().body().data = out;
+        p.get().body().size = sizeof(out);
+        beast::error_code ec;
+        auto const used = p.put(net::buffer(buf), ec);
+        buf.erase(0, used);
+        if(ec == http::error::need_buffer)
+            ec = {};
+        REQUIRE(! ec);
+        body.append(out, sizeof(out) - p.get().body().size);
+    }
+    REQUIRE(buf.empty());
+    REQUIRE(body == m.body);
+}
+
+TEST_CASE("http parser chunks body limit", "chunked") {
+    auto const m = make_message(100, false);
+    for(std::uint64_t limit : {std::uint64_t(0), std::uint64_t(1),
+        std::uint64_t(m.body.size() / 2), std::uint64_t(m.body.size() - 1)})
+    {
+        http::response_parser<http::string_body> p;
+        p.eager(true);
+        p.body_limit(limit);
+        beast::error_code ec;
+        std::string buf = m.wire;
+        while(! ec)
+            buf.erase(0, p.put(net::buffer(buf), ec));
+        REQUIRE(ec == http::error::body_limit);
+        REQUIRE(p.get().body().size() <= limit);
+    }
+    http::response_parser<http::string_body> p;
+    p.body_limit(m.body.size());
+    feed(p, m.wire, m.wire.size());
+    REQUIRE(p.get().body() == m.body);
+}
+
+TEST_CASE("http parser bad chunks", "chunked") {
+    for(std::string const bad : {
+        "5\r\nhello\r\n5\r\nworld\r\nx\r\n\r\n",
+        "5\r\nhello\r\n5\r\nworldXX5\r\nworld\r\n0\r\n\r\n",
+        "5\r\nhello\r\n11111111111111111\r\n",
+        })
+    {
+        http::response_parser<http::string_body> p;
+        p.eager(true);
+        std::string buf =
+            "HTTP/1.1 200 OK\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "\r\n" + bad;
+        beast::error_code ec;
+        while(! ec)
+        {
+            auto const used = p.put(net::buffer(buf), ec);
+            REQUIRE((used > 0 || ec));
+            buf.erase(0, used);
+        }
+        REQUIRE(ec != http::error::need_more);
+        REQUIRE(! p.is_done());
+    }
+}
@@ -0,0 +1,146 @@
+#include "catch.hpp"
+#include <sstream>
+#include <string>
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/fields.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+
+namespace http = boost::beast::http;
+
+namespace {
+
+template<bool isRequest, class Body, class Fields>
+std::string
+to_string(http::message<isRequest, Body, Fields> const& m)
+{
+    std::ostringstream os;
+    os << m;
+    return os.str();
+}
+
+// Returns the number of buffers presented for the header
+template<class Fields>
+std::size_t
+header_buffers(typename Fields::writer const& w)
+{
+    std::size_t n = 0;
+    for(auto const b : w.get())
+        if(b.size() > 0)
+            ++n;
+    return n;
+}
+
+http::request<http::string_body>
+make_request()
+{
+    http::request<http::string_body> req{
+        http::verb::post, "/index.html", 11};
+    req.set(http::field::host, "www.example.com");
+    req.set(http::field::user_agent, "Beast");
+    req.set(http::field::accept, "*/*");
+    req.set("X-Custom", "1");
+    req.body() = "body";
+    req.prepare_payload();
+    return req;
+}
+
+} // (anon)
+
+TEST_CASE("fields cache_serialized request", "fields") {
+    auto req = make_request();
+    auto const expected = to_string(req);
+    REQUIRE(! req.cache_serialized());
+    REQUIRE(header_buffers<http::fields>(
+        http::fields::writer(req, req.version(), req.method())) == 9);
+
+    req.cache_serialized(true);
+    REQUIRE(req.cache_serialized());
+    REQUIRE(to_string(req) == expected);
+
+    // the start-line and fields are one buffer, then the final CRLF
+    {
+        http::fields::writer w(req, req.version(), req.method());
+        REQUIRE(header_buffers<http::fields>(w) == 2);
+        auto const first = *w.get().begin();
+
+        // serializing again reuses the same bytes
+        http::fields::writer w2(req, req.version(), req.method());
+        REQUIRE((*w2.get().begin()).data() == first.data());
+    }
+
+    // a changed field is rendered again
+    req.set(http::field::user_agent, "Beast/2");
+    auto req2 = make_request();
+    req2.set(http::field::user_agent, "Beast/2");
+    REQUIRE(to_string(req) == to_string(req2));
+
+    // so are the method, target and version
+    req.method(http::verb::put);
+    req.target("/other");
+    req.version(10);
+    req2.method(http::verb::put);
+    req2.target("/other");
+    req2.version(10);
+    REQUIRE(to_string(req) == to_string(req2));
+
+    // erasing
+    req.erase("X-Custom");
+    req2.erase("X-Custom");
+    REQUIRE(to_string(req) == to_string(req2));
+
+    req.cache_serialized(false);
+    REQUIRE(to_string(req) == to_string(req2));
+}
+
+TEST_CASE("fields cache_serialized response", "fields") {
+    http::response<http::empty_body> res{http::status::ok, 11};
+    res.set(http::field::server, "Beast");
+    auto const expected = to_string(res);
+    res.cache_serialized(true);
+    REQUIRE(to_string(res) == expected);
+
+    res.result(http::status::not_found);
+    http::response<http::empty_body> res2{http::status::not_found, 11};
+    res2.set(http::field::server, "Beast");
+    REQUIRE(to_string(res) == to_string(res2));
+
+    res.reason("Gone Fishing");
+    res2.reason("Gone Fishing");
+    REQUIRE(to_string(res) == to_string(res2));
+}
+
+TEST_CASE("fields cache_serialized copy move swap", "fields") {
+    auto req = make_request();
+    auto const expected = to_string(req);
+    req.cache_serialized(true);
+    REQUIRE(to_string(req) == expected);
+
+    // the setting is copied, the cache is not shared
+    auto copy = req;
+    REQUIRE(copy.cache_serialized());
+    copy.set(http::field::host, "other");
+    REQUIRE(to_string(req) == expected);
+
+    // a move takes the cache
+    auto moved = std::move(req);
+    REQUIRE(moved.cache_serialized());
+    REQUIRE(to_string(moved) == expected);
+
+    // the moved-from object is as if newly constructed
+    REQUIRE(! req.cache_serialized());
+
+    // a swap exchanges the caches with the fields
+    auto copy_expected = to_string(copy);
+    swap(moved, copy);
+    REQUIRE(to_string(moved) == copy_expected);
+    REQUIRE(to_string(copy) == expected);
+
+    // clear
+    copy.clear();
+    http::request<http::string_body> empty{
+        http::verb::post, "/index.html", 11};
+    empty.body() = "body";
+    REQUIRE(to_string(copy) == to_string(empty));
+}
@@ -0,0 +1,253 @@
+#include "catch.hpp"
+#include <cstddef>
+#include <new>
+#include <string>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/detail/thread_context.hpp>
+#include <asio/detail/thread_info_base.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+
+namespace net = asio;
+namespace http = boost::beast::http;
+using tcp = net::ip::tcp;
+using thread_info = net::detail::thread_info_base;
+
+TEST_CASE("handler memory size classes", "handler_memory") {
+    thread_info ti;
+    auto const& st = ti.statistics();
+
+    // freed blocks are reused for any size in the same class
+    void* p = thread_info::allocate(&ti, 100);
+    REQUIRE(st.misses == 1);
+    thread_info::deallocate(&ti, p, 100);
+    void* q = thread_info::allocate(&ti, 120);
+    REQUIRE(q == p);
+    REQUIRE(st.hits == 1);
+
+    // several blocks of one class are cached at once
+    void* r = thread_info::allocate(&ti, 100);
+    thread_info::deallocate(&ti, q, 120);
+    thread_info::deallocate(&ti, r, 100);
+    REQUIRE(st.releases == 0);
+    thread_info::allocate(&ti, 100);
+    thread_info::allocate(&ti, 100);
+    REQUIRE(st.hits == 3);
+
+    // blocks of another class are not used
+    void* s = thread_info::allocate(&ti, 1000);
+    REQUIRE(st.misses == 3);
+    thread_info::deallocate(&ti, s, 1000);
+
+    // without a thread, memory comes from the heap
+    void* t = thread_info::allocate(nullptr, 100);
+    thread_info::deallocate(nullptr, t, 100);
+    REQUIRE(st.allocations == 6);
+}
+
+namespace {
+
+// Every block which a recycling_allocator takes from the heap
+std::size_t heap_allocations = 0;
+
+// Keeps freed blocks for reuse, so that messages which
+// are parsed over and over stop reaching the heap.
+// Only for use from one thread.
+template<class T>
+struct recycling_allocator
+{
+    using value_type = T;
+
+    recycling_allocator() = default;
+
+    template<class U>
+    recycling_allocator(recycling_allocator<U> const&) noexcept
+    {
+    }
+
+    T*
+    allocate(std::size_t n)
+    {
+        auto const i = bucket(n * sizeof(T));
+        if(i < buckets && cache()[i].size > 0)
+        {
+            auto& b = cache()[i];
+            return static_cast<T*>(b.blocks[--b.size]);
+        }
+        ++heap_allocations;
+        return static_cast<T*>(::operator new(
+            i < buckets ? (i + 1) * granularity : n * sizeof(T)));
+    }
+
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        auto const i = bucket(n * sizeof(T));
+        if(i < buckets && cache()[i].size < depth)
+        {
+            auto& b = cache()[i];
+            b.blocks[b.size++] = p;
+            return;
+        }
+        ::operator delete(p);
+    }
+
+    friend
+    bool
+    operator==(
+        recycling_allocator const&,
+        recycling_allocator const&) noexcept
+    {
+        return true;
+    }
+
+    friend
+    bool
+    operator!=(
+        recycling_allocator const&,
+        recycling_allocator const&) noexcept
+    {
+        return false;
+    }
+
+private:
+    static std::size_t constexpr granularity = 16;
+    static std::size_t constexpr buckets = 64;
+    static std::size_t constexpr depth = 16;
+
+    struct free_list
+    {
+        void* blocks[depth];
+        std::size_t size = 0;
+    };
+
+    static
+    std::size_t
+    bucket(std::size_t bytes) noexcept
+    {
+        return (bytes + granularity - 1) / granularity - 1;
+    }
+
+    static
+    free_list*
+    cache() noexcept
+    {
+        static free_list lists[buckets];
+        return lists;
+    }
+};
+
+using fields = http::basic_fields<recycling_allocator<char>>;
+using body = http::basic_string_body<char,
+    std::char_traits<char>, recycling_allocator<char>>;
+
+// One client request and server response after another, on one thread
+class round_trips
+{
+    tcp::acceptor acceptor_;
+    boost::beast::tcp_stream client_;
+    boost::beast::tcp_stream server_;
+    boost::beast::flat_buffer client_buffer_;
+    boost::beast::flat_buffer server_buffer_;
+    http::request<http::string_body> req_;
+    http::request<body, fields> req_in_;
+    http::response<http::string_body> res_;
+    http::response<body, fields> res_in_;
+    std::size_t remain_;
+    std::size_t warmup_;
+
+public:
+    thread_info::cache_statistics start{};
+    thread_info::cache_statistics end{};
+    std::size_t heap_start = 0;
+    std::size_t heap_end = 0;
+
+    round_trips(net::io_context& ioc, std::size_t n, std::size_t warmup)
+        : acceptor_(ioc, tcp::endpoint(
+            net::ip::make_address("127.0.0.1"), 0))
+        , client_(ioc)
+        , server_(ioc)
+        , remain_(n)
+        , warmup_(warmup)
+    {
+        client_.socket().connect(acceptor_.local_endpoint());
+        acceptor_.accept(server_.socket());
+
+        req_.method(http::verb::post);
+        req_.target("/index.html");
+        req_.set(http::field::host, "localhost");
+        req_.set(http::field::user_agent, "test");
+        req_.body() = "Hello, world!";
+        req_.prepare_payload();
+
+        res_.result(http::status::ok);
+        res_.set(http::field::server, "test");
+        res_.body() = "Goodbye, world!";
+        res_.prepare_payload();
+    }
+
+    void
+    run()
+    {
+        http::async_write(client_, req_,
+            [this](std::error_code ec, std::size_t)
+            {
+                REQUIRE(! ec);
+            });
+        http::async_read(server_, server_buffer_, req_in_,
+            [this](std::error_code ec, std::size_t)
+            {
+                REQUIRE(! ec);
+                req_in_ = {};
+                http::async_write(server_, res_,
+                    [this](std::error_code ec, std::size_t)
+                    {
+                        REQUIRE(! ec);
+                    });
+            });
+        http::async_read(client_, client_buffer_, res_in_,
+            [this](std::error_code ec, std::size_t)
+            {
+                REQUIRE(! ec);
+                REQUIRE(res_in_.body() == "Goodbye, world!");
+                res_in_ = {};
+                auto const ti = net::detail::thread_context::
+                    thread_call_stack::top();
+                REQUIRE(ti != nullptr);
+                if(warmup_ > 0 && --warmup_ == 0)
+                {
+                    start = ti->statistics();
+                    heap_start = heap_allocations;
+                }
+                if(--remain_ > 0)
+                    return run();
+                end = ti->statistics();
+                heap_end = heap_allocations;
+            });
+    }
+};
+
+} // (anon)
+
+TEST_CASE("handler memory http round trip", "handler_memory") {
+    net::io_context ioc(1);
+    round_trips rt(ioc, 100, 10);
+    rt.run();
+    ioc.run();
+
+    // After the first round trips warm the cache, every operation
+    // and every stable state is recycled instead of allocated. The
+    // messages which are read use a recycling allocator for their
+    // fields and body, as they are parsed anew each time, and it
+    // no longer reaches the heap either.
+    REQUIRE(rt.end.allocations > rt.start.allocations);
+    REQUIRE(rt.end.misses == rt.start.misses);
+    REQUIRE(rt.end.releases == rt.start.releases);
+    REQUIRE(rt.heap_start > 0);
+    CAPTURE(rt.heap_end - rt.heap_start);
+    REQUIRE(rt.heap_end == rt.heap_start);
+}
@@ -0,0 +1,252 @@
+#include "catch.hpp"
+#include "stream.hpp"
+#include <string>
+#include <asio/buffer.hpp>
+#include <asio/io_context.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/header_view_parser.hpp>
+#include <boost/beast/http/parser.hpp>
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace test = beast::test;
+
+namespace {
+
+std::string const response =
+    "HTTP/1.1 301 Moved Permanently\r\n"
+    "Server: test\r\n"
+    "Location: https://example.com/\r\n"
+    "X-Custom: one\r\n"
+    "Set-Cookie: a=1\r\n"
+    "Set-Cookie: b=2\r\n"
+    "Content-Length: 5\r\n"
+    "\r\n"
+    "hello";
+
+// Feed `s` a byte at a time through a flat_buffer,
+// as a read loop would.
+template<bool isRequest>
+std::size_t
+parse_bytewise(
+    http::header_view_parser<isRequest>& p,
+    beast::flat_buffer& b,
+    std::string const& s)
+{
+    beast::error_code ec;
+    for(char c : s)
+    {
+        auto const mb = b.prepare(1);
+        *static_cast<char*>(mb.data()) = c;
+        b.commit(1);
+        auto const n = p.put(b.data(), ec);
+        if(ec == http::error::need_more)
+        {
+            REQUIRE(n == 0);
+            continue;
+        }
+        REQUIRE(! ec);
+        return n;
+    }
+    return 0;
+}
+
+} // (anon)
+
+TEST_CASE("header_view_parser response", "header_view_parser") {
+    beast::flat_buffer b;
+    http::response_header_view_parser p;
+    auto const n = parse_bytewise(p, b, response);
+    REQUIRE(n == response.size() - 5);
+    REQUIRE(p.is_header_done());
+    REQUIRE(p.version() == 11);
+    REQUIRE(p.result() == http::status::moved_permanently);
+    REQUIRE(p.result_int() == 301);
+    REQUIRE(p.reason() == "Moved Permanently");
+    REQUIRE(p.size() == 6);
+    REQUIRE(*p.find(http::field::location) == "https://example.com/");
+    REQUIRE(*p.find("x-custom") == "one");
+    REQUIRE(*p.find("LOCATION") == "https://example.com/");
+    REQUIRE(! p.find(http::field::host));
+    REQUIRE(! p.find("x-other"));
+    REQUIRE(p.count(http::field::set_cookie) == 2);
+    REQUIRE(p[3].name == http::field::set_cookie);
+    REQUIRE(p[3].name_string == "Set-Cookie");
+    REQUIRE(p[4].value == "b=2");
+    REQUIRE(p.content_length() == 5);
+
+    // the views point into the caller's buffer
+    auto const data = static_cast<char const*>(b.data().data());
+    REQUIRE(p.reason().data() > data);
+    REQUIRE(p.reason().data() < data + n);
+    REQUIRE(p[0].value.data() > data);
+    REQUIRE(p[0].value.data() < data + n);
+
+    // the body is parsed and discarded
+    b.consume(n);
+    b.commit(net::buffer_copy(b.prepare(5), net::buffer("hello", 5)));
+    beast::error_code ec;
+    REQUIRE(p.put(b.data(), ec) == 5);
+    REQUIRE(! ec);
+    REQUIRE(p.is_done());
+}
+
+TEST_CASE("header_view_parser request", "header_view_parser") {
+    std::string const s =
+        "PATCH /a/b?c=d HTTP/1.0\r\n"
+        "Host: example.com\r\n"
+        "\r\n";
+    http::request_header_view_parser p;
+    beast::error_code ec;
+    REQUIRE(p.put(net::buffer(s), ec) == s.size());
+    REQUIRE(! ec);
+    REQUIRE(p.is_done());
+    REQUIRE(p.method() == http::verb::patch);
+    REQUIRE(p.method_string() == "PATCH");
+    REQUIRE(p.target() == "/a/b?c=d");
+    REQUIRE(p.version() == 10);
+    REQUIRE(*p.find(http::field::host) == "example.com");
+
+    std::string const s2 =
+        "FROB * HTTP/1.1\r\n"
+        "Host: x\r\n"
+        "\r\n";
+    http::request_header_view_parser p2;
+    REQUIRE(p2.put(net::buffer(s2), ec) == s2.size());
+    REQUIRE(p2.method() == http::verb::unknown);
+    auto const h = p2.to_header();
+    REQUIRE(h.method_string() == "FROB");
+    REQUIRE(h.target() == "*");
+}
+
+TEST_CASE("header_view_parser many fields", "header_view_parser") {
+    std::string s = "HTTP/1.1 200 OK\r\n";
+    std::size_t const n = http::response_header_view_parser::inline_fields * 3;
+    for(std::size_t i = 0; i < n; ++i)
+        s += "X-Field-" + std::to_string(i) + ": " +
+            std::to_string(i * 7) + "\r\n";
+    s +=
+        "X-Folded: first\r\n"
+        " second\r\n"
+        "\r\n";
+    http::response_header_view_parser p;
+    beast::error_code ec;
+    REQUIRE(p.put(net::buffer(s), ec) == s.size());
+    REQUIRE(! ec);
+    REQUIRE(p.size() == n + 1);
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        REQUIRE(p[i].name == http::field::unknown);
+        REQUIRE(p[i].name_string == "X-Field-" + std::to_string(i));
+        REQUIRE(p[i].value == std::to_string(i * 7));
+    }
+    REQUIRE(*p.find("x-field-40") == "280");
+    REQUIRE(*p.find("X-Folded") == "first second");
+
+    // the copy matches what the full parser makes
+    http::response_parser<http::empty_body> full;
+    full.put(net::buffer(s), ec);
+    REQUIRE(! ec);
+    auto const h = p.to_header();
+    REQUIRE(h.result() == http::status::ok);
+    REQUIRE(h.reason() == "OK");
+    auto it = full.get().begin();
+    for(auto const& f : h)
+    {
+        REQUIRE(it != full.get().end());
+        REQUIRE(f.name_string() == it->name_string());
+        REQUIRE(f.value() == it->value());
+        ++it;
+    }
+    REQUIRE(it == full.get().end());
+}
+
+TEST_CASE("header_view_parser limits", "header_view_parser") {
+    http::response_header_view_parser p;
+    p.header_limit(64);
+    beast::error_code ec;
+    std::string s = "HTTP/1.1 200 OK\r\nServer: ";
+    REQUIRE(p.put(net::buffer(s), ec) == 0);
+    REQUIRE(ec == http::error::need_more);
+    s.append(60, 'x');
+    REQUIRE(p.put(net::buffer(s), ec) == 0);
+    REQUIRE(ec == http::error::header_limit);
+
+    http::response_header_view_parser p2;
+    std::string const bad = "HTTP/1.1 2000 OK\r\n\r\n";
+    p2.put(net::buffer(bad), ec);
+    REQUIRE(ec == http::error::bad_status);
+}
+
+TEST_CASE("header_view_parser read_header", "header_view_parser") {
+    for(bool async : {false, true})
+    {
+        // a few bytes at a time, so the buffer grows and moves
+        net::io_context ioc;
+        test::stream ts(ioc, response);
+        ts.read_size(7);
+        beast::flat_buffer b;
+        http::response_header_view_parser p;
+        std::size_t n = 0;
+        if(async)
+        {
+            bool invoked = false;
+            http::async_read_header(ts, b, p,
+                [&](beast::error_code ec, std::size_t bytes)
+                {
+                    REQUIRE(! ec);
+                    n = bytes;
+                    invoked = true;
+                });
+            REQUIRE(! invoked);
+            ioc.run();
+            REQUIRE(invoked);
+        }
+        else
+        {
+            n = http::read_header(ts, b, p);
+        }
+        REQUIRE(n == response.size() - 5);
+        REQUIRE(n == p.header_size());
+        REQUIRE(p.is_header_done());
+        REQUIRE(p.result_int() == 301);
+        REQUIRE(*p.find(http::field::location) == "https://example.com/");
+
+        // the header stays in the buffer, and the views refer to it
+        REQUIRE(b.size() >= n);
+        auto const data = static_cast<char const*>(b.data().data());
+        REQUIRE(p.reason().data() > data);
+        REQUIRE(p.reason().data() < data + n);
+        REQUIRE(p[5].value.data() > data);
+        REQUIRE(p[5].value.data() < data + n);
+        b.consume(n);
+    }
+}
+
+TEST_CASE("header_view_parser read_header eof", "header_view_parser") {
+    net::io_context ioc;
+    {
+        test::stream ts(ioc, "HTTP/1.1 200 OK\r\n");
+        ts.close_remote();
+        beast::flat_buffer b;
+        http::response_header_view_parser p;
+        beast::error_code ec;
+        REQUIRE(http::read_header(ts, b, p, ec) == 0);
+        REQUIRE(ec == http::error::partial_message);
+    }
+    {
+        test::stream ts(ioc);
+        ts.close_remote();
+        beast::flat_buffer b;
+        http::response_header_view_parser p;
+        beast::error_code ec;
+        http::async_read_header(ts, b, p,
+            [&](beast::error_code ec_, std::size_t) { ec = ec_; });
+        ioc.run();
+        REQUIRE(ec == http::error::end_of_stream);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,363 @@
+#include "catch.hpp"
+#include "stream.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <thread>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/read.hpp>
+#include <asio/write.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/relay.hpp>
+#include <boost/beast/http/string_body.hpp>
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace test = beast::test;
+using tcp = net::ip::tcp;
+
+namespace {
+
+std::string
+make_body(std::size_t n)
+{
+    std::string s;
+    s.reserve(n);
+    for(std::size_t i = 0; i < n; ++i)
+        s.push_back(static_cast<char>('a' + (i * 7) % 26));
+    return s;
+}
+
+std::string
+make_chunked(std::string const& body, std::size_t chunk)
+{
+    std::string s =
+        "POST /upload HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n";
+    for(std::size_t pos = 0; pos < body.size(); pos += chunk)
+    {
+        auto const n = (std::min)(chunk, body.size() - pos);
+        char size[32];
+        std::snprintf(size, sizeof(size), "%zx\r\n", n);
+        s += size;
+        s += body.substr(pos, n);
+        s += "\r\n";
+    }
+    s += "0\r\n\r\n";
+    return s;
+}
+
+std::string
+make_sized(std::string const& body)
+{
+    return
+        "POST /upload HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "\r\n" + body;
+}
+
+// Parse a complete request from `wire`
+http::request<http::string_body>
+parse(beast::string_view wire)
+{
+    http::request_parser<http::string_body> p;
+    p.body_limit(std::nullopt);
+    p.eager(true);
+    beast::error_code ec;
+    auto const n = p.put(net::buffer(wire), ec);
+    REQUIRE(! ec);
+    REQUIRE(p.is_done());
+    REQUIRE(n == wire.size());
+    return p.release();
+}
+
+auto const rewrite =
+    [](http::request_header<>& h, beast::error_code&)
+    {
+        h.target("/backend/upload");
+        h.set(http::field::host, "backend");
+        h.set("X-Forwarded-For", "10.0.0.1");
+    };
+
+void
+check_rewritten(http::request<http::string_body> const& m)
+{
+    REQUIRE(m.target() == "/backend/upload");
+    REQUIRE(m[http::field::host] == "backend");
+    REQUIRE(m["X-Forwarded-For"] == "10.0.0.1");
+}
+
+} // (anon)
+
+TEST_CASE("http relay chunked", "relay") {
+    auto const body = make_body(300000);
+    auto const wire = make_chunked(body, 1000) + "GET / HTTP/1.1\r\n";
+
+    for(bool async : {false, true})
+    {
+        net::io_context ioc;
+        test::stream in(ioc, wire);
+        test::stream out(ioc);
+        test::stream peer(ioc);
+        out.connect(peer);
+        in.read_size(777);
+        beast::flat_buffer b;
+        std::size_t n = 0;
+        if(async)
+        {
+            bool invoked = false;
+            http::async_relay<true>(in, out, b, rewrite,
+                [&](beast::error_code ec, std::size_t bytes)
+                {
+                    REQUIRE(! ec);
+                    n = bytes;
+                    invoked = true;
+                });
+            ioc.run();
+            REQUIRE(invoked);
+        }
+        else
+        {
+            n = http::relay<true>(in, out, b, rewrite);
+        }
+        REQUIRE(n == body.size());
+        auto const m = parse(peer.str());
+        check_rewritten(m);
+        REQUIRE(m.chunked());
+        REQUIRE(m.body() == body);
+
+        // the pipelined request stays in the buffer
+        REQUIRE(beast::buffers_to_string(b.data()) ==
+            "GET / HTTP/1.1\r\n");
+    }
+}
+
+TEST_CASE("http relay content length", "relay") {
+    auto const body = make_body(200000);
+    for(bool async : {false, true})
+    {
+        net::io_context ioc;
+        test::stream in(ioc, make_sized(body) + "GET");
+        test::stream out(ioc);
+        test::stream peer(ioc);
+        out.connect(peer);
+        in.read_size(1500);
+        beast::flat_buffer b;
+        std::size_t n = 0;
+        if(async)
+            http::async_relay<true>(in, out, b, rewrite,
+                [&](beast::error_code ec, std::size_t bytes)
+                {
+                    REQUIRE(! ec);
+                    n = bytes;
+                });
+        else
+            n = http::relay<true>(in, out, b, rewrite);
+        ioc.run();
+        REQUIRE(n == body.size());
+        auto const m = parse(peer.str());
+        check_rewritten(m);
+        REQUIRE(! m.chunked());
+        REQUIRE(m[http::field::content_length] ==
+            std::to_string(body.size()));
+        REQUIRE(m.body() == body);
+        REQUIRE(beast::buffers_to_string(b.data()) == "GET");
+    }
+}
+
+TEST_CASE("http relay rechunk", "relay") {
+    // the transformation switches the body to chunked
+    auto const body = make_body(100000);
+    net::io_context ioc;
+    test::stream in(ioc, make_sized(body));
+    test::stream out(ioc);
+    test::stream peer(ioc);
+    out.connect(peer);
+    beast::flat_buffer b;
+    auto const n = http::relay<true>(in, out, b,
+        [](http::request_header<>& h, beast::error_code&)
+        {
+            h.erase(http::field::content_length);
+            h.set(http::field::transfer_encoding, "chunked");
+        });
+    REQUIRE(n == body.size());
+    auto const m = parse(peer.str());
+    REQUIRE(m.chunked());
+    REQUIRE(m.body() == body);
+}
+
+TEST_CASE("http relay errors", "relay") {
+    // the transformation stops the relay
+    {
+        net::io_context ioc;
+        test::stream in(ioc, make_sized("hello"));
+        test::stream out(ioc);
+        test::stream peer(ioc);
+        out.connect(peer);
+        beast::flat_buffer b;
+        beast::error_code ec;
+        http::relay<true>(in, out, b,
+            [](http::request_header<>&, beast::error_code& ec)
+            {
+                ec = http::error::bad_target;
+            }, ec);
+        REQUIRE(ec == http::error::bad_target);
+        REQUIRE(peer.str().empty());
+    }
+
+    // the input ends in the middle of the body
+    {
+        net::io_context ioc;
+        auto wire = make_sized(make_body(5000));
+        wire.resize(wire.size() - 10);
+        test::stream in(ioc, wire);
+        test::stream out(ioc);
+        test::stream peer(ioc);
+        out.connect(peer);
+        in.close_remote();
+        beast::flat_buffer b;
+        beast::error_code result;
+        http::async_relay<true>(in, out, b, rewrite,
+            [&](beast::error_code ec, std::size_t)
+            {
+                result = ec;
+            });
+        ioc.run();
+        REQUIRE(result == http::error::partial_message);
+    }
+}
+
+namespace {
+
+struct socket_relay
+{
+    std::string received;
+    std::string rest;
+    std::size_t bytes = 0;
+};
+
+// Relay `wire` from one loopback connection to another
+// and return what arrived.
+template<class Transform>
+socket_relay
+relay_sockets(
+    std::string const& wire,
+    Transform const& transform,
+    bool async)
+{
+    net::io_context ioc;
+    tcp::acceptor acceptor(ioc,
+        tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+    tcp::socket client(ioc), in(ioc), out(ioc), server(ioc);
+    client.connect(acceptor.local_endpoint());
+    acceptor.accept(in);
+    out.connect(acceptor.local_endpoint());
+    acceptor.accept(server);
+
+    socket_relay r;
+    std::thread writer(
+        [&]
+        {
+            net::write(client, net::buffer(wire));
+        });
+    std::thread reader(
+        [&]
+        {
+            beast::error_code ec;
+            std::string buf(65536, 0);
+            for(;;)
+            {
+                auto const n = server.read_some(
+                    net::buffer(buf), ec);
+                if(ec)
+                    break;
+                r.received.append(buf.data(), n);
+            }
+        });
+
+    beast::flat_buffer b;
+    if(async)
+    {
+        http::async_relay<true>(in, out, b, transform,
+            [&](beast::error_code ec, std::size_t bytes)
+            {
+                REQUIRE(! ec);
+                r.bytes = bytes;
+            });
+        ioc.run();
+    }
+    else
+    {
+        r.bytes = http::relay<true>(in, out, b, transform);
+    }
+    writer.join();
+    out.shutdown(tcp::socket::shutdown_send);
+    reader.join();
+    if(! async)
+    {
+        // asynchronous operations turn the mode on
+        // themselves, so only the blocking case shows
+        REQUIRE(! in.native_non_blocking());
+        REQUIRE(! out.native_non_blocking());
+    }
+
+    // whatever followed the message
+    r.rest.resize(3);
+    auto const extra = b.size();
+    net::buffer_copy(net::buffer(r.rest), b.data());
+    if(extra < 3)
+        net::read(in, net::buffer(&r.rest[extra], 3 - extra));
+    return r;
+}
+
+} // (anon)
+
+TEST_CASE("http relay sockets", "relay") {
+    // Content-Length bodies between sockets are spliced on Linux
+    auto const body = make_body(4 * 1024 * 1024);
+    auto const wire = make_sized(body) + "GET";
+    for(bool async : {false, true})
+    {
+        auto const r = relay_sockets(wire, rewrite, async);
+        REQUIRE(r.bytes == body.size());
+        auto const m = parse(r.received);
+        check_rewritten(m);
+        REQUIRE(m.body() == body);
+
+        // nothing past the message was consumed
+        REQUIRE(r.rest == "GET");
+    }
+}
+
+TEST_CASE("http relay sockets reframed", "relay") {
+    // A transform which changes the framing of the body
+    // is honored instead of splicing the input bytes
+    auto const body = make_body(1024 * 1024);
+    auto const wire = make_sized(body) + "GET";
+    for(bool async : {false, true})
+    {
+        auto const r = relay_sockets(wire,
+            [](http::request_header<>& h, beast::error_code& ec)
+            {
+                rewrite(h, ec);
+                h.erase(http::field::content_length);
+                h.set(http::field::transfer_encoding, "chunked");
+            }, async);
+        auto const m = parse(r.received);
+        check_rewritten(m);
+        REQUIRE(m.chunked());
+        REQUIRE(m.count(http::field::content_length) == 0);
+        REQUIRE(m.body() == body);
+        REQUIRE(r.rest == "GET");
+    }
+}
@@ -0,0 +1,209 @@
+#include "catch.hpp"
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/write.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/request_template.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+using tcp = net::ip::tcp;
+
+namespace {
+
+template<class Body>
+std::string
+to_string(http::request<Body> const& req)
+{
+    std::ostringstream os;
+    os << req;
+    return os.str();
+}
+
+// The variable fields of a template come after the others
+http::request<http::string_body>
+make_request(
+    std::string const& target,
+    std::string const& token,
+    std::string const& id,
+    std::string const& body)
+{
+    http::request<http::string_body> req{http::verb::post, target, 11};
+    req.set(http::field::host, "www.example.com");
+    req.set(http::field::user_agent, "Beast");
+    req.set(http::field::authorization, token);
+    req.set("X-Request-Id", id);
+    req.body() = body;
+    req.prepare_payload();
+    return req;
+}
+
+http::request<http::empty_body>
+make_prototype()
+{
+    http::request<http::empty_body> req{http::verb::post, "/", 11};
+    req.set(http::field::host, "www.example.com");
+    req.set(http::field::authorization, "Bearer 1");
+    req.set(http::field::user_agent, "Beast");
+    req.content_length(0);
+    return req;
+}
+
+} // (anon)
+
+static_assert(net::is_const_buffer_sequence<
+    http::request_template::const_buffers_type>::value, "");
+
+TEST_CASE("request_template serialize", "request_template") {
+    http::request<http::empty_body> req{http::verb::get, "/index.html", 10};
+    req.set(http::field::host, "www.example.com");
+    req.set(http::field::user_agent, "Beast");
+
+    // with nothing variable, the output is the serializer's
+    http::request_template t(req);
+    REQUIRE(! t.has_body());
+    REQUIRE(beast::buffers_to_string(t.buffers()) == to_string(req));
+    REQUIRE(t.size() == to_string(req).size());
+
+    t.target("/other");
+    REQUIRE(t.target() == "/other");
+    req.target("/other");
+    REQUIRE(beast::buffers_to_string(t.buffers()) == to_string(req));
+
+    REQUIRE_THROWS_AS(t.set(http::field::host, "x"), std::out_of_range);
+    REQUIRE_THROWS_AS(t.at(http::field::host), std::out_of_range);
+    REQUIRE_THROWS_AS(t.body(net::buffer("x", 1)), std::logic_error);
+
+    req.chunked(true);
+    REQUIRE_THROWS_AS(http::request_template(req), std::invalid_argument);
+}
+
+TEST_CASE("request_template patch", "request_template") {
+    http::request_template t(make_prototype(),
+        {http::field::authorization, http::field::unknown});
+    REQUIRE(t.has_body());
+    REQUIRE(t.at(http::field::authorization) == "Bearer 1");
+    REQUIRE(t.at("AUTHORIZATION") == "Bearer 1");
+
+    http::request_template t2(make_prototype(),
+        {"authorization", "X-Request-Id"});
+    REQUIRE(t2.at("x-request-id") == "");
+    REQUIRE(beast::buffers_to_string(t2.buffers()) ==
+        to_string(make_request("/", "Bearer 1", "", "")));
+
+    std::string const body = "{\"key\":\"value\"}";
+    for(int i = 0; i < 3; ++i)
+    {
+        auto const target = "/item/" + std::to_string(i * 1000);
+        auto const token = "Bearer t" + std::string(i * 20, 'x');
+        auto const id = std::to_string(i);
+        t2.target(target);
+        t2.set(http::field::authorization, token);
+        t2.set("X-Request-Id", id);
+        t2.body(net::buffer(body.data(), i * 5));
+        REQUIRE(beast::buffers_to_string(t2.buffers()) == to_string(
+            make_request(target, token, id, body.substr(0, i * 5))));
+    }
+
+    // copies and moves refer to their own storage
+    auto const expected = beast::buffers_to_string(t2.buffers());
+    auto copy = t2;
+    t2.target("/changed");
+    REQUIRE(beast::buffers_to_string(copy.buffers()) == expected);
+    auto moved = std::move(copy);
+    REQUIRE(beast::buffers_to_string(moved.buffers()) == expected);
+    copy = moved;
+    REQUIRE(beast::buffers_to_string(copy.buffers()) == expected);
+    moved = std::move(t2);
+    REQUIRE(moved.target() == "/changed");
+}
+
+TEST_CASE("request_template invalid", "request_template") {
+    http::request_template t(make_prototype(),
+        {http::field::authorization});
+    auto const expected = beast::buffers_to_string(t.buffers());
+
+    // nothing may end the start-line or a field early
+    REQUIRE_THROWS_AS(t.target("/a b"), std::invalid_argument);
+    REQUIRE_THROWS_AS(t.target("/a\r\nX: y"), std::invalid_argument);
+    REQUIRE_THROWS_AS(t.set(http::field::authorization,
+        "x\r\nX-Injected: 1"), std::invalid_argument);
+    REQUIRE_THROWS_AS(t.set(http::field::authorization,
+        "x\ny"), std::invalid_argument);
+    REQUIRE_THROWS_AS(t.set(http::field::authorization,
+        std::string("x\0y", 3)), std::invalid_argument);
+    REQUIRE(beast::buffers_to_string(t.buffers()) == expected);
+
+    t.set(http::field::authorization, "Bearer a, b\tc");
+    REQUIRE(t.at(http::field::authorization) == "Bearer a, b\tc");
+}
+
+TEST_CASE("request_template moved-from", "request_template") {
+    http::request_template t(make_prototype(),
+        {http::field::authorization});
+    auto const moved = std::move(t);
+
+    // the moved-from object is empty and may still be used
+    REQUIRE(t.size() == 0);
+    REQUIRE(t.buffers().size() == 0);
+    REQUIRE(! t.has_body());
+    REQUIRE(t.target().empty());
+    t.target("/");
+    REQUIRE(t.target() == "/");
+    REQUIRE_THROWS_AS(t.set(http::field::authorization, "x"),
+        std::out_of_range);
+    REQUIRE_THROWS_AS(t.body(net::buffer("x", 1)), std::logic_error);
+
+    http::request_template u(make_prototype());
+    u = std::move(t);
+    REQUIRE(u.target() == "/");
+    REQUIRE(u.buffers().size() == 0);
+    REQUIRE(t.buffers().size() == 0);
+    t = moved;
+    REQUIRE(beast::buffers_to_string(t.buffers()) ==
+        beast::buffers_to_string(moved.buffers()));
+}
+
+TEST_CASE("request_template async_write", "request_template") {
+    net::io_context ioc;
+    tcp::acceptor acceptor(ioc,
+        tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+    beast::tcp_stream client(ioc);
+    tcp::socket server(ioc);
+    client.socket().connect(acceptor.local_endpoint());
+    acceptor.accept(server);
+
+    http::request_template t(make_prototype(), {http::field::authorization});
+    std::string const body = "Hello, world!";
+    t.target("/upload");
+    t.set(http::field::authorization, "Bearer 2");
+    t.body(net::buffer(body));
+
+    std::size_t written = 0;
+    net::async_write(client, t.buffers(),
+        [&](beast::error_code ec, std::size_t n)
+        {
+            REQUIRE(! ec);
+            written = n;
+        });
+    ioc.run();
+    REQUIRE(written == t.size());
+
+    beast::flat_buffer buffer;
+    http::request<http::string_body> req;
+    http::read(server, buffer, req);
+    REQUIRE(req.target() == "/upload");
+    REQUIRE(req[http::field::authorization] == "Bearer 2");
+    REQUIRE(req[http::field::host] == "www.example.com");
+    REQUIRE(req.body() == body);
+}
@@ -0,0 +1,211 @@
+#include "catch.hpp"
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <asio/buffer.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/steady_timer.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/websocket/keepalive.hpp>
+#include <boost/beast/websocket/stream.hpp>
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+using tcp = net::ip::tcp;
+using ws_type = websocket::stream<tcp::socket>;
+using namespace std::chrono_literals;
+
+namespace {
+
+// A client and a server connected on loopback,
+// both run by the same io_context.
+struct pair
+{
+    net::io_context ioc;
+    ws_type client{ioc};
+    ws_type server{ioc};
+
+    pair()
+    {
+        tcp::acceptor acceptor(ioc,
+            tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+        client.next_layer().connect(acceptor.local_endpoint());
+        acceptor.accept(server.next_layer());
+        server.async_accept(
+            [](beast::error_code ec)
+            {
+                REQUIRE(! ec);
+            });
+        client.async_handshake("localhost", "/",
+            [](beast::error_code ec)
+            {
+                REQUIRE(! ec);
+            });
+        ioc.run();
+        ioc.restart();
+    }
+};
+
+} // (anon)
+
+TEST_CASE("websocket keepalive pings", "keepalive") {
+    pair p;
+    websocket::keepalive ka(p.ioc.get_executor(), 5ms);
+    ka.add(p.server, 40ms, 1s);
+
+    // both sides read, so pings are answered
+    beast::flat_buffer cb;
+    beast::error_code cec;
+    p.client.async_read(cb,
+        [&](beast::error_code ec, std::size_t)
+        {
+            cec = ec;
+        });
+    beast::flat_buffer sb;
+    beast::error_code sec;
+    p.server.async_read(sb,
+        [&](beast::error_code ec, std::size_t)
+        {
+            sec = ec;
+        });
+
+    net::steady_timer t(p.ioc, 300ms);
+    websocket::keepalive_stats stats;
+    t.async_wait(
+        [&](beast::error_code)
+        {
+            stats = ka.stats();
+            ka.remove(p.server);
+            p.client.async_close({},
+                [](beast::error_code)
+                {
+                });
+        });
+    p.ioc.run();
+
+    REQUIRE(stats.streams == 1);
+    REQUIRE(stats.pings >= 3);
+    REQUIRE(stats.pongs >= 2);
+    REQUIRE(stats.pongs <= stats.pings);
+    REQUIRE(stats.timeouts == 0);
+    REQUIRE(stats.passes > 0);
+    REQUIRE(stats.rtt_min.count() > 0);
+    REQUIRE(stats.rtt_min <= stats.rtt_mean);
+    REQUIRE(stats.rtt_mean <= stats.rtt_max);
+    REQUIRE(sec == websocket::error::closed);
+    // the client's own close ends its read
+    REQUIRE(cec == net::error::operation_aborted);
+    REQUIRE(ka.stats().streams == 0);
+}
+
+TEST_CASE("websocket keepalive timeout", "keepalive") {
+    pair p;
+    websocket::keepalive ka(p.ioc.get_executor(), 5ms);
+    ka.add(p.server, 30ms, 100ms);
+
+    // the client never reads, so it never answers
+    auto const t0 = std::chrono::steady_clock::now();
+    beast::flat_buffer sb;
+    beast::error_code sec;
+    p.server.async_read(sb,
+        [&](beast::error_code ec, std::size_t)
+        {
+            sec = ec;
+        });
+    p.ioc.run();
+
+    REQUIRE(sec == beast::error::timeout);
+    REQUIRE(std::chrono::steady_clock::now() - t0 >= 100ms);
+    auto const stats = ka.stats();
+    REQUIRE(stats.streams == 0);
+    REQUIRE(stats.pings == 1);
+    REQUIRE(stats.pongs == 0);
+    REQUIRE(stats.timeouts == 1);
+}
+
+TEST_CASE("websocket keepalive activity", "keepalive") {
+    pair p;
+    websocket::keepalive ka(p.ioc.get_executor(), 5ms);
+    ka.add(p.server, 60ms, 200ms);
+
+    // messages from the client keep the stream busy
+    int sent = 0;
+    net::steady_timer t(p.ioc);
+    std::function<void()> send =
+        [&]
+        {
+            if(sent++ == 20)
+            {
+                ka.remove(p.server);
+                p.client.async_close({},
+                    [](beast::error_code)
+                    {
+                    });
+                return;
+            }
+            p.client.async_write(net::buffer("x", 1),
+                [&](beast::error_code ec, std::size_t)
+                {
+                    REQUIRE(! ec);
+                    t.expires_after(15ms);
+                    t.async_wait(
+                        [&](beast::error_code)
+                        {
+                            send();
+                        });
+                });
+        };
+    send();
+
+    std::function<void()> read;
+    beast::flat_buffer sb;
+    read =
+        [&]
+        {
+            p.server.async_read(sb,
+                [&](beast::error_code ec, std::size_t)
+                {
+                    if(ec)
+                    {
+                        REQUIRE(ec == websocket::error::closed);
+                        return;
+                    }
+                    sb.clear();
+                    read();
+                });
+        };
+    read();
+
+    beast::flat_buffer cb;
+    p.client.async_read(cb,
+        [&](beast::error_code, std::size_t)
+        {
+        });
+    p.ioc.run();
+
+    auto const stats = ka.stats();
+    REQUIRE(stats.pings == 0);
+    REQUIRE(stats.timeouts == 0);
+}
+
+TEST_CASE("websocket keepalive arguments", "keepalive") {
+    net::io_context ioc;
+    REQUIRE_THROWS_AS(websocket::keepalive(
+        ioc.get_executor(), 0ms), std::invalid_argument);
+    REQUIRE_THROWS_AS(websocket::keepalive(
+        ioc.get_executor(), 10ms, 0), std::invalid_argument);
+
+    ws_type ws(ioc);
+    websocket::keepalive ka(ioc.get_executor());
+    REQUIRE_THROWS_AS(ka.add(ws, 0ms, 1s), std::invalid_argument);
+    REQUIRE_THROWS_AS(ka.add(ws, 1s, 1s), std::invalid_argument);
+
+    // a stream which is not open is dropped
+    ka.add(ws, 1ms, 1s);
+    REQUIRE(ka.stats().streams == 1);
+    ioc.run();
+    REQUIRE(ka.stats().streams == 0);
+}
@@ -0,0 +1,282 @@
+#include "catch.hpp"
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <asio/buffer.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/websocket/detail/payload.hpp>
+#include <boost/beast/websocket/stream.hpp>
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+namespace detail = websocket::detail;
+using tcp = net::ip::tcp;
+
+namespace {
+
+// ASCII text with a multi-byte code point now and then
+std::string
+make_text(std::size_t n, unsigned seed)
+{
+    static char const* const cps[] = {
+        "\xc2\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80"};
+    std::mt19937 g(seed);
+    std::string s;
+    while(s.size() < n)
+    {
+        if(g() % 16 == 0)
+            s += cps[g() % 3];
+        else
+            s += static_cast<char>('a' + g() % 26);
+    }
+    return s;
+}
+
+detail::prepared_key
+make_key(std::uint32_t k)
+{
+    detail::prepared_key key;
+    detail::prepare_key(key, k);
+    return key;
+}
+
+// Copies `in` to `out` in pieces of the given sizes,
+// as successive reads of one message would.
+bool
+copy_in_pieces(
+    std::string& out,
+    std::string const& in,
+    std::vector<std::size_t> const& sizes,
+    detail::prepared_key* key,
+    detail::utf8_checker* utf8)
+{
+    out.resize(in.size());
+    std::size_t pos = 0;
+    for(std::size_t i = 0; pos < in.size(); ++i)
+    {
+        auto const n = (std::min)(
+            sizes[i % sizes.size()], in.size() - pos);
+        if(! detail::copy_payload(net::buffer(&out[pos], n),
+                net::buffer(&in[pos], n), n, key, utf8))
+            return false;
+        pos += n;
+    }
+    return true;
+}
+
+} // (anon)
+
+TEST_CASE("websocket copy_payload", "payload") {
+    auto const text = make_text(10000, 1);
+    std::vector<std::vector<std::size_t>> const pieces = {
+        {10000}, {1}, {3, 5, 7}, {1023, 2, 1025}, {4096, 1}};
+
+    for(auto const& sizes : pieces)
+    {
+        // unmasked text is copied and checked
+        {
+            std::string out;
+            detail::utf8_checker utf8;
+            REQUIRE(copy_in_pieces(out, text, sizes, nullptr, &utf8));
+            REQUIRE(utf8.finish());
+            REQUIRE(out == text);
+        }
+
+        // masked text is unmasked with the key carried across pieces
+        {
+            auto masked = text;
+            auto key = make_key(0xdeadbeef);
+            detail::mask_inplace(net::buffer(&masked[0], masked.size()), key);
+            REQUIRE(masked != text);
+
+            key = make_key(0xdeadbeef);
+            std::string out;
+            detail::utf8_checker utf8;
+            REQUIRE(copy_in_pieces(out, masked, sizes, &key, &utf8));
+            REQUIRE(utf8.finish());
+            REQUIRE(out == text);
+            REQUIRE(key == make_key(0xdeadbeef >> (text.size() % 4 * 8) |
+                0xdeadbeef << ((4 - text.size() % 4) % 4 * 8)));
+        }
+    }
+
+    // in place, as when reading into the caller's buffer
+    {
+        auto buf = text;
+        auto key = make_key(0x01020304);
+        detail::mask_inplace(net::buffer(&buf[0], buf.size()), key);
+        key = make_key(0x01020304);
+        detail::utf8_checker utf8;
+        auto const b = net::buffer(&buf[0], buf.size());
+        REQUIRE(detail::copy_payload(b, b, buf.size(), &key, &utf8));
+        REQUIRE(utf8.finish());
+        REQUIRE(buf == text);
+    }
+}
+
+TEST_CASE("websocket copy_payload invalid", "payload") {
+    // an invalid byte anywhere, including across block boundaries
+    for(std::size_t pos : {0, 1, 7, 8, 1023, 1024, 1025, 4000})
+    {
+        std::string text(5000, 'a');
+        text[pos] = '\xff';
+        for(std::size_t piece : {5000, 1024, 3})
+        {
+            std::string out;
+            detail::utf8_checker utf8;
+            REQUIRE(! copy_in_pieces(out, text, {piece}, nullptr, &utf8));
+        }
+    }
+
+    // a code point cut short by ASCII at the start of the next block
+    {
+        std::string text(2048, 'a');
+        text[1023] = '\xe2';
+        std::string out;
+        detail::utf8_checker utf8;
+        REQUIRE(! copy_in_pieces(out, text, {2048}, nullptr, &utf8));
+    }
+
+    // a code point which is split between reads is valid
+    {
+        std::string text(2048, 'a');
+        text.replace(1023, 3, "\xe2\x82\xac");
+        std::string out;
+        detail::utf8_checker utf8;
+        REQUIRE(copy_in_pieces(out, text, {1024}, nullptr, &utf8));
+        REQUIRE(utf8.finish());
+    }
+
+    // an incomplete final code point
+    {
+        std::string text(100, 'a');
+        text.back() = '\xc2';
+        std::string out;
+        detail::utf8_checker utf8;
+        REQUIRE(copy_in_pieces(out, text, {100}, nullptr, &utf8));
+        REQUIRE(! utf8.finish());
+    }
+}
+
+namespace {
+
+// Runs a client and a server on a loopback connection,
+// the client sends messages and the server reads them.
+template<class Client, class Server>
+void
+run_pair(Client&& client, Server&& server)
+{
+    net::io_context ioc;
+    tcp::acceptor acceptor(ioc,
+        tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+    websocket::stream<tcp::socket> cs(ioc);
+    websocket::stream<tcp::socket> ss(ioc);
+    cs.next_layer().connect(acceptor.local_endpoint());
+    acceptor.accept(ss.next_layer());
+
+    std::thread t(
+        [&]
+        {
+            ss.accept();
+            server(ss, ioc);
+        });
+    cs.handshake("localhost", "/");
+    client(cs);
+    t.join();
+}
+
+} // (anon)
+
+TEST_CASE("websocket read text", "payload") {
+    std::vector<std::string> const messages = {
+        "", "Hello", make_text(100, 2), make_text(5000, 3),
+        make_text(1000000, 4)};
+
+    // client frames are masked, server frames are not
+    run_pair(
+        [&](websocket::stream<tcp::socket>& ws)
+        {
+            ws.text(true);
+            for(auto const& m : messages)
+                ws.write(net::buffer(m));
+            for(auto const& m : messages)
+            {
+                beast::flat_buffer b;
+                ws.read(b);
+                REQUIRE(ws.got_text());
+                REQUIRE(beast::buffers_to_string(b.data()) == m);
+            }
+        },
+        [&](websocket::stream<tcp::socket>& ws, net::io_context&)
+        {
+            for(auto const& m : messages)
+            {
+                beast::flat_buffer b;
+                ws.read(b);
+                REQUIRE(beast::buffers_to_string(b.data()) == m);
+            }
+            ws.text(true);
+            for(auto const& m : messages)
+                ws.write(net::buffer(m));
+        });
+
+    // the asynchronous read, in pieces smaller and larger
+    // than the read buffer so both ways of reading are used
+    run_pair(
+        [&](websocket::stream<tcp::socket>& ws)
+        {
+            ws.text(true);
+            ws.write(net::buffer(messages.back()));
+        },
+        [&](websocket::stream<tcp::socket>& ws, net::io_context& ioc)
+        {
+            std::string s;
+            std::vector<char> buf(100000);
+            std::size_t reads = 0;
+            std::function<void()> read =
+                [&]
+                {
+                    ws.async_read_some(net::buffer(buf.data(),
+                            ++reads % 2 ? 777 : buf.size()),
+                        [&](beast::error_code ec, std::size_t n)
+                        {
+                            REQUIRE(! ec);
+                            s.append(buf.data(), n);
+                            if(! ws.is_message_done())
+                                read();
+                        });
+                };
+            read();
+            ioc.run();
+            REQUIRE(s == messages.back());
+        });
+}
+
+TEST_CASE("websocket read invalid text", "payload") {
+    auto text = make_text(100000, 5);
+    text[60000] = '\xff';
+    run_pair(
+        [&](websocket::stream<tcp::socket>& ws)
+        {
+            ws.text(true);
+            ws.write(net::buffer(text));
+            beast::flat_buffer b;
+            beast::error_code ec;
+            ws.read(b, ec);
+            REQUIRE(ec == websocket::error::closed);
+            REQUIRE(ws.reason().code == websocket::close_code::bad_payload);
+        },
+        [&](websocket::stream<tcp::socket>& ws, net::io_context&)
+        {
+            beast::flat_buffer b;
+            beast::error_code ec;
+            ws.read(b, ec);
+            REQUIRE(ec == websocket::error::bad_frame_payload);
+        });
+}
@@ -0,0 +1,370 @@
+#include "catch.hpp"
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <asio/buffer.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/read.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/websocket/prepared_message.hpp>
+#include <boost/beast/websocket/stream.hpp>
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+using tcp = net::ip::tcp;
+using ws_type = websocket::stream<tcp::socket>;
+
+namespace {
+
+// Connects n clients to n servers on loopback connections. Each
+// client sends "go" once its handshake is done, which the server
+// reads before it is handed to `server`, so that later frames
+// never arrive together with the handshake response.
+void
+run_broadcast(
+    std::size_t n,
+    std::function<void(ws_type&)> const& setup,
+    std::function<void(std::vector<std::unique_ptr<ws_type>>&,
+        net::io_context&)> const& server,
+    std::function<void(ws_type&)> const& client)
+{
+    net::io_context ioc;
+    tcp::acceptor acceptor(ioc,
+        tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+    std::vector<std::unique_ptr<ws_type>> servers;
+    std::vector<std::thread> clients;
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        clients.emplace_back(
+            [&]
+            {
+                net::io_context cioc;
+                ws_type ws(cioc);
+                setup(ws);
+                ws.next_layer().connect(acceptor.local_endpoint());
+                ws.handshake("localhost", "/");
+                ws.write(net::buffer("go", 2));
+                client(ws);
+            });
+        servers.emplace_back(new ws_type(ioc));
+        setup(*servers.back());
+        acceptor.accept(servers.back()->next_layer());
+        servers.back()->accept();
+        beast::flat_buffer b;
+        servers.back()->read(b);
+    }
+    server(servers, ioc);
+    for(auto& t : clients)
+        t.join();
+}
+
+void
+no_setup(ws_type&)
+{
+}
+
+// Sets up a stream to negotiate permessage-deflate with
+// no context takeover in the server role.
+void
+pmd_setup(ws_type& ws)
+{
+    websocket::permessage_deflate pmd;
+    pmd.client_enable = true;
+    pmd.server_enable = true;
+    pmd.server_no_context_takeover = true;
+    ws.set_option(pmd);
+}
+
+// Reads a frame as raw bytes from the connection
+std::string
+read_raw(ws_type& ws, std::size_t n)
+{
+    std::string s(n, 0);
+    net::read(ws.next_layer(), net::buffer(&s[0], n));
+    return s;
+}
+
+std::string
+to_string(net::const_buffer b)
+{
+    return std::string(static_cast<char const*>(b.data()), b.size());
+}
+
+std::string
+make_payload(std::size_t n)
+{
+    std::string s;
+    while(s.size() < n)
+        s += "the quick brown fox " + std::to_string(s.size());
+    s.resize(n);
+    return s;
+}
+
+} // (anon)
+
+TEST_CASE("websocket prepared_message frame", "prepared_message") {
+    for(std::size_t n : {0, 5, 125, 126, 65535, 65536, 100000})
+    {
+        auto const s = make_payload(n);
+        websocket::prepared_message m(n % 2 == 0, net::buffer(s));
+        REQUIRE(m.text() == (n % 2 == 0));
+        REQUIRE(m.size() == n);
+        REQUIRE(beast::buffers_to_string(m) == s);
+        REQUIRE(m.window_bits() == 0);
+        REQUIRE(m.deflated_frame().size() == 0);
+
+        auto const f = to_string(m.frame());
+        std::size_t const h = n < 126 ? 2 : n < 65536 ? 4 : 10;
+        REQUIRE(f.size() == h + n);
+        REQUIRE(static_cast<unsigned char>(f[0]) ==
+            (n % 2 == 0 ? 0x81 : 0x82));
+        REQUIRE(static_cast<unsigned char>(f[1]) ==
+            (n < 126 ? n : n < 65536 ? 126 : 127));
+        REQUIRE(f.substr(h) == s);
+
+        // copies share the frame
+        auto const m2 = m;
+        REQUIRE(m2.frame().data() == m.frame().data());
+    }
+}
+
+TEST_CASE("websocket prepared_message options", "prepared_message") {
+    websocket::permessage_deflate pmd;
+    auto const s = make_payload(1000);
+    {
+        websocket::prepared_message m(true, net::buffer(s), pmd);
+        REQUIRE(m.window_bits() == 15);
+        REQUIRE(m.deflated_frame().size() > 0);
+        REQUIRE(m.deflated_frame().size() < m.frame().size());
+        REQUIRE((static_cast<unsigned char const*>(
+            m.deflated_frame().data())[0] & 0x40) != 0);
+    }
+    pmd.server_max_window_bits = 8;
+    REQUIRE_THROWS_AS(websocket::prepared_message(
+        true, net::buffer(s), pmd), std::invalid_argument);
+    pmd.server_max_window_bits = 15;
+    pmd.compLevel = 10;
+    REQUIRE_THROWS_AS(websocket::prepared_message(
+        true, net::buffer(s), pmd), std::invalid_argument);
+    pmd.compLevel = 8;
+    pmd.memLevel = 0;
+    REQUIRE_THROWS_AS(websocket::prepared_message(
+        true, net::buffer(s), pmd), std::invalid_argument);
+}
+
+TEST_CASE("websocket prepared_message broadcast", "prepared_message") {
+    auto const s = make_payload(3000);
+    websocket::prepared_message const m(false, net::buffer(s));
+    auto const frame = to_string(m.frame());
+
+    // every server writes the shared frame as it is
+    run_broadcast(4, no_setup,
+        [&](std::vector<std::unique_ptr<ws_type>>& v,
+            net::io_context& ioc)
+        {
+            std::size_t done = 0;
+            for(auto& ws : v)
+                ws->async_write(m,
+                    [&](beast::error_code ec, std::size_t n)
+                    {
+                        REQUIRE(! ec);
+                        REQUIRE(n == s.size());
+                        ++done;
+                    });
+            ioc.run();
+            REQUIRE(done == v.size());
+            for(auto& ws : v)
+                REQUIRE(ws->write(m) == s.size());
+        },
+        [&](ws_type& ws)
+        {
+            REQUIRE(read_raw(ws, frame.size()) == frame);
+            REQUIRE(read_raw(ws, frame.size()) == frame);
+        });
+}
+
+TEST_CASE("websocket prepared_message deflate", "prepared_message") {
+    auto const s = make_payload(3000);
+    websocket::permessage_deflate pmd;
+    websocket::prepared_message const m(true, net::buffer(s), pmd);
+    auto const frame = to_string(m.deflated_frame());
+
+    // the shared compressed frame is sent as it is...
+    run_broadcast(3, pmd_setup,
+        [&](std::vector<std::unique_ptr<ws_type>>& v,
+            net::io_context&)
+        {
+            for(auto& ws : v)
+                REQUIRE(ws->write(m) == s.size());
+        },
+        [&](ws_type& ws)
+        {
+            REQUIRE(read_raw(ws, frame.size()) == frame);
+        });
+
+    // ...and decodes as the original message
+    run_broadcast(2, pmd_setup,
+        [&](std::vector<std::unique_ptr<ws_type>>& v,
+            net::io_context&)
+        {
+            for(auto& ws : v)
+            {
+                ws->write(m);
+                ws->write(m);
+            }
+        },
+        [&](ws_type& ws)
+        {
+            for(int i = 0; i < 2; ++i)
+            {
+                beast::flat_buffer b;
+                ws.read(b);
+                REQUIRE(ws.got_text());
+                REQUIRE(beast::buffers_to_string(b.data()) == s);
+            }
+        });
+}
+
+TEST_CASE("websocket prepared_message fallback", "prepared_message") {
+    auto const s = make_payload(3000);
+    websocket::permessage_deflate pmd;
+    websocket::prepared_message const m(true, net::buffer(s), pmd);
+    auto const check =
+        [&](ws_type& ws)
+        {
+            for(int i = 0; i < 3; ++i)
+            {
+                beast::flat_buffer b;
+                ws.read(b);
+                REQUIRE(beast::buffers_to_string(b.data()) == s);
+            }
+        };
+
+    // context takeover, compressed by each stream
+    run_broadcast(2,
+        [](ws_type& ws)
+        {
+            websocket::permessage_deflate pmd;
+            pmd.client_enable = true;
+            pmd.server_enable = true;
+            ws.set_option(pmd);
+        },
+        [&](std::vector<std::unique_ptr<ws_type>>& v,
+            net::io_context& ioc)
+        {
+            for(auto& ws : v)
+            {
+                ws->write(m);
+                ws->write(m);
+                ws->async_write(m,
+                    [&](beast::error_code ec, std::size_t n)
+                    {
+                        REQUIRE(! ec);
+                        REQUIRE(n == s.size());
+                    });
+            }
+            ioc.run();
+        },
+        check);
+
+    // a smaller window than the message's
+    run_broadcast(1,
+        [](ws_type& ws)
+        {
+            pmd_setup(ws);
+            websocket::permessage_deflate pmd;
+            ws.get_option(pmd);
+            pmd.server_max_window_bits = 10;
+            ws.set_option(pmd);
+        },
+        [&](std::vector<std::unique_ptr<ws_type>>& v,
+            net::io_context&)
+        {
+            for(int i = 0; i < 3; ++i)
+                v[0]->write(m);
+        },
+        check);
+
+    // client role, where every frame is masked
+    {
+        net::io_context ioc;
+        tcp::acceptor acceptor(ioc,
+            tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+        ws_type cs(ioc);
+        ws_type ss(ioc);
+        cs.next_layer().connect(acceptor.local_endpoint());
+        acceptor.accept(ss.next_layer());
+        std::thread t(
+            [&]
+            {
+                ss.accept();
+                check(ss);
+            });
+        cs.handshake("localhost", "/");
+        cs.write(m);
+        cs.write(m);
+        cs.async_write(m,
+            [&](beast::error_code ec, std::size_t n)
+            {
+                REQUIRE(! ec);
+                REQUIRE(n == s.size());
+            });
+        ioc.run();
+        t.join();
+    }
+}
+
+TEST_CASE("websocket prepared_message fallback opcode", "prepared_message") {
+    // the fallback sends the type of the message, not the stream's
+    auto const s = make_payload(100);
+    websocket::permessage_deflate pmd;
+    websocket::prepared_message const text(true, net::buffer(s), pmd);
+    websocket::prepared_message const binary(false, net::buffer(s), pmd);
+    for(bool stream_binary : {false, true})
+    {
+        auto const& m = stream_binary ? text : binary;
+        net::io_context ioc;
+        tcp::acceptor acceptor(ioc,
+            tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+        ws_type cs(ioc);
+        ws_type ss(ioc);
+        cs.next_layer().connect(acceptor.local_endpoint());
+        acceptor.accept(ss.next_layer());
+        int texts = 0;
+        int binaries = 0;
+        std::thread t(
+            [&]
+            {
+                ss.accept();
+                for(int i = 0; i < 3; ++i)
+                {
+                    beast::flat_buffer b;
+                    ss.read(b);
+                    texts += ss.got_text();
+                    binaries += ss.got_binary();
+                }
+            });
+        cs.handshake("localhost", "/");
+        cs.binary(stream_binary);
+        cs.write(m);
+        cs.async_write(m,
+            [&](beast::error_code ec, std::size_t)
+            {
+                REQUIRE(! ec);
+            });
+        ioc.run();
+
+        // the stream's own type is left alone
+        REQUIRE(cs.binary() == stream_binary);
+        cs.write(net::buffer(s));
+        t.join();
+        REQUIRE(texts == (stream_binary ? 2 : 1));
+        REQUIRE(binaries == (stream_binary ? 1 : 2));
+    }
+}
\ No newline at end of file
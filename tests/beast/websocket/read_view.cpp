@@ -0,0 +1,222 @@
+#include "catch.hpp"
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <asio/buffer.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/websocket/stream.hpp>
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+using tcp = net::ip::tcp;
+using ws_type = websocket::stream<tcp::socket>;
+
+namespace {
+
+// Runs a client and a server on a loopback connection
+template<class Client, class Server, class Setup>
+void
+run_pair(Client&& client, Server&& server, Setup&& setup)
+{
+    net::io_context ioc;
+    tcp::acceptor acceptor(ioc,
+        tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+    ws_type cs(ioc);
+    ws_type ss(ioc);
+    setup(cs);
+    setup(ss);
+    cs.next_layer().connect(acceptor.local_endpoint());
+    acceptor.accept(ss.next_layer());
+
+    std::thread t(
+        [&]
+        {
+            ss.accept();
+            server(ss, ioc);
+        });
+    cs.handshake("localhost", "/");
+    client(cs);
+    t.join();
+}
+
+template<class Client, class Server>
+void
+run_pair(Client&& client, Server&& server)
+{
+    run_pair(client, server, [](ws_type&){});
+}
+
+std::vector<std::string>
+make_messages()
+{
+    return {
+        "Hello",
+        "",
+        std::string(1000, 'a'),
+        std::string(1500, 'b'),     // about the size of the read buffer
+        std::string(100000, 'c'),   // larger than the read buffer
+        "\xe2\x82\xac"};
+}
+
+void
+send(ws_type& ws, std::vector<std::string> const& messages)
+{
+    ws.text(true);
+    for(auto const& m : messages)
+        ws.write(net::buffer(m));
+}
+
+} // (anon)
+
+TEST_CASE("websocket read_view", "read_view") {
+    auto const messages = make_messages();
+
+    // masked frames to a server, unmasked ones to a client
+    run_pair(
+        [&](ws_type& ws)
+        {
+            send(ws, messages);
+            for(auto const& m : messages)
+            {
+                auto const view = ws.read_view();
+                REQUIRE(ws.got_text());
+                REQUIRE(ws.is_message_done());
+                REQUIRE(beast::buffers_to_string(view) == m);
+            }
+            ws.close(websocket::close_code::normal);
+        },
+        [&](ws_type& ws, net::io_context&)
+        {
+            std::vector<std::string> got;
+            for(std::size_t i = 0; i < messages.size(); ++i)
+                got.push_back(beast::buffers_to_string(ws.read_view()));
+            REQUIRE(got == messages);
+            send(ws, messages);
+            beast::error_code ec;
+            ws.read_view(ec);
+            REQUIRE(ec == websocket::error::closed);
+        });
+}
+
+TEST_CASE("websocket read_view mixed", "read_view") {
+    run_pair(
+        [&](ws_type& ws)
+        {
+            ws.binary(true);
+            ws.write(net::buffer("first", 5));
+
+            // a message in several frames, with a ping between
+            ws.write_some(false, net::buffer("sec", 3));
+            ws.ping({});
+            ws.write_some(true, net::buffer("ond", 3));
+
+            ws.write(net::buffer("third", 5));
+            ws.text(true);
+            ws.write(net::buffer("fourth", 6));
+            ws.close(websocket::close_code::normal);
+        },
+        [&](ws_type& ws, net::io_context&)
+        {
+            auto view = ws.read_view();
+            REQUIRE(ws.got_binary());
+            REQUIRE(beast::buffers_to_string(view) == "first");
+
+            view = ws.read_view();
+            REQUIRE(beast::buffers_to_string(view) == "second");
+
+            // the other reads still work after a view
+            beast::flat_buffer b;
+            ws.read(b);
+            REQUIRE(beast::buffers_to_string(b.data()) == "third");
+
+            view = ws.read_view();
+            REQUIRE(ws.got_text());
+            REQUIRE(beast::buffers_to_string(view) == "fourth");
+
+            beast::error_code ec;
+            ws.read(b, ec);
+            REQUIRE(ec == websocket::error::closed);
+        });
+}
+
+TEST_CASE("websocket read_view deflate", "read_view") {
+    auto const messages = make_messages();
+    run_pair(
+        [&](ws_type& ws)
+        {
+            send(ws, messages);
+        },
+        [&](ws_type& ws, net::io_context&)
+        {
+            for(auto const& m : messages)
+                REQUIRE(beast::buffers_to_string(ws.read_view()) == m);
+        },
+        [](ws_type& ws)
+        {
+            websocket::permessage_deflate pmd;
+            pmd.client_enable = true;
+            pmd.server_enable = true;
+            ws.set_option(pmd);
+        });
+}
+
+TEST_CASE("websocket read_view invalid text", "read_view") {
+    run_pair(
+        [&](ws_type& ws)
+        {
+            ws.text(true);
+            ws.write(net::buffer("ok\xff", 3));
+            beast::flat_buffer b;
+            beast::error_code ec;
+            ws.read(b, ec);
+            REQUIRE(ec == websocket::error::closed);
+            REQUIRE(ws.reason().code == websocket::close_code::bad_payload);
+        },
+        [&](ws_type& ws, net::io_context&)
+        {
+            beast::error_code ec;
+            ws.read_view(ec);
+            REQUIRE(ec == websocket::error::bad_frame_payload);
+        });
+}
+
+TEST_CASE("websocket async_read_view", "read_view") {
+    auto const messages = make_messages();
+    run_pair(
+        [&](ws_type& ws)
+        {
+            send(ws, messages);
+            ws.close(websocket::close_code::normal);
+        },
+        [&](ws_type& ws, net::io_context& ioc)
+        {
+            std::vector<std::string> got;
+            beast::error_code result;
+            std::function<void()> read =
+                [&]
+                {
+                    ws.async_read_view(
+                        [&](beast::error_code ec,
+                            ws_type::message_view view)
+                        {
+                            if(ec)
+                            {
+                                result = ec;
+                                return;
+                            }
+                            got.push_back(
+                                beast::buffers_to_string(view));
+                            read();
+                        });
+                };
+            read();
+            ioc.run();
+            REQUIRE(got == messages);
+            REQUIRE(result == websocket::error::closed);
+        });
+}
@@ -0,0 +1,221 @@
+#include "catch.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <asio/buffer.hpp>
+#include <asio/executor_work_guard.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/websocket/stream.hpp>
+
+namespace net = asio;
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+using tcp = net::ip::tcp;
+using ws_type = websocket::stream<tcp::socket>;
+
+namespace {
+
+// Runs a client and a server on a loopback connection
+template<class Client, class Server>
+void
+run_pair(Client&& client, Server&& server)
+{
+    net::io_context ioc;
+    tcp::acceptor acceptor(ioc,
+        tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+    ws_type cs(ioc);
+    ws_type ss(ioc);
+    cs.next_layer().connect(acceptor.local_endpoint());
+    acceptor.accept(ss.next_layer());
+
+    std::thread t(
+        [&]
+        {
+            ss.accept();
+            server(ss, ioc);
+        });
+    cs.handshake("localhost", "/");
+    client(cs);
+    t.join();
+}
+
+std::vector<std::string>
+make_messages(std::size_t n)
+{
+    std::vector<std::string> v;
+    for(std::size_t i = 0; i < n; ++i)
+        v.push_back(std::to_string(i) + std::string(
+            i % 10 == 9 ? 20000 : i % 7, 'x'));
+    return v;
+}
+
+} // (anon)
+
+TEST_CASE("websocket async_send", "send") {
+    auto const messages = make_messages(200);
+
+    // unmasked, from the thread running the stream
+    run_pair(
+        [&](ws_type& ws)
+        {
+            for(auto const& m : messages)
+            {
+                beast::flat_buffer b;
+                ws.read(b);
+                REQUIRE(ws.got_binary());
+                REQUIRE(beast::buffers_to_string(b.data()) == m);
+            }
+            beast::flat_buffer b;
+            ws.read(b);
+            REQUIRE(ws.got_text());
+            REQUIRE(beast::buffers_to_string(b.data()) == "done");
+        },
+        [&](ws_type& ws, net::io_context& ioc)
+        {
+            std::size_t sent = 0;
+            ws.binary(true);
+            for(auto const& m : messages)
+                ws.async_send(net::buffer(m),
+                    [&](beast::error_code ec, std::size_t n)
+                    {
+                        REQUIRE(! ec);
+                        REQUIRE(n == messages[sent].size());
+                        ++sent;
+                    });
+            ws.text(true);
+            ws.async_send(net::buffer("done", 4),
+                [&](beast::error_code ec, std::size_t)
+                {
+                    REQUIRE(! ec);
+                    ++sent;
+                });
+            auto const stats0 = ws.send_stats();
+            REQUIRE(stats0.depth == messages.size() + 1);
+            REQUIRE(stats0.bytes > 0);
+            ioc.run();
+            REQUIRE(sent == messages.size() + 1);
+
+            auto const stats = ws.send_stats();
+            REQUIRE(stats.depth == 0);
+            REQUIRE(stats.bytes == 0);
+            REQUIRE(stats.messages == messages.size() + 1);
+            REQUIRE(stats.batches < stats.messages);
+            REQUIRE(stats.largest_batch > 1);
+        });
+}
+
+TEST_CASE("websocket async_send threads", "send") {
+    std::size_t constexpr threads = 4;
+    std::size_t constexpr per_thread = 500;
+
+    // masked, from several threads at once
+    run_pair(
+        [&](ws_type& ws)
+        {
+            std::atomic<std::size_t> sent{0};
+            std::atomic<bool> failed{false};
+            auto& ioc = static_cast<net::io_context&>(
+                ws.get_executor().context());
+            ioc.restart();
+            auto work = net::make_work_guard(ioc);
+            std::thread runner([&]{ ioc.run(); });
+            std::vector<std::thread> v;
+            for(std::size_t i = 0; i < threads; ++i)
+                v.emplace_back(
+                    [&, i]
+                    {
+                        for(std::size_t j = 0; j < per_thread; ++j)
+                        {
+                            auto s = std::make_shared<std::string>(
+                                std::to_string(i) + ":" +
+                                    std::to_string(j));
+                            ws.async_send(net::buffer(*s),
+                                [&, s](beast::error_code ec, std::size_t)
+                                {
+                                    if(ec)
+                                        failed = true;
+                                    ++sent;
+                                });
+                        }
+                    });
+            for(auto& t : v)
+                t.join();
+            work.reset();
+            runner.join();
+            REQUIRE(! failed);
+            REQUIRE(sent == threads * per_thread);
+            REQUIRE(ws.send_stats().messages == threads * per_thread);
+        },
+        [&](ws_type& ws, net::io_context&)
+        {
+            // each thread's messages arrive in order
+            std::vector<std::size_t> next(threads);
+            for(std::size_t n = 0; n < threads * per_thread; ++n)
+            {
+                beast::flat_buffer b;
+                ws.read(b);
+                auto const s = beast::buffers_to_string(b.data());
+                auto const colon = s.find(':');
+                auto const i = std::stoul(s.substr(0, colon));
+                REQUIRE(i < threads);
+                REQUIRE(std::stoul(s.substr(colon + 1)) == next[i]);
+                ++next[i];
+            }
+        });
+}
+
+TEST_CASE("websocket async_send limit", "send") {
+    run_pair(
+        [&](ws_type& ws)
+        {
+            beast::flat_buffer b;
+            ws.read(b);
+            REQUIRE(beast::buffers_to_string(b.data()) ==
+                std::string(60, 'a'));
+            b.clear();
+            ws.read(b);
+            REQUIRE(beast::buffers_to_string(b.data()) ==
+                std::string(40, 'c'));
+            ws.close(websocket::close_code::normal);
+        },
+        [&](ws_type& ws, net::io_context& ioc)
+        {
+            std::string const a(60, 'a');
+            std::string const b(50, 'b');
+            std::string const c(40, 'c');
+            std::vector<beast::error_code> results;
+            auto const handler =
+                [&](beast::error_code ec, std::size_t)
+                {
+                    results.push_back(ec);
+                };
+            ws.send_queue_limit(100);
+            REQUIRE(ws.send_queue_limit() == 100);
+            ws.async_send(net::buffer(a), handler);
+            ws.async_send(net::buffer(b), handler);
+            ws.async_send(net::buffer(c), handler);
+            REQUIRE(ws.send_stats().depth == 2);
+            REQUIRE(ws.send_stats().bytes == 100);
+            ioc.run();
+            REQUIRE(results.size() == 3);
+            REQUIRE(results[0] == websocket::error::send_queue_full);
+            REQUIRE(! results[1]);
+            REQUIRE(! results[2]);
+
+            // messages queued after the close fail
+            beast::flat_buffer buf;
+            beast::error_code ec;
+            ws.read(buf, ec);
+            REQUIRE(ec == websocket::error::closed);
+            results.clear();
+            ws.async_send(net::buffer(a), handler);
+            ioc.restart();
+            ioc.run();
+            REQUIRE(results.size() == 1);
+            REQUIRE(results[0] == net::error::operation_aborted);
+        });
+}